@@ -57,10 +57,16 @@ settings.video_defaults = {}
 settings.video_defaults.full_screen = true
 settings.video_defaults.screen_resx = 1280
 settings.video_defaults.screen_resy = 1024
+settings.video_defaults.render_scale = 100
+settings.video_defaults.smooth_scaling = true
+settings.video_defaults.native_gui = true
 settings.video_settings = {}
 settings.video_settings.full_screen = true
 settings.video_settings.screen_resx = 1280
 settings.video_settings.screen_resy = 1024
+settings.video_settings.render_scale = 100
+settings.video_settings.smooth_scaling = true
+settings.video_settings.native_gui = true
 settings.audio_settings = {}
 settings.audio_settings.music_vol = 1
 settings.audio_settings.sound_vol = 1
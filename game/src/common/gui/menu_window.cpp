@@ -79,6 +79,7 @@ bool MenuWindow::Create(float w, float h, int32 visible_flags, int32 shared_flag
 
 void MenuWindow::Destroy() {
 	_skin = NULL;
+	_image_cache.Destroy();
 	GUIManager->_RemoveMenuWindow(this);
 }
 
@@ -175,6 +176,7 @@ void MenuWindow::Draw() {
 	if (_window_state == VIDEO_MENU_STATE_HIDDEN)
 		return;
 
+	VideoManager->BeginRenderPass(VIDEO_RENDER_PASS_GUI);
 	VideoManager->PushState();
 	VideoManager->SetDrawFlags(_xalign, _yalign, VIDEO_BLEND, 0);
 
@@ -190,13 +192,26 @@ void MenuWindow::Draw() {
 	}
 
 	VideoManager->Move(_x_position, _y_position);
-	_menu_image.Draw(Color::white);
+
+	// The cache is only recorded once every tile of the window has been loaded, or the missing tiles would be retained
+	if (_image_cache.IsDirty() == true && _menu_image.IsLoadPending() == false) {
+		if (_image_cache.BeginRecording(_menu_image.GetWidth(), _menu_image.GetHeight()) == true) {
+			_menu_image.Draw(Color::white);
+			_image_cache.EndRecording();
+		}
+	}
+
+	if (_image_cache.IsDirty() == false)
+		_image_cache.Draw(Color::white);
+	else
+		_menu_image.Draw(Color::white);
 
 	if (GUIManager->DEBUG_DrawOutlines() == true) {
 		_DEBUG_DrawOutline();
 	}
 
 	VideoManager->PopState();
+	VideoManager->EndRenderPass();
 	return;
 } // void MenuWindow::Draw()
 
@@ -333,6 +348,7 @@ bool MenuWindow::_RecreateImage() {
 	}
 
 	_menu_image.Clear();
+	_image_cache.Invalidate();
 
 	// Get information about the border sizes
 	float left_border_size   = _skin->borders[1][0].GetWidth();
@@ -22,6 +22,7 @@
 #include "gui.h"
 #include "screen_rect.h"
 #include "image.h"
+#include "render_cache.h"
 
 namespace hoa_gui {
 
@@ -143,6 +144,12 @@ public:
 *** the display of dialogue text, inventory lists, etc. This class is designed
 *** with that practice in mind.
 ***
+*** \note The border and background of a window are made of many small tiles.
+*** They are drawn once into a render cache and from then on drawn as a single
+*** image, until a change to the size, edges, or skin of the window requires
+*** the tiles to be composed again. Windows are drawn from their tiles whenever
+*** the cache can not be used.
+***
 *** \todo Allow the user to specify an arbitrary amount of time for showing/
 *** hiding the menu window.
 ***
@@ -292,6 +299,9 @@ private:
 	//! \brief The image that creates the window
 	hoa_video::CompositeImage _menu_image;
 
+	//! \brief Retains the drawn menu image, so that it can be drawn as one quad while the window is unchanged
+	hoa_video::RenderCache _image_cache;
+
 	//! \brief The window's display mode (instant, expand from center, etc).
 	VIDEO_MENU_DISPLAY_MODE _display_mode;
 
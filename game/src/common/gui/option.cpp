@@ -164,6 +164,7 @@ void OptionBox::Draw() {
 		return;
 	}
 
+	VideoManager->BeginRenderPass(VIDEO_RENDER_PASS_GUI);
 	VideoManager->PushState();
 	VideoManager->SetDrawFlags(_xalign, _yalign, VIDEO_BLEND, 0);
 	VideoManager->DisableScissoring();
@@ -296,6 +297,7 @@ void OptionBox::Draw() {
 		GUIControl::_DEBUG_DrawOutline();
 
 	VideoManager->PopState();
+	VideoManager->EndRenderPass();
 } // void OptionBox::Draw()
 
 
@@ -98,6 +98,7 @@ void TextBox::Draw() {
 	//  (4): Determine the text draw position from the alignment flags
 	//  (5): Draw each line of text to the screen
 	//  (6): Restore the original video engine context
+	VideoManager->BeginRenderPass(VIDEO_RENDER_PASS_TEXT);
 	VideoManager->PushState();
 
 	VideoManager->SetDrawFlags(_xalign, _yalign, VIDEO_BLEND, 0);
@@ -173,6 +174,7 @@ void TextBox::Draw() {
 		_DEBUG_DrawOutline(text_ypos);
 
 	VideoManager->PopState();
+	VideoManager->EndRenderPass();
 } // void TextBox::Draw()
 
 
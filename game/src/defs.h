@@ -106,6 +106,10 @@ namespace hoa_video {
 		class VariableTexNode;
 
 		class ImageMemory;
+		class ImageLoadRequest;
+		class ImageLoader;
+		class ImageCacheHeader;
+		class ImageCache;
 
 		class BaseTexture;
 		class ImageTexture;
@@ -117,13 +121,16 @@ namespace hoa_video {
 		class ParticleManager;
 		class ParticleSystem;
 		class ParticleSystemDef;
-		class Particle;
+		class ParticleSystemJob;
+		class ParticleArrays;
 		class ParticleVertex;
 		class ParticleTexCoord;
 		class ParticleKeyframe;
 
 		class ScreenFader;
 		class ShakeForce;
+
+		class LightBuffer;
 	}
 }
 
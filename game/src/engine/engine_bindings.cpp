@@ -224,6 +224,8 @@ void BindEngineCode() {
 			.def("StopShaking", &VideoEngine::StopShaking)
 			.def("EnableLightOverlay", &VideoEngine::EnableLightOverlay)
 			.def("DisableLightOverlay", &VideoEngine::DisableLightOverlay)
+			.def("EnableSceneLighting", &VideoEngine::EnableSceneLighting)
+			.def("DisableSceneLighting", &VideoEngine::DisableSceneLighting)
 			.def("EnableAmbientOverlay", &VideoEngine::EnableAmbientOverlay)
 			.def("DisableAmbientOverlay", &VideoEngine::DisableAmbientOverlay)
 			.def("LoadLightningEffect", &VideoEngine::LoadLightningEffect)
@@ -305,6 +305,20 @@ void InputEngine::_KeyEventHandler(SDL_KeyboardEvent& key_event) {
 				// Ctrl+A: "Advanced" display of video engine information
 				VideoManager->ToggleAdvancedDisplay();
 			}
+			else if (key_event.keysym.sym == SDLK_d) {
+				// Ctrl+D: "Draw" call capture of the following frames to a file
+				static uint32 i = 1;
+				string path = "";
+				while (true)
+				{
+					path = hoa_utils::GetUserDataPath(true) + "draw_capture_" + NumberToString<uint32>(i) + ".txt";
+					if (!DoesFileExist(path))
+						break;
+					i++;
+				}
+				VideoManager->CaptureDrawCalls(path, VIDEO_DRAW_CAPTURE_FRAMES);
+				return;
+			}
 			else if (key_event.keysym.sym == SDLK_f) {
 				// Ctrl+F: "Fullscreen" toggle
 				VideoManager->ToggleFullscreen();
@@ -316,6 +330,30 @@ void InputEngine::_KeyEventHandler(SDL_KeyboardEvent& key_event) {
 				ModeManager->DEBUG_ToggleGraphicsEnabled();
 				return;
 			}
+			else if (key_event.keysym.sym == SDLK_l) {
+				// Ctrl+L: "Log" of render pass timings to a file toggle
+				if (VideoManager->IsFrameProfileLogging() == true) {
+					VideoManager->StopFrameProfileLog();
+					return;
+				}
+
+				static uint32 i = 1;
+				string path = "";
+				while (true)
+				{
+					path = hoa_utils::GetUserDataPath(true) + "frame_profile_" + NumberToString<uint32>(i) + ".csv";
+					if (!DoesFileExist(path))
+						break;
+					i++;
+				}
+				VideoManager->StartFrameProfileLog(path);
+				return;
+			}
+			else if (key_event.keysym.sym == SDLK_p) {
+				// Ctrl+P: "Profiler" display toggle
+				VideoManager->ToggleFrameProfiler();
+				return;
+			}
 			else if (key_event.keysym.sym == SDLK_q) {
 				// Ctrl+Q: "Quit" command requested
 				_quit_press = true;
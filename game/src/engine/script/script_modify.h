@@ -294,7 +294,7 @@ template <class T> void ModifyScriptDescriptor::_AddNewData(const std::string& k
 	// A pointer to the table where the object is contained
 	luabind::object* table = NULL;
 
-	if (_open_tables.empty() == false) // Retrieve the globals table
+	if (_open_tables.empty() == true) // Retrieve the globals table
 		table = new luabind::object(luabind::from_stack(_lstack, LUA_GLOBALSINDEX));
 	else // Retrieve the most recently opened table from the top of the stack
 		table = new luabind::object(luabind::from_stack(_lstack, private_script::STACK_TOP));
@@ -302,17 +302,19 @@ template <class T> void ModifyScriptDescriptor::_AddNewData(const std::string& k
 	if (luabind::type(*table) != LUA_TTABLE) {
 		_error_messages << "* _AddNewData() failed because the top of the stack was not a table "
 			<< "when trying to add the new data: " << key << std::endl;
+		delete(table);
 		return;
 	}
 
 	// NOTE: If the key already exists in the table, its value will be overwritten here
 	luabind::settable(*table, key, value);
+	delete(table);
 } // template <class T> void ModifyScriptDescriptor::_AddNewData(const std::string& key, T value)
 
 
 
 template <class T> void ModifyScriptDescriptor::_AddNewData(int32 key, T value) {
-	if (_open_tables.empty() == false) {
+	if (_open_tables.empty() == true) {
 		_error_messages << "* _AddNewData() failed because there were no open tables when the "
 			<< "function was invoked for key: " << key << std::endl;
 		return;
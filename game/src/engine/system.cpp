@@ -28,6 +28,9 @@
 	#include <limits.h>
 #endif
 
+#include <cmath>
+#include <thread>
+
 // #include "gettext.h"
 #include <libintl.h>
 
@@ -236,6 +239,131 @@ void SystemTimer::_UpdateTimer(uint32 time) {
 	}
 }
 
+// -----------------------------------------------------------------------------
+// FramePacer Class
+// -----------------------------------------------------------------------------
+
+//! \brief The number of milliseconds that the pacer spins for before a deadline, in addition to the expected oversleep
+const double FRAME_SPIN_MARGIN = 1.0;
+
+//! \brief Frames longer than this many milliseconds, such as those that load a map, are left out of the unpaced frame time
+const double FRAME_TIME_OUTLIER = 250.0;
+
+FramePacer::FramePacer() :
+	_target_frame_rate(SYSTEM_DEFAULT_FRAME_RATE),
+	_frame_start(Clock::now()),
+	_deadline(_frame_start),
+	_unpaced_frame_time(0.0),
+	_sleep_overshoot(FRAME_SPIN_MARGIN),
+	_next_frame_time(0),
+	_num_frame_times(0)
+{}
+
+
+
+void FramePacer::SetTargetFrameRate(uint32 frames_per_second) {
+	_target_frame_rate = frames_per_second;
+	_deadline = Clock::now();
+}
+
+
+
+void FramePacer::WaitForNextFrame(bool vsync_active) {
+	Clock::time_point now = Clock::now();
+
+	// ----- (1): Update the estimate of how long a frame takes when the pacer does not hold it
+	double unpaced = chrono::duration<double, milli>(now - _frame_start).count();
+	if (_unpaced_frame_time <= 0.0)
+		_unpaced_frame_time = unpaced;
+	else if (unpaced < FRAME_TIME_OUTLIER)
+		_unpaced_frame_time += (unpaced - _unpaced_frame_time) * 0.1;
+
+	// ----- (2): Wait until the next frame should begin
+	if (_target_frame_rate != 0) {
+		double period = 1000.0 / _target_frame_rate;
+
+		if (vsync_active == true) {
+			// The buffer swap has just returned at a display refresh, so the unpaced frame time is a whole number of
+			// refresh intervals. Sleeping through all but the last of the intervals in the period lets the next swap
+			// land on the intended refresh.
+			uint32 intervals = static_cast<uint32>(period / _unpaced_frame_time + 0.5);
+			if (intervals > 1) {
+				_WaitUntil(now + chrono::duration_cast<Clock::duration>(
+					chrono::duration<double, milli>((intervals - 1) * _unpaced_frame_time)));
+			}
+			_deadline = Clock::now();
+		}
+		else {
+			Clock::duration period_duration = chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(period));
+			_deadline += period_duration;
+			if (now - _deadline > period_duration)
+				_deadline = now;
+			_WaitUntil(_deadline);
+		}
+	}
+
+	// ----- (3): Record the duration of the frame that just ended
+	Clock::time_point frame_end = Clock::now();
+	_frame_times[_next_frame_time] = chrono::duration<float, milli>(frame_end - _frame_start).count();
+	_next_frame_time = (_next_frame_time + 1) % SYSTEM_FRAME_TIME_SAMPLES;
+	if (_num_frame_times < SYSTEM_FRAME_TIME_SAMPLES)
+		_num_frame_times++;
+	_frame_start = frame_end;
+} // void FramePacer::WaitForNextFrame(bool vsync_active)
+
+
+
+float FramePacer::GetFrameTimeAverage() const {
+	if (_num_frame_times == 0)
+		return 0.0f;
+
+	float sum = 0.0f;
+	for (uint32 i = 0; i < _num_frame_times; i++)
+		sum += _frame_times[i];
+	return sum / _num_frame_times;
+}
+
+
+
+float FramePacer::GetFrameTimeDeviation() const {
+	if (_num_frame_times == 0)
+		return 0.0f;
+
+	float average = GetFrameTimeAverage();
+	float sum = 0.0f;
+	for (uint32 i = 0; i < _num_frame_times; i++)
+		sum += (_frame_times[i] - average) * (_frame_times[i] - average);
+	return sqrtf(sum / _num_frame_times);
+}
+
+
+
+float FramePacer::GetFrameTimeMaximum() const {
+	float maximum = 0.0f;
+	for (uint32 i = 0; i < _num_frame_times; i++)
+		maximum = max(maximum, _frame_times[i]);
+	return maximum;
+}
+
+
+
+void FramePacer::_WaitUntil(const Clock::time_point& time) {
+	Clock::time_point sleep_start = Clock::now();
+	int32 sleep_time = static_cast<int32>(chrono::duration<double, milli>(time - sleep_start).count() - _sleep_overshoot - FRAME_SPIN_MARGIN);
+
+	if (sleep_time > 0) {
+		SDL_Delay(sleep_time);
+
+		// A longer oversleep is adopted right away, while the estimate only decays slowly so that an occasional long sleep
+		// does not make the pacer miss the following deadlines
+		double overshoot = chrono::duration<double, milli>(Clock::now() - sleep_start).count() - sleep_time;
+		_sleep_overshoot = max(overshoot, _sleep_overshoot * 0.99);
+	}
+
+	while (Clock::now() < time)
+		this_thread::yield();
+}
+
 // -----------------------------------------------------------------------------
 // SystemEngine Class
 // -----------------------------------------------------------------------------
@@ -299,8 +427,9 @@ bool SystemEngine::SingletonInitialize() {
 
 
 void SystemEngine::InitializeTimers() {
-	_last_update = SDL_GetTicks();
+	_last_update = chrono::steady_clock::now();
 	_update_time = 1; // Set to non-zero, otherwise bad things may happen...
+	_update_time_remainder = 0.0;
 	_hours_played = 0;
 	_minutes_played = 0;
 	_seconds_played = 0;
@@ -346,9 +475,12 @@ void SystemEngine::RemoveAutoTimer(SystemTimer* timer) {
 
 void SystemEngine::UpdateTimers() {
 	// ----- (1): Update the update game timer
-	uint32 tmp = _last_update;
-	_last_update = SDL_GetTicks();
-	_update_time = _last_update - tmp;
+	// The fraction of a millisecond that is left over is carried into the next update
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	double elapsed = chrono::duration<double, milli>(now - _last_update).count() + _update_time_remainder;
+	_last_update = now;
+	_update_time = static_cast<uint32>(elapsed);
+	_update_time_remainder = elapsed - _update_time;
 
 	// ----- (2): Update the game play timer
 	_milliseconds_played += _update_time;
@@ -23,6 +23,8 @@
 #ifndef __SYSTEM_HEADER__
 #define __SYSTEM_HEADER__
 
+#include <chrono>
+
 #include <SDL/SDL.h>
 
 #include "defs.h"
@@ -73,6 +75,12 @@ const int32 SYSTEM_TIMER_NO_LOOPS = 0;
 **/
 const int32 SYSTEM_TIMER_INFINITE_LOOP = -1;
 
+//! \brief The frame rate that the main loop is limited to unless the settings file specifies another
+const uint32 SYSTEM_DEFAULT_FRAME_RATE = 60;
+
+//! \brief The number of recent frames that the frame time statistics of the FramePacer class are computed over
+const uint32 SYSTEM_FRAME_TIME_SAMPLES = 120;
+
 //! \brief All of the possible states which a SystemTimer classs object may be in
 enum SYSTEM_TIMER_STATE {
 	SYSTEM_TIMER_INVALID  = -1,
@@ -296,6 +304,93 @@ protected:
 }; // class SystemTimer
 
 
+/** ****************************************************************************
+*** \brief Limits the rate at which the main game loop runs and measures its frame times
+***
+*** Without a limit the main loop runs as fast as the machine allows, which wastes
+*** power and makes the duration of each frame vary. The pacer holds each frame
+*** until a fixed deadline has passed. Sleeping with SDL_Delay() is only accurate
+*** to a millisecond or worse, so the pacer sleeps until shortly before the deadline
+*** and spins for the remaining time. The length of that spin is adapted to how much
+*** the operating system has been observed to oversleep.
+***
+*** When vertical synchronization is active the buffer swap already blocks until the
+*** next display refresh, and a sleep that ends between two refreshes would only
+*** delay a frame by a whole refresh interval. In that case the pacer rounds its
+*** period to a whole number of refresh intervals, measured from the frames
+*** themselves, and sleeps only through the intervals that should be skipped.
+***
+*** \note The deadlines advance by a fixed period rather than from the end of the
+*** previous frame, so an early frame does not shift all of the frames after it. A
+*** frame that is late by more than a full period resets the deadline instead of
+*** causing a burst of unpaced frames to catch up.
+*** ***************************************************************************/
+class FramePacer {
+public:
+	FramePacer();
+
+	/** \brief Sets the frame rate that the main loop is limited to
+	*** \param frames_per_second The number of frames per second, or zero to not limit the frame rate
+	**/
+	void SetTargetFrameRate(uint32 frames_per_second);
+
+	//! \brief Returns the frame rate that the main loop is limited to, or zero if it is unlimited
+	uint32 GetTargetFrameRate() const
+		{ return _target_frame_rate; }
+
+	/** \brief Waits until the next frame should begin
+	*** \param vsync_active True if the last buffer swap was synchronized with the display refresh
+	***
+	*** This should be called once per iteration of the main loop, right after the frame has been displayed.
+	**/
+	void WaitForNextFrame(bool vsync_active);
+
+	/** \name Frame Time Statistics
+	*** \brief Statistics of the durations of the most recent frames, in milliseconds
+	*** The duration of a frame includes the time spent waiting for its deadline.
+	**/
+	//@{
+	float GetFrameTimeAverage() const;
+
+	float GetFrameTimeDeviation() const;
+
+	float GetFrameTimeMaximum() const;
+	//@}
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	//! \brief The frame rate that the main loop is limited to, or zero if it is unlimited
+	uint32 _target_frame_rate;
+
+	//! \brief The time when the last call to WaitForNextFrame() returned
+	Clock::time_point _frame_start;
+
+	//! \brief The time that the current frame should end when vertical synchronization is not active
+	Clock::time_point _deadline;
+
+	/** \brief A running estimate of how long the main loop takes when it is not held by the pacer, in milliseconds
+	*** When vertical synchronization is active this is a whole number of display refresh intervals.
+	**/
+	double _unpaced_frame_time;
+
+	//! \brief A running estimate of how much longer than requested SDL_Delay() sleeps, in milliseconds
+	double _sleep_overshoot;
+
+	//! \brief The durations of the most recent frames, in milliseconds, used as a circular buffer
+	float _frame_times[SYSTEM_FRAME_TIME_SAMPLES];
+
+	//! \brief The index in _frame_times where the next duration will be written
+	uint32 _next_frame_time;
+
+	//! \brief The number of entries of _frame_times that hold a duration
+	uint32 _num_frame_times;
+
+	//! \brief Sleeps and then spins until a point in time has been reached
+	void _WaitUntil(const Clock::time_point& time);
+}; // class FramePacer
+
+
 /** ****************************************************************************
 *** \brief Engine class that manages system information and functions
 ***
@@ -323,7 +418,7 @@ public:
 	*** the active game mode's execution begins with only 1 millisecond of time expired instead of several.
 	**/
 	void InitializeUpdateTimer()
-		{ _last_update = SDL_GetTicks(); _update_time = 1; }
+		{ _last_update = std::chrono::steady_clock::now(); _update_time_remainder = 0.0; _update_time = 1; }
 
 	/** \brief Adds a timer to the set system timers for auto updating
 	*** \param timer A pointer to the timer to add
@@ -366,6 +461,18 @@ public:
 	uint32 GetUpdateTime() const
 		{ return _update_time; }
 
+	/** \brief Waits until the main game loop should begin its next frame
+	*** \param vsync_active True if the last buffer swap was synchronized with the display refresh
+	*** This function should only be called <b>once</b> for each cycle through the main game loop, right after
+	*** the frame has been displayed.
+	**/
+	void WaitForNextFrame(bool vsync_active)
+		{ _frame_pacer.WaitForNextFrame(vsync_active); }
+
+	//! \brief Returns the object that limits the frame rate of the main game loop
+	FramePacer& GetFramePacer()
+		{ return _frame_pacer; }
+
 	/** \brief Sets the play time of a game instance
 	*** \param h The amount of hours to set.
 	*** \param m The amount of minutes to set.
@@ -426,12 +533,20 @@ public:
 private:
 	SystemEngine();
 
-	//! \brief The last time that the UpdateTimers function was called, in milliseconds.
-	uint32 _last_update;
+	//! \brief The last time that the UpdateTimers function was called
+	std::chrono::steady_clock::time_point _last_update;
 
 	//! \brief The number of milliseconds that have transpired on the last timer update.
 	uint32 _update_time;
 
+	/** \brief The fraction of a millisecond that was left over from the last timer update
+	*** It is carried into the next update, so that the sum of all update times does not drift from the real time.
+	**/
+	double _update_time_remainder;
+
+	//! \brief Limits the frame rate of the main game loop
+	FramePacer _frame_pacer;
+
 	/** \name Play time members
 	*** \brief Timers that retain the total amount of time that the user has been playing
 	*** When the player starts a new game or loads an existing game, these timers are reset.
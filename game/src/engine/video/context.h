@@ -17,6 +17,7 @@
 #define __CONTEXT_HEADER__
 
 #include <string>
+#include <cmath>
 
 #include "defs.h"
 #include "utils.h"
@@ -41,7 +42,7 @@ namespace private_video {
 *** class which modifies this context.
 ***
 *** \note Transformations are actually handled separately by the OpenGL
-*** transformation stack
+*** transformation stack, which is mirrored on the CPU by the Transform2D class
 *** ***************************************************************************/
 class Context {
 public:
@@ -67,6 +68,57 @@ public:
 	bool scissoring_enabled;
 }; // class Context
 
+
+/** ****************************************************************************
+*** \brief A copy of the OpenGL modelview transformation that is kept on the CPU
+***
+*** The video engine only translates, rotates about the z axis, and scales in
+*** the x/y plane, so the modelview matrix always reduces to a 2D affine
+*** transformation. Every transformation method of the VideoEngine class applies
+*** the same operation to this object as to the OpenGL matrix, so that batched
+*** quads can be transformed without querying the matrix from OpenGL, which
+*** would stall the rendering pipeline.
+***
+*** A point (x, y) is transformed to (m[0] * x + m[2] * y + m[4], m[1] * x + m[3] * y + m[5]),
+*** which matches the layout of the corresponding elements of an OpenGL matrix.
+*** ***************************************************************************/
+class Transform2D {
+public:
+	Transform2D()
+		{ LoadIdentity(); }
+
+	//! \brief The six elements of the transformation
+	float m[6];
+
+	//! \brief Resets the transformation, as glLoadIdentity() does
+	void LoadIdentity()
+		{ m[0] = 1.0f; m[1] = 0.0f; m[2] = 0.0f; m[3] = 1.0f; m[4] = 0.0f; m[5] = 0.0f; }
+
+	//! \brief Sets the transformation from the x/y elements of a 4x4 OpenGL matrix
+	void LoadMatrix(const float matrix[16])
+		{ m[0] = matrix[0]; m[1] = matrix[1]; m[2] = matrix[4]; m[3] = matrix[5]; m[4] = matrix[12]; m[5] = matrix[13]; }
+
+	//! \brief Applies a translation, as glTranslatef(x, y, 0.0f) does
+	void Translate(float x, float y)
+		{ m[4] += m[0] * x + m[2] * y; m[5] += m[1] * x + m[3] * y; }
+
+	//! \brief Applies a scale, as glScalef(x, y, 1.0f) does
+	void Scale(float x, float y)
+		{ m[0] *= x; m[1] *= x; m[2] *= y; m[3] *= y; }
+
+	//! \brief Applies a counterclockwise rotation about the z axis, as glRotatef(degrees, 0, 0, 1) does
+	void Rotate(float degrees) {
+		float radians = degrees * 0.0174532925f;
+		float c = cosf(radians);
+		float s = sinf(radians);
+		float m0 = m[0], m1 = m[1];
+		m[0] = m0 * c + m[2] * s;
+		m[1] = m1 * c + m[3] * s;
+		m[2] = m[2] * c - m0 * s;
+		m[3] = m[3] * c - m1 * s;
+	}
+}; // class Transform2D
+
 } // namespace private_video
 
 } // namespace hoa_video
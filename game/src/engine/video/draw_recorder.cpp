@@ -0,0 +1,227 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    draw_recorder.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the DrawRecorder class
+*** ***************************************************************************/
+
+#include "draw_recorder.h"
+#include "video.h"
+
+using namespace std;
+
+using namespace hoa_utils;
+
+namespace hoa_video {
+
+namespace private_video {
+
+void FrameStatistics::Reset() {
+	draw_calls = 0;
+	texture_binds = 0;
+	state_changes = 0;
+	vertices = 0;
+	covered_pixels = 0.0f;
+	screen_pixels = 0.0f;
+}
+
+// -----------------------------------------------------------------------------
+// DrawRecorder class
+// -----------------------------------------------------------------------------
+
+DrawRecorder::DrawRecorder() :
+	_in_frame(false),
+	_estimate_coverage(false),
+	_capture_frames_remaining(0),
+	_capture_frame_number(0)
+{}
+
+
+
+DrawRecorder::~DrawRecorder() {
+	if (_capture_file.is_open() == true)
+		_capture_file.close();
+}
+
+
+
+void DrawRecorder::BeginFrame(int32 screen_width, int32 screen_height, bool estimate_coverage) {
+	_current_frame.Reset();
+	_current_frame.screen_pixels = static_cast<float>(screen_width) * static_cast<float>(screen_height);
+	_commands.clear();
+
+	// Coverage is always estimated for captured frames, so that captures taken with and without the statistics shown match
+	_estimate_coverage = (estimate_coverage == true || IsCapturing() == true);
+	_in_frame = true;
+}
+
+
+
+void DrawRecorder::EndFrame() {
+	if (_in_frame == false)
+		return;
+
+	_in_frame = false;
+	if (_estimate_coverage == false)
+		_current_frame.screen_pixels = 0.0f;
+	_last_frame = _current_frame;
+
+	if (IsCapturing() == true)
+		_WriteCapturedFrame();
+}
+
+
+
+void DrawRecorder::RecordDraw(GLenum primitive, GLuint texture, uint8 blend_mode, const void* vertices, GLenum vertex_type, uint32 vertex_count) {
+	if (_in_frame == false)
+		return;
+
+	_current_frame.draw_calls++;
+	_current_frame.vertices += vertex_count;
+
+	if (_estimate_coverage == false)
+		return;
+
+	GLfloat modelview[16];
+	glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+
+	// Lines cover a negligible area, so only quads contribute to the overdraw estimate
+	float coverage = 0.0f;
+	if (primitive == GL_QUADS)
+		coverage = _EstimateQuadCoverage(vertices, vertex_type, vertex_count, modelview);
+	_current_frame.covered_pixels += coverage;
+
+	if (IsCapturing() == true) {
+		DrawCommand command;
+		command.primitive = primitive;
+		command.texture = texture;
+		command.vertex_count = vertex_count;
+		command.blend_mode = blend_mode;
+		command.transform[0] = modelview[0];
+		command.transform[1] = modelview[1];
+		command.transform[2] = modelview[4];
+		command.transform[3] = modelview[5];
+		command.transform[4] = modelview[12];
+		command.transform[5] = modelview[13];
+		command.coverage = coverage;
+		_commands.push_back(command);
+	}
+} // void DrawRecorder::RecordDraw(...)
+
+
+
+bool DrawRecorder::StartCapture(const string& filename, uint32 number_frames) {
+	if (_capture_file.is_open() == true)
+		_capture_file.close();
+
+	if (number_frames == 0) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "requested a capture of zero frames" << endl;
+		return false;
+	}
+
+	_capture_file.open(filename.c_str(), ios::out | ios::trunc);
+	if (_capture_file.is_open() == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to open the draw capture file: " << filename << endl;
+		return false;
+	}
+
+	_capture_file << "# Draw capture of " << number_frames << " frames" << endl;
+	_capture_file << "# draw <primitive> texture=<id> vertices=<count> blend=<mode> transform=<x axis> <y axis> <translation> pixels=<coverage>" << endl;
+
+	_capture_frames_remaining = number_frames;
+	_capture_frame_number = 0;
+	return true;
+}
+
+
+
+float DrawRecorder::_EstimateQuadCoverage(const void* vertices, GLenum vertex_type, uint32 vertex_count, const GLfloat* modelview) const {
+	GLfloat projection[16];
+	GLint viewport[4];
+	glGetFloatv(GL_PROJECTION_MATRIX, projection);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	// Combine the x, y, and w rows of the projection and modelview matrices, which are stored in column-major order.
+	// The drawing is two dimensional, so the z coordinate of every vertex is zero and the z column is not needed.
+	float combined[3][3];
+	const uint32 rows[3] = { 0, 1, 3 };
+	const uint32 columns[3] = { 0, 1, 3 };
+	for (uint32 r = 0; r < 3; r++) {
+		for (uint32 c = 0; c < 3; c++) {
+			combined[r][c] = 0.0f;
+			for (uint32 k = 0; k < 4; k++)
+				combined[r][c] += projection[k * 4 + rows[r]] * modelview[columns[c] * 4 + k];
+		}
+	}
+
+	const float half_width = viewport[2] * 0.5f;
+	const float half_height = viewport[3] * 0.5f;
+	const GLfloat* float_vertices = static_cast<const GLfloat*>(vertices);
+	const GLint* int_vertices = static_cast<const GLint*>(vertices);
+
+	float total_area = 0.0f;
+	for (uint32 quad = 0; quad + 4 <= vertex_count; quad += 4) {
+		float x[4], y[4];
+		for (uint32 i = 0; i < 4; i++) {
+			float vx, vy;
+			if (vertex_type == GL_INT) {
+				vx = static_cast<float>(int_vertices[(quad + i) * 2]);
+				vy = static_cast<float>(int_vertices[(quad + i) * 2 + 1]);
+			}
+			else {
+				vx = float_vertices[(quad + i) * 2];
+				vy = float_vertices[(quad + i) * 2 + 1];
+			}
+
+			float w = combined[2][0] * vx + combined[2][1] * vy + combined[2][2];
+			if (w == 0.0f)
+				w = 1.0f;
+			x[i] = (combined[0][0] * vx + combined[0][1] * vy + combined[0][2]) / w * half_width;
+			y[i] = (combined[1][0] * vx + combined[1][1] * vy + combined[1][2]) / w * half_height;
+		}
+
+		// The shoelace formula gives the area of the quad regardless of its rotation or the direction of its axes
+		float area = (x[0] * y[1] - x[1] * y[0]) + (x[1] * y[2] - x[2] * y[1]) + (x[2] * y[3] - x[3] * y[2]) + (x[3] * y[0] - x[0] * y[3]);
+		total_area += fabs(area) * 0.5f;
+	}
+
+	return total_area;
+} // float DrawRecorder::_EstimateQuadCoverage(...)
+
+
+
+void DrawRecorder::_WriteCapturedFrame() {
+	_capture_file << "frame " << _capture_frame_number << " draws=" << _last_frame.draw_calls << " binds=" << _last_frame.texture_binds
+		<< " state_changes=" << _last_frame.state_changes << " vertices=" << _last_frame.vertices
+		<< " overdraw=" << _last_frame.GetOverdraw() << endl;
+
+	for (uint32 i = 0; i < _commands.size(); i++) {
+		const DrawCommand& command = _commands[i];
+		_capture_file << "draw " << (command.primitive == GL_QUADS ? "quads" : (command.primitive == GL_LINES ? "lines" : "other"))
+			<< " texture=" << command.texture << " vertices=" << command.vertex_count
+			<< " blend=" << static_cast<uint32>(command.blend_mode) << " transform=";
+		for (uint32 j = 0; j < 6; j++)
+			_capture_file << command.transform[j] << (j < 5 ? " " : "");
+		_capture_file << " pixels=" << command.coverage << endl;
+	}
+	_commands.clear();
+
+	_capture_frame_number++;
+	_capture_frames_remaining--;
+	if (_capture_frames_remaining == 0) {
+		_capture_file.close();
+		IF_PRINT_DEBUG(VIDEO_DEBUG) << "finished capturing " << _capture_frame_number << " frames of draw calls" << endl;
+	}
+}
+
+} // namespace private_video
+
+} // namespace hoa_video
@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    draw_recorder.h
+*** \author  agent, agent@local
+*** \brief   Header file for the DrawRecorder class
+***
+*** The draw recorder keeps count of the work that each frame submits to OpenGL,
+*** so that the effect of rendering optimizations can be measured. It can also
+*** write every draw call of a number of frames to a file, for comparison
+*** between two builds of the game.
+*** ***************************************************************************/
+
+#ifndef __DRAW_RECORDER_HEADER__
+#define __DRAW_RECORDER_HEADER__
+
+#ifdef __APPLE__
+	#include <OpenGL/gl.h>
+#else
+	#include <GL/gl.h>
+#endif
+
+#include "defs.h"
+#include "utils.h"
+
+namespace hoa_video {
+
+//! \brief The number of frames that are captured when a draw call capture is requested from the keyboard
+const uint32 VIDEO_DRAW_CAPTURE_FRAMES = 60;
+
+namespace private_video {
+
+/** ****************************************************************************
+*** \brief A single draw call as it was submitted to OpenGL
+*** ***************************************************************************/
+class DrawCommand {
+public:
+	//! \brief The primitive type that was drawn, such as GL_QUADS or GL_LINES
+	GLenum primitive;
+
+	//! \brief The OpenGL id of the texture sheet that was bound, or 0 if the draw was untextured
+	GLuint texture;
+
+	//! \brief The number of vertices that were drawn
+	uint32 vertex_count;
+
+	//! \brief The blending mode that was active, as used by VideoEngine::_SetGLBlendMode()
+	uint8 blend_mode;
+
+	/** \brief The two dimensional part of the modelview matrix: the x axis, the y axis, and the translation
+	*** Quads drawn through the batch were transformed before they were submitted, so their transform is the identity.
+	**/
+	float transform[6];
+
+	//! \brief The number of pixels covered by the draw, or zero if coverage was not estimated
+	float coverage;
+}; // class DrawCommand
+
+
+/** ****************************************************************************
+*** \brief The totals of the work that was submitted to OpenGL during one frame
+*** ***************************************************************************/
+class FrameStatistics {
+public:
+	FrameStatistics()
+		{ Reset(); }
+
+	//! \brief Sets all totals back to zero
+	void Reset();
+
+	/** \brief Returns the average number of times that each pixel of the screen was drawn to
+	*** This is an estimate, since the area of quads that extend past the edges of the viewport is counted in full.
+	*** It is zero if coverage was not estimated during the frame.
+	**/
+	float GetOverdraw() const
+		{ return (screen_pixels > 0.0f) ? (covered_pixels / screen_pixels) : 0.0f; }
+
+	//! \brief The number of draw calls made
+	uint32 draw_calls;
+
+	//! \brief The number of times that a different texture was bound
+	uint32 texture_binds;
+
+	//! \brief The number of changes made to the blending, texturing, client array, and fragment program states
+	uint32 state_changes;
+
+	//! \brief The total number of vertices drawn
+	uint32 vertices;
+
+	//! \brief The sum of the pixels covered by every draw
+	float covered_pixels;
+
+	//! \brief The number of pixels on the screen
+	float screen_pixels;
+}; // class FrameStatistics
+
+
+/** ****************************************************************************
+*** \brief Counts draw calls and state changes, and logs them to a file on request
+***
+*** The video engine reports every draw call, texture bind, and state change that
+*** it makes between BeginFrame() and EndFrame(). Anything reported outside of a
+*** frame, such as the debugging overlays drawn over the finished frame, is not
+*** counted.
+***
+*** Counting is always done, since it only costs an increment. The number of
+*** pixels each draw covers requires the vertices to be transformed to screen
+*** coordinates, so it is only estimated while the statistics are being shown or
+*** frames are being captured to a file.
+*** ***************************************************************************/
+class DrawRecorder {
+public:
+	DrawRecorder();
+
+	~DrawRecorder();
+
+	/** \brief Resets the totals of the current frame and begins counting
+	*** \param screen_width The width of the screen in pixels
+	*** \param screen_height The height of the screen in pixels
+	*** \param estimate_coverage If true, the number of pixels covered by each draw call is estimated
+	**/
+	void BeginFrame(int32 screen_width, int32 screen_height, bool estimate_coverage);
+
+	/** \brief Ends counting for the frame and retains its totals
+	*** If frames are being captured, the draw calls of the frame are written to the capture file.
+	**/
+	void EndFrame();
+
+	/** \brief Reports a draw call that was just made
+	*** \param primitive The primitive type passed to glDrawArrays()
+	*** \param texture The OpenGL id of the texture that is bound, or 0 if texturing is disabled
+	*** \param blend_mode The blending mode that is active
+	*** \param vertices The vertex array that was drawn, holding two coordinates per vertex
+	*** \param vertex_type The type of the coordinates, either GL_FLOAT or GL_INT
+	*** \param vertex_count The number of vertices that were drawn
+	*** \note The matrices and viewport used for the draw must still be active when this is called.
+	**/
+	void RecordDraw(GLenum primitive, GLuint texture, uint8 blend_mode, const void* vertices, GLenum vertex_type, uint32 vertex_count);
+
+	//! \brief Reports that a different texture was bound
+	void RecordTextureBind()
+		{ if (_in_frame == true) _current_frame.texture_binds++; }
+
+	//! \brief Reports that an OpenGL state was changed
+	void RecordStateChange()
+		{ if (_in_frame == true) _current_frame.state_changes++; }
+
+	/** \brief Begins writing every draw call of the following frames to a file
+	*** \param filename The name of the file to write, which is replaced if it already exists
+	*** \param number_frames The number of frames to capture
+	*** \return False if the file could not be opened
+	***
+	*** Any capture that was in progress is ended first. Each frame is written as a line with its totals, followed by
+	*** one line per draw call, so that two captures can be compared with a text diff.
+	**/
+	bool StartCapture(const std::string& filename, uint32 number_frames);
+
+	//! \brief Returns true if frames are being written to a capture file
+	bool IsCapturing() const
+		{ return _capture_file.is_open(); }
+
+	//! \brief Returns the totals of the last frame that was completed
+	const FrameStatistics& GetLastFrame() const
+		{ return _last_frame; }
+
+private:
+	//! \brief True between calls to BeginFrame() and EndFrame()
+	bool _in_frame;
+
+	//! \brief True if the coverage of each draw call is estimated during the current frame
+	bool _estimate_coverage;
+
+	//! \brief The totals of the frame that is in progress
+	FrameStatistics _current_frame;
+
+	//! \brief The totals of the last frame that was completed
+	FrameStatistics _last_frame;
+
+	//! \brief The draw calls of the current frame, which are only retained while frames are being captured
+	std::vector<DrawCommand> _commands;
+
+	//! \brief The file that captured frames are written to
+	std::ofstream _capture_file;
+
+	//! \brief The number of frames that remain to be captured
+	uint32 _capture_frames_remaining;
+
+	//! \brief The number of frames that have been written to the current capture file
+	uint32 _capture_frame_number;
+
+	/** \brief Estimates the number of pixels covered by a set of quads
+	*** \param vertices The vertices of the quads, with four per quad
+	*** \param vertex_type The type of the coordinates, either GL_FLOAT or GL_INT
+	*** \param vertex_count The number of vertices
+	*** \param modelview The modelview matrix that the quads were drawn with
+	*** \return The sum of the areas of the quads in pixels
+	**/
+	float _EstimateQuadCoverage(const void* vertices, GLenum vertex_type, uint32 vertex_count, const GLfloat* modelview) const;
+
+	//! \brief Writes the current frame to the capture file, and closes the file once enough frames were captured
+	void _WriteCapturedFrame();
+}; // class DrawRecorder
+
+} // namespace private_video
+
+} // namespace hoa_video
+
+#endif // __DRAW_RECORDER_HEADER__
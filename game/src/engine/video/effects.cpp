@@ -15,21 +15,7 @@ using namespace hoa_video::private_video;
 namespace hoa_video {
 
 ParticleEffectID VideoEngine::AddParticleEffect(const string &filename, float x, float y, bool reload) {
-	ParticleEffectDef *def = NULL;
-
-	bool effect_loaded = _particle_effect_defs.find(filename) != _particle_effect_defs.end();
-
-	if(effect_loaded && !reload)
-	{
-		def = _particle_effect_defs[filename];
-	}
-	else
-	{
-		def = _particle_manager.LoadEffect(filename);
-		if(effect_loaded)
-			delete _particle_effect_defs[filename];
-		_particle_effect_defs[filename] = def;
-	}
+	const ParticleEffectDef *def = _particle_manager.LoadEffect(filename, reload);
 
 	if(!def)
 	{
@@ -50,6 +36,20 @@ ParticleEffectID VideoEngine::AddParticleEffect(const string &filename, float x,
 }
 
 
+//-----------------------------------------------------------------------------
+// PreloadParticleEffects: reads every particle effect definition file in a
+//                         directory, so that adding those effects later does
+//                         not need to read any files
+//-----------------------------------------------------------------------------
+
+uint32 VideoEngine::PreloadParticleEffects(const string &directory)
+{
+	uint32 num_loaded = _particle_manager.PreloadEffects(directory);
+	IF_PRINT_DEBUG(VIDEO_DEBUG) << "preloaded " << num_loaded << " particle effect definitions from " << directory << endl;
+	return num_loaded;
+}
+
+
 //-----------------------------------------------------------------------------
 // DrawParticleEffects: call this once per frame. You should call this after
 //                      rendering things like tiles, characters, and monsters,
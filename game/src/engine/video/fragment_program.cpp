@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    fragment_program.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the FragmentProgram class
+*** ***************************************************************************/
+
+#include <cstring>
+
+#include "fragment_program.h"
+#include "video.h"
+
+// The extension's tokens are not defined by the OpenGL 1.1 headers available on some platforms
+#ifndef GL_FRAGMENT_PROGRAM_ARB
+	#define GL_FRAGMENT_PROGRAM_ARB 0x8804
+#endif
+#ifndef GL_PROGRAM_FORMAT_ASCII_ARB
+	#define GL_PROGRAM_FORMAT_ASCII_ARB 0x8875
+#endif
+#ifndef GL_PROGRAM_ERROR_POSITION_ARB
+	#define GL_PROGRAM_ERROR_POSITION_ARB 0x864B
+#endif
+#ifndef GL_PROGRAM_ERROR_STRING_ARB
+	#define GL_PROGRAM_ERROR_STRING_ARB 0x8874
+#endif
+
+#ifndef APIENTRY
+	#define APIENTRY
+#endif
+
+using namespace std;
+
+using namespace hoa_utils;
+
+namespace hoa_video {
+
+namespace private_video {
+
+const char* GRAYSCALE_FRAGMENT_PROGRAM =
+	"!!ARBfp1.0\n"
+	"TEMP color;\n"
+	"TEX color, fragment.texcoord[0], texture[0], 2D;\n"
+	"DP3 color.rgb, color, {0.30, 0.59, 0.11, 0.0};\n"
+	"MUL result.color, color, fragment.color;\n"
+	"END\n";
+
+// Entry points of the GL_ARB_fragment_program extension. These are given their own names so that they do not
+// collide with the declarations made by glext.h or GLEW on platforms that provide them.
+typedef void (APIENTRY *GenProgramsFunction)(GLsizei n, GLuint* programs);
+typedef void (APIENTRY *DeleteProgramsFunction)(GLsizei n, const GLuint* programs);
+typedef void (APIENTRY *BindProgramFunction)(GLenum target, GLuint program);
+typedef void (APIENTRY *ProgramStringFunction)(GLenum target, GLenum format, GLsizei length, const GLvoid* string);
+
+static GenProgramsFunction gen_programs = NULL;
+static DeleteProgramsFunction delete_programs = NULL;
+static BindProgramFunction bind_program = NULL;
+static ProgramStringFunction program_string = NULL;
+
+bool FragmentProgram::_supported = false;
+
+FragmentProgram::FragmentProgram() :
+	_program_id(0)
+{}
+
+
+
+FragmentProgram::~FragmentProgram() {
+	// The OpenGL context is usually gone by the time the program is destroyed, so nothing is deleted here
+	if (_program_id != 0) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "fragment program was not destroyed before its destructor was invoked" << endl;
+	}
+}
+
+
+
+bool FragmentProgram::InitializeExtension() {
+	_supported = false;
+
+	const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+	if (extensions == NULL || strstr(extensions, "GL_ARB_fragment_program") == NULL)
+		return false;
+
+	gen_programs = reinterpret_cast<GenProgramsFunction>(GetGLProcAddress("glGenProgramsARB"));
+	delete_programs = reinterpret_cast<DeleteProgramsFunction>(GetGLProcAddress("glDeleteProgramsARB"));
+	bind_program = reinterpret_cast<BindProgramFunction>(GetGLProcAddress("glBindProgramARB"));
+	program_string = reinterpret_cast<ProgramStringFunction>(GetGLProcAddress("glProgramStringARB"));
+
+	if (gen_programs == NULL || delete_programs == NULL || bind_program == NULL || program_string == NULL) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "fragment program extension was reported but its functions could not be retrieved" << endl;
+		return false;
+	}
+
+	_supported = true;
+	return true;
+} // bool FragmentProgram::InitializeExtension()
+
+
+
+bool FragmentProgram::Create(const char* source) {
+	Destroy();
+
+	if (_supported == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "fragment programs are not supported by the current OpenGL context" << endl;
+		return false;
+	}
+
+	// Clear any earlier error so that a compilation error can be told apart from it
+	glGetError();
+
+	gen_programs(1, &_program_id);
+	bind_program(GL_FRAGMENT_PROGRAM_ARB, _program_id);
+	program_string(GL_FRAGMENT_PROGRAM_ARB, GL_PROGRAM_FORMAT_ASCII_ARB, static_cast<GLsizei>(strlen(source)), source);
+
+	if (glGetError() != GL_NO_ERROR) {
+		GLint error_position = -1;
+		glGetIntegerv(GL_PROGRAM_ERROR_POSITION_ARB, &error_position);
+		const char* error_string = reinterpret_cast<const char*>(glGetString(GL_PROGRAM_ERROR_STRING_ARB));
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to compile fragment program at position " << error_position << ": "
+			<< (error_string != NULL ? error_string : "") << endl;
+		Destroy();
+		return false;
+	}
+
+	return true;
+} // bool FragmentProgram::Create(const char* source)
+
+
+
+void FragmentProgram::Destroy() {
+	if (_program_id == 0)
+		return;
+
+	delete_programs(1, &_program_id);
+	_program_id = 0;
+}
+
+
+
+void FragmentProgram::Enable() const {
+	glEnable(GL_FRAGMENT_PROGRAM_ARB);
+	bind_program(GL_FRAGMENT_PROGRAM_ARB, _program_id);
+}
+
+
+
+void FragmentProgram::Disable() {
+	if (_supported == true)
+		glDisable(GL_FRAGMENT_PROGRAM_ARB);
+}
+
+} // namespace private_video
+
+} // namespace hoa_video
@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    fragment_program.h
+*** \author  agent, agent@local
+*** \brief   Header file for the FragmentProgram class
+***
+*** A fragment program replaces the fixed function texturing and coloring of
+*** OpenGL with a short program that computes the color of each pixel drawn.
+*** The video engine uses fragment programs for effects that would otherwise
+*** require a modified copy of an image's texture data, such as grayscale.
+*** ***************************************************************************/
+
+#ifndef __FRAGMENT_PROGRAM_HEADER__
+#define __FRAGMENT_PROGRAM_HEADER__
+
+#ifdef __APPLE__
+	#include <OpenGL/gl.h>
+#else
+	#include <GL/gl.h>
+#endif
+
+#include "defs.h"
+#include "utils.h"
+
+namespace hoa_video {
+
+namespace private_video {
+
+/** \brief Computes the grayscale value of the texture color, then modulates it by the vertex color
+*** The weights of the color components are the same as those used by ImageMemory::ConvertToGrayscale().
+**/
+extern const char* GRAYSCALE_FRAGMENT_PROGRAM;
+
+/** ****************************************************************************
+*** \brief An assembly fragment program loaded into the current OpenGL context
+***
+*** Programs are implemented with the GL_ARB_fragment_program extension. The
+*** entry points of the extension are retrieved at run-time, so the game still
+*** runs on drivers that do not support it. InitializeExtension() must be called
+*** every time a new OpenGL context is created, and no other method may be used
+*** if it returns false.
+*** ***************************************************************************/
+class FragmentProgram {
+public:
+	FragmentProgram();
+
+	~FragmentProgram();
+
+	/** \brief Retrieves the fragment program entry points from the current OpenGL context
+	*** \return True if fragment programs are supported by the context
+	**/
+	static bool InitializeExtension();
+
+	//! \brief Returns true if the last call to InitializeExtension() succeeded
+	static bool IsSupported()
+		{ return _supported; }
+
+	/** \brief Compiles a program from its source text
+	*** \param source The source of the program, written in the ARBfp1.0 assembly language
+	*** \return True if the program compiled successfully
+	***
+	*** Any previously created program is destroyed first. If the call fails, the program is left invalid.
+	**/
+	bool Create(const char* source);
+
+	/** \brief Deletes the program
+	*** This must be called while the OpenGL context that created the program is still active.
+	**/
+	void Destroy();
+
+	//! \brief Enables fragment programs and makes this program the active one
+	void Enable() const;
+
+	//! \brief Disables fragment programs, so that fixed function texturing and coloring are used again
+	static void Disable();
+
+	//! \brief Returns true if the program has been created and may be enabled
+	bool IsValid() const
+		{ return _program_id != 0; }
+
+private:
+	//! \brief True if the current OpenGL context supports fragment programs
+	static bool _supported;
+
+	//! \brief The OpenGL id of the program, or 0 if the program has not been created
+	GLuint _program_id;
+
+	FragmentProgram(const FragmentProgram& copy);
+	FragmentProgram& operator=(const FragmentProgram& copy);
+}; // class FragmentProgram
+
+} // namespace private_video
+
+} // namespace hoa_video
+
+#endif // __FRAGMENT_PROGRAM_HEADER__
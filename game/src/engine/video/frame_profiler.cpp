@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    frame_profiler.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the FrameProfiler class
+*** ***************************************************************************/
+
+#include <cstring>
+
+#include "frame_profiler.h"
+#include "video.h"
+
+// The extension's tokens are not defined by the OpenGL 1.1 headers available on some platforms
+#ifndef GL_TIME_ELAPSED
+	#define GL_TIME_ELAPSED 0x88BF
+#endif
+#ifndef GL_QUERY_RESULT
+	#define GL_QUERY_RESULT 0x8866
+#endif
+
+#ifndef APIENTRY
+	#define APIENTRY
+#endif
+
+using namespace std;
+
+using namespace hoa_utils;
+
+namespace hoa_video {
+
+namespace private_video {
+
+// Entry points of the timer query extensions. These are given their own names so that they do not collide with the
+// declarations made by glext.h or GLEW on platforms that provide them.
+typedef void (APIENTRY *GenQueriesFunction)(GLsizei n, GLuint* ids);
+typedef void (APIENTRY *DeleteQueriesFunction)(GLsizei n, const GLuint* ids);
+typedef void (APIENTRY *BeginQueryFunction)(GLenum target, GLuint id);
+typedef void (APIENTRY *EndQueryFunction)(GLenum target);
+typedef void (APIENTRY *GetQueryObjectui64vFunction)(GLuint id, GLenum pname, uint64_t* params);
+
+static GenQueriesFunction gen_queries = NULL;
+static DeleteQueriesFunction delete_queries = NULL;
+static BeginQueryFunction begin_query = NULL;
+static EndQueryFunction end_query = NULL;
+static GetQueryObjectui64vFunction get_query_object_ui64v = NULL;
+
+static const char* RENDER_PASS_NAMES[VIDEO_RENDER_PASS_TOTAL] = {
+	"Other", "Tiles", "Objects", "Particles", "Overlays", "GUI", "Text"
+};
+
+bool FrameProfiler::_supported = false;
+
+FrameProfiler::FrameProfiler() :
+	_in_frame(false),
+	_frame_number(0),
+	_current_slot(NULL),
+	_history_index(0)
+{
+	for (uint32 i = 0; i < PROFILER_FRAME_LATENCY; i++) {
+		_slots[i].frame_number = 0;
+		_slots[i].pending = false;
+	}
+
+	for (uint32 pass = 0; pass < VIDEO_RENDER_PASS_TOTAL; pass++) {
+		for (uint32 i = 0; i < PROFILER_HISTORY_SIZE; i++) {
+			_cpu_history[pass][i] = 0.0f;
+			_gpu_history[pass][i] = 0.0f;
+		}
+		_cpu_history_sum[pass] = 0.0f;
+		_gpu_history_sum[pass] = 0.0f;
+	}
+}
+
+
+
+FrameProfiler::~FrameProfiler() {
+	StopLog();
+
+	// The OpenGL context is usually gone by the time the profiler is destroyed, so no queries are deleted here
+	for (uint32 i = 0; i < PROFILER_FRAME_LATENCY; i++) {
+		if (_slots[i].queries.empty() == false) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "timer queries were not destroyed before the profiler's destructor was invoked" << endl;
+			break;
+		}
+	}
+}
+
+
+
+bool FrameProfiler::InitializeExtension() {
+	_supported = false;
+
+	const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+	if (extensions == NULL)
+		return false;
+
+	// The ARB extension uses the core names of OpenGL 3.3, while the older EXT extension builds on the query objects of
+	// OpenGL 1.5 and adds its own function to read 64-bit results
+	if (strstr(extensions, "GL_ARB_timer_query") != NULL) {
+		get_query_object_ui64v = reinterpret_cast<GetQueryObjectui64vFunction>(GetGLProcAddress("glGetQueryObjectui64v"));
+	}
+	else if (strstr(extensions, "GL_EXT_timer_query") != NULL) {
+		get_query_object_ui64v = reinterpret_cast<GetQueryObjectui64vFunction>(GetGLProcAddress("glGetQueryObjectui64vEXT"));
+	}
+	else {
+		return false;
+	}
+
+	gen_queries = reinterpret_cast<GenQueriesFunction>(GetGLProcAddress("glGenQueries"));
+	delete_queries = reinterpret_cast<DeleteQueriesFunction>(GetGLProcAddress("glDeleteQueries"));
+	begin_query = reinterpret_cast<BeginQueryFunction>(GetGLProcAddress("glBeginQuery"));
+	end_query = reinterpret_cast<EndQueryFunction>(GetGLProcAddress("glEndQuery"));
+
+	if (gen_queries == NULL || delete_queries == NULL || begin_query == NULL || end_query == NULL) {
+		gen_queries = reinterpret_cast<GenQueriesFunction>(GetGLProcAddress("glGenQueriesARB"));
+		delete_queries = reinterpret_cast<DeleteQueriesFunction>(GetGLProcAddress("glDeleteQueriesARB"));
+		begin_query = reinterpret_cast<BeginQueryFunction>(GetGLProcAddress("glBeginQueryARB"));
+		end_query = reinterpret_cast<EndQueryFunction>(GetGLProcAddress("glEndQueryARB"));
+	}
+
+	if (gen_queries == NULL || delete_queries == NULL || begin_query == NULL || end_query == NULL || get_query_object_ui64v == NULL) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "timer query extension was reported but its functions could not be retrieved" << endl;
+		return false;
+	}
+
+	_supported = true;
+	return true;
+} // bool FrameProfiler::InitializeExtension()
+
+
+
+void FrameProfiler::BeginFrame(bool profile) {
+	_in_frame = false;
+	if (profile == false && IsLogging() == false)
+		return;
+
+	// The slot is reused from PROFILER_FRAME_LATENCY frames ago, by which time the GPU has almost always finished with
+	// it. Should it not have, reading the results waits for it.
+	_current_slot = &_slots[_frame_number % PROFILER_FRAME_LATENCY];
+	if (_current_slot->pending == true)
+		_ResolveSlot(*_current_slot);
+
+	_current_slot->frame_number = _frame_number;
+	_current_slot->segment_passes.clear();
+	for (uint32 pass = 0; pass < VIDEO_RENDER_PASS_TOTAL; pass++)
+		_current_slot->cpu_times[pass] = 0.0f;
+
+	_pass_stack.clear();
+	_pass_stack.push_back(VIDEO_RENDER_PASS_OTHER);
+	_in_frame = true;
+	_StartSegment();
+}
+
+
+
+void FrameProfiler::EndFrame() {
+	if (_in_frame == false)
+		return;
+
+	_EndSegment();
+	_in_frame = false;
+	_current_slot->pending = true;
+	_frame_number++;
+
+	// Without timer queries there is nothing to wait for
+	if (_supported == false)
+		_ResolveSlot(*_current_slot);
+}
+
+
+
+void FrameProfiler::BeginPass(VIDEO_RENDER_PASS pass) {
+	if (_in_frame == false)
+		return;
+
+	if (pass <= VIDEO_RENDER_PASS_INVALID || pass >= VIDEO_RENDER_PASS_TOTAL) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid render pass argument: " << pass << endl;
+		return;
+	}
+
+	_EndSegment();
+	_pass_stack.push_back(pass);
+	_StartSegment();
+}
+
+
+
+void FrameProfiler::EndPass() {
+	if (_in_frame == false)
+		return;
+
+	if (_pass_stack.size() <= 1) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "a render pass was ended without having begun" << endl;
+		return;
+	}
+
+	_EndSegment();
+	_pass_stack.pop_back();
+	_StartSegment();
+}
+
+
+
+const char* FrameProfiler::GetPassName(VIDEO_RENDER_PASS pass) {
+	if (pass <= VIDEO_RENDER_PASS_INVALID || pass >= VIDEO_RENDER_PASS_TOTAL)
+		return "";
+
+	return RENDER_PASS_NAMES[pass];
+}
+
+
+
+bool FrameProfiler::StartLog(const string& filename) {
+	StopLog();
+
+	_log_file.open(filename.c_str(), ios::out | ios::trunc);
+	if (_log_file.is_open() == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to open the frame profile log: " << filename << endl;
+		return false;
+	}
+
+	_log_file << "frame";
+	for (uint32 pass = 0; pass < VIDEO_RENDER_PASS_TOTAL; pass++)
+		_log_file << "," << RENDER_PASS_NAMES[pass] << " CPU ms," << RENDER_PASS_NAMES[pass] << " GPU ms";
+	_log_file << endl;
+
+	return true;
+}
+
+
+
+void FrameProfiler::StopLog() {
+	if (_log_file.is_open() == true)
+		_log_file.close();
+}
+
+
+
+void FrameProfiler::DestroyQueries() {
+	for (uint32 i = 0; i < PROFILER_FRAME_LATENCY; i++) {
+		if (_slots[i].queries.empty() == false && delete_queries != NULL)
+			delete_queries(static_cast<GLsizei>(_slots[i].queries.size()), &_slots[i].queries[0]);
+		_slots[i].queries.clear();
+		_slots[i].segment_passes.clear();
+		_slots[i].pending = false;
+	}
+
+	_in_frame = false;
+}
+
+
+
+void FrameProfiler::_StartSegment() {
+	VIDEO_RENDER_PASS pass = _pass_stack.back();
+
+	if (_supported == true) {
+		// Only one timer query may be active at a time, which is why nested passes are timed as separate segments
+		uint32 index = _current_slot->segment_passes.size();
+		if (index >= _current_slot->queries.size()) {
+			GLuint query = 0;
+			gen_queries(1, &query);
+			_current_slot->queries.push_back(query);
+		}
+		begin_query(GL_TIME_ELAPSED, _current_slot->queries[index]);
+	}
+
+	_current_slot->segment_passes.push_back(pass);
+	_segment_start = chrono::steady_clock::now();
+}
+
+
+
+void FrameProfiler::_EndSegment() {
+	chrono::duration<float, milli> elapsed = chrono::steady_clock::now() - _segment_start;
+	_current_slot->cpu_times[_current_slot->segment_passes.back()] += elapsed.count();
+
+	if (_supported == true)
+		end_query(GL_TIME_ELAPSED);
+}
+
+
+
+void FrameProfiler::_ResolveSlot(FrameSlot& slot) {
+	slot.pending = false;
+
+	float gpu_times[VIDEO_RENDER_PASS_TOTAL];
+	for (uint32 pass = 0; pass < VIDEO_RENDER_PASS_TOTAL; pass++)
+		gpu_times[pass] = 0.0f;
+
+	if (_supported == true) {
+		for (uint32 i = 0; i < slot.segment_passes.size(); i++) {
+			uint64_t nanoseconds = 0;
+			get_query_object_ui64v(slot.queries[i], GL_QUERY_RESULT, &nanoseconds);
+			gpu_times[slot.segment_passes[i]] += static_cast<float>(nanoseconds) / 1000000.0f;
+		}
+	}
+
+	for (uint32 pass = 0; pass < VIDEO_RENDER_PASS_TOTAL; pass++) {
+		_cpu_history_sum[pass] += slot.cpu_times[pass] - _cpu_history[pass][_history_index];
+		_gpu_history_sum[pass] += gpu_times[pass] - _gpu_history[pass][_history_index];
+		_cpu_history[pass][_history_index] = slot.cpu_times[pass];
+		_gpu_history[pass][_history_index] = gpu_times[pass];
+	}
+	_history_index = (_history_index + 1) % PROFILER_HISTORY_SIZE;
+
+	if (IsLogging() == true) {
+		_log_file << slot.frame_number;
+		for (uint32 pass = 0; pass < VIDEO_RENDER_PASS_TOTAL; pass++) {
+			_log_file << "," << slot.cpu_times[pass] << ",";
+			if (_supported == true)
+				_log_file << gpu_times[pass];
+		}
+		_log_file << endl;
+	}
+} // void FrameProfiler::_ResolveSlot(FrameSlot& slot)
+
+} // namespace private_video
+
+} // namespace hoa_video
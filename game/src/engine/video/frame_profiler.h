@@ -0,0 +1,236 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    frame_profiler.h
+*** \author  agent, agent@local
+*** \brief   Header file for the FrameProfiler class
+***
+*** The frame profiler measures how much time the CPU and GPU spend on each
+*** render pass of a frame, such as the map tiles or the GUI. The results are
+*** shown in an overlay and may be logged to a CSV file.
+*** ***************************************************************************/
+
+#ifndef __FRAME_PROFILER_HEADER__
+#define __FRAME_PROFILER_HEADER__
+
+#include <chrono>
+
+#ifdef __APPLE__
+	#include <OpenGL/gl.h>
+#else
+	#include <GL/gl.h>
+#endif
+
+#include "defs.h"
+#include "utils.h"
+
+namespace hoa_video {
+
+//! \brief The parts of a frame that are timed separately by the frame profiler
+enum VIDEO_RENDER_PASS {
+	VIDEO_RENDER_PASS_INVALID = -1,
+
+	//! Everything drawn outside of the other passes
+	VIDEO_RENDER_PASS_OTHER = 0,
+
+	//! The tile layers of a map
+	VIDEO_RENDER_PASS_TILES = 1,
+
+	//! The object layers of a map, which hold sprites and other map objects
+	VIDEO_RENDER_PASS_OBJECTS = 2,
+
+	//! All particle effects
+	VIDEO_RENDER_PASS_PARTICLES = 3,
+
+	//! The ambient, lighting, lightning, and fade overlays that cover the screen
+	VIDEO_RENDER_PASS_OVERLAYS = 4,
+
+	//! Menu windows, option boxes, and text boxes, without the text they contain
+	VIDEO_RENDER_PASS_GUI = 5,
+
+	//! All rendered text
+	VIDEO_RENDER_PASS_TEXT = 6,
+
+	VIDEO_RENDER_PASS_TOTAL = 7
+};
+
+namespace private_video {
+
+//! \brief The number of frames that the GPU timings are read back after, so that reading them never stalls the CPU
+const uint32 PROFILER_FRAME_LATENCY = 4;
+
+//! \brief The number of frames that the displayed timings are averaged over
+const uint32 PROFILER_HISTORY_SIZE = 60;
+
+/** ****************************************************************************
+*** \brief Times the render passes of each frame on the CPU and, when supported, the GPU
+***
+*** The passes of a frame are bracketed by calls to BeginPass() and EndPass().
+*** Passes may be nested, in which case the time spent in the inner pass is not
+*** counted towards the outer one. Time spent outside of all passes is counted
+*** as VIDEO_RENDER_PASS_OTHER.
+***
+*** GPU time is measured with the timer queries of the GL_ARB_timer_query or
+*** GL_EXT_timer_query extensions. The results of a frame are read back several
+*** frames later, once the GPU has finished with it. If neither extension is
+*** supported, as is the case with many software renderers, only CPU time is
+*** measured. CPU time is the time taken to submit a pass, not to draw it.
+***
+*** \note The video engine must flush its quad batch before every call to
+*** BeginPass() and EndPass(), or batched quads would be timed in a later pass.
+*** Profiled frames therefore make more draw calls than frames that are not.
+*** ***************************************************************************/
+class FrameProfiler {
+public:
+	FrameProfiler();
+
+	~FrameProfiler();
+
+	/** \brief Retrieves the timer query entry points from the current OpenGL context
+	*** \return True if GPU timings are supported by the context
+	*** \note This must be called every time a new OpenGL context is created.
+	**/
+	static bool InitializeExtension();
+
+	//! \brief Returns true if the last call to InitializeExtension() succeeded
+	static bool IsGPUTimingSupported()
+		{ return _supported; }
+
+	/** \brief Begins timing a frame
+	*** \param profile If false, the frame is only timed if a log file is open
+	**/
+	void BeginFrame(bool profile);
+
+	//! \brief Ends timing of the current frame
+	void EndFrame();
+
+	//! \brief Returns true if the current frame is being timed
+	bool IsProfiling() const
+		{ return _in_frame; }
+
+	/** \brief Begins timing a pass, suspending the pass that is currently being timed
+	*** \param pass The pass to time
+	**/
+	void BeginPass(VIDEO_RENDER_PASS pass);
+
+	//! \brief Ends timing of the current pass and resumes the pass it suspended
+	void EndPass();
+
+	//! \brief Returns the CPU time of a pass in milliseconds, averaged over the last PROFILER_HISTORY_SIZE frames
+	float GetCPUTime(VIDEO_RENDER_PASS pass) const
+		{ return _cpu_history_sum[pass] / PROFILER_HISTORY_SIZE; }
+
+	//! \brief Returns the GPU time of a pass in milliseconds, averaged over the last PROFILER_HISTORY_SIZE frames
+	float GetGPUTime(VIDEO_RENDER_PASS pass) const
+		{ return _gpu_history_sum[pass] / PROFILER_HISTORY_SIZE; }
+
+	//! \brief Returns the display name of a pass
+	static const char* GetPassName(VIDEO_RENDER_PASS pass);
+
+	/** \brief Begins writing the timings of every frame to a CSV file
+	*** \param filename The name of the file to write, which is replaced if it already exists
+	*** \return False if the file could not be opened
+	***
+	*** Frames are timed for as long as the log is open, whether or not the overlay is shown. Each row holds the
+	*** frame number followed by the CPU and GPU time of each pass. The GPU columns are empty if GPU timings are
+	*** not supported.
+	**/
+	bool StartLog(const std::string& filename);
+
+	//! \brief Closes the log file
+	void StopLog();
+
+	//! \brief Returns true if timings are being written to a log file
+	bool IsLogging() const
+		{ return _log_file.is_open(); }
+
+	/** \brief Deletes all timer queries and discards the timings that have not been read back
+	*** This must be called while the OpenGL context that created the queries is still active.
+	**/
+	void DestroyQueries();
+
+private:
+	/** ***************************************************************************
+	*** \brief The timings of one frame, held until its timer queries can be read back
+	*** **************************************************************************/
+	class FrameSlot {
+	public:
+		//! \brief The number of the frame that the slot holds
+		uint32 frame_number;
+
+		//! \brief True if the frame has ended but its timings have not been read back
+		bool pending;
+
+		//! \brief The CPU time of each pass, in milliseconds
+		float cpu_times[VIDEO_RENDER_PASS_TOTAL];
+
+		//! \brief The pass that each timer query was issued for, in the order that they were issued
+		std::vector<VIDEO_RENDER_PASS> segment_passes;
+
+		//! \brief Timer queries that have been created for this slot, which are reused from frame to frame
+		std::vector<GLuint> queries;
+	};
+
+	//! \brief True if the current OpenGL context supports timer queries
+	static bool _supported;
+
+	//! \brief True between calls to BeginFrame() and EndFrame() when the frame is being timed
+	bool _in_frame;
+
+	//! \brief The number of frames that have been timed
+	uint32 _frame_number;
+
+	//! \brief The slots that hold the timings of the most recent frames
+	FrameSlot _slots[PROFILER_FRAME_LATENCY];
+
+	//! \brief The slot of the frame that is being timed
+	FrameSlot* _current_slot;
+
+	//! \brief The passes that have begun but not yet ended, with the pass being timed at the back
+	std::vector<VIDEO_RENDER_PASS> _pass_stack;
+
+	//! \brief The time at which the current segment of the current pass began
+	std::chrono::steady_clock::time_point _segment_start;
+
+	//! \brief The CPU and GPU times of the last PROFILER_HISTORY_SIZE frames for each pass
+	//@{
+	float _cpu_history[VIDEO_RENDER_PASS_TOTAL][PROFILER_HISTORY_SIZE];
+	float _gpu_history[VIDEO_RENDER_PASS_TOTAL][PROFILER_HISTORY_SIZE];
+	//@}
+
+	//! \brief The sums of the history arrays, kept so that the averages do not need to be summed every frame
+	//@{
+	float _cpu_history_sum[VIDEO_RENDER_PASS_TOTAL];
+	float _gpu_history_sum[VIDEO_RENDER_PASS_TOTAL];
+	//@}
+
+	//! \brief The index in the history arrays that the next frame's timings are written to
+	uint32 _history_index;
+
+	//! \brief The file that timings are logged to
+	std::ofstream _log_file;
+
+	//! \brief Begins timing a segment of the pass at the back of the pass stack
+	void _StartSegment();
+
+	//! \brief Ends timing of the current segment and adds its CPU time to its pass
+	void _EndSegment();
+
+	/** \brief Reads back the GPU timings of a slot, adds the timings to the history, and logs them
+	*** \param slot The slot to resolve, which must be pending
+	**/
+	void _ResolveSlot(FrameSlot& slot);
+}; // class FrameProfiler
+
+} // namespace private_video
+
+} // namespace hoa_video
+
+#endif // __FRAME_PROFILER_HEADER__
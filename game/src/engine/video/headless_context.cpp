@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    headless_context.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the HeadlessContext class
+*** ***************************************************************************/
+
+#include "headless_context.h"
+#include "video.h"
+
+#ifdef ENABLE_OSMESA
+	#include <GL/osmesa.h>
+#endif
+
+using namespace std;
+
+using namespace hoa_utils;
+
+namespace hoa_video {
+
+namespace private_video {
+
+void* GetGLProcAddress(const char* name) {
+#ifdef ENABLE_OSMESA
+	if (HeadlessContext::IsCurrent() == true)
+		return reinterpret_cast<void*>(OSMesaGetProcAddress(name));
+#endif
+
+	return SDL_GL_GetProcAddress(name);
+}
+
+HeadlessContext* HeadlessContext::_current = NULL;
+
+HeadlessContext::HeadlessContext() :
+	_context(NULL),
+	_width(0),
+	_height(0)
+{}
+
+
+
+HeadlessContext::~HeadlessContext() {
+	Destroy();
+}
+
+
+
+bool HeadlessContext::IsAvailable() {
+#ifdef ENABLE_OSMESA
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+
+bool HeadlessContext::Create(int32 width, int32 height) {
+	if (width <= 0 || height <= 0) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid dimensions for the headless context: " << width << "x" << height << endl;
+		return false;
+	}
+
+#ifdef ENABLE_OSMESA
+	OSMesaContext context = static_cast<OSMesaContext>(_context);
+	if (context == NULL) {
+		// The depth and stencil buffers match what is requested of SDL for a window
+		context = OSMesaCreateContextExt(OSMESA_RGBA, 16, 8, 0, NULL);
+		if (context == NULL) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "OSMesaCreateContextExt() failed to create a context" << endl;
+			return false;
+		}
+	}
+
+	vector<uint8> buffer(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+	if (OSMesaMakeCurrent(context, &buffer[0], GL_UNSIGNED_BYTE, width, height) == GL_FALSE) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "OSMesaMakeCurrent() failed for a " << width << "x" << height << " buffer" << endl;
+		if (_context == NULL) {
+			OSMesaDestroyContext(context);
+		}
+		else if (OSMesaMakeCurrent(context, &_buffer[0], GL_UNSIGNED_BYTE, _width, _height) == GL_FALSE) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to restore the previous buffer of the headless context" << endl;
+		}
+		return false;
+	}
+
+	// The context now draws into the new buffer, so the old one can be released
+	_buffer.swap(buffer);
+	_context = context;
+	_width = width;
+	_height = height;
+	_current = this;
+	return true;
+#else
+	IF_PRINT_WARNING(VIDEO_DEBUG) << "the game was built without OSMesa, so headless contexts are not available" << endl;
+	return false;
+#endif
+} // bool HeadlessContext::Create(int32 width, int32 height)
+
+
+
+void HeadlessContext::Destroy() {
+	if (_context == NULL)
+		return;
+
+#ifdef ENABLE_OSMESA
+	OSMesaDestroyContext(static_cast<OSMesaContext>(_context));
+#endif
+
+	if (_current == this)
+		_current = NULL;
+
+	_context = NULL;
+	_buffer.clear();
+	_width = 0;
+	_height = 0;
+}
+
+} // namespace private_video
+
+} // namespace hoa_video
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    headless_context.h
+*** \author  agent, agent@local
+*** \brief   Header file for the HeadlessContext class
+***
+*** A headless context lets the video engine draw without a display, such as
+*** on the servers that run automated playthroughs and benchmarks. Frames are
+*** rendered in software into a buffer in main memory instead of a window.
+*** ***************************************************************************/
+
+#ifndef __HEADLESS_CONTEXT_HEADER__
+#define __HEADLESS_CONTEXT_HEADER__
+
+#ifdef __APPLE__
+	#include <OpenGL/gl.h>
+#else
+	#include <GL/gl.h>
+#endif
+
+#include "defs.h"
+#include "utils.h"
+
+namespace hoa_video {
+
+namespace private_video {
+
+/** \brief Retrieves the address of an OpenGL function from the context that is currently active
+*** \param name The name of the function to retrieve
+*** \return A pointer to the function, or NULL if the context does not provide it
+***
+*** All OpenGL extensions must be loaded through this function rather than SDL_GL_GetProcAddress(), since SDL
+*** knows nothing about a headless context.
+**/
+void* GetGLProcAddress(const char* name);
+
+/** ****************************************************************************
+*** \brief An OpenGL context that renders into main memory instead of a window
+***
+*** The context is implemented with the OSMesa library, which is only linked when
+*** the game is configured with --enable-osmesa. When it is not, Create() always
+*** fails and the headless video target can not be used.
+***
+*** The context survives changes to the resolution, so the textures created in
+*** it remain valid. Only the buffer that frames are drawn into is replaced.
+*** ***************************************************************************/
+class HeadlessContext {
+public:
+	HeadlessContext();
+
+	~HeadlessContext();
+
+	//! \brief Returns true if the game was built with support for headless contexts
+	static bool IsAvailable();
+
+	/** \brief Creates the context, or resizes its buffer if it already exists, and makes it current
+	*** \param width The width of the buffer to draw frames into, in pixels
+	*** \param height The height of the buffer to draw frames into, in pixels
+	*** \return True if the context is current and has the requested size. If false, the previous state is kept.
+	**/
+	bool Create(int32 width, int32 height);
+
+	//! \brief Destroys the context and releases its buffer
+	void Destroy();
+
+	/** \brief Waits until all drawing commands issued for the frame have been executed
+	*** This takes the place of the buffer swap, so that the time taken to render each frame is measured.
+	**/
+	void Finish() const
+		{ glFinish(); }
+
+	//! \brief Returns true if the context has been created
+	bool IsValid() const
+		{ return _context != NULL; }
+
+	//! \brief Returns true if a headless context is the context that OpenGL calls are currently made to
+	static bool IsCurrent()
+		{ return _current != NULL; }
+
+private:
+	//! \brief The headless context that is currently active, or NULL if none is
+	static HeadlessContext* _current;
+
+	//! \brief The OSMesa context, stored without its type so that this header does not depend on OSMesa
+	void* _context;
+
+	//! \brief The buffer that frames are drawn into, holding four bytes per pixel
+	std::vector<uint8> _buffer;
+
+	//! \brief The dimensions of the buffer, in pixels
+	int32 _width, _height;
+
+	HeadlessContext(const HeadlessContext& copy);
+	HeadlessContext& operator=(const HeadlessContext& copy);
+}; // class HeadlessContext
+
+} // namespace private_video
+
+} // namespace hoa_video
+
+#endif // __HEADLESS_CONTEXT_HEADER__
@@ -45,13 +45,6 @@ ImageDescriptor::ImageDescriptor() :
 
 
 ImageDescriptor::~ImageDescriptor() {
-	// The destructor for the inherited class should have disabled grayscale mode
-	// If it didn't, the grayscale image might not have been properly dereferenced
-	// and/or removed from texture memory
-	if (_grayscale == true)
-		IF_PRINT_WARNING(VIDEO_DEBUG) << "grayscale mode was still enabled when destructor was invoked -- possible memory leak" << endl;
-
-	// Remove the reference to the original, colored texture
 	if (_texture != NULL)
 		_RemoveTextureReference();
 
@@ -122,11 +115,6 @@ ImageDescriptor& ImageDescriptor::operator=(const ImageDescriptor& copy) {
 
 
 void ImageDescriptor::Clear() {
-	// This will also remove a reference to the grayscale version of the image
-	// TODO
-// 	if (_grayscale)
-// 		DisableGrayScale();
-
 	if (_texture != NULL)
 		_RemoveTextureReference();
 
@@ -182,7 +170,19 @@ void ImageDescriptor::SetVertexColors(const Color &tl, const Color &tr, const Co
 
 
 
+bool ImageDescriptor::IsLoadPending() const {
+	return (_texture != NULL && _texture->texture_sheet == NULL);
+}
+
+
+
 void ImageDescriptor::GetImageInfo(const std::string& filename, uint32 &rows, uint32& cols, uint32& bpp) throw(Exception) {
+	// The dimensions of images packed into a texture atlas are recorded in the atlas manifest, so the file need not be read
+	if (TextureManager->_GetAtlasImageInfo(filename, rows, cols) == true) {
+		bpp = 32;
+		return;
+	}
+
 	// Isolate the file extension
 	size_t ext_position = filename.rfind('.');
 
@@ -204,7 +204,7 @@ void ImageDescriptor::GetImageInfo(const std::string& filename, uint32 &rows, ui
 
 
 bool ImageDescriptor::LoadMultiImageFromElementSize(vector<StillImage>& images, const string& filename,
-	const uint32 elem_width, const uint32 elem_height)
+	const uint32 elem_width, const uint32 elem_height, const bool async)
 {
 	// First retrieve the dimensions of the multi image (in pixels)
 	uint32 img_height, img_width, bpp;
@@ -242,13 +242,13 @@ bool ImageDescriptor::LoadMultiImageFromElementSize(vector<StillImage>& images,
 			i->_width = static_cast<float>(elem_width);
 	}
 
-	return _LoadMultiImage(images, filename, grid_rows, grid_cols);
+	return _LoadMultiImage(images, filename, grid_rows, grid_cols, async);
 } // bool ImageDescriptor::LoadMultiImageFromElementSize(...)
 
 
 
 bool ImageDescriptor::LoadMultiImageFromElementGrid(vector<StillImage>& images, const string& filename,
-		const uint32 grid_rows, const uint32 grid_cols)
+		const uint32 grid_rows, const uint32 grid_cols, const bool async)
 {
 	if (DoesFileExist(filename) == false) {
 		IF_PRINT_WARNING(VIDEO_DEBUG) << "function call failed because the file requested did not exist: " << filename << endl;
@@ -289,7 +289,7 @@ bool ImageDescriptor::LoadMultiImageFromElementGrid(vector<StillImage>& images,
 			i->_width = static_cast<float>(elem_width);
 	}
 
-	return _LoadMultiImage(images, filename, grid_rows, grid_cols);
+	return _LoadMultiImage(images, filename, grid_rows, grid_cols, async);
 } // bool ImageDescriptor::LoadMultiImageFromElementGrid(...)
 
 
@@ -358,11 +358,11 @@ bool ImageDescriptor::SaveMultiImage(const vector<StillImage*>& images, const st
 		return false;
 	}
 
-	// Initially, we need to grab the Image pointer of the first StillImage, the texture ID of its TextureSheet owner,
-	// and malloc enough memory for the entire sheet so that we can copy over the texture sheet from video memory to
-	// system memory.
+	// Initially, we need to grab the Image pointer of the first StillImage, its TextureSheet owner, and malloc enough
+	// memory for the entire sheet so that we can copy over the texture sheet from video memory to system memory.
+	// Sheets are compared rather than texture IDs, since sheets that were evicted from texture memory have no ID.
 	ImageTexture* img = images[0]->_image_texture;
-	GLuint tex_id = img->texture_sheet->tex_id;
+	TexSheet* sheet = img->texture_sheet;
 
 	ImageMemory texture;
 	texture.width = img->texture_sheet->width;
@@ -375,7 +375,8 @@ bool ImageDescriptor::SaveMultiImage(const vector<StillImage*>& images, const st
 		return false;
 	}
 
-	TextureManager->_BindTexture(tex_id);
+	TextureManager->_UseTexSheet(sheet);
+	TextureManager->_BindTexture(sheet->tex_id);
 	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, texture.pixels);
 
 	uint32 i = 0; // i is used to count through the images vector to get the image to save
@@ -383,13 +384,14 @@ bool ImageDescriptor::SaveMultiImage(const vector<StillImage*>& images, const st
 		for (uint32 y = 0; y < grid_columns; y++) {
 			img = images[i]->_image_texture;
 
-			// Check if this image has a different texture ID than the last. If it does, we need to re-grab the texture
+			// Check if this image has a different texture sheet than the last. If it does, we need to re-grab the texture
 			// memory for the texture sheet that the new image is contained within and store it in the texture.pixels
 			// buffer, which is CPU system memory.
-			if (tex_id != img->texture_sheet->tex_id) {
-				// Get new texture ID
-				TextureManager->_BindTexture(img->texture_sheet->tex_id);
-				tex_id = img->texture_sheet->tex_id;
+			if (sheet != img->texture_sheet) {
+				// Get new texture sheet
+				sheet = img->texture_sheet;
+				TextureManager->_UseTexSheet(sheet);
+				TextureManager->_BindTexture(sheet->tex_id);
 
 				// If the new texture is bigger, reallocate memory
 				if (texture.height * texture.width < img->texture_sheet->height * img->texture_sheet->width) {
@@ -457,12 +459,32 @@ void ImageDescriptor::_RemoveTextureReference() {
 	}
 
 	if (_texture->RemoveReference() == true) {
-		_texture->texture_sheet->RemoveTexture(_texture);
+		// A texture sharing the space of an identical image is not held by any texture sheet. Instead, the reference
+		// that it holds to that image is removed in the same manner.
+		ImageTexture* image_texture = dynamic_cast<ImageTexture*>(_texture);
+		if (image_texture != NULL && image_texture->shared_texture != NULL) {
+			_texture = image_texture->shared_texture;
+			delete image_texture;
+			_RemoveTextureReference();
+			return;
+		}
 
-		// If the image exceeds 512 in either width or height, it has an un-shared texture sheet, which we
-		// should now delete that the image is being removed
-		if (_texture->width > 512 || _texture->height > 512) {
-			TextureManager->_RemoveSheet(_texture->texture_sheet);
+		// A texture that is still being loaded asynchronously is not held by any texture sheet yet
+		if (_texture->texture_sheet == NULL) {
+			TextureManager->_image_loader.CancelTexture(_texture);
+		}
+		else {
+			_texture->texture_sheet->RemoveTexture(_texture);
+
+			// If the image exceeds 512 in either width or height, it has an un-shared texture sheet, which we
+			// should now delete that the image is being removed
+			if (_texture->width > 512 || _texture->height > 512) {
+				TextureManager->_RemoveSheet(_texture->texture_sheet);
+			}
+			// Likewise, a texture atlas is deleted once none of the images that it holds are in use
+			else if (_texture->texture_sheet->type == VIDEO_TEXSHEET_ATLAS && _texture->texture_sheet->GetNumberTextures() == 0) {
+				TextureManager->_RemoveSheet(_texture->texture_sheet);
+			}
 		}
 // 		else {
 //
@@ -515,7 +537,7 @@ void ImageDescriptor::_DrawOrientation() const {
 		x_scale = -x_scale;
 	if (current_context.coordinate_system.GetVerticalDirection() < 0.0f)
 		y_scale = -y_scale;
-	glScalef(x_scale, y_scale, 1.0f);
+	VideoManager->Scale(x_scale, y_scale);
 }
 
 
@@ -535,108 +557,61 @@ void ImageDescriptor::_DrawTexture(const Color* draw_color) const {
 	if (draw_color == NULL)
 		draw_color = _color;
 
-	// Set blending parameters
+	// Determine the blending mode: 0 for no blending, 1 for normal blending, and 2 for additive blending
+	uint8 blend = 0;
 	if (VideoManager->_current_context.blend) {
-		glEnable(GL_BLEND);
 		if (VideoManager->_current_context.blend == 1)
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
+			blend = 1;
 		else
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending
+			blend = 2;
 	}
 	else if (_blend) {
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
+		blend = 1;
 	}
-	else {
-		glDisable(GL_BLEND);
-	}
-
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_FLOAT, 0, vert_coords);
-
-	// If we have a valid image texture poiner, setup texture coordinates and the texture coordinate array for glDrawArrays()
-	if (_texture != NULL) {
-		// Set the texture coordinates
-		float s0, s1, t0, t1;
-
-		s0 = _texture->u1 + (_u1 * (_texture->u2 - _texture->u1));
-		s1 = _texture->u1 + (_u2 * (_texture->u2 - _texture->u1));
-		t0 = _texture->v1 + (_v1 * (_texture->v2 - _texture->v1));
-		t1 = _texture->v1 + (_v2 * (_texture->v2 - _texture->v1));
 
-		// Swap x texture coordinates if x flipping is enabled
-		if (VideoManager->_current_context.x_flip) {
-			float temp = s0;
-			s0 = s1;
-			s1 = temp;
-		}
+	// Without an image texture we're drawing pure color on the vertices
+	if (_texture == NULL) {
+		VideoManager->_BatchQuad(NULL, false, blend, false, vert_coords, NULL, draw_color, _unichrome_vertices);
+		return;
+	}
 
-		// Swap y texture coordinates if y flipping is enabled
-		if (VideoManager->_current_context.y_flip) {
-			float temp = t0;
-			t0 = t1;
-			t1 = temp;
-		}
+	// Nothing is drawn for an image whose image data is still being loaded asynchronously
+	if (_texture->texture_sheet == NULL)
+		return;
 
-		// Place the texture coordinates in a 4x2 array mirroring the structure of the vertex array for use in glDrawArrays().
-		float tex_coords[] = {
-			s0, t1,
-			s1, t1,
-			s1, t0,
-			s0, t0,
-		};
-
-		// Enable texturing and bind texture
-		glEnable(GL_TEXTURE_2D);
-		TextureManager->_BindTexture(_texture->texture_sheet->tex_id);
-		_texture->texture_sheet->Smooth(_texture->smooth);
-
-		// Enable and setup the texture coordinate array
-		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-		glTexCoordPointer(2, GL_FLOAT, 0, tex_coords);
-
-		if (_unichrome_vertices == true) {
-			glColor4fv((GLfloat*)draw_color[0].GetColors());
-			glDisableClientState(GL_COLOR_ARRAY);
-		}
-		else {
-			glEnableClientState(GL_COLOR_ARRAY);
-			glColorPointer(4, GL_FLOAT, 0, (GLfloat*)draw_color);
-		}
-	} // if (_texture != NULL)
+	// Set the texture coordinates
+	float s0, s1, t0, t1;
 
-	// Otherwise there is no image texture, so we're drawing pure color on the vertices
-	else {
-		// Use a single call to glColor for unichrome images, or a setup a gl color array for multiple colors
-		if (_unichrome_vertices == true) {
-			glColor4fv((GLfloat*)draw_color[0].GetColors());
-			glDisableClientState(GL_COLOR_ARRAY);
-		}
-		else {
-			glEnableClientState(GL_COLOR_ARRAY);
-			glColorPointer(4, GL_FLOAT, 0, (GLfloat*)draw_color);
-		}
+	s0 = _texture->u1 + (_u1 * (_texture->u2 - _texture->u1));
+	s1 = _texture->u1 + (_u2 * (_texture->u2 - _texture->u1));
+	t0 = _texture->v1 + (_v1 * (_texture->v2 - _texture->v1));
+	t1 = _texture->v1 + (_v2 * (_texture->v2 - _texture->v1));
 
-		// Disable texturing as we're using pure colour
-		glDisable(GL_TEXTURE_2D);
+	// Swap x texture coordinates if x flipping is enabled
+	if (VideoManager->_current_context.x_flip) {
+		float temp = s0;
+		s0 = s1;
+		s1 = temp;
 	}
 
-	// Use a vertex array to draw all of the vertices
-	glDrawArrays(GL_QUADS, 0, 4);
-	glDisableClientState(GL_VERTEX_ARRAY);
-
-	if (_texture != NULL)
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	if (glIsEnabled(GL_COLOR_ARRAY))
-		glDisableClientState(GL_COLOR_ARRAY);
+	// Swap y texture coordinates if y flipping is enabled
+	if (VideoManager->_current_context.y_flip) {
+		float temp = t0;
+		t0 = t1;
+		t1 = temp;
+	}
 
-	if (VideoManager->_current_context.blend || _blend == true)
-		glDisable(GL_BLEND);
+	// Place the texture coordinates in a 4x2 array mirroring the structure of the vertex array
+	float tex_coords[] = {
+		s0, t1,
+		s1, t1,
+		s1, t0,
+		s0, t0,
+	};
 
-	if (VideoManager->CheckGLError() == true) {
-		IF_PRINT_WARNING(VIDEO_DEBUG) << "an OpenGL error occurred: " << VideoManager->CreateGLErrorString() << endl;
-	}
+	// The quad is not drawn immediately, but is added to the video engine's batch of quads that share the same texture
+	// sheet, blending, and grayscale mode. The batch is drawn with a single call when any of that state changes.
+	VideoManager->_BatchQuad(_texture->texture_sheet, _texture->smooth, blend, _grayscale, vert_coords, tex_coords, draw_color, _unichrome_vertices);
 } // void ImageDescriptor::_DrawTexture(const Color* color_array) const
 
 
@@ -743,7 +718,7 @@ void ImageDescriptor::_GetJpgImageInfo(const std::string& filename, uint32& rows
 
 
 bool ImageDescriptor::_LoadMultiImage(vector<StillImage>& images, const string &filename,
-	const uint32 grid_rows, const uint32 grid_cols)
+	const uint32 grid_rows, const uint32 grid_cols, const bool async)
 {
 	uint32 current_image;
 	uint32 x, y;
@@ -772,10 +747,30 @@ bool ImageDescriptor::_LoadMultiImage(vector<StillImage>& images, const string &
 	}
 
 	// If the image elements are not all loaded, then load the multi image file
-	// from disk and create enough memory to copy over individual sub-image elements from it
+	// from disk and create enough memory to copy over individual sub-image elements from it.
+	// This is not necessary when the multi image was packed into a texture atlas.
+	bool in_atlas = TextureManager->_IsImageInAtlas(filename);
+
 	ImageMemory multi_image;
 	ImageMemory sub_image;
-	if (need_load) {
+	vector<ImageTexture*> async_textures;
+	if (need_load && in_atlas == false && async == true) {
+		// Only the dimensions of the multi image are needed for now. The file is decoded later by the image loader.
+		uint32 img_height, img_width, bpp;
+		try {
+			GetImageInfo(filename, img_height, img_width, bpp);
+		}
+		catch (Exception e) {
+			if (VIDEO_DEBUG)
+				cerr << e.ToString() << endl;
+			return false;
+		}
+
+		sub_image.width = img_width / grid_cols;
+		sub_image.height = img_height / grid_rows;
+		async_textures.resize(grid_rows * grid_cols, NULL);
+	}
+	else if (need_load && in_atlas == false) {
 		if (multi_image.LoadImage(filename) == false) {
 			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to load multi image file: " << filename << endl;
 			return false;
@@ -814,7 +809,37 @@ bool ImageDescriptor::_LoadMultiImage(vector<StillImage>& images, const string &
 					return false;
 				}
 
+				// An element that is still being loaded asynchronously must be completed if this load is not asynchronous
+				if (async == false && img->texture_sheet == NULL)
+					TextureManager->_image_loader.FinishTexture(img);
+
+				images.at(current_image)._filename = filename;
+				images.at(current_image)._texture = img;
+				images.at(current_image)._image_texture = img;
+			}
+
+			// The element image is located within the texture atlas that the multi image was packed into
+			else if (in_atlas == true) {
+				images.at(current_image)._filename = filename;
+
+				img = TextureManager->_CreateAtlasImageTexture(filename, tags[current_image], grid_rows, grid_cols, x, y);
+				if (img == NULL) {
+					IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextureController::_CreateAtlasImageTexture failed -- " <<
+						"aborting multi image load operation" << endl;
+					return false;
+				}
+
+				images.at(current_image)._texture = img;
+				images.at(current_image)._image_texture = img;
+			}
+
+			// The element image is created now, but it is only added to a texture sheet once the multi image file has been decoded
+			else if (async == true) {
 				images.at(current_image)._filename = filename;
+
+				img = new ImageTexture(filename, tags[current_image], sub_image.width, sub_image.height);
+				async_textures[current_image] = img;
+
 				images.at(current_image)._texture = img;
 				images.at(current_image)._image_texture = img;
 			}
@@ -832,10 +857,10 @@ bool ImageDescriptor::_LoadMultiImage(vector<StillImage>& images, const string &
 				img = new ImageTexture(filename, tags[current_image], sub_image.width, sub_image.height);
 
 				// Try to insert the image in a texture sheet
-				TexSheet* sheet = TextureManager->_InsertImageInTexSheet(img, sub_image, images.at(current_image)._is_static);
+				TexSheet* sheet = TextureManager->_InsertImageTexture(img, sub_image, images.at(current_image)._is_static);
 
 				if (sheet == NULL) {
-					IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextureController::_InsertImageInTexSheet failed -- " <<
+					IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextureController::_InsertImageTexture failed -- " <<
 						"aborting multi image load operation" << endl;
 
 					free(multi_image.pixels);
@@ -852,18 +877,13 @@ bool ImageDescriptor::_LoadMultiImage(vector<StillImage>& images, const string &
 
 			img->AddReference();
 
-			// Finally, do a grayscale conversion for the image if grayscale mode is enabled
-			if (images.at(current_image)._grayscale) {
-				// Set _grayscale to false so that the call doesn't think that the grayscale image is already loaded
-				// It will be set back to true by the EnableGrayScale call
-				images.at(current_image)._grayscale = false;
-				images.at(current_image).EnableGrayScale();
-			}
-
 			current_image++;
 		} // for (y = 0; y < grid_cols; y++)
 	} // for (x = 0; x < grid_rows; x++)
 
+	if (async_textures.empty() == false)
+		TextureManager->_image_loader.RequestLoad(filename, async_textures, grid_rows, grid_cols, images.front()._is_static);
+
 	// Make sure to free all dynamically allocated memory
 	if (multi_image.pixels) {
 		free(multi_image.pixels);
@@ -906,7 +926,7 @@ void StillImage::Clear() {
 
 
 
-bool StillImage::Load(const string& filename) {
+bool StillImage::_Load(const string& filename, bool async) {
 	// Delete everything previously stored in here
 	if (_image_texture != NULL) {
 		_RemoveTextureReference();
@@ -931,6 +951,10 @@ bool StillImage::Load(const string& filename) {
 			return false;
 		}
 
+		// The image may still be loading from an earlier asynchronous load call
+		if (async == false && _image_texture->texture_sheet == NULL)
+			TextureManager->_image_loader.FinishTexture(_image_texture);
+
 		// If the width or height of this object is 0.0, use the pixel width/height of the image texture
 		if (IsFloatEqual(_width, 0.0f))
 			_width = static_cast<float>(_image_texture->width);
@@ -941,21 +965,62 @@ bool StillImage::Load(const string& filename) {
 		return true;
 	}
 
-	// 2. The image file needs to be loaded from disk
+	// 2. If the image file was packed into a texture atlas, the image is located within the atlas and no file needs to be read
+	if (TextureManager->_IsImageInAtlas(_filename) == true) {
+		_image_texture = TextureManager->_CreateAtlasImageTexture(_filename, "", 1, 1, 0, 0);
+		_texture = _image_texture;
+
+		if (_image_texture == NULL) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextureController::_CreateAtlasImageTexture() failed for file: " << _filename << endl;
+			return false;
+		}
+
+		_image_texture->AddReference();
+
+		if (IsFloatEqual(_width, 0.0f) == true)
+			_width = static_cast<float>(_image_texture->width);
+		if (IsFloatEqual(_height, 0.0f) == true)
+			_height = static_cast<float>(_image_texture->height);
+		return true;
+	}
+
+	// 3. The image file needs to be decoded on a worker thread. Only the dimensions of the image are read from the file now.
+	if (async == true) {
+		uint32 rows, cols, bpp;
+		try {
+			GetImageInfo(_filename, rows, cols, bpp);
+		}
+		catch (Exception e) {
+			if (VIDEO_DEBUG)
+				cerr << e.ToString() << endl;
+			return false;
+		}
+
+		_image_texture = new ImageTexture(_filename, "", cols, rows);
+		_texture = _image_texture;
+		_image_texture->AddReference();
+		TextureManager->_image_loader.RequestLoad(_filename, vector<ImageTexture*>(1, _image_texture), 1, 1, _is_static);
+
+		if (IsFloatEqual(_width, 0.0f) == true)
+			_width = static_cast<float>(cols);
+		if (IsFloatEqual(_height, 0.0f) == true)
+			_height = static_cast<float>(rows);
+		return true;
+	}
+
+	// 4. The image file needs to be loaded from disk
 	ImageMemory img_data;
 	if (img_data.LoadImage(_filename) == false) {
 		IF_PRINT_WARNING(VIDEO_DEBUG) << "call to ImageMemory::LoadImage() failed for file: " << _filename << endl;
 		return false;
 	}
 
-	// Create a new texture image and store it in a texture sheet. If the _grayscale member of this class is true,
-	// we first load the color copy of the image to a texture sheet. Then we'll convert the image data to grayscale
-	// and save that image data to texture memory as well
+	// Create a new texture image and store it in a texture sheet
 	_image_texture = new ImageTexture(_filename, "", img_data.width, img_data.height);
 	_texture = _image_texture;
 
-	if (TextureManager->_InsertImageInTexSheet(_image_texture, img_data, _is_static) == NULL) {
-		IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextureController::_InsertImageInTexSheet() failed for file: " << _filename << endl;
+	if (TextureManager->_InsertImageTexture(_image_texture, img_data, _is_static) == NULL) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextureController::_InsertImageTexture() failed for file: " << _filename << endl;
 		delete _image_texture;
 		_image_texture = NULL;
 		_texture = NULL;
@@ -973,36 +1038,10 @@ bool StillImage::Load(const string& filename) {
 	if (IsFloatEqual(_height, 0.0f) == true)
 		_height = static_cast<float>(img_data.height);
 
-	// If we don't need to create a grayscale version, we finished successfully
-	if (_grayscale == false) {
-		free(img_data.pixels);
-		img_data.pixels = NULL;
-		return true;
-	}
-
-	// 3. If we reached this point, we must now create a grayscale version of this image
-	img_data.ConvertToGrayscale();
-	ImageTexture* gray_image = new ImageTexture(_filename, "<G>", img_data.width, img_data.height);
-	if (TextureManager->_InsertImageInTexSheet(gray_image, img_data, _is_static) == NULL) {
-		IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextureController::_InsertImageInTexSheet() failed for file: " << _filename << endl;
-
-		TextureManager->_UnregisterImageTexture(gray_image);
-		delete gray_image;
-		_RemoveTextureReference(); // sets _texture to NULL
-		_image_texture = NULL;
-		free(img_data.pixels);
-		img_data.pixels = NULL;
-		return false;
-	}
-
-	_image_texture = gray_image;
-	_texture = _image_texture;
-	_image_texture->AddReference();
-
 	free(img_data.pixels);
 	img_data.pixels = NULL;
 	return true;
-} // bool StillImage::Load(const string& filename)
+} // bool StillImage::_Load(const string& filename, bool async)
 
 
 
@@ -1019,7 +1058,7 @@ void StillImage::Draw(const Color& draw_color) const {
 		return;
 	}
 
-	glPushMatrix();
+	VideoManager->PushMatrix();
 	_DrawOrientation();
 
 	float modulation = VideoManager->_screen_fader.GetFadeModulation();
@@ -1040,7 +1079,7 @@ void StillImage::Draw(const Color& draw_color) const {
 		_DrawTexture(modulated_colors);
 	}
 
-	glPopMatrix();
+	VideoManager->PopMatrix();
 } // void StillImage::Draw(const Color& draw_color) const
 
 
@@ -1071,8 +1110,19 @@ bool StillImage::Save(const string& filename) const {
 		return false;
 	}
 
+	// The image data must be in texture memory before it can be copied
+	if (_image_texture->texture_sheet == NULL)
+		TextureManager->_image_loader.FinishTexture(_image_texture);
+	if (_image_texture->texture_sheet == NULL) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "attempted to save an image that failed to load: " << _filename << endl;
+		return false;
+	}
+
 	ImageMemory buffer;
 	buffer.CopyFromImage(_image_texture);
+	// Grayscale is only applied when the image is drawn, so the conversion must be made here to save the image as it appears
+	if (_grayscale == true)
+		buffer.ConvertToGrayscale();
 	return buffer.SaveImage(filename, is_png_image);
 } // bool StillImage::Save(const string& filename)
 
@@ -1085,51 +1135,6 @@ void StillImage::EnableGrayScale() {
 	}
 
 	_grayscale = true;
-
-	// 1. If no image texture is available we are done here (when Load() is next called, grayscale will automatically be enabled)
-	if (_image_texture == NULL) {
-		return;
-	}
-
-	// 2. Check if a grayscale version of this image already exists in texture memory and if so, update the ImageTexture pointer and reference
-	string search_key = _filename + _image_texture->tags + "<G>";
-	string tags = _image_texture->tags;
-	ImageTexture *temp_texture = _image_texture;
-	if ((_image_texture = TextureManager->_GetImageTexture(search_key)) != NULL) {
-		// NOTE: We do not decrement the reference to the colored image, because we want to guarantee that
-		// it remains referenced in texture memory while its grayscale counterpart is being used
-		_texture = _image_texture;
-		_image_texture->AddReference();
-		return;
-	}
-
-	// 3. If no grayscale version exists, create a copy of the image, convert it to grayscale, and add the gray copy to texture memory
-	ImageMemory gray_img;
-	gray_img.CopyFromImage(temp_texture);
-	gray_img.ConvertToGrayscale();
-
-	ImageTexture* new_img = new ImageTexture(_filename, tags + "<G>", gray_img.width, gray_img.height);
-
-	if (TextureManager->_InsertImageInTexSheet(new_img, gray_img, _is_static) == NULL) {
-		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to insert new grayscale image into texture sheet" << endl;
-		delete new_img;
-
-		if (gray_img.pixels) {
-			free(gray_img.pixels);
-			gray_img.pixels = NULL;
-		}
-
-		return;
-	}
-
-	_image_texture = new_img;
-	_texture = _image_texture;
-	_image_texture->AddReference();
-
-	if (gray_img.pixels) {
-		free(gray_img.pixels);
-		gray_img.pixels = NULL;
-	}
 } // void StillImage::EnableGrayScale()
 
 
@@ -1141,24 +1146,6 @@ void StillImage::DisableGrayScale() {
 	}
 
 	_grayscale = false;
-
-	// If no image data is loaded, we're finished
-	if (_image_texture == NULL) {
-		return;
-	}
-
-	string search_key = _image_texture->filename + _image_texture->tags.substr(0, _image_texture->tags.length() - 3);
-	if ((_image_texture = TextureManager->_GetImageTexture(search_key)) == NULL) {
-		PRINT_WARNING << "non-grayscale version of image was not found in texture memory" << endl;
-		return;
-	}
-
-	// Remove the reference to the grayscale version and grab the reference to the original color image
-	_RemoveTextureReference();
-
-	// No reference change is needed for the color image, since the color texture did not have a reference
-	// decrement when the grayscale version was enabled
-	_texture = _image_texture;
 } // void StillImage::DisableGrayScale()
 
 
@@ -1211,11 +1198,12 @@ void AnimatedImage::Clear() {
 
 
 
-bool AnimatedImage::LoadFromFrameSize(const string& filename, const vector<uint32>& timings, const uint32 frame_width, const uint32 frame_height, const uint32 trim) {
+bool AnimatedImage::LoadFromFrameSize(const string& filename, const vector<uint32>& timings, const uint32 frame_width, const uint32 frame_height,
+	const uint32 trim, const bool async)
+{
 	// Make the multi image call
-	// TODO: Handle the case where the _grayscale member is true so all frames are loaded in grayscale format
 	vector<StillImage> image_frames;
-	if (ImageDescriptor::LoadMultiImageFromElementSize(image_frames, filename, frame_width, frame_height) == false) {
+	if (ImageDescriptor::LoadMultiImageFromElementSize(image_frames, filename, frame_width, frame_height, async) == false) {
 		return false;
 	}
 
@@ -1237,6 +1225,7 @@ bool AnimatedImage::LoadFromFrameSize(const string& filename, const vector<uint3
 		_frames.push_back(AnimationFrame());
 		image_frames[i].SetDimensions(_width, _height);
 		_frames.back().image = image_frames[i];
+		_frames.back().image._grayscale = _grayscale;
 		_frames.back().frame_time = timings[i];
 		_animation_length += timings[i];
 		if (timings[i] == 0) {
@@ -1249,7 +1238,9 @@ bool AnimatedImage::LoadFromFrameSize(const string& filename, const vector<uint3
 
 
 
-bool AnimatedImage::LoadFromFrameGrid(const string& filename, const vector<uint32>& timings, const uint32 frame_rows, const uint32 frame_cols, const uint32 trim) {
+bool AnimatedImage::LoadFromFrameGrid(const string& filename, const vector<uint32>& timings, const uint32 frame_rows, const uint32 frame_cols,
+	const uint32 trim, const bool async)
+{
 	if (DoesFileExist(filename) == false) {
 		IF_PRINT_WARNING(VIDEO_DEBUG) << "file does not exist: " << filename << endl;
 		return false;
@@ -1269,9 +1260,8 @@ bool AnimatedImage::LoadFromFrameGrid(const string& filename, const vector<uint3
 	ResetAnimation();
 
 	// Make the multi image call
-	// TODO: Handle the case where the _grayscale member is true so all frames are loaded in grayscale format
 	vector<StillImage> image_frames;
-	if (ImageDescriptor::LoadMultiImageFromElementGrid(image_frames, filename, frame_rows, frame_cols) == false) {
+	if (ImageDescriptor::LoadMultiImageFromElementGrid(image_frames, filename, frame_rows, frame_cols, async) == false) {
 		return false;
 	}
 
@@ -1286,6 +1276,7 @@ bool AnimatedImage::LoadFromFrameGrid(const string& filename, const vector<uint3
 		_frames.push_back(AnimationFrame());
 		image_frames[i].SetDimensions(_width, _height);
 		_frames.back().image = image_frames[i];
+		_frames.back().image._grayscale = _grayscale;
 		_frames.back().frame_time = timings[i];
 		_animation_length += timings[i];
 		if (timings[i] == 0) {
@@ -1320,6 +1311,16 @@ void AnimatedImage::Draw(const Color& draw_color) const {
 
 
 
+bool AnimatedImage::IsLoadPending() const {
+	for (uint32 i = 0; i < _frames.size(); i++) {
+		if (_frames[i].image.IsLoadPending() == true)
+			return true;
+	}
+	return false;
+}
+
+
+
 bool AnimatedImage::Save(const std::string& filename, uint32 grid_rows, uint32 grid_cols) const {
 	vector<StillImage*> image_frames;
 	for (uint32 i = 0; i < _frames.size(); i++) {
@@ -1578,7 +1579,7 @@ void CompositeImage::Draw(const Color& draw_color) const {
 		coord_sys.GetVerticalDirection();
 
 	// Save the draw cursor position as we move to draw each element
-	glPushMatrix();
+	VideoManager->PushMatrix();
 
 	VideoManager->MoveRelative(x_align_offset, y_align_offset);
 
@@ -1608,7 +1609,7 @@ void CompositeImage::Draw(const Color& draw_color) const {
 		x_off += x_shake;
 		y_off += y_shake;
 
-		glPushMatrix();
+		VideoManager->PushMatrix();
 		VideoManager->MoveRelative(x_off * coord_sys.GetHorizontalDirection(),
 			y_off * coord_sys.GetVerticalDirection());
 
@@ -1620,7 +1621,7 @@ void CompositeImage::Draw(const Color& draw_color) const {
 		if (coord_sys.GetVerticalDirection() < 0.0f)
 			y_scale = -y_scale;
 
-		glScalef(x_scale, y_scale, 1.0f);
+		VideoManager->Scale(x_scale, y_scale);
 
 		if (skip_modulation)
 			_elements[i].image._DrawTexture(_color);
@@ -1632,13 +1633,23 @@ void CompositeImage::Draw(const Color& draw_color) const {
 			modulated_colors[3] = _color[3] * fade_color;
 			_elements[i].image._DrawTexture(modulated_colors);
 		}
-		glPopMatrix();
+		VideoManager->PopMatrix();
 	}
-	glPopMatrix();
+	VideoManager->PopMatrix();
 } // void CompositeImage::Draw(const Color& draw_color) const
 
 
 
+bool CompositeImage::IsLoadPending() const {
+	for (uint32 i = 0; i < _elements.size(); i++) {
+		if (_elements[i].image.IsLoadPending() == true)
+			return true;
+	}
+	return false;
+}
+
+
+
 void CompositeImage::SetWidth(float width) {
 	// Case 1: No image elements loaded, just change the internal width
 	if (_elements.empty() == true) {
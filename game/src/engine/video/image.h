@@ -85,6 +85,7 @@ namespace hoa_video {
 *** ***************************************************************************/
 class ImageDescriptor {
 	friend class VideoEngine;
+	friend class QuadBuffer;
 
 public:
 	ImageDescriptor();
@@ -123,6 +124,12 @@ public:
 	bool IsGrayScale() const
 		{ return _grayscale; }
 
+	/** \brief Returns true if the image was loaded asynchronously and its image data is not yet in texture memory
+	*** Images in this state are not drawn. They become drawable once the video engine uploads their image data,
+	*** which happens over the course of the frames following the load call.
+	**/
+	virtual bool IsLoadPending() const;
+
 	virtual void EnableGrayScale() = 0;
 
 	virtual void DisableGrayScale() = 0;
@@ -193,6 +200,7 @@ public:
 	*** \param filename The name of the multi image file to load the image data from
 	*** \param elem_width The width of each sub-image element, in pixels
 	*** \param elem_height The  height of each sub-image element, in pixels
+	*** \param async If true, the multi image file is decoded on a worker thread and the images are not drawn until it is ready
 	*** \return True upon successful loading, false if there was an error
 	***
 	*** This function determines the image elements to extract from the multi image by the width and height
@@ -202,13 +210,14 @@ public:
 	*** \note All image elements within the multi image should be of the same size
 	 */
 	static bool LoadMultiImageFromElementSize(std::vector<StillImage>& images, const std::string& filename,
-		const uint32 elem_width, const uint32 elem_height);
+		const uint32 elem_width, const uint32 elem_height, const bool async = false);
 
 	/** \brief Loads a multi image into a vector of StillImage objects
 	*** \param images Reference to the vector of StillImages to be loaded with elements from the multi image
 	*** \param filename The name of the multi image file to load the image data from
 	*** \param grid_rows The number of rows of image elements contained in the multi image
 	*** \param grid_cols The number of columns of image elements contained in the multi image
+	*** \param async If true, the multi image file is decoded on a worker thread and the images are not drawn until it is ready
 	*** \return True upon successful loading, false if there was an error
 	***
 	*** This function determines the image elements to extract from dividing the multi image into a number
@@ -217,7 +226,7 @@ public:
 	*** \note All image elements within the multi image should be of the same size
 	**/
 	static bool LoadMultiImageFromElementGrid(std::vector<StillImage>& images, const std::string& filename,
-		const uint32 grid_rows, const uint32 grid_cols);
+		const uint32 grid_rows, const uint32 grid_cols, const bool async = false);
 
 	/** \brief Saves a vector of images into a single image file (a multi image)
 	*** \param images A reference to the vector of StillImage pointers to save into a multi image
@@ -290,6 +299,9 @@ protected:
 	*** completed prior to the calling of this function. The draw_color argument is usually nothing
 	*** more than a pointer to the _color member of this very class, but in certain cases like during
 	*** a screen fade these colors may differ.
+	***
+	*** \note The texture is not drawn immediately. Its transformed quad is added to the video engine's
+	*** quad batch, which is drawn once the texture sheet, blending mode, or scissoring state changes.
 	**/
 	void _DrawTexture(const Color* draw_color) const;
 
@@ -317,10 +329,11 @@ private:
 	*** \param filename The name of the multi image file to read
 	*** \param grid_rows The number of rows of image elements in the multi image
 	*** \param grid_cols The number of columns of image elements in the multi image
+	*** \param async If true, the elements that are not yet in texture memory are loaded asynchronously
 	*** \return True if the image file was loaded and parsed successfully, false if there was an error.
 	**/
 	static bool _LoadMultiImage(std::vector<StillImage>& images, const std::string& filename,
-		const uint32 grid_rows, const uint32 grid_cols);
+		const uint32 grid_rows, const uint32 grid_cols, const bool async);
 }; // class ImageDescriptor
 
 
@@ -357,11 +370,26 @@ public:
 	*** a colored quad for the image procedurally. It is not an error to pass an empty string to
 	*** the function.
 	**/
-	bool Load(const std::string& filename);
+	bool Load(const std::string& filename)
+		{ return _Load(filename, false); }
 
 	bool Load(const std::string& filename, float width, float height)
 		{ SetDimensions(width, height); return Load(filename); }
 
+	/** \brief Loads a single image file without waiting for the file to be read and decoded
+	*** \param filename The filename of the image to load (should have a .png or .jpg extension)
+	*** \return True if the image file exists and will be loaded
+	***
+	*** The dimensions of the image are available immediately, but the image is not drawn until a worker
+	*** thread has decoded the file and the video engine has copied the image data into texture memory.
+	*** Images that are already in texture memory or that were packed into a texture atlas are ready at once.
+	**/
+	bool LoadAsync(const std::string& filename)
+		{ return _Load(filename, true); }
+
+	bool LoadAsync(const std::string& filename, float width, float height)
+		{ SetDimensions(width, height); return LoadAsync(filename); }
+
 	//! \brief Draws the image to the screen
 	void Draw() const;
 
@@ -379,10 +407,12 @@ public:
 	**/
 	bool Save(const std::string& filename) const;
 
-	//! \brief Enables grayscaling for the image then reloads it
+	/** \brief Enables grayscaling for the image
+	*** The image data is not modified. The image is converted to grayscale by the video engine when it is drawn.
+	**/
 	void EnableGrayScale();
 
-	//! \brief Disables grayscaling for the image then reloads it
+	//! \brief Disables grayscaling for the image
 	void DisableGrayScale();
 
 	//! \name Class Member Access Functions
@@ -445,6 +475,13 @@ protected:
 
 	//! \brief The texture image that is referenced by this element
 	private_video::ImageTexture* _image_texture;
+
+	/** \brief The implementation of the Load() and LoadAsync() methods
+	*** \param filename The filename of the image to load
+	*** \param async If true, the image file is decoded on a worker thread when it needs to be read
+	*** \return True if the image was successfully loaded, or will be once it is decoded
+	**/
+	bool _Load(const std::string& filename, bool async);
 }; // class StillImage : public ImageDescriptor
 
 
@@ -514,13 +551,15 @@ public:
 	*** \param frame_width The width (in pixels) of each frame in the multi image file
 	*** \param frame_height The height (in pixels) of each frame in the multi image file
 	*** \param trim The number of frame images to "ignore" from the multi image (default == 0)
+	*** \param async If true, the frames are not drawn until the image file has been decoded on a worker thread (default == false)
 	*** \return True if the animation was successfully constructed from the loaded multi image
 	***
 	*** The trim factor must be less than the total number of frames that are stored in the multi image.
 	*** The size of the timings vector must be at least (# of frames in multi image - trim). It may
 	*** be larger than this, but the rest of the elements beyond the minimum size will be ignored.
 	**/
-	bool LoadFromFrameSize(const std::string& filename, const std::vector<uint32>& timings, const uint32 frame_width, const uint32 frame_height, const uint32 trim = 0);
+	bool LoadFromFrameSize(const std::string& filename, const std::vector<uint32>& timings, const uint32 frame_width, const uint32 frame_height,
+		const uint32 trim = 0, const bool async = false);
 
 	/** \brief Loads an AnimatedImage from a multi image file
 	*** \param filename The name of the file to load, which should end in a .png or .jpg extension
@@ -528,6 +567,7 @@ public:
 	*** \param frame_rows The number of rows of frame images in the image file
 	*** \param frame_cols The number of columns of frame images in the image file
 	*** \param trim The number of frame images to "ignore" from the multi image (default == 0)
+	*** \param async If true, the frames are not drawn until the image file has been decoded on a worker thread (default == false)
 	*** \return True if the animation was successfully constructed from the loaded multi image
 	***
 	*** The trim factor is useful for indicating if any of the final frames in a multi image
@@ -542,11 +582,15 @@ public:
 	*** than this minimum size, but only the first (frame_rows * frame_cols - trim) elements will
 	*** be used, and the rest of the vector ignored.
 	**/
-	bool LoadFromFrameGrid(const std::string& filename, const std::vector<uint32>& timings, const uint32 frame_rows, const uint32 frame_cols, const uint32 trim = 0);
+	bool LoadFromFrameGrid(const std::string& filename, const std::vector<uint32>& timings, const uint32 frame_rows, const uint32 frame_cols,
+		const uint32 trim = 0, const bool async = false);
 
 	//! \brief Draws the current frame image to the screen
 	void Draw() const;
 
+	//! \brief Returns true if any of the frame images are waiting on their image data to be loaded
+	bool IsLoadPending() const;
+
 	/** \brief Draws the current frame image which is modulated by a color
 	*** \param draw_color The color to modulate the image by
 	**/
@@ -819,6 +863,9 @@ public:
 	**/
 	void Draw(const Color& draw_color) const;
 
+	//! \brief Returns true if any of the element images are waiting on their image data to be loaded
+	bool IsLoadPending() const;
+
 	/** \brief Sets the static member for all future element images
 	*** \param is_static Flag indicating whether the image will be static or not
 	*** \note If the elements are already loaded, it doesn't bother to try to unload them
@@ -17,6 +17,8 @@
 #include <math.h>
 
 #include "image_base.h"
+#include "image_cache.h"
+#include "pixel_kernels.h"
 #include "video.h"
 
 using namespace std;
@@ -70,13 +72,19 @@ bool ImageMemory::LoadImage(const string& filename) {
 
 	// NOTE: We could technically try uppercase forms of the file extension, or also include the .jpeg extension name,
 	// but Allacrost's file standard states that only the .png and .jpg image file extensions are suppported.
-	if (extension == ".png")
-		return _LoadPngImage(filename);
-	else if (extension == ".jpg")
-		return _LoadJpgImage(filename);
+	if (extension != ".png" && extension != ".jpg") {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "unsupported file extension: \"" << extension << "\" for filename: " << filename << endl;
+		return false;
+	}
+
+	// Decoding the image file is skipped entirely if an up to date copy of its data is in the image cache
+	if (ImageCache::LoadImage(filename, *this) == true)
+		return true;
 
-	IF_PRINT_WARNING(VIDEO_DEBUG) << "unsupported file extension: \"" << extension << "\" for filename: " << filename << endl;
-	return false;
+	bool success = (extension == ".png") ? _LoadPngImage(filename) : _LoadJpgImage(filename);
+	if (success == true)
+		ImageCache::SaveImage(filename, *this);
+	return success;
 }
 
 
@@ -111,17 +119,8 @@ void ImageMemory::ConvertToGrayscale() {
 		return;
 	}
 
-	uint8 format_bytes = (rgb_format ? 3 : 4);
-	uint8* end_position = static_cast<uint8*>(pixels) + (width * height * format_bytes);
-
-	for (uint8* i = static_cast<uint8*>(pixels); i < end_position; i += format_bytes) {
-		// Compute the grayscale value for this pixel based on RGB values: 0.30R + 0.59G + 0.11B
-		uint8 value = static_cast<uint8>((30 * *(i) + 59 * *(i + 1) + 11 * *(i + 2)) * 0.01f);
-		*i = value;
-		*(i + 1) = value;
-		*(i + 2) = value;
-		// *(i + 3) for RGBA is the alpha value and is left unmodified
-	}
+	// Compute the grayscale value for each pixel based on RGB values: 0.30R + 0.59G + 0.11B
+	private_video::ConvertToGrayscale(static_cast<uint8*>(pixels), width * height, rgb_format == false);
 }
 
 
@@ -141,15 +140,7 @@ void ImageMemory::RGBAToRGB() {
 		return;
 	}
 
-	uint8* pixel_index = static_cast<uint8*>(pixels);
-	uint8* pixel_source = pixel_index;
-
-	for (int32 i = 0; i < height * width; i++, pixel_index += 4) {
-		int32 index = 3 * i;
-		pixel_source[index] = *pixel_index;
-		pixel_source[index + 1] = *(pixel_index + 1);
-		pixel_source[index + 2] = *(pixel_index + 2);
-	}
+	PackRGBAToRGB(static_cast<uint8*>(pixels), static_cast<uint8*>(pixels), width * height);
 
 	// Reduce the memory consumed by 1/4 since we no longer need to contain alpha data
 	void* new_pixels = realloc(pixels, width * height * 3);
@@ -173,6 +164,8 @@ void ImageMemory::CopyFromTexture(TexSheet* texture) {
 		PRINT_ERROR << "failed to malloc enough memory to copy the texture" << endl;
 	}
 
+	// The contents of a sheet that was evicted from texture memory must be reloaded before they can be read
+	TextureManager->_UseTexSheet(texture);
 	TextureManager->_BindTexture(texture->tex_id);
 	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 }
@@ -277,75 +270,47 @@ bool ImageMemory::_LoadPngImage(const string& filename) {
 	// this is mostly just byteswapping and adding extra data - we want everything in four channels
 	// for the moment, anyway
 	uint32 bpp = png_get_channels(png_ptr, info_ptr);
-	uint8* img_pixel = NULL;
-	uint8* dst_pixel = NULL;
+	uint8* dst_row = static_cast<uint8*>(pixels);
 
 	if (png_get_color_type(png_ptr, info_ptr) == PNG_COLOR_TYPE_PALETTE) {
 		// colours come from a palette - for this colour type, we have to look up the colour from the palette
-		png_color c;
 		png_colorp palette;
 		int num_palette = 0;
 		png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette);
-		for (uint32 y = 0; y < static_cast<uint32>(height); y++) {
-			for (uint32 x = 0; x < static_cast<uint32>(width); x++) {
-				img_pixel = row_pointers[y] + (x * bpp);
-				dst_pixel = ((uint8*)pixels) + ((y * width) + x) * 4;
-				c = palette[img_pixel[0]];
-
-				dst_pixel[0] = c.red;
-				dst_pixel[1] = c.green;
-				dst_pixel[2] = c.blue;
-				dst_pixel[3] = 0xFF;
+
+		uint8 palette_table[256 * 4];
+		memset(palette_table, 0, sizeof(palette_table));
+		for (int32 i = 0; i < 256; i++) {
+			if (i < num_palette) {
+				palette_table[i * 4] = palette[i].red;
+				palette_table[i * 4 + 1] = palette[i].green;
+				palette_table[i * 4 + 2] = palette[i].blue;
 			}
+			palette_table[i * 4 + 3] = 0xFF;
+		}
+
+		for (uint32 y = 0; y < static_cast<uint32>(height); y++, dst_row += width * 4) {
+			ExpandPaletteToRGBA(row_pointers[y], palette_table, dst_row, width);
 		}
 	}
 	else if (bpp == 1) {
-		for (uint32 y = 0; y < static_cast<uint32>(height); y++) {
-			for (uint32 x = 0; x < static_cast<uint32>(width); x++) {
-				img_pixel = row_pointers[y] + (x * bpp);
-				dst_pixel = ((uint8*)pixels) + ((y * width) + x) * 4;
-				dst_pixel[0] = img_pixel[0];
-				dst_pixel[1] = img_pixel[0];
-				dst_pixel[2] = img_pixel[0];
-				dst_pixel[3] = 0xFF;
-			}
+		for (uint32 y = 0; y < static_cast<uint32>(height); y++, dst_row += width * 4) {
+			ExpandGrayToRGBA(row_pointers[y], dst_row, width);
 		}
 	}
 	else if (bpp == 3) {
-		for (uint32 y = 0; y < static_cast<uint32>(height); y++) {
-			for (uint32 x = 0; x < static_cast<uint32>(width); x++) {
-				img_pixel = row_pointers[y] + (x * bpp);
-				dst_pixel = ((uint8*)pixels) + ((y * width) + x) * 4;
-				dst_pixel[0] = img_pixel[0];
-				dst_pixel[1] = img_pixel[1];
-				dst_pixel[2] = img_pixel[2];
-				dst_pixel[3] = 0xFF;
-			}
+		for (uint32 y = 0; y < static_cast<uint32>(height); y++, dst_row += width * 4) {
+			ExpandRGBToRGBA(row_pointers[y], dst_row, width);
 		}
 	}
 	else if (bpp == 4) {
-		for (uint32 y = 0; y < static_cast<uint32>(height); y++) {
-			for (uint32 x = 0; x < static_cast<uint32>(width); x++) {
-				img_pixel = row_pointers[y] + (x * bpp);
-				dst_pixel = ((uint8*)pixels) + ((y * width) + x) * 4;
-				// When a pixel is fully transparent and the texture smoothing option is enabled in the video engine,
-				// this causes OpenGL to use GL_LINEAR, which performs a linear average between pixels. Unfortunately,
-				// this results in a white outline to be seen when moving between transparent and non-transparent pixels
-				// in an image. To eliminate this unwanted artifact, we set the RGB values for all transparent pixels to
-				// 0 (black).
-				if (img_pixel[3] == 0) {
-					dst_pixel[0] = 0;
-					dst_pixel[1] = 0;
-					dst_pixel[2] = 0;
-					dst_pixel[3] = img_pixel[3];
-				}
-				else {
-					dst_pixel[0] = img_pixel[0];
-					dst_pixel[1] = img_pixel[1];
-					dst_pixel[2] = img_pixel[2];
-					dst_pixel[3] = img_pixel[3];
-				}
-			}
+		// When a pixel is fully transparent and the texture smoothing option is enabled in the video engine,
+		// this causes OpenGL to use GL_LINEAR, which performs a linear average between pixels. Unfortunately,
+		// this results in a white outline to be seen when moving between transparent and non-transparent pixels
+		// in an image. To eliminate this unwanted artifact, we set the RGB values for all transparent pixels to
+		// 0 (black).
+		for (uint32 y = 0; y < static_cast<uint32>(height); y++, dst_row += width * 4) {
+			CopyRGBAClearTransparent(row_pointers[y], dst_row, width);
 		}
 	}
 	else {
@@ -400,35 +365,18 @@ bool ImageMemory::_LoadJpgImage(const string& filename) {
 
 	// swizzle everything so it's in the format we want
 	uint32 bpp = cinfo.output_components;
-	uint8* img_pixel = NULL;
-	uint8* dst_pixel = NULL;
+	uint8* dst_row = static_cast<uint8*>(pixels);
 
 	if (bpp == 3) {
-		for (uint32 y = 0; y < cinfo.output_height; y++) {
+		for (uint32 y = 0; y < cinfo.output_height; y++, dst_row += cinfo.output_width * 3) {
 			jpeg_read_scanlines(&cinfo, buffer, 1);
-
-			for(uint32 x = 0; x < cinfo.output_width; x++) {
-				img_pixel = buffer[0] + (x * bpp);
-				dst_pixel = ((uint8 *)pixels) + ((y * cinfo.output_width) + x) * 3;
-
-				dst_pixel[0] = img_pixel[0];
-				dst_pixel[1] = img_pixel[1];
-				dst_pixel[2] = img_pixel[2];
-			}
+			memcpy(dst_row, buffer[0], cinfo.output_width * 3);
 		}
 	}
 	else if (bpp == 4) {
-		for (uint32 y = 0; y < cinfo.output_height; y++) {
+		for (uint32 y = 0; y < cinfo.output_height; y++, dst_row += cinfo.output_width * 3) {
 			jpeg_read_scanlines(&cinfo, buffer, 1);
-
-			for (uint32 x = 0; x < cinfo.output_width; x++) {
-				img_pixel = buffer[0] + (x * bpp);
-				dst_pixel = ((uint8 *)pixels) + ((y * cinfo.output_width) + x) * 3;
-
-				dst_pixel[0] = img_pixel[0];
-				dst_pixel[1] = img_pixel[1];
-				dst_pixel[2] = img_pixel[2];
-			}
+			PackRGBAToRGB(buffer[0], dst_row, cinfo.output_width);
 		}
 	}
 	else {
@@ -573,6 +521,43 @@ bool ImageMemory::_SaveJpgImage(const std::string& filename) const {
 	return true;
 } // bool ImageMemory::_SaveJpgImage(const std::string& file_name) const
 
+// -----------------------------------------------------------------------------
+// ImageContentKey class
+// -----------------------------------------------------------------------------
+
+void ImageContentKey::Compute(const ImageMemory& image, int32 x, int32 y, int32 area_width, int32 area_height) {
+	width = area_width;
+	height = area_height;
+	rgb_format = image.rgb_format;
+	fnv_hash = 2166136261U;
+	sdbm_hash = 0;
+
+	uint32 pixel_bytes = (rgb_format ? 3 : 4);
+	uint32 row_bytes = area_width * pixel_bytes;
+	for (int32 row = 0; row < area_height; row++) {
+		const uint8* pixels = static_cast<const uint8*>(image.pixels) + ((y + row) * image.width + x) * pixel_bytes;
+		for (uint32 i = 0; i < row_bytes; i++) {
+			fnv_hash ^= pixels[i];
+			fnv_hash *= 16777619U;
+			sdbm_hash = pixels[i] + (sdbm_hash << 6) + (sdbm_hash << 16) - sdbm_hash;
+		}
+	}
+}
+
+
+
+bool ImageContentKey::operator<(const ImageContentKey& other) const {
+	if (fnv_hash != other.fnv_hash)
+		return (fnv_hash < other.fnv_hash);
+	if (sdbm_hash != other.sdbm_hash)
+		return (sdbm_hash < other.sdbm_hash);
+	if (width != other.width)
+		return (width < other.width);
+	if (height != other.height)
+		return (height < other.height);
+	return (rgb_format == false && other.rgb_format == true);
+}
+
 // -----------------------------------------------------------------------------
 // BaseTexture class
 // -----------------------------------------------------------------------------
@@ -653,7 +638,8 @@ bool BaseTexture::RemoveReference() {
 ImageTexture::ImageTexture(const string& filename_, const string& tags_, int32 width_, int32 height_) :
 	BaseTexture(width_, height_),
 	filename(filename_),
-	tags(tags_)
+	tags(tags_),
+	shared_texture(NULL)
 {
 	if (VIDEO_DEBUG) {
 		if (TextureManager->_IsImageTextureRegistered(filename + tags))
@@ -668,7 +654,8 @@ ImageTexture::ImageTexture(const string& filename_, const string& tags_, int32 w
 ImageTexture::ImageTexture(TexSheet* texture_sheet_, const string& filename_, const string& tags_, int32 width_, int32 height_) :
 	BaseTexture(texture_sheet_, width_, height_),
 	filename(filename_),
-	tags(tags_)
+	tags(tags_),
+	shared_texture(NULL)
 {
 	if (VIDEO_DEBUG) {
 		if (TextureManager->_IsImageTextureRegistered(filename + tags))
@@ -150,6 +150,52 @@ private:
 }; // class ImageMemory
 
 
+/** ****************************************************************************
+*** \brief Identifies the contents of an image by its format, its dimensions, and two hashes of its pixels
+***
+*** The two hashes are computed by unrelated 32-bit algorithms (FNV-1a and sdbm),
+*** so that two images with different pixels rarely have equal keys. The texture
+*** controller uses the key to find images that may be identical, and compares
+*** their pixels before it shares texture sheet space between them.
+*** ***************************************************************************/
+class ImageContentKey {
+public:
+	ImageContentKey() :
+		width(0), height(0), rgb_format(false), fnv_hash(0), sdbm_hash(0) {}
+
+	//! \brief The dimensions of the image, in pixels
+	int32 width, height;
+
+	//! \brief True if the pixels are in RGB format, false if they are in RGBA format
+	bool rgb_format;
+
+	//! \brief The two hashes of the pixel data
+	uint32 fnv_hash, sdbm_hash;
+
+	/** \brief Computes the key of a rectangular area of an image
+	*** \param image The image data to compute the key from
+	*** \param x The x coordinate of the left edge of the area, in pixels
+	*** \param y The y coordinate of the top edge of the area, in pixels
+	*** \param area_width The width of the area, in pixels
+	*** \param area_height The height of the area, in pixels
+	***
+	*** This only reads the pixel data, so it may be called from the worker threads of the image loader.
+	**/
+	void Compute(const ImageMemory& image, int32 x, int32 y, int32 area_width, int32 area_height);
+
+	//! \brief Computes the key of an entire image
+	void Compute(const ImageMemory& image)
+		{ Compute(image, 0, 0, image.width, image.height); }
+
+	//! \brief Orders the keys so that they may be used in an associative container
+	bool operator<(const ImageContentKey& other) const;
+
+	bool operator==(const ImageContentKey& other) const
+		{ return (width == other.width && height == other.height && rgb_format == other.rgb_format &&
+			fnv_hash == other.fnv_hash && sdbm_hash == other.sdbm_hash); }
+}; // class ImageContentKey
+
+
 /** ****************************************************************************
 *** \brief Represents the location and properties of an image in texture memory
 ***
@@ -276,7 +322,6 @@ public:
 	***    while "ROWS" is the total number of rows of elements in the multi image
 	*** -# \<Ycol_COLS>: used for multi image elements. "col" is the column number of this particular element
 	***    while "COLS" is the total number of columns of elements in the multi image
-	*** -# \<G>: used to indicate that this image texture has been converted to grayscale mode
 	***
 	*** \note The \<T> tag and multi image tags can not appear together
 	*** \note The \<T> tag is likely temporary, as its need will later be replaced with procedural image classes
@@ -284,6 +329,19 @@ public:
 	**/
 	std::string tags;
 
+	/** \brief The texture whose space in a texture sheet is used by this texture, or NULL if this texture has its own space
+	*** When the pixel data of an image is identical to that of an image which is already held by a texture sheet, the
+	*** new texture takes the sheet position of the existing one instead of being added to a sheet. It holds one
+	*** reference to the shared texture for as long as it exists.
+	**/
+	ImageTexture* shared_texture;
+
+	/** \brief Identifies the pixel data of the texture, which is used to find other images with identical data
+	*** This is only set for textures that hold their own space in a texture sheet and are available to be shared.
+	*** Temporary images (with the \<T> tag) are never shared, since their contents may be replaced.
+	**/
+	ImageContentKey content_key;
+
 private:
 	ImageTexture(const ImageTexture& copy);
 	ImageTexture& operator=(const ImageTexture& copy);
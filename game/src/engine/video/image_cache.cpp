@@ -0,0 +1,232 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    image_cache.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the decoded image cache
+*** ***************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+	// windows.h defines LoadImage as a macro, which would rename the ImageCache method of the same name
+	#undef LoadImage
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+#include <SDL/SDL_thread.h>
+
+#include "image_cache.h"
+#include "image_base.h"
+#include "video.h"
+
+using namespace std;
+
+using namespace hoa_utils;
+
+namespace hoa_video {
+
+namespace private_video {
+
+string ImageCache::_directory;
+
+
+
+bool ImageCache::SetDirectory(const string& directory) {
+	_directory.clear();
+
+	if (MakeDirectory(directory) == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "could not create the image cache directory: " << directory << endl;
+		return false;
+	}
+
+	_directory = directory;
+	if (_directory[_directory.length() - 1] != '/')
+		_directory += "/";
+	return true;
+}
+
+
+
+bool ImageCache::LoadImage(const string& filename, ImageMemory& image) {
+	if (IsEnabled() == false)
+		return false;
+
+	uint32 source_size, source_time;
+	if (_GetSourceInfo(filename, source_size, source_time) == false)
+		return false;
+
+	string cache_filename = _CacheFilename(filename);
+
+	// Map the entire cache file into memory. A missing cache file is the normal case for an image that has not been loaded before.
+#ifdef _WIN32
+	HANDLE file = CreateFileA(cache_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	DWORD file_size = GetFileSize(file, NULL);
+	HANDLE mapping = NULL;
+	const uint8* data = NULL;
+	if (file_size != INVALID_FILE_SIZE && file_size >= sizeof(ImageCacheHeader)) {
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping != NULL)
+			data = static_cast<const uint8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	}
+#else
+	int file = open(cache_filename.c_str(), O_RDONLY);
+	if (file == -1)
+		return false;
+
+	struct stat file_info;
+	size_t file_size = 0;
+	const uint8* data = NULL;
+	if (fstat(file, &file_info) == 0 && static_cast<size_t>(file_info.st_size) >= sizeof(ImageCacheHeader)) {
+		file_size = static_cast<size_t>(file_info.st_size);
+		void* mapping = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapping != MAP_FAILED)
+			data = static_cast<const uint8*>(mapping);
+	}
+#endif
+
+	// The cache file is only used if it was created from the current version of the source file
+	bool valid = false;
+	if (data != NULL) {
+		ImageCacheHeader header;
+		memcpy(&header, data, sizeof(ImageCacheHeader));
+		uint32 pixel_size = header.width * header.height * header.pixel_bytes;
+
+		valid = (header.magic == IMAGE_CACHE_MAGIC && header.version == IMAGE_CACHE_VERSION &&
+			header.source_size == source_size && header.source_time == source_time &&
+			header.width > 0 && header.height > 0 && (header.pixel_bytes == 3 || header.pixel_bytes == 4) &&
+			file_size == sizeof(ImageCacheHeader) + header.filename_length + pixel_size &&
+			header.filename_length == filename.length() &&
+			memcmp(data + sizeof(ImageCacheHeader), filename.c_str(), header.filename_length) == 0);
+
+		if (valid == true) {
+			image.pixels = malloc(pixel_size);
+			if (image.pixels == NULL) {
+				valid = false;
+			}
+			else {
+				memcpy(image.pixels, data + sizeof(ImageCacheHeader) + header.filename_length, pixel_size);
+				image.width = header.width;
+				image.height = header.height;
+				image.rgb_format = (header.pixel_bytes == 3);
+			}
+		}
+	}
+
+#ifdef _WIN32
+	if (data != NULL)
+		UnmapViewOfFile(data);
+	if (mapping != NULL)
+		CloseHandle(mapping);
+	CloseHandle(file);
+#else
+	if (data != NULL)
+		munmap(const_cast<uint8*>(data), file_size);
+	close(file);
+#endif
+
+	return valid;
+} // bool ImageCache::LoadImage(const string& filename, ImageMemory& image)
+
+
+
+bool ImageCache::SaveImage(const string& filename, const ImageMemory& image) {
+	if (IsEnabled() == false)
+		return false;
+
+	if (image.pixels == NULL || image.width <= 0 || image.height <= 0) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "image contained no data for file: " << filename << endl;
+		return false;
+	}
+
+	ImageCacheHeader header;
+	if (_GetSourceInfo(filename, header.source_size, header.source_time) == false)
+		return false;
+
+	header.magic = IMAGE_CACHE_MAGIC;
+	header.version = IMAGE_CACHE_VERSION;
+	header.width = image.width;
+	header.height = image.height;
+	header.pixel_bytes = (image.rgb_format ? 3 : 4);
+	header.filename_length = filename.length();
+	uint32 pixel_size = header.width * header.height * header.pixel_bytes;
+
+	// The file is written under a name unique to this thread and then renamed, so that another thread loading the
+	// same image never reads a partially written cache file
+	string cache_filename = _CacheFilename(filename);
+	string temp_filename = cache_filename + "." + NumberToString(SDL_ThreadID());
+
+	FILE* file = fopen(temp_filename.c_str(), "wb");
+	if (file == NULL) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "could not open image cache file for writing: " << temp_filename << endl;
+		return false;
+	}
+
+	bool success = (fwrite(&header, sizeof(ImageCacheHeader), 1, file) == 1 &&
+		fwrite(filename.c_str(), 1, header.filename_length, file) == header.filename_length &&
+		fwrite(image.pixels, 1, pixel_size, file) == pixel_size);
+	if (fclose(file) != 0)
+		success = false;
+
+	// Windows does not allow rename() to replace an existing file
+#ifdef _WIN32
+	if (success == true)
+		remove(cache_filename.c_str());
+#endif
+	if (success == false || rename(temp_filename.c_str(), cache_filename.c_str()) != 0) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to write image cache file: " << cache_filename << endl;
+		remove(temp_filename.c_str());
+		return false;
+	}
+
+	return true;
+} // bool ImageCache::SaveImage(const string& filename, const ImageMemory& image)
+
+
+
+string ImageCache::_CacheFilename(const string& filename) {
+	// The cache file is named after a 32-bit FNV-1a hash of the source filename. The source filename is also stored
+	// within the cache file, so a hash collision only causes the two images to replace each other's cache file.
+	uint32 hash = 2166136261U;
+	for (uint32 i = 0; i < filename.length(); i++) {
+		hash ^= static_cast<uint8>(filename[i]);
+		hash *= 16777619U;
+	}
+
+	char hash_text[9];
+	sprintf(hash_text, "%08x", hash);
+	return _directory + hash_text + ".img";
+}
+
+
+
+bool ImageCache::_GetSourceInfo(const string& filename, uint32& size, uint32& time) {
+	struct stat file_info;
+	if (stat(filename.c_str(), &file_info) != 0)
+		return false;
+
+	size = static_cast<uint32>(file_info.st_size);
+	time = static_cast<uint32>(file_info.st_mtime);
+	return true;
+}
+
+} // namespace private_video
+
+} // namespace hoa_video
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    image_cache.h
+*** \author  agent, agent@local
+*** \brief   Header file for the decoded image cache
+***
+*** Decompressing PNG and JPG files makes up the bulk of the time that it takes
+*** to load an image. The image cache keeps a copy of the decoded pixel data of
+*** every image file that is loaded in the user's data directory. Each cache
+*** file records the size and modification time of the image file that it was
+*** created from, and is ignored and rewritten whenever the image file changes.
+***
+*** A cache file consists of an ImageCacheHeader, followed by the filename of
+*** the source image (without a terminating null character), followed by the
+*** raw pixel data in either RGB or RGBA format. The pixel data is read by
+*** memory mapping the cache file.
+*** ***************************************************************************/
+
+#ifndef __IMAGE_CACHE_HEADER__
+#define __IMAGE_CACHE_HEADER__
+
+#include "defs.h"
+#include "utils.h"
+
+namespace hoa_video {
+
+namespace private_video {
+
+//! \brief Identifies a file as an image cache file
+const uint32 IMAGE_CACHE_MAGIC = 0x43494F48; // "HOIC" when read as little endian bytes
+
+//! \brief Incremented whenever the format of cache files changes, so that older cache files are rebuilt
+const uint32 IMAGE_CACHE_VERSION = 1;
+
+/** ****************************************************************************
+*** \brief The header found at the beginning of every image cache file
+*** ***************************************************************************/
+class ImageCacheHeader {
+public:
+	//! \brief Must be equal to IMAGE_CACHE_MAGIC
+	uint32 magic;
+
+	//! \brief Must be equal to IMAGE_CACHE_VERSION
+	uint32 version;
+
+	//! \brief The size of the source image file, in bytes
+	uint32 source_size;
+
+	//! \brief The modification time of the source image file, truncated to 32 bits
+	uint32 source_time;
+
+	//! \brief The dimensions of the image, in pixels
+	int32 width, height;
+
+	//! \brief The number of bytes that each pixel occupies, which is 3 for RGB data or 4 for RGBA data
+	uint32 pixel_bytes;
+
+	//! \brief The length of the source image filename that follows the header
+	uint32 filename_length;
+}; // class ImageCacheHeader
+
+
+/** ****************************************************************************
+*** \brief Stores and retrieves decoded image data in a directory of cache files
+***
+*** All methods of this class are static and may be called from the image loader
+*** threads. The cache is disabled until SetDirectory() is called.
+*** ***************************************************************************/
+class ImageCache {
+public:
+	/** \brief Enables the cache and sets the directory where cache files are kept
+	*** \param directory The name of the directory, which will be created if it does not exist
+	*** \return True if the directory is usable, false if it is not and the cache remains disabled
+	***
+	*** This should be called by the main thread before any images are loaded.
+	**/
+	static bool SetDirectory(const std::string& directory);
+
+	//! \brief Returns true if the cache is enabled
+	static bool IsEnabled()
+		{ return (_directory.empty() == false); }
+
+	/** \brief Retrieves the decoded data of an image file from the cache
+	*** \param filename The name of the source image file
+	*** \param image The image to place the data in, whose pixels member must be NULL
+	*** \return True if an up to date cache file was found and read, false if the image file must be decoded
+	**/
+	static bool LoadImage(const std::string& filename, ImageMemory& image);
+
+	/** \brief Writes the decoded data of an image file to the cache
+	*** \param filename The name of the source image file
+	*** \param image The image data that was decoded from the file
+	*** \return True if the cache file was written successfully
+	**/
+	static bool SaveImage(const std::string& filename, const ImageMemory& image);
+
+private:
+	//! \brief The directory where cache files are kept, including the trailing slash. Empty if the cache is disabled.
+	static std::string _directory;
+
+	//! \brief Returns the name of the cache file used for a source image file
+	static std::string _CacheFilename(const std::string& filename);
+
+	/** \brief Retrieves the size and modification time of a source image file
+	*** \return False if the file could not be found
+	**/
+	static bool _GetSourceInfo(const std::string& filename, uint32& size, uint32& time);
+}; // class ImageCache
+
+} // namespace private_video
+
+} // namespace hoa_video
+
+#endif // __IMAGE_CACHE_HEADER__
@@ -0,0 +1,328 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    image_loader.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the asynchronous image loader
+*** ***************************************************************************/
+
+#include <algorithm>
+
+#include "image_loader.h"
+#include "video.h"
+#include "system.h"
+
+using namespace std;
+
+using namespace hoa_utils;
+
+namespace hoa_video {
+
+namespace private_video {
+
+ImageLoader::ImageLoader() :
+	_queue_mutex(SDL_CreateMutex()),
+	_pending_semaphore(SDL_CreateSemaphore(0)),
+	_decoded_condition(SDL_CreateCond()),
+	_shutdown(false)
+{}
+
+
+
+ImageLoader::~ImageLoader() {
+	Shutdown();
+	SDL_DestroyCond(_decoded_condition);
+	SDL_DestroySemaphore(_pending_semaphore);
+	SDL_DestroyMutex(_queue_mutex);
+}
+
+
+
+void ImageLoader::Initialize() {
+#if (THREAD_TYPE == SDL_THREADS)
+	for (uint32 i = 0; i < IMAGE_LOADER_THREADS; i++) {
+		SDL_Thread* thread = SDL_CreateThread(_WorkerThread, this);
+		if (thread == NULL) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create an image loader thread: " << SDL_GetError() << endl;
+			break;
+		}
+		_threads.push_back(thread);
+	}
+#endif
+}
+
+
+
+void ImageLoader::Shutdown() {
+	SDL_mutexP(_queue_mutex);
+	_shutdown = true;
+	SDL_mutexV(_queue_mutex);
+
+	// Each thread is woken up once, upon which it sees that it should exit
+	for (uint32 i = 0; i < _threads.size(); i++) {
+		SDL_SemPost(_pending_semaphore);
+	}
+	for (uint32 i = 0; i < _threads.size(); i++) {
+		SDL_WaitThread(_threads[i], NULL);
+	}
+	_threads.clear();
+
+	for (set<ImageLoadRequest*>::iterator i = _requests.begin(); i != _requests.end(); i++) {
+		if ((*i)->image_data.pixels != NULL) {
+			free((*i)->image_data.pixels);
+			(*i)->image_data.pixels = NULL;
+		}
+		delete *i;
+	}
+	_requests.clear();
+	_texture_requests.clear();
+	_pending_requests.clear();
+	_decoded_requests.clear();
+
+	// Any requests made from this point on are decoded on the main thread
+	_shutdown = false;
+}
+
+
+
+void ImageLoader::RequestLoad(const string& filename, const vector<ImageTexture*>& textures,
+	uint32 grid_rows, uint32 grid_cols, bool is_static)
+{
+	ImageLoadRequest* request = new ImageLoadRequest();
+	request->filename = filename;
+	request->textures = textures;
+	request->grid_rows = grid_rows;
+	request->grid_cols = grid_cols;
+	request->is_static = is_static;
+
+	_requests.insert(request);
+	for (uint32 i = 0; i < textures.size(); i++) {
+		if (textures[i] != NULL)
+			_texture_requests[textures[i]] = request;
+	}
+
+	SDL_mutexP(_queue_mutex);
+	_pending_requests.push_back(request);
+	SDL_mutexV(_queue_mutex);
+
+	if (_threads.empty() == false)
+		SDL_SemPost(_pending_semaphore);
+}
+
+
+
+void ImageLoader::CancelTexture(BaseTexture* texture) {
+	map<BaseTexture*, ImageLoadRequest*>::iterator entry = _texture_requests.find(texture);
+	if (entry == _texture_requests.end())
+		return;
+
+	// The request is still completed for any other textures that it holds. If none remain, it simply discards the image data.
+	vector<ImageTexture*>& textures = entry->second->textures;
+	for (uint32 i = 0; i < textures.size(); i++) {
+		if (textures[i] == texture)
+			textures[i] = NULL;
+	}
+	_texture_requests.erase(entry);
+}
+
+
+
+void ImageLoader::UploadImages(uint32 time_budget) {
+	if (_requests.empty() == true)
+		return;
+
+	uint32 start_time = SDL_GetTicks();
+	do {
+		ImageLoadRequest* request = NULL;
+		bool decode = false;
+
+		SDL_mutexP(_queue_mutex);
+		if (_decoded_requests.empty() == false) {
+			request = _decoded_requests.front();
+			_decoded_requests.pop_front();
+		}
+		else if (_threads.empty() == true && _pending_requests.empty() == false) {
+			request = _pending_requests.front();
+			_pending_requests.pop_front();
+			decode = true;
+		}
+		SDL_mutexV(_queue_mutex);
+
+		if (request == NULL)
+			return;
+
+		if (decode == true)
+			_DecodeRequest(request);
+		_CompleteRequest(request);
+	} while (SDL_GetTicks() - start_time < time_budget);
+}
+
+
+
+void ImageLoader::FinishTexture(BaseTexture* texture) {
+	map<BaseTexture*, ImageLoadRequest*>::iterator entry = _texture_requests.find(texture);
+	if (entry != _texture_requests.end())
+		_FinishRequest(entry->second);
+}
+
+
+
+void ImageLoader::FinishAll() {
+	while (_requests.empty() == false) {
+		_FinishRequest(*_requests.begin());
+	}
+}
+
+
+
+int ImageLoader::_WorkerThread(void* loader) {
+	ImageLoader* image_loader = static_cast<ImageLoader*>(loader);
+
+	while (true) {
+		SDL_SemWait(image_loader->_pending_semaphore);
+
+		SDL_mutexP(image_loader->_queue_mutex);
+		if (image_loader->_shutdown == true) {
+			SDL_mutexV(image_loader->_queue_mutex);
+			return 0;
+		}
+
+		// The queue may be empty if the main thread took the request to finish it itself
+		if (image_loader->_pending_requests.empty() == true) {
+			SDL_mutexV(image_loader->_queue_mutex);
+			continue;
+		}
+
+		ImageLoadRequest* request = image_loader->_pending_requests.front();
+		image_loader->_pending_requests.pop_front();
+		SDL_mutexV(image_loader->_queue_mutex);
+
+		_DecodeRequest(request);
+
+		SDL_mutexP(image_loader->_queue_mutex);
+		image_loader->_decoded_requests.push_back(request);
+		SDL_CondBroadcast(image_loader->_decoded_condition);
+		SDL_mutexV(image_loader->_queue_mutex);
+	}
+} // int ImageLoader::_WorkerThread(void* loader)
+
+
+
+void ImageLoader::_DecodeRequest(ImageLoadRequest* request) {
+	request->success = request->image_data.LoadImage(request->filename);
+	if (request->success == false)
+		return;
+
+	const ImageMemory& image_data = request->image_data;
+	int32 element_width = image_data.width / request->grid_cols;
+	int32 element_height = image_data.height / request->grid_rows;
+	request->content_keys.resize(request->grid_rows * request->grid_cols);
+	for (uint32 x = 0; x < request->grid_rows; x++) {
+		for (uint32 y = 0; y < request->grid_cols; y++) {
+			// The same area that is extracted for the element when the request is completed
+			request->content_keys[x * request->grid_cols + y].Compute(image_data, y * image_data.width / request->grid_cols,
+				x * image_data.height / request->grid_rows, element_width, element_height);
+		}
+	}
+}
+
+
+
+void ImageLoader::_FinishRequest(ImageLoadRequest* request) {
+	bool decode = false;
+
+	// Remove the request from whichever queue holds it. If it is in neither queue, a worker thread is decoding
+	// it at this moment, so wait for a worker to signal that it has added a request to the decoded queue.
+	SDL_mutexP(_queue_mutex);
+	while (true) {
+		deque<ImageLoadRequest*>::iterator pending = find(_pending_requests.begin(), _pending_requests.end(), request);
+		if (pending != _pending_requests.end()) {
+			_pending_requests.erase(pending);
+			decode = true;
+			break;
+		}
+
+		deque<ImageLoadRequest*>::iterator decoded = find(_decoded_requests.begin(), _decoded_requests.end(), request);
+		if (decoded != _decoded_requests.end()) {
+			_decoded_requests.erase(decoded);
+			break;
+		}
+
+		SDL_CondWait(_decoded_condition, _queue_mutex);
+	}
+	SDL_mutexV(_queue_mutex);
+
+	if (decode == true)
+		_DecodeRequest(request);
+	_CompleteRequest(request);
+} // void ImageLoader::_FinishRequest(ImageLoadRequest* request)
+
+
+
+void ImageLoader::_CompleteRequest(ImageLoadRequest* request) {
+	_requests.erase(request);
+	for (uint32 i = 0; i < request->textures.size(); i++) {
+		if (request->textures[i] != NULL)
+			_texture_requests.erase(request->textures[i]);
+	}
+
+	ImageMemory& image_data = request->image_data;
+	if (request->success == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to load image file: " << request->filename << endl;
+	}
+	else if (request->grid_rows == 1 && request->grid_cols == 1) {
+		ImageTexture* texture = request->textures[0];
+		if (texture != NULL && TextureManager->_InsertImageTexture(texture, image_data, request->is_static, &request->content_keys[0]) == NULL) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextureController::_InsertImageTexture() failed for file: " << request->filename << endl;
+		}
+	}
+	else {
+		// Extract each element of the multi image, in the same manner as ImageDescriptor::_LoadMultiImage()
+		ImageMemory sub_image;
+		sub_image.width = image_data.width / request->grid_cols;
+		sub_image.height = image_data.height / request->grid_rows;
+		sub_image.pixels = malloc(sub_image.width * sub_image.height * 4);
+		if (sub_image.pixels == NULL) {
+			PRINT_ERROR << "failed to malloc memory for multi image file: " << request->filename << endl;
+		}
+
+		for (uint32 x = 0; x < request->grid_rows && sub_image.pixels != NULL; x++) {
+			for (uint32 y = 0; y < request->grid_cols; y++) {
+				ImageTexture* texture = request->textures[x * request->grid_cols + y];
+				if (texture == NULL)
+					continue;
+
+				for (int32 i = 0; i < sub_image.height; i++) {
+					memcpy((uint8*)sub_image.pixels + 4 * sub_image.width * i, (uint8*)image_data.pixels + (((x * image_data.height / request->grid_rows) + i) *
+						image_data.width + y * image_data.width / request->grid_cols) * 4, 4 * sub_image.width);
+				}
+
+				if (TextureManager->_InsertImageTexture(texture, sub_image, request->is_static, &request->content_keys[x * request->grid_cols + y]) == NULL) {
+					IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextureController::_InsertImageTexture() failed for file: " << request->filename << endl;
+				}
+			}
+		}
+
+		if (sub_image.pixels != NULL) {
+			free(sub_image.pixels);
+			sub_image.pixels = NULL;
+		}
+	}
+
+	if (image_data.pixels != NULL) {
+		free(image_data.pixels);
+		image_data.pixels = NULL;
+	}
+	delete request;
+} // void ImageLoader::_CompleteRequest(ImageLoadRequest* request)
+
+} // namespace private_video
+
+} // namespace hoa_video
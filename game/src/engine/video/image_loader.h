@@ -0,0 +1,192 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    image_loader.h
+*** \author  agent, agent@local
+*** \brief   Header file for the asynchronous image loader
+***
+*** The image loader decodes image files on worker threads so that the thread
+*** which requested an image does not need to wait for the file to be read and
+*** decompressed. Decoded images are handed back to the main thread, which is
+*** the only thread that may make OpenGL calls, and are copied into texture
+*** memory a few at a time at the end of every frame.
+*** ***************************************************************************/
+
+#ifndef __IMAGE_LOADER_HEADER__
+#define __IMAGE_LOADER_HEADER__
+
+#include <SDL/SDL_thread.h>
+#include <SDL/SDL_mutex.h>
+
+#include <deque>
+
+#include "defs.h"
+#include "utils.h"
+
+#include "image_base.h"
+
+namespace hoa_video {
+
+namespace private_video {
+
+//! \brief The number of worker threads that the image loader decodes image files with
+const uint32 IMAGE_LOADER_THREADS = 2;
+
+/** ****************************************************************************
+*** \brief A request to load an image file into one or more image textures
+***
+*** The worker threads only ever access the filename, grid_rows, grid_cols,
+*** image_data, content_keys, and success members. All other members are
+*** accessed exclusively by the main thread.
+*** ***************************************************************************/
+class ImageLoadRequest {
+public:
+	ImageLoadRequest() :
+		grid_rows(1), grid_cols(1), is_static(false), success(false) {}
+
+	//! \brief The name of the image file to load
+	std::string filename;
+
+	/** \brief The textures that the image data will be inserted into
+	*** For a multi image, the textures are ordered from left to right and top to bottom. A texture is set to NULL
+	*** if it is deleted before the request has been completed.
+	**/
+	std::vector<ImageTexture*> textures;
+
+	//! \brief The number of rows and columns of elements that the image is divided into, which is 1x1 for an ordinary image
+	uint32 grid_rows, grid_cols;
+
+	//! \brief Indicates whether the textures should be placed in static texture sheets
+	bool is_static;
+
+	//! \brief Holds the decoded image data
+	ImageMemory image_data;
+
+	/** \brief The content key of each element of the decoded image, in the same order as the textures
+	*** These are computed by the thread which decoded the image, so that the main thread does not need to hash the
+	*** pixels when it looks for identical images to share texture space with.
+	**/
+	std::vector<ImageContentKey> content_keys;
+
+	//! \brief Set to true by the thread which decoded the image if the image file was loaded successfully
+	bool success;
+}; // class ImageLoadRequest
+
+
+/** ****************************************************************************
+*** \brief Decodes image files on worker threads and inserts them into texture sheets on the main thread
+***
+*** The textures of a request are created and registered with the texture controller
+*** when the request is made, but are not placed in any texture sheet until the
+*** image data has been decoded and uploaded. Until then, their texture_sheet member
+*** is NULL and images that refer to them are not drawn.
+***
+*** If no worker threads could be created, or threads are disabled in system.h,
+*** image files are decoded on the main thread by UploadImages() instead, so that
+*** requests are still completed over the course of several frames.
+*** ***************************************************************************/
+class ImageLoader {
+public:
+	ImageLoader();
+
+	~ImageLoader();
+
+	//! \brief Creates the worker threads
+	void Initialize();
+
+	/** \brief Stops the worker threads and discards all outstanding requests
+	*** The textures of discarded requests are left in their unloaded state.
+	**/
+	void Shutdown();
+
+	/** \brief Requests that an image file be loaded into a set of textures
+	*** \param filename The name of the image file to load
+	*** \param textures The unloaded textures that the image will be inserted into, where NULL entries are multi image elements to skip
+	*** \param grid_rows The number of rows of elements that the image is divided into
+	*** \param grid_cols The number of columns of elements that the image is divided into
+	*** \param is_static Indicates whether the textures should be placed in static texture sheets
+	**/
+	void RequestLoad(const std::string& filename, const std::vector<ImageTexture*>& textures,
+		uint32 grid_rows, uint32 grid_cols, bool is_static);
+
+	/** \brief Stops a texture from receiving any image data
+	*** \param texture The texture, which is about to be deleted
+	***
+	*** This must be called before an unloaded texture is deleted. Nothing happens if the texture is not part of any request.
+	**/
+	void CancelTexture(BaseTexture* texture);
+
+	/** \brief Inserts decoded images into texture sheets until a time limit is reached
+	*** \param time_budget The number of milliseconds that may be spent, although at least one image is always uploaded if any are ready
+	**/
+	void UploadImages(uint32 time_budget);
+
+	/** \brief Completes the request that a texture belongs to, waiting on the image to be decoded if necessary
+	*** \param texture The texture to load
+	**/
+	void FinishTexture(BaseTexture* texture);
+
+	//! \brief Completes every outstanding request
+	void FinishAll();
+
+	//! \brief Returns true if any request has not yet been completed
+	bool IsLoading() const
+		{ return (_requests.empty() == false); }
+
+private:
+	//! \brief The worker threads
+	std::vector<SDL_Thread*> _threads;
+
+	//! \brief Protects the _pending_requests, _decoded_requests, and _shutdown members, which are shared with the worker threads
+	SDL_mutex* _queue_mutex;
+
+	//! \brief Counts the number of requests that have been added to the pending queue, so that idle worker threads may sleep on it
+	SDL_sem* _pending_semaphore;
+
+	//! \brief Signaled by the worker threads each time that a request is added to the decoded queue
+	SDL_cond* _decoded_condition;
+
+	//! \brief Requests which are waiting for their image file to be decoded
+	std::deque<ImageLoadRequest*> _pending_requests;
+
+	//! \brief Requests which have had their image file decoded and are waiting to be uploaded
+	std::deque<ImageLoadRequest*> _decoded_requests;
+
+	//! \brief Set to true to instruct the worker threads to exit
+	bool _shutdown;
+
+	//! \brief All requests that have not been completed, which is only accessed by the main thread
+	std::set<ImageLoadRequest*> _requests;
+
+	//! \brief The request that each unloaded texture belongs to, which is only accessed by the main thread
+	std::map<BaseTexture*, ImageLoadRequest*> _texture_requests;
+
+	//! \brief The function run by each worker thread
+	static int _WorkerThread(void* loader);
+
+	//! \brief Decodes the image file of a request and computes the content key of each of its elements
+	static void _DecodeRequest(ImageLoadRequest* request);
+
+	/** \brief Completes a request immediately, decoding its image file on the calling thread if no worker thread has done so yet
+	*** \param request The request to complete, which may be in either queue or be in the middle of being decoded
+	**/
+	void _FinishRequest(ImageLoadRequest* request);
+
+	/** \brief Inserts the decoded image of a request into texture sheets and deletes the request
+	*** \param request The request to complete, which must have been removed from both queues
+	**/
+	void _CompleteRequest(ImageLoadRequest* request);
+}; // class ImageLoader
+
+} // namespace private_video
+
+} // namespace hoa_video
+
+#endif // __IMAGE_LOADER_HEADER__
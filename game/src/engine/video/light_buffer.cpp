@@ -0,0 +1,394 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    light_buffer.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the LightBuffer class
+*** ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "light_buffer.h"
+#include "video.h"
+
+using namespace std;
+
+using namespace hoa_utils;
+
+namespace hoa_video {
+
+namespace private_video {
+
+//! \brief The width and height of the falloff texture, in pixels
+const int32 LIGHT_FALLOFF_TEXTURE_SIZE = 64;
+
+//! \brief Orders lights by their distance from the center of the viewport, nearest first
+static bool CompareLightDistance(const LightSource& first, const LightSource& second) {
+	float first_x = first.left + first.width * 0.5f - 0.5f;
+	float first_y = first.bottom + first.height * 0.5f - 0.5f;
+	float second_x = second.left + second.width * 0.5f - 0.5f;
+	float second_y = second.bottom + second.height * 0.5f - 0.5f;
+	return (first_x * first_x + first_y * first_y) < (second_x * second_x + second_y * second_y);
+}
+
+LightBuffer::LightBuffer() :
+	_falloff_texture(INVALID_TEXTURE_ID)
+{}
+
+
+
+LightBuffer::~LightBuffer() {
+	// The video engine destroys the buffer before the OpenGL context goes away
+	if (_target.IsValid() == true || _falloff_texture != INVALID_TEXTURE_ID) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "the light buffer was not destroyed before its destructor was invoked" << endl;
+	}
+}
+
+
+
+bool LightBuffer::AddLight(float radius, float x, float y, const Color& color) {
+	if (radius <= 0.0f) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid radius argument: " << radius << endl;
+		return false;
+	}
+
+	const CoordSys& coord_sys = VideoManager->_current_context.coordinate_system;
+	float coord_width = coord_sys.GetRight() - coord_sys.GetLeft();
+	float coord_height = coord_sys.GetTop() - coord_sys.GetBottom();
+
+	LightSource light;
+	light.halo = NULL;
+	light.width = 2.0f * radius / fabs(coord_width);
+	light.height = 2.0f * radius / fabs(coord_height);
+	light.left = (x - coord_sys.GetLeft()) / coord_width - light.width * 0.5f;
+	light.bottom = (y - coord_sys.GetBottom()) / coord_height - light.height * 0.5f;
+	light.color = color;
+	return _AddSource(light);
+}
+
+
+
+bool LightBuffer::AddHalo(const ImageDescriptor& image, float x, float y, const Color& color) {
+	const Context& context = VideoManager->_current_context;
+	const CoordSys& coord_sys = context.coordinate_system;
+	float coord_width = coord_sys.GetRight() - coord_sys.GetLeft();
+	float coord_height = coord_sys.GetTop() - coord_sys.GetBottom();
+
+	// The same alignment that is applied to an image drawn at the draw cursor
+	float x_start = x + ((context.x_align + 1) * image.GetWidth()) * 0.5f * -coord_sys.GetHorizontalDirection();
+	float y_start = y + ((context.y_align + 1) * image.GetHeight()) * 0.5f * -coord_sys.GetVerticalDirection();
+	float x_end = x_start + image.GetWidth() * coord_sys.GetHorizontalDirection();
+	float y_end = y_start + image.GetHeight() * coord_sys.GetVerticalDirection();
+
+	// Coordinate systems that run from right to left or top to bottom reverse the order of the normalized edges
+	float normalized_x[2] = { (x_start - coord_sys.GetLeft()) / coord_width, (x_end - coord_sys.GetLeft()) / coord_width };
+	float normalized_y[2] = { (y_start - coord_sys.GetBottom()) / coord_height, (y_end - coord_sys.GetBottom()) / coord_height };
+
+	LightSource halo;
+	halo.halo = &image;
+	halo.left = min(normalized_x[0], normalized_x[1]);
+	halo.bottom = min(normalized_y[0], normalized_y[1]);
+	halo.width = fabs(normalized_x[1] - normalized_x[0]);
+	halo.height = fabs(normalized_y[1] - normalized_y[0]);
+	halo.color = color;
+	return _AddSource(halo);
+}
+
+
+
+void LightBuffer::Apply(const Color& ambient) {
+	if (_lights.empty() == true) {
+		// Without any lights, the ambient color alone is applied and no framebuffer is needed
+		if (ambient != Color::white)
+			_Composite(ambient, false);
+		return;
+	}
+
+	_LimitLights();
+
+	bool falloff_lights = false;
+	for (uint32 i = 0; i < _lights.size(); i++) {
+		if (_lights[i].halo == NULL) {
+			falloff_lights = true;
+			break;
+		}
+	}
+
+	if (falloff_lights == true && _falloff_texture == INVALID_TEXTURE_ID && _CreateFalloffTexture() == false) {
+		_lights.clear();
+		if (ambient != Color::white)
+			_Composite(ambient, false);
+		return;
+	}
+
+	// Lights only lift the scene from the ambient color towards its own colors, so while the ambient color is white
+	// the framebuffer would have no visible effect. The lights are then added directly onto the scene instead.
+	bool lights_in_target = false;
+	if (falloff_lights == true && ambient != Color::white)
+		lights_in_target = _AccumulateLights(ambient);
+
+	if (lights_in_target == true)
+		_Composite(Color::white, true);
+	else if (ambient != Color::white)
+		_Composite(ambient, false);
+
+	// Halos are always added on top of the lit scene, as they are when drawn without the light buffer
+	VideoManager->PushState();
+	VideoManager->SetCoordSys(0.0f, 1.0f, 0.0f, 1.0f);
+	if (lights_in_target == false)
+		_DrawFalloffLights();
+	_DrawHalos();
+	VideoManager->_FlushBatch();
+	VideoManager->PopState();
+
+	_lights.clear();
+} // void LightBuffer::Apply(const Color& ambient)
+
+
+
+void LightBuffer::Destroy() {
+	_lights.clear();
+
+	if (_target.IsValid() == true) {
+		VideoManager->_FlushBatch();
+		_target.Destroy();
+		VideoManager->_BindScreenTarget();
+	}
+
+	if (_falloff_texture != INVALID_TEXTURE_ID) {
+		TextureManager->_DeleteTexture(_falloff_texture);
+		_falloff_texture = INVALID_TEXTURE_ID;
+	}
+}
+
+
+
+bool LightBuffer::_AddSource(const LightSource& source) {
+	if (source.left + source.width < 0.0f || source.left > 1.0f || source.bottom + source.height < 0.0f || source.bottom > 1.0f)
+		return false;
+
+	_lights.push_back(source);
+	return true;
+}
+
+
+
+void LightBuffer::_LimitLights() {
+	if (_lights.size() <= VIDEO_MAX_LIGHTS)
+		return;
+
+	// The order of the lights that remain does not matter, since they are added together
+	nth_element(_lights.begin(), _lights.begin() + VIDEO_MAX_LIGHTS, _lights.end(), CompareLightDistance);
+	_lights.resize(VIDEO_MAX_LIGHTS);
+}
+
+
+
+bool LightBuffer::_CreateFalloffTexture() {
+	// The color is white throughout and the alpha falls off with the square of the distance from the center, which
+	// looks softer at the edge of the light than a linear falloff
+	vector<uint8> pixels(LIGHT_FALLOFF_TEXTURE_SIZE * LIGHT_FALLOFF_TEXTURE_SIZE * 4);
+	const float half_size = LIGHT_FALLOFF_TEXTURE_SIZE * 0.5f;
+	for (int32 y = 0; y < LIGHT_FALLOFF_TEXTURE_SIZE; y++) {
+		for (int32 x = 0; x < LIGHT_FALLOFF_TEXTURE_SIZE; x++) {
+			float dx = (x + 0.5f - half_size) / half_size;
+			float dy = (y + 0.5f - half_size) / half_size;
+			float intensity = max(0.0f, 1.0f - (dx * dx + dy * dy));
+			uint8* pixel = &pixels[(y * LIGHT_FALLOFF_TEXTURE_SIZE + x) * 4];
+			pixel[0] = 255;
+			pixel[1] = 255;
+			pixel[2] = 255;
+			pixel[3] = static_cast<uint8>(intensity * intensity * 255.0f);
+		}
+	}
+
+	VideoManager->_FlushBatch();
+	_falloff_texture = TextureManager->_CreateBlankGLTexture(LIGHT_FALLOFF_TEXTURE_SIZE, LIGHT_FALLOFF_TEXTURE_SIZE);
+	if (_falloff_texture == INVALID_TEXTURE_ID) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create the light falloff texture" << endl;
+		return false;
+	}
+
+	// The texture is always stretched well beyond its size, so it is filtered regardless of the smoothing setting
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, LIGHT_FALLOFF_TEXTURE_SIZE, LIGHT_FALLOFF_TEXTURE_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	return true;
+} // bool LightBuffer::_CreateFalloffTexture()
+
+
+
+bool LightBuffer::_AccumulateLights(const Color& ambient) {
+	if (RenderTarget::IsSupported() == false)
+		return false;
+
+	const ScreenRect& viewport = VideoManager->_current_context.viewport;
+	int32 width = max(1, (viewport.width + VIDEO_LIGHT_BUFFER_DIVISOR - 1) / VIDEO_LIGHT_BUFFER_DIVISOR);
+	int32 height = max(1, (viewport.height + VIDEO_LIGHT_BUFFER_DIVISOR - 1) / VIDEO_LIGHT_BUFFER_DIVISOR);
+
+	VideoManager->_FlushBatch();
+
+	if (_target.IsValid() == false || _target.GetWidth() != width || _target.GetHeight() != height) {
+		if (_target.Create(width, height) == false) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create the " << width << "x" << height << " light buffer" << endl;
+			VideoManager->_BindScreenTarget();
+			return false;
+		}
+
+		// The buffer is stretched over the viewport, so it must be interpolated to hide its lower resolution
+		TextureManager->_BindTexture(_target.GetTexture());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+	else {
+		_target.Bind();
+	}
+
+	VideoManager->PushState();
+	VideoManager->DisableScissoring();
+	VideoManager->_current_context.viewport = ScreenRect(0, 0, width, height);
+	glViewport(0, 0, width, height);
+	VideoManager->SetCoordSys(0.0f, 1.0f, 0.0f, 1.0f);
+
+	glClearColor(ambient[0], ambient[1], ambient[2], 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	_DrawFalloffLights();
+	VideoManager->_FlushBatch();
+
+	VideoManager->_BindScreenTarget();
+
+	// Restores the viewport, coordinate system, and scissoring of the screen
+	VideoManager->PopState();
+	return true;
+} // bool LightBuffer::_AccumulateLights(const Color& ambient)
+
+
+
+void LightBuffer::_DrawFalloffLights() {
+	vector<GLfloat> vertices;
+	vector<GLfloat> tex_coords;
+	vector<GLfloat> colors;
+	vertices.reserve(_lights.size() * 8);
+	tex_coords.reserve(_lights.size() * 8);
+	colors.reserve(_lights.size() * 16);
+
+	const GLfloat corner_coords[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+	for (uint32 i = 0; i < _lights.size(); i++) {
+		const LightSource& light = _lights[i];
+		if (light.halo != NULL)
+			continue;
+
+		for (uint32 corner = 0; corner < 4; corner++) {
+			vertices.push_back(light.left + corner_coords[corner * 2] * light.width);
+			vertices.push_back(light.bottom + corner_coords[corner * 2 + 1] * light.height);
+			tex_coords.push_back(corner_coords[corner * 2]);
+			tex_coords.push_back(corner_coords[corner * 2 + 1]);
+			colors.push_back(light.color[0]);
+			colors.push_back(light.color[1]);
+			colors.push_back(light.color[2]);
+			colors.push_back(light.color[3]);
+		}
+	}
+
+	if (vertices.empty() == false) {
+		VideoManager->_FlushBatch();
+		VideoManager->_SetGLBlendMode(2);
+		VideoManager->_SetGLTexturing(true);
+		VideoManager->_SetGLClientStates(true, true, true);
+		TextureManager->_BindTexture(_falloff_texture);
+
+		uint32 vertex_count = vertices.size() / 2;
+		glPushMatrix();
+		glLoadIdentity();
+		glVertexPointer(2, GL_FLOAT, 0, &vertices[0]);
+		glTexCoordPointer(2, GL_FLOAT, 0, &tex_coords[0]);
+		glColorPointer(4, GL_FLOAT, 0, &colors[0]);
+		glDrawArrays(GL_QUADS, 0, vertex_count);
+		VideoManager->_RecordDraw(GL_QUADS, &vertices[0], GL_FLOAT, vertex_count);
+		glPopMatrix();
+	}
+} // void LightBuffer::_DrawFalloffLights()
+
+
+
+void LightBuffer::_DrawHalos() {
+	// The halos are drawn as ordinary images, stretched to the area they covered when they were added
+	VideoManager->SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_BOTTOM, VIDEO_X_NOFLIP, VIDEO_Y_NOFLIP, VIDEO_BLEND_ADD, 0);
+	for (uint32 i = 0; i < _lights.size(); i++) {
+		const LightSource& halo = _lights[i];
+		if (halo.halo == NULL || halo.halo->GetWidth() <= 0.0f || halo.halo->GetHeight() <= 0.0f)
+			continue;
+
+		VideoManager->PushMatrix();
+		VideoManager->Move(halo.left, halo.bottom);
+		VideoManager->Scale(halo.width / halo.halo->GetWidth(), halo.height / halo.halo->GetHeight());
+		halo.halo->Draw(halo.color);
+		VideoManager->PopMatrix();
+	}
+} // void LightBuffer::_DrawHalos()
+
+
+
+void LightBuffer::_Composite(const Color& color, bool use_target) {
+	const GLfloat vertices[] = {
+		0.0f, 0.0f,
+		1.0f, 0.0f,
+		1.0f, 1.0f,
+		0.0f, 1.0f
+	};
+
+	// Only the lower left portion of the target's power-of-two texture holds the lights
+	GLfloat s1 = 1.0f;
+	GLfloat t1 = 1.0f;
+	if (use_target == true) {
+		s1 = static_cast<GLfloat>(_target.GetWidth()) / static_cast<GLfloat>(_target.GetTextureWidth());
+		t1 = static_cast<GLfloat>(_target.GetHeight()) / static_cast<GLfloat>(_target.GetTextureHeight());
+	}
+	const GLfloat tex_coords[] = {
+		0.0f, 0.0f,
+		s1, 0.0f,
+		s1, t1,
+		0.0f, t1
+	};
+
+	VideoManager->_FlushBatch();
+	VideoManager->PushState();
+	VideoManager->SetCoordSys(0.0f, 1.0f, 0.0f, 1.0f);
+
+	VideoManager->_SetGLBlendMode(4);
+	VideoManager->_SetGLTexturing(use_target);
+	VideoManager->_SetGLClientStates(true, use_target, false);
+	if (use_target == true) {
+		TextureManager->_BindTexture(_target.GetTexture());
+		glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+	}
+	else {
+		glColor4f(color[0], color[1], color[2], 1.0f);
+	}
+
+	glPushMatrix();
+	glLoadIdentity();
+	glVertexPointer(2, GL_FLOAT, 0, vertices);
+	glTexCoordPointer(2, GL_FLOAT, 0, tex_coords);
+	glDrawArrays(GL_QUADS, 0, 4);
+	VideoManager->_RecordDraw(GL_QUADS, vertices, GL_FLOAT, 4);
+	glPopMatrix();
+
+	VideoManager->PopState();
+
+	if (VideoManager->CheckGLError() == true) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "an OpenGL error occurred: " << VideoManager->CreateGLErrorString() << endl;
+	}
+} // void LightBuffer::_Composite(const Color& color, bool use_target)
+
+} // namespace private_video
+
+} // namespace hoa_video
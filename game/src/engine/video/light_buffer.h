@@ -0,0 +1,184 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    light_buffer.h
+*** \author  agent, agent@local
+*** \brief   Header file for the LightBuffer class
+***
+*** The light buffer collects the lights and halos drawn during a frame and
+*** applies them to the scene all at once, by accumulating the lights into a
+*** small offscreen texture that is stretched over the screen.
+*** ***************************************************************************/
+
+#ifndef __LIGHT_BUFFER_HEADER__
+#define __LIGHT_BUFFER_HEADER__
+
+#include "defs.h"
+#include "utils.h"
+
+#include "color.h"
+#include "render_target.h"
+
+namespace hoa_video {
+
+//! \brief The maximum number of lights and halos that are applied to a single frame
+const uint32 VIDEO_MAX_LIGHTS = 64;
+
+//! \brief The width and height of the screen are divided by this amount to determine the size of the light buffer
+const int32 VIDEO_LIGHT_BUFFER_DIVISOR = 4;
+
+namespace private_video {
+
+/** ****************************************************************************
+*** \brief A light or halo that is waiting to be applied to the scene
+***
+*** The area of the light is stored in normalized coordinates, where (0, 0) is
+*** the bottom left corner of the viewport and (1, 1) is its top right corner,
+*** so that it does not depend on the coordinate system it was drawn in.
+*** ***************************************************************************/
+class LightSource {
+public:
+	//! \brief The image of a halo, or NULL for a light that is drawn with the buffer's falloff texture
+	const ImageDescriptor* halo;
+
+	//! \brief The bottom left corner of the area covered by the light
+	float left, bottom;
+
+	//! \brief The dimensions of the area covered by the light
+	float width, height;
+
+	//! \brief The color of the light
+	Color color;
+}; // class LightSource
+
+
+/** ****************************************************************************
+*** \brief Accumulates the lights of a frame and applies them to the scene in one pass
+***
+*** Lights and halos are not drawn when they are added, but held until Apply() is
+*** called. When the ambient light color is not white, Apply() fills a
+*** framebuffer that is a fraction of the size of the viewport with the ambient
+*** color, adds every light to it, and then multiplies the scene by the
+*** framebuffer with a single quad. Since lighting is smooth, the reduced
+*** resolution is not noticeable and each light covers only a fraction of the
+*** pixels it would cover on the screen.
+***
+*** A light can at most lift the scene back to its full brightness, so while the
+*** ambient color is white the framebuffer would have no effect. The lights are
+*** then added directly onto the scene instead, and no framebuffer pass is paid
+*** for. Halos are always added directly onto the scene after the ambient color
+*** and lights have been applied, the same as when they are drawn normally.
+***
+*** Lights that lie entirely outside of the viewport are discarded when they are
+*** added. If more than VIDEO_MAX_LIGHTS remain, those furthest from the center
+*** of the viewport are discarded.
+***
+*** If framebuffer objects are not supported, the ambient color and lights are
+*** drawn directly onto the scene instead. Lights then brighten the scene
+*** additively rather than lifting it from the ambient color, which is close
+*** enough for the purpose.
+***
+*** \note The images of halos are held by pointer, so they must remain valid
+*** until Apply() or Clear() is called.
+*** ***************************************************************************/
+class LightBuffer {
+public:
+	LightBuffer();
+
+	~LightBuffer();
+
+	/** \brief Adds a light with a smooth circular falloff
+	*** \param radius The radius of the light, in units of the current coordinate system
+	*** \param x The x coordinate of the center of the light
+	*** \param y The y coordinate of the center of the light
+	*** \param color The color of the light at its center
+	*** \return False if the light was discarded because it lies outside of the viewport
+	**/
+	bool AddLight(float radius, float x, float y, const Color& color);
+
+	/** \brief Adds a halo, whose image is added onto the scene as it is
+	*** \param image The image of the halo
+	*** \param x The x coordinate of the draw cursor for the image
+	*** \param y The y coordinate of the draw cursor for the image
+	*** \param color The color to modulate the image by
+	*** \return False if the halo was discarded because it lies outside of the viewport
+	*** The image is aligned to the draw cursor according to the current draw flags, as it would be if drawn normally.
+	**/
+	bool AddHalo(const ImageDescriptor& image, float x, float y, const Color& color);
+
+	/** \brief Applies the ambient color and all added lights to the scene and then removes the lights
+	*** \param ambient The color of the scene where no light falls on it
+	*** Nothing is drawn if no lights were added and the ambient color is white.
+	**/
+	void Apply(const Color& ambient);
+
+	//! \brief Removes all added lights without applying them
+	void Clear()
+		{ _lights.clear(); }
+
+	//! \brief Returns the number of lights and halos waiting to be applied
+	uint32 GetNumberLights() const
+		{ return _lights.size(); }
+
+	/** \brief Deletes the framebuffer and falloff texture
+	*** This must be called while the OpenGL context that created them is still active. They are created again the
+	*** next time they are needed.
+	**/
+	void Destroy();
+
+private:
+	//! \brief The lights and halos waiting to be applied
+	std::vector<LightSource> _lights;
+
+	//! \brief The reduced resolution framebuffer that lights are accumulated in
+	RenderTarget _target;
+
+	//! \brief The OpenGL id of the texture that lights are drawn with, or INVALID_TEXTURE_ID if it was not created
+	GLuint _falloff_texture;
+
+	/** \brief Adds a light or halo if it lies within the viewport
+	*** \param source The light to add
+	*** \return False if the light lies outside of the viewport
+	**/
+	bool _AddSource(const LightSource& source);
+
+	//! \brief Discards the lights furthest from the center of the viewport until no more than VIDEO_MAX_LIGHTS remain
+	void _LimitLights();
+
+	//! \brief Creates the texture that lights are drawn with, which fades from opaque at its center to transparent at its edge
+	bool _CreateFalloffTexture();
+
+	/** \brief Creates the framebuffer if needed and accumulates the ambient color and lights in it
+	*** \param ambient The color that the framebuffer is cleared to
+	*** \return False if the framebuffer could not be used
+	*** Halos are not drawn into the framebuffer.
+	**/
+	bool _AccumulateLights(const Color& ambient);
+
+	/** \brief Draws all lights that use the falloff texture additively with a single draw call
+	*** The lights are drawn in a coordinate system that spans the viewport from 0 to 1.
+	**/
+	void _DrawFalloffLights();
+
+	//! \brief Draws all halos additively in a coordinate system that spans the viewport from 0 to 1
+	void _DrawHalos();
+
+	/** \brief Multiplies the contents of the viewport by a color or by the contents of the framebuffer
+	*** \param color The color to multiply by, which is ignored if the framebuffer is used
+	*** \param use_target If true, the viewport is multiplied by the framebuffer stretched over it
+	**/
+	void _Composite(const Color& color, bool use_target);
+}; // class LightBuffer
+
+} // namespace private_video
+
+} // namespace hoa_video
+
+#endif // __LIGHT_BUFFER_HEADER__
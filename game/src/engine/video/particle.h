@@ -12,16 +12,19 @@
  * \author  Raj Sharma, roos@allacrost.org
  * \brief   Header file for particle data
  *
- * This file contains structure(s) for representing a single particle. In theory,
- * we should be able to just have one structure which holds all properties for
- * a particle, but in fact we have two: one for the position, and one for everything
- * else. The reason is that having the positions separated is more efficient
- * for rendering.
+ * This file contains the structures for representing particles. The properties
+ * of the particles of a system are not kept together in one structure per
+ * particle, but in a separate array for each property. The update of a system
+ * then runs over one property of every particle at a time, which lets several
+ * particles be processed at once with vector instructions, and lets the
+ * renderer read positions and colors without touching any other data.
  *****************************************************************************/
 
 #ifndef __PARTICLE_HEADER__
 #define __PARTICLE_HEADER__
 
+#include <vector>
+
 #include "defs.h"
 #include "utils.h"
 #include "color.h"
@@ -69,101 +72,180 @@ public:
 
 
 /*!***************************************************************************
- *  \brief this is the structure we use to represent a particle
+ *  \brief the properties of a particle that describe its progress through the
+ *         keyframes. These are only read by the keyframe update, so they are
+ *         kept apart from the properties that the rest of the update uses.
  *****************************************************************************/
 
+class ParticleKeyframeState
+{
+public:
 
-class Particle
+	//! property variations
+	float current_size_variation_x;
+	float current_size_variation_y;
+	float next_size_variation_x;
+	float next_size_variation_y;
+	float current_rotation_speed_variation;
+	float next_rotation_speed_variation;
+	Color current_color_variation;
+	Color next_color_variation;
+
+	//! keep track of current and next keyframes
+	ParticleKeyframe *current_keyframe;
+	ParticleKeyframe *next_keyframe;
+
+	//! time of the current keyframe, and one over the time until the next keyframe, which
+	//! turn the particle's scaled time into the interpolation factor between the two
+	float keyframe_start_time;
+	float keyframe_inverse_duration;
+
+	//! keyframed property values (including variations) at the current keyframe, and
+	//! how much they change between the current and the next keyframe
+	float start_size_x;
+	float start_size_y;
+	float start_rotation_speed;
+	Color start_color;
+	float delta_size_x;
+	float delta_size_y;
+	float delta_rotation_speed;
+	Color delta_color;
+};
+
+
+/*!***************************************************************************
+ *  \brief this is the structure we use to represent the particles of a system.
+ *         Each member holds one property, and element i of every member
+ *         belongs to particle i.
+ *****************************************************************************/
+
+class ParticleArrays
 {
 public:
 
+	/*!
+	 *  \brief changes the number of particles that the arrays can hold
+	 * \param size the new number of particles
+	 */
+	void Resize(int32 size)
+	{
+		x.resize(size); y.resize(size);
+		size_x.resize(size); size_y.resize(size);
+		velocity_x.resize(size); velocity_y.resize(size);
+		combined_velocity_x.resize(size); combined_velocity_y.resize(size);
+		color.resize(size);
+		rotation_angle.resize(size); rotation_speed.resize(size); rotation_direction.resize(size);
+		time.resize(size); lifetime.resize(size);
+		wave_length_coefficient.resize(size); wave_half_amplitude.resize(size);
+		acceleration_x.resize(size); acceleration_y.resize(size);
+		tangential_acceleration.resize(size); radial_acceleration.resize(size);
+		wind_velocity_x.resize(size); wind_velocity_y.resize(size);
+		damping.resize(size);
+		keyframe_state.resize(size);
+	}
+
+	/*!
+	 *  \brief copies all properties of one particle over those of another
+	 * \param src the particle to copy from
+	 * \param dest the particle to copy to
+	 */
+	void Move(int32 src, int32 dest)
+	{
+		x[dest] = x[src]; y[dest] = y[src];
+		size_x[dest] = size_x[src]; size_y[dest] = size_y[src];
+		velocity_x[dest] = velocity_x[src]; velocity_y[dest] = velocity_y[src];
+		combined_velocity_x[dest] = combined_velocity_x[src]; combined_velocity_y[dest] = combined_velocity_y[src];
+		color[dest] = color[src];
+		rotation_angle[dest] = rotation_angle[src]; rotation_speed[dest] = rotation_speed[src]; rotation_direction[dest] = rotation_direction[src];
+		time[dest] = time[src]; lifetime[dest] = lifetime[src];
+		wave_length_coefficient[dest] = wave_length_coefficient[src]; wave_half_amplitude[dest] = wave_half_amplitude[src];
+		acceleration_x[dest] = acceleration_x[src]; acceleration_y[dest] = acceleration_y[src];
+		tangential_acceleration[dest] = tangential_acceleration[src]; radial_acceleration[dest] = radial_acceleration[src];
+		wind_velocity_x[dest] = wind_velocity_x[src]; wind_velocity_y[dest] = wind_velocity_y[src];
+		damping[dest] = damping[src];
+		keyframe_state[dest] = keyframe_state[src];
+	}
+
+	//! \brief releases the memory held by all of the arrays
+	void Clear()
+		{ Resize(0); }
+
 	//! position
-	float  x;
-	float  y;
-	
+	std::vector<float> x;
+	std::vector<float> y;
+
 	//! size
-	float  size_x;
-	float  size_y;
-	
+	std::vector<float> size_x;
+	std::vector<float> size_y;
+
 	//! velocity
-	float  velocity_x;
-	float  velocity_y;
-	
+	std::vector<float> velocity_x;
+	std::vector<float> velocity_y;
+
 	//! store the combined velocity (particle + wind + wave) so we only have
 	//! to calculate it once
-	float combined_velocity_x;
-	float combined_velocity_y;
-	
+	std::vector<float> combined_velocity_x;
+	std::vector<float> combined_velocity_y;
+
 	//! color
-	Color  color;
-		
+	std::vector<Color> color;
+
 	//! current rotation angle
-	float  rotation_angle;
-	
+	std::vector<float> rotation_angle;
+
 	//! rotation speed
-	float  rotation_speed;
-	
+	std::vector<float> rotation_speed;
+
+	//! when a particle is created, it is given a rotation direction: either
+	//! 1 (clockwise) or -1 (counterclockwise)
+	std::vector<float> rotation_direction;
+
 	//! seconds since particle was spawned
-	float  time;
-	
+	std::vector<float> time;
+
 	//! lifetime (when the particle is supposed to die)
-	float  lifetime;
-	
+	std::vector<float> lifetime;
+
 	//! this is 2 * pi / wavelength. The reason we store this weird
 	//! number instead of the wavelength is because that's what we
 	//! will ultimately plug into the sin function
-	float wave_length_coefficient;	
-	
+	std::vector<float> wave_length_coefficient;
+
 	//! half the amplitude of the wave. We store half the amplitude
 	//! instead of the whole amplitude because that's what gets multiplied
 	//! with the sin function
-	float wave_half_amplitude;
+	std::vector<float> wave_half_amplitude;
 
 	//! acceleration, i.e. change in velocity per second. The most common use
 	//! for this is for simulating gravity. If you have multiple constant
 	//! forces acting on particles, then this vector should be the sum of
 	//! those forces.
-	float acceleration_x;
-	float acceleration_y;
-	
+	std::vector<float> acceleration_x;
+	std::vector<float> acceleration_y;
+
 	//! tangential acceleration- just like normal acceleration, except it
 	//! is applied in the tangent direction. positive = clockwise.
-	float tangential_acceleration;
-	
+	std::vector<float> tangential_acceleration;
+
 	//! radial acceleration- acceleration towards (negative) or away (positive)
 	//! from an attractor. Note that the default attractor is the emitter position.
 	//! The client can set an attractor for the entire effect by calling
 	//! ParticleEffect::SetAttractor(x,y)
-	float radial_acceleration;
-	
+	std::vector<float> radial_acceleration;
+
 	//! wind velocity. this gets added to the particle's velocity each frame.
 	//! note that different particles might also have a slightly different wind
-	//! velocity, if the system has some wind velocity variation	
-	float wind_velocity_x;
-	float wind_velocity_y;
-	
+	//! velocity, if the system has some wind velocity variation
+	std::vector<float> wind_velocity_x;
+	std::vector<float> wind_velocity_y;
+
 	//! damping- the particle's velocity gets multiplied by this value each second.
 	//! So for example, a damping of .6 means that a particle slows down by 40% each
 	//! second.
-	float damping;	
-	
-	//! when a particle is created, it is given a rotation direction: either
-	//! 1 (clockwise) or -1 (counterclockwise)
-	float rotation_direction;
-		
-	//! property variations	
-	float current_size_variation_x;
-	float current_size_variation_y;
-	float next_size_variation_x;
-	float next_size_variation_y;	
-	float current_rotation_speed_variation;
-	float next_rotation_speed_variation;	
-	Color current_color_variation;
-	Color next_color_variation;
-	
-	//! keep track of current and next keyframes
-	ParticleKeyframe *current_keyframe;
-	ParticleKeyframe *next_keyframe;
+	std::vector<float> damping;
+
+	//! keyframe properties, which are not needed by the update of every frame
+	std::vector<ParticleKeyframeState> keyframe_state;
 };
 
 }
@@ -21,6 +21,17 @@ namespace hoa_video
 {
 
 
+//-----------------------------------------------------------------------------
+// ParticleEffectDef
+//-----------------------------------------------------------------------------
+
+ParticleEffectDef::~ParticleEffectDef() {
+	for (list<ParticleSystemDef *>::iterator iSystem = _systems.begin(); iSystem != _systems.end(); ++iSystem) {
+		delete *iSystem;
+	}
+}
+
+
 //-----------------------------------------------------------------------------
 // ParticleEffect
 //-----------------------------------------------------------------------------
@@ -70,25 +81,25 @@ bool ParticleEffect::_Draw() {
 
 
 //-----------------------------------------------------------------------------
-// Update: updates particle effect. Called by ParticleManager, not by user.
+// _PrepareUpdate: removes dead systems, and adds a job to update each of the
+//                 other systems. Called by ParticleManager, not by user.
 //-----------------------------------------------------------------------------
 
-bool ParticleEffect::_Update(float frame_time) {
+void ParticleEffect::_PrepareUpdate(float frame_time, vector<ParticleSystemJob> &jobs) {
 	_age += frame_time;
 	_num_particles = 0;
 
 	if (!_alive)
-		return true;
+		return;
 
-	bool success = true;
-
-	private_video::EffectParameters effect_parameters;
-	effect_parameters.orientation = _orientation;
+	ParticleSystemJob job;
+	job.params.orientation = _orientation;
 
 	// note we subtract the effect position to put the attractor point in effect
 	// space instead of screen space
-	effect_parameters.attractor_x = _attractor_x - _x;
-	effect_parameters.attractor_y = _attractor_y - _y;
+	job.params.attractor_x = _attractor_x - _x;
+	job.params.attractor_y = _attractor_y - _y;
+	job.success = true;
 
 	list<ParticleSystem *>::iterator iSystem = _systems.begin();
 
@@ -101,23 +112,30 @@ bool ParticleEffect::_Update(float frame_time) {
 				_alive = false;
 		}
 		else {
-			if (!(*iSystem)->Update(frame_time, effect_parameters)) {
-				success = false;
-				if(VIDEO_DEBUG)
-					cerr << "VIDEO ERROR: failed to update system in ParticleEffect::_Update()" << endl;
-			}
-
-			_num_particles += (*iSystem)->GetNumParticles();
+			job.system = *iSystem;
+			jobs.push_back(job);
 			++iSystem;
 		}
 	}
+}
 
-	return success;
+
+//-----------------------------------------------------------------------------
+// _FinishUpdate: counts the particles of the updated systems. Called by
+//                ParticleManager, not by user.
+//-----------------------------------------------------------------------------
+
+void ParticleEffect::_FinishUpdate() {
+	_num_particles = 0;
+
+	for (list<ParticleSystem *>::iterator iSystem = _systems.begin(); iSystem != _systems.end(); ++iSystem) {
+		_num_particles += (*iSystem)->GetNumParticles();
+	}
 }
 
 
 //-----------------------------------------------------------------------------
-// Destroy: destroys the effect. Called by ParticleManager during _Update(), if
+// Destroy: destroys the effect. Called by ParticleManager during Update(), if
 //          this effect is not alive (i.e. IsAlive() returns false)
 //-----------------------------------------------------------------------------
 
@@ -42,6 +42,7 @@ namespace hoa_video
 
 using private_video::ParticleSystem;
 using private_video::ParticleSystemDef;
+using private_video::ParticleSystemJob;
 
 /*!***************************************************************************
  *  \brief particle effect definition, just consists of each of its subsystems'
@@ -52,6 +53,9 @@ using private_video::ParticleSystemDef;
 class ParticleEffectDef
 {
 public:
+
+	//! deletes the system definitions
+	~ParticleEffectDef();
 	
 	//! list of system definitions
 	std::list<ParticleSystemDef *> _systems;
@@ -172,12 +176,20 @@ private:
 
 
 	/*!
-	 *  \brief updates the effect. This is private so that only the ParticleManager class
-	 *         can update effects.
-	 * \param the new frame time
-	 * \return success/failure
-	 */			
-	bool _Update(float frame_time);
+	 *  \brief begins updating the effect. Systems which have died are removed, and a job
+	 *         is added for each remaining system. This is private so that only the
+	 *         ParticleManager class can update effects.
+	 * \param frame_time the new frame time
+	 * \param jobs the list to add the update jobs of the effect's systems to
+	 */
+	void _PrepareUpdate(float frame_time, std::vector<ParticleSystemJob> &jobs);
+
+
+	/*!
+	 *  \brief finishes updating the effect, once the jobs added by _PrepareUpdate()
+	 *         have all been done
+	 */
+	void _FinishUpdate();
 
 
 	/*!
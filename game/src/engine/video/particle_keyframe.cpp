@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "particle_keyframe.h"
+
+using namespace std;
+
+namespace hoa_video
+{
+
+namespace private_video
+{
+
+
+//-----------------------------------------------------------------------------
+// ParticleKeyframeTable
+//-----------------------------------------------------------------------------
+
+void ParticleKeyframeTable::Build(const vector<ParticleKeyframe *> &keyframes)
+{
+	_times.resize(keyframes.size());
+	for(size_t k = 0; k < keyframes.size(); ++k)
+		_times[k] = keyframes[k]->time;
+
+	_entries.assign(PARTICLE_KEYFRAME_TABLE_SIZE, 0);
+	if(_times.empty())
+		return;
+
+	// the start of each entry is an exact multiple of the entry size, which FindKeyframe() relies
+	// on so that the keyframe it starts searching from is never past the correct one
+	uint32 k = 0;
+	for(uint32 entry = 0; entry < PARTICLE_KEYFRAME_TABLE_SIZE; ++entry)
+	{
+		float entry_start = static_cast<float>(entry) / static_cast<float>(PARTICLE_KEYFRAME_TABLE_SIZE);
+		while(k + 1 < _times.size() && _times[k + 1] <= entry_start)
+			++k;
+		_entries[entry] = k;
+	}
+}
+
+
+}  // namespace private_video
+}  // namespace hoa_video
@@ -82,6 +82,60 @@ public:
 };
 
 
+//! number of entries in a keyframe table. Each entry covers an equal part of a particle's lifetime
+const uint32 PARTICLE_KEYFRAME_TABLE_SIZE = 64;
+
+
+/*!***************************************************************************
+ *  \brief lookup table which finds the keyframe that a particle is on from its
+ *         scaled time (0.0 to 1.0), without searching through every keyframe.
+ *         The table is built once for each system definition, after its
+ *         keyframes have been loaded. Each entry holds the keyframe that is
+ *         current at the start of the entry's part of the lifetime, so at most
+ *         a few keyframes need to be stepped over to find the exact one.
+ *****************************************************************************/
+
+class ParticleKeyframeTable
+{
+public:
+
+	/*!
+	 *  \brief builds the table from a list of keyframes
+	 * \param keyframes the keyframes, which must be sorted by time
+	 */
+	void Build(const std::vector<ParticleKeyframe *> &keyframes);
+
+
+	/*!
+	 *  \brief finds the keyframe that is current at a given time
+	 * \param scaled_time the time, from 0.0 to 1.0
+	 * \return the index of the last keyframe whose time is not after scaled_time,
+	 *         or zero if every keyframe is after it
+	 */
+	uint32 FindKeyframe(float scaled_time) const
+	{
+		int32 entry = static_cast<int32>(scaled_time * static_cast<float>(PARTICLE_KEYFRAME_TABLE_SIZE));
+		if(entry < 0)
+			entry = 0;
+		else if(entry >= static_cast<int32>(PARTICLE_KEYFRAME_TABLE_SIZE))
+			entry = PARTICLE_KEYFRAME_TABLE_SIZE - 1;
+
+		uint32 k = _entries[entry];
+		while(k + 1 < _times.size() && _times[k + 1] <= scaled_time)
+			++k;
+		return k;
+	}
+
+private:
+
+	//! the keyframe that is current at the start of each entry
+	std::vector<uint32> _entries;
+
+	//! the time of each keyframe
+	std::vector<float> _times;
+};
+
+
 }  // namespace private_video
 }  // namespace hoa_video
 
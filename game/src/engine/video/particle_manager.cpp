@@ -7,8 +7,11 @@
 // See http://www.gnu.org/copyleft/gpl.html for details.
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <thread>
+
 #include "video.h"
 #include "script.h"
+#include "system.h"
 
 #include "particle_manager.h"
 #include "particle_effect.h"
@@ -27,7 +30,52 @@ namespace private_video {
 // ParticleManager class methods
 // -----------------------------------------------------------------------------
 
-ParticleEffectDef* ParticleManager::LoadEffect(const string& filename) {
+ParticleManager::ParticleManager() :
+	_current_id(0),
+	_num_particles(0),
+	_job_mutex(SDL_CreateMutex()),
+	_start_semaphore(SDL_CreateSemaphore(0)),
+	_finished_semaphore(SDL_CreateSemaphore(0)),
+	_next_job(0),
+	_job_frame_time(0.0f),
+	_shutdown(false)
+{}
+
+
+
+ParticleManager::~ParticleManager() {
+	_StopThreads();
+	SDL_DestroySemaphore(_finished_semaphore);
+	SDL_DestroySemaphore(_start_semaphore);
+	SDL_DestroyMutex(_job_mutex);
+}
+
+
+
+void ParticleManager::Initialize() {
+	_shutdown = false;
+
+#if (THREAD_TYPE == SDL_THREADS)
+	// The number of cores is reported as zero when it can not be determined, in which case no threads are created
+	uint32 num_cores = std::thread::hardware_concurrency();
+	uint32 num_threads = (num_cores > 1) ? num_cores - 1 : 0;
+	if (num_threads > PARTICLE_MAX_WORKER_THREADS)
+		num_threads = PARTICLE_MAX_WORKER_THREADS;
+
+	for (uint32 i = 0; i < num_threads; i++) {
+		SDL_Thread* thread = SDL_CreateThread(_WorkerThread, this);
+		if (thread == NULL) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create a particle update thread: " << SDL_GetError() << endl;
+			break;
+		}
+		_threads.push_back(thread);
+	}
+#endif
+}
+
+
+
+ParticleEffectDef* ParticleManager::_ParseEffect(const string& filename) {
 	ReadScriptDescriptor script;
 
 	if (script.OpenFile(filename) == false) {
@@ -184,6 +232,7 @@ ParticleEffectDef* ParticleManager::LoadEffect(const string& filename) {
 			script.CloseTable();
 		}
 		script.CloseTable(); // close the keyframes table
+		system_definition->keyframe_table.Build(system_definition->keyframes);
 
 		// Read the animation frames and times
 		script.ReadStringVector("animation_frames", system_definition->animation_frame_filenames);
@@ -220,6 +269,11 @@ ParticleEffectDef* ParticleManager::LoadEffect(const string& filename) {
 			}
 		}
 
+		// Load the animation frames now, so that creating a system from the definition does not need to load any images
+		for (uint32 i = 0; i < system_definition->animation_frame_filenames.size(); i++) {
+			system_definition->animation.AddFrame(system_definition->animation_frame_filenames[i], system_definition->animation_frame_times[i]);
+		}
+
 		// Read the remaining particle system data
 		system_definition->enabled = script.ReadBool("enabled");
 		system_definition->blend_mode = script.ReadInt("blend_mode");
@@ -291,7 +345,40 @@ ParticleEffectDef* ParticleManager::LoadEffect(const string& filename) {
 	script.CloseFile(); // close the systems table
 
 	return effect_definition;
-} // ParticleEffectDef* ParticleManager::LoadEffect(const string& filename)
+} // ParticleEffectDef* ParticleManager::_ParseEffect(const string& filename)
+
+
+
+const ParticleEffectDef* ParticleManager::LoadEffect(const string& filename, bool reload) {
+	map<string, ParticleEffectDef*>::iterator cached = _effect_defs.find(filename);
+	if (cached != _effect_defs.end()) {
+		if (reload == false)
+			return cached->second;
+
+		// Effects that were created from the old definition may still be active, so it can not be deleted yet
+		if (cached->second != NULL)
+			_retired_effect_defs.push_back(cached->second);
+	}
+
+	// A definition that failed to load is cached as NULL, so that the file is not read again every time the effect is added
+	ParticleEffectDef* definition = _ParseEffect(filename);
+	_effect_defs[filename] = definition;
+	return definition;
+}
+
+
+
+uint32 ParticleManager::PreloadEffects(const string& directory) {
+	uint32 num_loaded = 0;
+
+	vector<string> filenames = ListDirectory(directory, ".lua");
+	for (uint32 i = 0; i < filenames.size(); i++) {
+		if (LoadEffect(directory + "/" + filenames[i]) != NULL)
+			++num_loaded;
+	}
+
+	return num_loaded;
+}
 
 
 
@@ -312,6 +399,14 @@ ParticleEffectID ParticleManager::AddEffect(const ParticleEffectDef* definition,
 		return VIDEO_INVALID_EFFECT;
 	}
 
+	// Each system is given its own random number stream, which depends only on the effect's ID and the system's position
+	// in the effect. This way the same effects always produce the same particles, regardless of how the systems are updated.
+	uint32 system_index = 0;
+	for (list<ParticleSystem*>::iterator i = effect->_systems.begin(); i != effect->_systems.end(); ++i) {
+		(*i)->SeedRandom(static_cast<uint32>(_current_id) * 256 + system_index);
+		++system_index;
+	}
+
 	effect->Move(x, y);
 	_effects[_current_id] = effect;
 	++_current_id;
@@ -325,8 +420,9 @@ ParticleEffectID ParticleManager::AddEffect(const ParticleEffectDef* definition,
 bool ParticleManager::Update(int32 frame_time) {
 	float frame_time_seconds = static_cast<float>(frame_time) / 1000.0f;
 	bool success = true;
-	_num_particles = 0;
 
+	// Effects and systems are only ever created or removed here on the main thread, before any jobs are handed out
+	_jobs.clear();
 	for (map<ParticleEffectID, ParticleEffect*>::iterator i = _effects.begin(); i != _effects.end();) {
 		// Remove any particle effects that have completed their life cycle
 		if ((i->second)->IsAlive() == false) {
@@ -335,22 +431,50 @@ bool ParticleManager::Update(int32 frame_time) {
 			_effects.erase(finished_effect);
 		}
 		else {
-			if ((i->second)->_Update(frame_time_seconds) == false) {
-				success = false;
-				IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to update particle effect with ID #" << i->first << endl;
-			}
-
-			_num_particles += i->second->GetNumParticles();
+			(i->second)->_PrepareUpdate(frame_time_seconds, _jobs);
 			++i;
 		}
 	}
 
+	// The threads are only worth waking up when there are several systems which had enough particles between them last frame
+	_next_job = 0;
+	_job_frame_time = frame_time_seconds;
+	uint32 num_threads = 0;
+	if (_jobs.size() > 1 && _num_particles >= PARTICLE_PARALLEL_UPDATE_THRESHOLD) {
+		num_threads = _threads.size();
+		if (num_threads > _jobs.size() - 1)
+			num_threads = _jobs.size() - 1;
+	}
+
+	for (uint32 i = 0; i < num_threads; i++) {
+		SDL_SemPost(_start_semaphore);
+	}
+	_DoJobs();
+	for (uint32 i = 0; i < num_threads; i++) {
+		SDL_SemWait(_finished_semaphore);
+	}
+
+	for (uint32 i = 0; i < _jobs.size(); i++) {
+		if (_jobs[i].success == false) {
+			success = false;
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to update a particle system" << endl;
+		}
+	}
+	_jobs.clear();
+
+	_num_particles = 0;
+	for (map<ParticleEffectID, ParticleEffect*>::iterator i = _effects.begin(); i != _effects.end(); ++i) {
+		(i->second)->_FinishUpdate();
+		_num_particles += (i->second)->GetNumParticles();
+	}
+
 	return success;
-}
+} // bool ParticleManager::Update(int32 frame_time)
 
 
 
 bool ParticleManager::Draw() {
+	VideoManager->BeginRenderPass(VIDEO_RENDER_PASS_PARTICLES);
 	VideoManager->PushState();
 	// NOTE: the particle manager is using inverted y coordinates compared to how most of the rest of the code aligns the y axis
 	VideoManager->SetCoordSys(CoordSys(0.0f, 1024.0f, 768.0f, 0.0f));
@@ -369,6 +493,7 @@ bool ParticleManager::Draw() {
 	}
 
 	VideoManager->PopState();
+	VideoManager->EndRenderPass();
 	return success;
 }
 
@@ -393,12 +518,25 @@ ParticleEffect* ParticleManager::GetEffect(ParticleEffectID id) {
 
 
 void ParticleManager::Destroy() {
+	_StopThreads();
+
 	for (map<ParticleEffectID, ParticleEffect*>::iterator i = _effects.begin(); i != _effects.end(); ++i) {
 		(i->second)->_Destroy();
 		delete (i->second);
 	}
 
 	_effects.clear();
+
+	// The definitions are deleted last, since the effects refer to them
+	for (map<string, ParticleEffectDef*>::iterator i = _effect_defs.begin(); i != _effect_defs.end(); ++i) {
+		delete (i->second);
+	}
+	_effect_defs.clear();
+
+	for (uint32 i = 0; i < _retired_effect_defs.size(); i++) {
+		delete _retired_effect_defs[i];
+	}
+	_retired_effect_defs.clear();
 }
 
 
@@ -447,6 +585,61 @@ ParticleEffect *ParticleManager::_CreateEffect(const ParticleEffectDef *definiti
 
 
 
+void ParticleManager::_StopThreads() {
+	SDL_mutexP(_job_mutex);
+	_shutdown = true;
+	SDL_mutexV(_job_mutex);
+
+	// Each thread is woken up once, upon which it sees that it should exit
+	for (uint32 i = 0; i < _threads.size(); i++) {
+		SDL_SemPost(_start_semaphore);
+	}
+	for (uint32 i = 0; i < _threads.size(); i++) {
+		SDL_WaitThread(_threads[i], NULL);
+	}
+	_threads.clear();
+}
+
+
+
+int ParticleManager::_WorkerThread(void* manager) {
+	ParticleManager* particle_manager = static_cast<ParticleManager*>(manager);
+
+	while (true) {
+		SDL_SemWait(particle_manager->_start_semaphore);
+
+		SDL_mutexP(particle_manager->_job_mutex);
+		if (particle_manager->_shutdown == true) {
+			SDL_mutexV(particle_manager->_job_mutex);
+			return 0;
+		}
+		SDL_mutexV(particle_manager->_job_mutex);
+
+		particle_manager->_DoJobs();
+		SDL_SemPost(particle_manager->_finished_semaphore);
+	}
+} // int ParticleManager::_WorkerThread(void* manager)
+
+
+
+void ParticleManager::_DoJobs() {
+	while (true) {
+		SDL_mutexP(_job_mutex);
+		uint32 job_index = _next_job;
+		if (job_index < _jobs.size())
+			++_next_job;
+		SDL_mutexV(_job_mutex);
+
+		if (job_index >= _jobs.size())
+			return;
+
+		ParticleSystemJob& job = _jobs[job_index];
+		job.success = job.system->Update(_job_frame_time, job.params);
+	}
+}
+
+
+
 Color ParticleManager::_ReadColor(ReadScriptDescriptor& script, string parameter_name) {
 	vector<float> color_values;
 
@@ -15,11 +15,22 @@
 *** The particle manager is very simple. Every time you want to draw an effect,
 *** you call AddEffect() with a pointer to the effect definition structure.
 *** Then every frame, call Update() and Draw() to draw all the effects.
+*** Effect definitions are read from particle files with LoadEffect(), which
+*** keeps every definition that it reads, so each file is only parsed once.
+***
+*** Effects do not interact with each other, and neither do the systems within
+*** an effect, so the manager updates its systems on a pool of worker threads.
+*** Every system takes its random values from its own random number stream,
+*** which is seeded from the ID of its effect, so the particles that are
+*** produced do not depend on which thread updated which system.
 *** ***************************************************************************/
 
 #ifndef __PARTICLE_MANAGER_HEADER__
 #define __PARTICLE_MANAGER_HEADER__
 
+#include <SDL/SDL_thread.h>
+#include <SDL/SDL_mutex.h>
+
 #include "defs.h"
 #include "utils.h"
 
@@ -33,19 +44,47 @@ namespace hoa_video {
 
 namespace private_video {
 
+//! \brief The largest number of worker threads that the particle manager updates systems with
+const uint32 PARTICLE_MAX_WORKER_THREADS = 7;
+
+/** \brief The number of particles that must be active before the systems are updated on the worker threads
+*** Below this number, waking up the worker threads takes longer than updating the systems on the main thread.
+**/
+const int32 PARTICLE_PARALLEL_UPDATE_THRESHOLD = 2000;
+
 /** ****************************************************************************
 ***  \brief Used to store, update, and draw all particle effects.
+***
+*** The worker threads are only ever active during a call to Update(), which
+*** does not return until every system has been updated. Everything else,
+*** including the creation and destruction of effects, is done on the main thread.
 *** ***************************************************************************/
 class ParticleManager {
 public:
-	ParticleManager()
-		{ _current_id = 0; }
+	ParticleManager();
+
+	~ParticleManager();
+
+	/** \brief Creates the worker threads
+	*** One fewer thread than the number of processor cores is created, since the main thread also updates systems.
+	**/
+	void Initialize();
 
-	/** \brief Loads an effect definition from a particle file
+	/** \brief Retrieves the effect definition of a particle file, reading the file only if it has not been read before
 	*** \param filename The file to load the effect definition from
-	*** \return A pointer to the newly loaded effect definition
+	*** \param reload If true, the file is read again even if its definition is already cached (default value = false)
+	*** \return A pointer to the effect definition, or NULL if the file could not be loaded
+	***
+	*** \note The manager owns every definition that it returns, which remain valid until Destroy() is called.
+	*** This holds even after a definition has been replaced by reloading its file.
+	**/
+	const ParticleEffectDef* LoadEffect(const std::string &filename, bool reload = false);
+
+	/** \brief Loads the effect definitions of every particle file in a directory into the cache
+	*** \param directory The directory containing the particle files, such as "lua/graphics/particles"
+	*** \return The number of effect definitions that were loaded successfully
 	**/
-	ParticleEffectDef* LoadEffect(const std::string &filename);
+	uint32 PreloadEffects(const std::string &directory);
 
 	/** \brief Creates a new instance of an effect at (x,y)
 	*** \param definition A pointer to the new effect to add
@@ -89,7 +128,7 @@ public:
 	**/
 	ParticleEffect *GetEffect(ParticleEffectID id);
 
-	//! \brief Destroys the particle manager and all effects that it manages
+	//! \brief Destroys the particle manager, all effects that it manages, and all cached effect definitions
 	void Destroy();
 
 private:
@@ -105,12 +144,59 @@ private:
 	//! we can convert easily between an id and a pointer
 	std::map<ParticleEffectID, ParticleEffect*> _effects;
 
+	//! The effect definitions of every particle file that has been loaded, keyed by filename.
+	//! Files which failed to load have a NULL definition.
+	std::map<std::string, ParticleEffectDef*> _effect_defs;
+
+	//! Definitions that were replaced by reloading their file, which are kept until Destroy()
+	//! is called since active effects may still refer to them
+	std::vector<ParticleEffectDef*> _retired_effect_defs;
+
+	/** \brief Reads an effect definition from a particle file
+	*** \param filename The file to load the effect definition from
+	*** \return A pointer to the newly loaded effect definition, or NULL if the file was invalid
+	**/
+	ParticleEffectDef* _ParseEffect(const std::string &filename);
+
 	/** \brief Creates a new particle effect from a provided effect definition
 	*** \param definition A pointer to the definition data of the effect
 	*** \return A pointer to the created ParticleEffect object
 	**/
 	ParticleEffect* _CreateEffect(const ParticleEffectDef *definition);
 
+	//! \brief The worker threads
+	std::vector<SDL_Thread*> _threads;
+
+	//! \brief Protects the _next_job and _shutdown members, which are shared with the worker threads
+	SDL_mutex* _job_mutex;
+
+	//! \brief Posted once for each worker thread when there are jobs for the threads to do
+	SDL_sem* _start_semaphore;
+
+	//! \brief Posted by each worker thread once it finds that no jobs are left
+	SDL_sem* _finished_semaphore;
+
+	//! \brief The systems to update during the current call to Update()
+	std::vector<ParticleSystemJob> _jobs;
+
+	//! \brief The index of the next job in _jobs that has not been taken by a thread
+	uint32 _next_job;
+
+	//! \brief The number of seconds to update the systems by during the current call to Update()
+	float _job_frame_time;
+
+	//! \brief Set to true to instruct the worker threads to exit
+	bool _shutdown;
+
+	//! \brief Stops and waits on the worker threads
+	void _StopThreads();
+
+	//! \brief The function run by each worker thread
+	static int _WorkerThread(void* manager);
+
+	//! \brief Takes jobs from _jobs and does them until no jobs are left, which is done by the main and worker threads alike
+	void _DoJobs();
+
 	/** \brief A helper function that is used to read a table of color data (four floats)
 	*** \param script A reference to the script to read the data from
 	*** \param parameter_name The name of the parameter containing the float data to read
@@ -12,6 +12,12 @@
 #include "particle_system.h"
 #include "particle_keyframe.h"
 
+// The common force terms of the particle update are vectorized when SSE2 is available (all x86-64 processors)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define PARTICLE_UPDATE_SSE2
+	#include <emmintrin.h>
+#endif
+
 using namespace std;
 using namespace hoa_utils;
 
@@ -22,6 +28,17 @@ namespace private_video
 {
 
 
+//-----------------------------------------------------------------------------
+// ParticleSystemDef
+//-----------------------------------------------------------------------------
+
+ParticleSystemDef::~ParticleSystemDef()
+{
+	for(size_t k = 0; k < keyframes.size(); ++k)
+		delete keyframes[k];
+}
+
+
 //-----------------------------------------------------------------------------
 // ParticleSystem
 //-----------------------------------------------------------------------------
@@ -36,6 +53,8 @@ ParticleSystem::ParticleSystem()
 
 	_alive = true;
 	_stopped = false;
+
+	SeedRandom(0);
 }
 
 
@@ -49,7 +68,7 @@ bool ParticleSystem::Create(const ParticleSystemDef *sys_def)
 	_max_particles = sys_def->max_particles;
 	_num_particles = 0;
 
-	_particles.resize(_max_particles);
+	_particles.Resize(_max_particles);
 	_particle_vertices.resize(_max_particles * 4);
 	_particle_texcoords.resize(_max_particles * 4);
 	_particle_colors.resize(_max_particles * 4);
@@ -58,22 +77,8 @@ bool ParticleSystem::Create(const ParticleSystemDef *sys_def)
 	_stopped = false;
 	_age = 0.0f;
 
-	size_t num_frames = sys_def->animation_frame_filenames.size();
-
-	for(size_t j = 0; j < num_frames; ++j)
-	{
-		int32 frame_time;
-		if(j < sys_def->animation_frame_times.size())
-			frame_time = sys_def->animation_frame_times[j];
-		else if(sys_def->animation_frame_times.empty())
-			frame_time = 0;
-		else
-			frame_time = sys_def->animation_frame_times.back();
-
-		_animation.AddFrame(sys_def->animation_frame_filenames[j], frame_time);
-	}
-
-// 	VideoManager->LoadImage(_animation);
+	// the frames were loaded along with the definition, so this only shares their images
+	_animation = sys_def->animation;
 	return true;
 }
 
@@ -88,20 +93,16 @@ bool ParticleSystem::Draw()
 	if(!_system_def->enabled || _age < _system_def->emitter._start_time)
 		return true;
 
+	// draw any batched images before the blending and stencil state is changed
+	VideoManager->_FlushBatch();
+
 	// set blending parameters
 	if(_system_def->blend_mode == VIDEO_NO_BLEND)
-	{
-		glDisable(GL_BLEND);
-	}
+		VideoManager->_SetGLBlendMode(0);
+	else if(_system_def->blend_mode == VIDEO_BLEND)
+		VideoManager->_SetGLBlendMode(1);
 	else
-	{
-		glEnable(GL_BLEND);
-
-		if(_system_def->blend_mode == VIDEO_BLEND)
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		else
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE); // additive
-	}
+		VideoManager->_SetGLBlendMode(2); // additive
 
 
 	if(_system_def->use_stencil)
@@ -137,14 +138,13 @@ bool ParticleSystem::Draw()
 		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 	}
 
-	glEnable(GL_TEXTURE_2D);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	VideoManager->_SetGLTexturing(true);
 
 	StillImage *id = _animation.GetFrame(_animation.GetCurrentFrameIndex());
 	ImageTexture *img = id->_image_texture;
+	TextureManager->_UseTexSheet(img->texture_sheet);
 	TextureManager->_BindTexture(img->texture_sheet->tex_id);
+	img->texture_sheet->Smooth(true);
 
 
 	float frame_progress = _animation.GetPercentProgress();
@@ -165,19 +165,19 @@ bool ParticleSystem::Draw()
 		int32 v = 0;
 
 		for (int32 j = 0; j < _num_particles; ++j) {
-			float scaled_width_half  = img_width_half * _particles[j].size_x;
-			float scaled_height_half = img_height_half * _particles[j].size_y;
+			float scaled_width_half  = img_width_half * _particles.size_x[j];
+			float scaled_height_half = img_height_half * _particles.size_y[j];
 
-			float rotation_angle = _particles[j].rotation_angle;
+			float rotation_angle = _particles.rotation_angle[j];
 
 			if (_system_def->rotate_to_velocity) {
 				// calculate the angle based on the velocity
-				rotation_angle += UTILS_HALF_PI + atan2f(_particles[j].combined_velocity_y, _particles[j].combined_velocity_x);
+				rotation_angle += UTILS_HALF_PI + atan2f(_particles.combined_velocity_y[j], _particles.combined_velocity_x[j]);
 
 				// calculate the scaling due to speed
 				if (_system_def->speed_scale_used) {
 					// speed is magnitude of velocity
-					float speed = sqrtf(_particles[j].combined_velocity_x * _particles[j].combined_velocity_x + _particles[j].combined_velocity_y * _particles[j].combined_velocity_y);
+					float speed = sqrtf(_particles.combined_velocity_x[j] * _particles.combined_velocity_x[j] + _particles.combined_velocity_y[j] * _particles.combined_velocity_y[j]);
 					float scale_factor = _system_def->speed_scale * speed;
 
 					if(scale_factor < _system_def->min_speed_scale)
@@ -193,32 +193,32 @@ bool ParticleSystem::Draw()
 			_particle_vertices[v]._x = -scaled_width_half;
 			_particle_vertices[v]._y = -scaled_height_half;
 			RotatePoint(_particle_vertices[v]._x, _particle_vertices[v]._y, rotation_angle);
-			_particle_vertices[v]._x += _particles[j].x;
-			_particle_vertices[v]._y += _particles[j].y;
+			_particle_vertices[v]._x += _particles.x[j];
+			_particle_vertices[v]._y += _particles.y[j];
 			++v;
 
 			// upper-right vertex
 			_particle_vertices[v]._x = scaled_width_half;
 			_particle_vertices[v]._y = -scaled_height_half;
 			RotatePoint(_particle_vertices[v]._x, _particle_vertices[v]._y, rotation_angle);
-			_particle_vertices[v]._x += _particles[j].x;
-			_particle_vertices[v]._y += _particles[j].y;
+			_particle_vertices[v]._x += _particles.x[j];
+			_particle_vertices[v]._y += _particles.y[j];
 			++v;
 
 			// lower-right vertex
 			_particle_vertices[v]._x = scaled_width_half;
 			_particle_vertices[v]._y = scaled_height_half;
 			RotatePoint(_particle_vertices[v]._x, _particle_vertices[v]._y, rotation_angle);
-			_particle_vertices[v]._x += _particles[j].x;
-			_particle_vertices[v]._y += _particles[j].y;
+			_particle_vertices[v]._x += _particles.x[j];
+			_particle_vertices[v]._y += _particles.y[j];
 			++v;
 
 			// lower-left vertex
 			_particle_vertices[v]._x = -scaled_width_half;
 			_particle_vertices[v]._y = scaled_height_half;
 			RotatePoint(_particle_vertices[v]._x, _particle_vertices[v]._y, rotation_angle);
-			_particle_vertices[v]._x += _particles[j].x;
-			_particle_vertices[v]._y += _particles[j].y;
+			_particle_vertices[v]._x += _particles.x[j];
+			_particle_vertices[v]._y += _particles.y[j];
 			++v;
 		}
 	}
@@ -226,27 +226,27 @@ bool ParticleSystem::Draw()
 		int32 v = 0;
 
 		for (int32 j = 0; j < _num_particles; ++j) {
-			float scaled_width_half  = img_width_half * _particles[j].size_x;
-			float scaled_height_half = img_height_half * _particles[j].size_y;
+			float scaled_width_half  = img_width_half * _particles.size_x[j];
+			float scaled_height_half = img_height_half * _particles.size_y[j];
 
 			// upper-left vertex
-			_particle_vertices[v]._x = _particles[j].x - scaled_width_half;
-			_particle_vertices[v]._y = _particles[j].y - scaled_height_half;
+			_particle_vertices[v]._x = _particles.x[j] - scaled_width_half;
+			_particle_vertices[v]._y = _particles.y[j] - scaled_height_half;
 			++v;
 
 			// upper-right vertex
-			_particle_vertices[v]._x = _particles[j].x + scaled_width_half;
-			_particle_vertices[v]._y = _particles[j].y - scaled_height_half;
+			_particle_vertices[v]._x = _particles.x[j] + scaled_width_half;
+			_particle_vertices[v]._y = _particles.y[j] - scaled_height_half;
 			++v;
 
 			// lower-right vertex
-			_particle_vertices[v]._x = _particles[j].x + scaled_width_half;
-			_particle_vertices[v]._y = _particles[j].y + scaled_height_half;
+			_particle_vertices[v]._x = _particles.x[j] + scaled_width_half;
+			_particle_vertices[v]._y = _particles.y[j] + scaled_height_half;
 			++v;
 
 			// lower-left vertex
-			_particle_vertices[v]._x = _particles[j].x - scaled_width_half;
-			_particle_vertices[v]._y = _particles[j].y + scaled_height_half;
+			_particle_vertices[v]._x = _particles.x[j] - scaled_width_half;
+			_particle_vertices[v]._y = _particles.y[j] + scaled_height_half;
 			++v;
 		}
 	}
@@ -254,7 +254,7 @@ bool ParticleSystem::Draw()
 	// fill the color array
 	int32 c = 0;
 	for (int32 j = 0; j < _num_particles; ++j) {
-		Color color = _particles[j].color;
+		Color color = _particles.color[j];
 
 		if(_system_def->smooth_animation)
 			color = color * (1.0f - frame_progress);
@@ -294,26 +294,23 @@ bool ParticleSystem::Draw()
 		++t;
 	}
 
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_COLOR_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	VideoManager->_SetGLClientStates(true, true, true);
 	glVertexPointer   (2, GL_FLOAT, 0, &_particle_vertices[0]);
 	glColorPointer    (4, GL_FLOAT, 0, &_particle_colors[0]);
 	glTexCoordPointer (2, GL_FLOAT, 0, &_particle_texcoords[0]);
 
 	glDrawArrays(GL_QUADS, 0, _num_particles * 4);
-
-	glDisableClientState(GL_VERTEX_ARRAY);
+	VideoManager->_RecordDraw(GL_QUADS, &_particle_vertices[0], GL_FLOAT, static_cast<uint32>(_num_particles * 4));
 
 	if(_system_def->smooth_animation) {
-		glEnableClientState(GL_VERTEX_ARRAY);
-
 		int findex = _animation.GetCurrentFrameIndex();
 		findex = (findex + 1) % _animation.GetNumberOfFrames();
 
 		StillImage *id2 = _animation.GetFrame(findex);
 		ImageTexture *img2 = id2->_image_texture;
+		TextureManager->_UseTexSheet(img2->texture_sheet);
 		TextureManager->_BindTexture(img2->texture_sheet->tex_id);
+		img2->texture_sheet->Smooth(true);
 
 
 		u1 = img2->u1;
@@ -349,7 +346,7 @@ bool ParticleSystem::Draw()
 
 		c = 0;
 		for(int32 j = 0; j < _num_particles; ++j) {
-			Color color = _particles[j].color;
+			Color color = _particles.color[j];
 			color = color * frame_progress;
 
 			_particle_colors[c] = color;
@@ -367,10 +364,7 @@ bool ParticleSystem::Draw()
 		glTexCoordPointer (2, GL_FLOAT, 0, &_particle_texcoords[0]);
 
 		glDrawArrays(GL_QUADS, 0, _num_particles * 4);
-
-		glDisableClientState(GL_VERTEX_ARRAY);
-		glDisableClientState(GL_COLOR_ARRAY);
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		VideoManager->_RecordDraw(GL_QUADS, &_particle_vertices[0], GL_FLOAT, static_cast<uint32>(_num_particles * 4));
 	}
 
 	return true;
@@ -493,7 +487,7 @@ int32 ParticleSystem::GetNumParticles() const
 
 void ParticleSystem::Destroy()
 {
-	_particles.clear();
+	_particles.Clear();
 	_particle_vertices.clear();
 }
 
@@ -509,213 +503,379 @@ void ParticleSystem::Stop()
 
 
 //-----------------------------------------------------------------------------
-// _UpdateParticles: helper function to update the positions and properties
+// Force term helpers: each of these updates one group of particle properties
+// for every particle in the arrays. The loops contain no branches, so when SSE2
+// is available four particles are updated at a time. The vectorized loops
+// perform exactly the same operations in the same order as the scalar loops,
+// which handle the particles left over at the end of the arrays.
 //-----------------------------------------------------------------------------
 
-void ParticleSystem::_UpdateParticles(float t, const EffectParameters &params)
+// Adds the rotation speed to the rotation angle, and combines the particle and wind velocities
+static void UpdateRotationAndWind(ParticleArrays &particles, int32 count, float t)
 {
-	for(int j = 0; j < _num_particles; ++j)
+	float *angle = &particles.rotation_angle[0];
+	const float *speed = &particles.rotation_speed[0];
+	const float *direction = &particles.rotation_direction[0];
+	const float *velocity_x = &particles.velocity_x[0];
+	const float *velocity_y = &particles.velocity_y[0];
+	const float *wind_x = &particles.wind_velocity_x[0];
+	const float *wind_y = &particles.wind_velocity_y[0];
+	float *combined_x = &particles.combined_velocity_x[0];
+	float *combined_y = &particles.combined_velocity_y[0];
+
+	int32 j = 0;
+#ifdef PARTICLE_UPDATE_SSE2
+	const __m128 time = _mm_set1_ps(t);
+	for(; j + 4 <= count; j += 4)
 	{
-		// calculate a time for the particle from 0 to 1 since this is what
-		// the keyframes are based on
-		float scaled_time = _particles[j].time / _particles[j].lifetime;
+		__m128 rotation = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(speed + j), _mm_loadu_ps(direction + j)), time);
+		_mm_storeu_ps(angle + j, _mm_add_ps(_mm_loadu_ps(angle + j), rotation));
+		_mm_storeu_ps(combined_x + j, _mm_add_ps(_mm_loadu_ps(velocity_x + j), _mm_loadu_ps(wind_x + j)));
+		_mm_storeu_ps(combined_y + j, _mm_add_ps(_mm_loadu_ps(velocity_y + j), _mm_loadu_ps(wind_y + j)));
+	}
+#endif
+	for(; j < count; ++j)
+	{
+		angle[j] += speed[j] * direction[j] * t;
+		combined_x[j] = velocity_x[j] + wind_x[j];
+		combined_y[j] = velocity_y[j] + wind_y[j];
+	}
+}
+
+
+// Moves the particles by their combined velocities, applies their constant acceleration, and ages them
+static void UpdatePositions(ParticleArrays &particles, int32 count, float t)
+{
+	float *x = &particles.x[0];
+	float *y = &particles.y[0];
+	const float *combined_x = &particles.combined_velocity_x[0];
+	const float *combined_y = &particles.combined_velocity_y[0];
+	float *velocity_x = &particles.velocity_x[0];
+	float *velocity_y = &particles.velocity_y[0];
+	const float *acceleration_x = &particles.acceleration_x[0];
+	const float *acceleration_y = &particles.acceleration_y[0];
+	float *age = &particles.time[0];
+
+	int32 j = 0;
+#ifdef PARTICLE_UPDATE_SSE2
+	const __m128 time = _mm_set1_ps(t);
+	for(; j + 4 <= count; j += 4)
+	{
+		_mm_storeu_ps(x + j, _mm_add_ps(_mm_loadu_ps(x + j), _mm_mul_ps(_mm_loadu_ps(combined_x + j), time)));
+		_mm_storeu_ps(y + j, _mm_add_ps(_mm_loadu_ps(y + j), _mm_mul_ps(_mm_loadu_ps(combined_y + j), time)));
+		_mm_storeu_ps(velocity_x + j, _mm_add_ps(_mm_loadu_ps(velocity_x + j), _mm_mul_ps(_mm_loadu_ps(acceleration_x + j), time)));
+		_mm_storeu_ps(velocity_y + j, _mm_add_ps(_mm_loadu_ps(velocity_y + j), _mm_mul_ps(_mm_loadu_ps(acceleration_y + j), time)));
+		_mm_storeu_ps(age + j, _mm_add_ps(_mm_loadu_ps(age + j), time));
+	}
+#endif
+	for(; j < count; ++j)
+	{
+		x[j] += combined_x[j] * t;
+		y[j] += combined_y[j] * t;
+		velocity_x[j] += acceleration_x[j] * t;
+		velocity_y[j] += acceleration_y[j] * t;
+		age[j] += t;
+	}
+}
+
 
-		// figure out which keyframe we're on
-		if(_particles[j].next_keyframe)
+// Applies the radial and tangential acceleration of the particles, relative to an attractor point. A particle
+// whose radial or tangential acceleration is zero receives no change in velocity from it.
+static void UpdateAttraction(ParticleArrays &particles, int32 count, float t, float attractor_x, float attractor_y, float falloff)
+{
+	const float *x = &particles.x[0];
+	const float *y = &particles.y[0];
+	float *velocity_x = &particles.velocity_x[0];
+	float *velocity_y = &particles.velocity_y[0];
+	const float *radial = &particles.radial_acceleration[0];
+	const float *tangential = &particles.tangential_acceleration[0];
+
+	int32 j = 0;
+#ifdef PARTICLE_UPDATE_SSE2
+	const __m128 time = _mm_set1_ps(t);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 center_x = _mm_set1_ps(attractor_x);
+	const __m128 center_y = _mm_set1_ps(attractor_y);
+	const __m128 falloff_factor = _mm_set1_ps(falloff);
+	for(; j + 4 <= count; j += 4)
+	{
+		// unit vector from attractor to particle. Particles that are on the attractor keep a zero vector
+		__m128 to_particle_x = _mm_sub_ps(_mm_loadu_ps(x + j), center_x);
+		__m128 to_particle_y = _mm_sub_ps(_mm_loadu_ps(y + j), center_y);
+		__m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(to_particle_x, to_particle_x), _mm_mul_ps(to_particle_y, to_particle_y)));
+		__m128 nonzero = _mm_cmpneq_ps(distance, zero);
+		to_particle_x = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(to_particle_x, distance)), _mm_andnot_ps(nonzero, to_particle_x));
+		to_particle_y = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(to_particle_y, distance)), _mm_andnot_ps(nonzero, to_particle_y));
+
+		__m128 vel_x = _mm_loadu_ps(velocity_x + j);
+		__m128 vel_y = _mm_loadu_ps(velocity_y + j);
+
+		// radial acceleration, which is lessened with distance when there is a falloff and stops where it reaches zero
+		__m128 radial_x = _mm_mul_ps(_mm_mul_ps(to_particle_x, _mm_loadu_ps(radial + j)), time);
+		__m128 radial_y = _mm_mul_ps(_mm_mul_ps(to_particle_y, _mm_loadu_ps(radial + j)), time);
+		if(falloff != 0.0f)
 		{
-			ParticleKeyframe *old_next = _particles[j].next_keyframe;
+			__m128 attraction = _mm_sub_ps(one, _mm_mul_ps(falloff_factor, distance));
+			__m128 attracted = _mm_cmpgt_ps(attraction, zero);
+			radial_x = _mm_and_ps(attracted, _mm_mul_ps(radial_x, attraction));
+			radial_y = _mm_and_ps(attracted, _mm_mul_ps(radial_y, attraction));
+		}
+		vel_x = _mm_add_ps(vel_x, radial_x);
+		vel_y = _mm_add_ps(vel_y, radial_y);
 
-			// check if we need to advance the keyframe
-			if(scaled_time >= _particles[j].next_keyframe->time)
-			{
-				// figure out what keyframe we're on
-				size_t num_keyframes = _system_def->keyframes.size();
+		// tangential acceleration, where the tangent vector is simply the perpendicular vector
+		__m128 tangent = _mm_loadu_ps(tangential + j);
+		vel_x = _mm_add_ps(vel_x, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(zero, to_particle_y), tangent), time));
+		vel_y = _mm_add_ps(vel_y, _mm_mul_ps(_mm_mul_ps(to_particle_x, tangent), time));
 
-				size_t k;
-				for(k = 0; k < num_keyframes; ++k)
-				{
-					if(_system_def->keyframes[k]->time > scaled_time)
-					{
-						_particles[j].current_keyframe = _system_def->keyframes[k - 1];
-						_particles[j].next_keyframe    = _system_def->keyframes[k];
-						break;
-					}
-				}
+		_mm_storeu_ps(velocity_x + j, vel_x);
+		_mm_storeu_ps(velocity_y + j, vel_y);
+	}
+#endif
+	for(; j < count; ++j)
+	{
+		bool use_radial     = (radial[j] != 0.0f);
+		bool use_tangential = (tangential[j] != 0.0f);
 
-				// if we didn't find any keyframe whose time is larger than this
-				// particle's time, then we are on the last one
-				if(k == num_keyframes)
-				{
-					_particles[j].current_keyframe = _system_def->keyframes[k - 1];
-					_particles[j].next_keyframe = NULL;
-
-					// set all of the keyframed properties to the value stored in the last
-					// keyframe
-					_particles[j].color          = _particles[j].current_keyframe->color;
-					_particles[j].rotation_speed = _particles[j].current_keyframe->rotation_speed;
-					_particles[j].size_x         = _particles[j].current_keyframe->size_x;
-					_particles[j].size_y         = _particles[j].current_keyframe->size_y;
-				}
+		if(use_radial == false && use_tangential == false)
+			continue;
 
-				// if we skipped ahead only 1 keyframe, then inherit the current variations
-				// from the next ones
-				if(_particles[j].current_keyframe == old_next)
-				{
-					_particles[j].current_color_variation = _particles[j].next_color_variation;
-					_particles[j].current_rotation_speed_variation = _particles[j].current_rotation_speed_variation;
-					_particles[j].current_size_variation_x = _particles[j].next_size_variation_x;
-					_particles[j].current_size_variation_y = _particles[j].next_size_variation_y;
-				}
-				else
-				{
-					_particles[j].current_rotation_speed_variation = RandomFloat(-_particles[j].current_keyframe->rotation_speed_variation, _particles[j].current_keyframe->rotation_speed_variation);
-					for(int32 c = 0; c < 4; ++c)
-						_particles[j].current_color_variation[c] = RandomFloat(-_particles[j].current_keyframe->color_variation[c], _particles[j].current_keyframe->color_variation[c]);
-					_particles[j].current_size_variation_x = RandomFloat(-_particles[j].current_keyframe->size_variation_x, _particles[j].current_keyframe->size_variation_x);
-					_particles[j].current_size_variation_y = RandomFloat(-_particles[j].current_keyframe->size_variation_y, _particles[j].current_keyframe->size_variation_y);
-				}
+		// unit vector from attractor to particle
+		float attractor_to_particle_x = x[j] - attractor_x;
+		float attractor_to_particle_y = y[j] - attractor_y;
+
+		float distance = sqrtf(attractor_to_particle_x * attractor_to_particle_x + attractor_to_particle_y * attractor_to_particle_y);
 
-				// if there is a next keyframe, generate variations for it
-				if(_particles[j].next_keyframe)
+		if(distance != 0.0f)
+		{
+			attractor_to_particle_x /= distance;
+			attractor_to_particle_y /= distance;
+		}
+
+		// radial acceleration
+		if(use_radial)
+		{
+			if(falloff != 0.0f)
+			{
+				float attraction = 1.0f - falloff * distance;
+				if(attraction > 0.0f)
 				{
-					_particles[j].next_rotation_speed_variation = RandomFloat(-_particles[j].next_keyframe->rotation_speed_variation, _particles[j].next_keyframe->rotation_speed_variation);
-					for(int32 c = 0; c < 4; ++c)
-						_particles[j].next_color_variation[c] = RandomFloat(-_particles[j].next_keyframe->color_variation[c], _particles[j].next_keyframe->color_variation[c]);
-					_particles[j].next_size_variation_x = RandomFloat(-_particles[j].next_keyframe->size_variation_x, _particles[j].next_keyframe->size_variation_x);
-					_particles[j].next_size_variation_y = RandomFloat(-_particles[j].next_keyframe->size_variation_y, _particles[j].next_keyframe->size_variation_y);
+					velocity_x[j] += attractor_to_particle_x * radial[j] * t * attraction;
+					velocity_y[j] += attractor_to_particle_y * radial[j] * t * attraction;
 				}
 			}
+			else
+			{
+				velocity_x[j] += attractor_to_particle_x * radial[j] * t;
+				velocity_y[j] += attractor_to_particle_y * radial[j] * t;
+			}
 		}
 
-
-		// if we aren't already at the last keyframe, interpolate to figure out the
-		// current keyframed properties
-		if(_particles[j].next_keyframe)
+		// tangential acceleration
+		if(use_tangential)
 		{
-			// figure out how far we are from the current to the next (0.0 to 1.0)
-			float a = (scaled_time - _particles[j].current_keyframe->time) / (_particles[j].next_keyframe->time - _particles[j].current_keyframe->time);
-
-			_particles[j].rotation_speed = Lerp(a, _particles[j].current_keyframe->rotation_speed + _particles[j].current_rotation_speed_variation, _particles[j].next_keyframe->rotation_speed + _particles[j].next_rotation_speed_variation);
-			_particles[j].size_x         = Lerp(a, _particles[j].current_keyframe->size_x + _particles[j].current_size_variation_x, _particles[j].next_keyframe->size_x + _particles[j].next_size_variation_x);
-			_particles[j].size_y         = Lerp(a, _particles[j].current_keyframe->size_y + _particles[j].current_size_variation_y, _particles[j].next_keyframe->size_y + _particles[j].next_size_variation_y);
-			_particles[j].color[0]       = Lerp(a, _particles[j].current_keyframe->color[0] + _particles[j].current_color_variation[0], _particles[j].next_keyframe->color[0] + _particles[j].next_color_variation[0]);
-			_particles[j].color[1]       = Lerp(a, _particles[j].current_keyframe->color[1] + _particles[j].current_color_variation[1], _particles[j].next_keyframe->color[1] + _particles[j].next_color_variation[1]);
-			_particles[j].color[2]       = Lerp(a, _particles[j].current_keyframe->color[2] + _particles[j].current_color_variation[2], _particles[j].next_keyframe->color[2] + _particles[j].next_color_variation[2]);
-			_particles[j].color[3]       = Lerp(a, _particles[j].current_keyframe->color[3] + _particles[j].current_color_variation[3], _particles[j].next_keyframe->color[3] + _particles[j].next_color_variation[3]);
+			// tangent vector is simply perpendicular vector
+			float tangent_x = -attractor_to_particle_y;
+			float tangent_y = attractor_to_particle_x;
+
+			velocity_x[j] += tangent_x * tangential[j] * t;
+			velocity_y[j] += tangent_y * tangential[j] * t;
 		}
+	}
+}
 
 
-		_particles[j].rotation_angle += _particles[j].rotation_speed * _particles[j].rotation_direction * t;
+//-----------------------------------------------------------------------------
+// _UpdateParticles: helper function to update the positions and properties
+//-----------------------------------------------------------------------------
+
+void ParticleSystem::_UpdateParticles(float t, const EffectParameters &params)
+{
+	if(_num_particles == 0)
+		return;
+
+	// with only one keyframe, the keyframed properties of a particle never change after it is spawned
+	if(_system_def->keyframes.size() > 1)
+		_UpdateKeyframes();
 
-		float wind_velocity_x = _particles[j].wind_velocity_x;
-		float wind_velocity_y = _particles[j].wind_velocity_y;
+	// the remaining properties are updated one force term at a time, across all particles
 
-		_particles[j].combined_velocity_x = _particles[j].velocity_x + wind_velocity_x;
-		_particles[j].combined_velocity_y = _particles[j].velocity_y + wind_velocity_y;
+	UpdateRotationAndWind(_particles, _num_particles, t);
 
-		if(_system_def->wave_motion_used && _particles[j].wave_half_amplitude > 0.0f)
+	if(_system_def->wave_motion_used)
+	{
+		for(int32 j = 0; j < _num_particles; ++j)
 		{
+			if(_particles.wave_half_amplitude[j] <= 0.0f)
+				continue;
+
 			// find the magnitude of the wave velocity
-// 			float half_amp = _particles[j].wave_half_amplitude; UNUSED VARIABLE
-// 			float wcoef = _particles[j].wave_length_coefficient; UNUSED VARIABLE
-			float wave_speed = _particles[j].wave_half_amplitude * sinf(_particles[j].wave_length_coefficient * _particles[j].time);
+			float wave_speed = _particles.wave_half_amplitude[j] * sinf(_particles.wave_length_coefficient[j] * _particles.time[j]);
 
 			// now the wave velocity is just that wave speed times the particle's tangential vector
-			float tangent_x = -_particles[j].combined_velocity_y;
-			float tangent_y = _particles[j].combined_velocity_x;
+			float tangent_x = -_particles.combined_velocity_y[j];
+			float tangent_y = _particles.combined_velocity_x[j];
 			float speed = sqrtf(tangent_x * tangent_x + tangent_y * tangent_y);
 			tangent_x /= speed;
 			tangent_y /= speed;
 
-			float wave_velocity_x = tangent_x * wave_speed;
-			float wave_velocity_y = tangent_y * wave_speed;
-
-			_particles[j].combined_velocity_x += wave_velocity_x;
-			_particles[j].combined_velocity_y += wave_velocity_y;
+			_particles.combined_velocity_x[j] += tangent_x * wave_speed;
+			_particles.combined_velocity_y[j] += tangent_y * wave_speed;
 		}
+	}
 
-		_particles[j].x += (_particles[j].combined_velocity_x) * t;
-		_particles[j].y += (_particles[j].combined_velocity_y) * t;
+	UpdatePositions(_particles, _num_particles, t);
 
+	// radial and tangential acceleration are only computed for systems where some particle may have them
+	if(_system_def->radial_acceleration != 0.0f || _system_def->radial_acceleration_variation != 0.0f ||
+		_system_def->tangential_acceleration != 0.0f || _system_def->tangential_acceleration_variation != 0.0f)
+	{
+		if(_system_def->user_defined_attractor)
+			UpdateAttraction(_particles, _num_particles, t, params.attractor_x, params.attractor_y, _system_def->attractor_falloff);
+		else
+			UpdateAttraction(_particles, _num_particles, t, _system_def->emitter._center_x, _system_def->emitter._center_y, _system_def->attractor_falloff);
+	}
+
+	// damp the velocity
+	if(_system_def->damping != 1.0f || _system_def->damping_variation != 0.0f)
+	{
+		for(int32 j = 0; j < _num_particles; ++j)
+		{
+			if(_particles.damping[j] != 1.0f)
+			{
+				_particles.velocity_x[j] *= pow(_particles.damping[j], t);
+				_particles.velocity_y[j] *= pow(_particles.damping[j], t);
+			}
+		}
+	}
+}
 
-		// client-specified acceleration (dv = a * t)
-		_particles[j].velocity_x += _particles[j].acceleration_x * t;
-		_particles[j].velocity_y += _particles[j].acceleration_y * t;
 
-		// radial acceleration: calculate unit vector from emitter center to this particle,
-		// and scale by the radial acceleration, if there is any
+//-----------------------------------------------------------------------------
+// _UpdateKeyframes: helper function to update the keyframed properties
+//-----------------------------------------------------------------------------
+
+void ParticleSystem::_UpdateKeyframes()
+{
+	const vector<ParticleKeyframe *> &keyframes = _system_def->keyframes;
 
+	for(int32 j = 0; j < _num_particles; ++j)
+	{
+		ParticleKeyframeState &state = _particles.keyframe_state[j];
 
-		bool use_radial     = (_particles[j].radial_acceleration != 0.0f);
-		bool use_tangential = (_particles[j].tangential_acceleration != 0.0f);
+		// particles on their last keyframe already hold its property values
+		if(state.next_keyframe == NULL)
+			continue;
 
+		// calculate a time for the particle from 0 to 1 since this is what
+		// the keyframes are based on
+		float scaled_time = _particles.time[j] / _particles.lifetime[j];
 
-		if(use_radial || use_tangential)
+		// check if we need to advance the keyframe
+		if(scaled_time >= state.next_keyframe->time)
 		{
-			// unit vector from attractor to particle
-			float attractor_to_particle_x;
-			float attractor_to_particle_y;
+			// remember the next keyframe, so that advancing by exactly one keyframe can be detected
+			ParticleKeyframe *old_next = state.next_keyframe;
 
-			if(_system_def->user_defined_attractor)
+			// figure out what keyframe we're on
+			uint32 k = _system_def->keyframe_table.FindKeyframe(scaled_time);
+			state.current_keyframe = keyframes[k];
+
+			if(k + 1 < keyframes.size())
 			{
-				attractor_to_particle_x = _particles[j].x - params.attractor_x;
-				attractor_to_particle_y = _particles[j].y - params.attractor_y;
+				state.next_keyframe = keyframes[k + 1];
 			}
 			else
 			{
-				attractor_to_particle_x = _particles[j].x - _system_def->emitter._center_x;
-				attractor_to_particle_y = _particles[j].y - _system_def->emitter._center_y;
+				// if there is no keyframe after this particle's time, then we are on the last one
+				state.next_keyframe = NULL;
+
+				// set all of the keyframed properties to the value stored in the last
+				// keyframe
+				_particles.color[j]          = state.current_keyframe->color;
+				_particles.rotation_speed[j] = state.current_keyframe->rotation_speed;
+				_particles.size_x[j]         = state.current_keyframe->size_x;
+				_particles.size_y[j]         = state.current_keyframe->size_y;
 			}
 
-			float distance = sqrtf(attractor_to_particle_x * attractor_to_particle_x + attractor_to_particle_y * attractor_to_particle_y);
-
-			if(distance != 0.0f)
+			// if we skipped ahead only 1 keyframe, then inherit the current variations
+			// from the next ones
+			if(state.current_keyframe == old_next)
 			{
-				attractor_to_particle_x /= distance;
-				attractor_to_particle_y /= distance;
+				state.current_color_variation = state.next_color_variation;
+				state.current_rotation_speed_variation = state.next_rotation_speed_variation;
+				state.current_size_variation_x = state.next_size_variation_x;
+				state.current_size_variation_y = state.next_size_variation_y;
 			}
-
-			// radial acceleration
-			if(use_radial)
+			else
 			{
-				if(_system_def->attractor_falloff != 0.0f)
-				{
-					float attraction = 1.0f - _system_def->attractor_falloff * distance;
-					if(attraction > 0.0f)
-					{
-						_particles[j].velocity_x += attractor_to_particle_x * _particles[j].radial_acceleration * t * attraction;
-						_particles[j].velocity_y += attractor_to_particle_y * _particles[j].radial_acceleration * t * attraction;
-					}
-				}
-				else
-				{
-					_particles[j].velocity_x += attractor_to_particle_x * _particles[j].radial_acceleration * t;
-					_particles[j].velocity_y += attractor_to_particle_y * _particles[j].radial_acceleration * t;
-				}
+				state.current_rotation_speed_variation = _RandomFloat(-state.current_keyframe->rotation_speed_variation, state.current_keyframe->rotation_speed_variation);
+				for(int32 c = 0; c < 4; ++c)
+					state.current_color_variation[c] = _RandomFloat(-state.current_keyframe->color_variation[c], state.current_keyframe->color_variation[c]);
+				state.current_size_variation_x = _RandomFloat(-state.current_keyframe->size_variation_x, state.current_keyframe->size_variation_x);
+				state.current_size_variation_y = _RandomFloat(-state.current_keyframe->size_variation_y, state.current_keyframe->size_variation_y);
 			}
 
-			// tangential acceleration
-			if(use_tangential)
+			// if there is a next keyframe, generate variations for it
+			if(state.next_keyframe)
 			{
-				// tangent vector is simply perpendicular vector
-				float tangent_x = -attractor_to_particle_y;
-				float tangent_y = attractor_to_particle_x;
+				state.next_rotation_speed_variation = _RandomFloat(-state.next_keyframe->rotation_speed_variation, state.next_keyframe->rotation_speed_variation);
+				for(int32 c = 0; c < 4; ++c)
+					state.next_color_variation[c] = _RandomFloat(-state.next_keyframe->color_variation[c], state.next_keyframe->color_variation[c]);
+				state.next_size_variation_x = _RandomFloat(-state.next_keyframe->size_variation_x, state.next_keyframe->size_variation_x);
+				state.next_size_variation_y = _RandomFloat(-state.next_keyframe->size_variation_y, state.next_keyframe->size_variation_y);
 
-				_particles[j].velocity_x += tangent_x * _particles[j].tangential_acceleration * t;
-				_particles[j].velocity_y += tangent_y * _particles[j].tangential_acceleration * t;
+				_BeginKeyframe(j);
 			}
 		}
 
 
-		// damp the velocity
-
-		if(_particles[j].damping != 1.0f)
+		// if we aren't already at the last keyframe, interpolate to figure out the
+		// current keyframed properties
+		if(state.next_keyframe)
 		{
-			_particles[j].velocity_x *= pow(_particles[j].damping, t);
-			_particles[j].velocity_y *= pow(_particles[j].damping, t);
+			// figure out how far we are from the current to the next (0.0 to 1.0)
+			float a = (scaled_time - state.keyframe_start_time) * state.keyframe_inverse_duration;
+
+			_particles.rotation_speed[j] = state.start_rotation_speed + a * state.delta_rotation_speed;
+			_particles.size_x[j]         = state.start_size_x + a * state.delta_size_x;
+			_particles.size_y[j]         = state.start_size_y + a * state.delta_size_y;
+			_particles.color[j][0]       = state.start_color[0] + a * state.delta_color[0];
+			_particles.color[j][1]       = state.start_color[1] + a * state.delta_color[1];
+			_particles.color[j][2]       = state.start_color[2] + a * state.delta_color[2];
+			_particles.color[j][3]       = state.start_color[3] + a * state.delta_color[3];
 		}
+	}
+}
+
 
-		_particles[j].time += t;
+//-----------------------------------------------------------------------------
+// _BeginKeyframe: computes the start values and rates of change of a particle's
+//                 keyframed properties, once when it reaches a new keyframe, so
+//                 that the per-frame interpolation is a single multiply-add
+//-----------------------------------------------------------------------------
+
+void ParticleSystem::_BeginKeyframe(int32 i)
+{
+	ParticleKeyframeState &state = _particles.keyframe_state[i];
+	const ParticleKeyframe *current = state.current_keyframe;
+	const ParticleKeyframe *next = state.next_keyframe;
+
+	state.keyframe_start_time = current->time;
+	state.keyframe_inverse_duration = 1.0f / (next->time - current->time);
+
+	state.start_rotation_speed = current->rotation_speed + state.current_rotation_speed_variation;
+	state.delta_rotation_speed = next->rotation_speed + state.next_rotation_speed_variation - state.start_rotation_speed;
+	state.start_size_x = current->size_x + state.current_size_variation_x;
+	state.delta_size_x = next->size_x + state.next_size_variation_x - state.start_size_x;
+	state.start_size_y = current->size_y + state.current_size_variation_y;
+	state.delta_size_y = next->size_y + state.next_size_variation_y - state.start_size_y;
+
+	for(int32 c = 0; c < 4; ++c)
+	{
+		state.start_color[c] = current->color[c] + state.current_color_variation[c];
+		state.delta_color[c] = next->color[c] + state.next_color_variation[c] - state.start_color[c];
 	}
 }
 
@@ -732,7 +892,7 @@ void ParticleSystem::_KillParticles(int32 &num, const EffectParameters &params)
 	// check each active particle to see if it is expired
 	for(int j = 0; j < _num_particles; ++j)
 	{
-		if(_particles[j].time > _particles[j].lifetime)
+		if(_particles.time[j] > _particles.lifetime[j])
 		{
 			if(num > 0)
 			{
@@ -777,7 +937,7 @@ void ParticleSystem::_EmitParticles(int32 num, const EffectParameters &params)
 
 void ParticleSystem::_MoveParticle(int32 src, int32 dest)
 {
-	_particles[dest] = _particles[src];
+	_particles.Move(src, dest);
 }
 
 
@@ -794,21 +954,21 @@ void ParticleSystem::_RespawnParticle(int32 i, const EffectParameters &params)
 	{
 		case EMITTER_SHAPE_POINT:
 		{
-			_particles[i].x = emitter._x;
-			_particles[i].y = emitter._y;
+			_particles.x[i] = emitter._x;
+			_particles.y[i] = emitter._y;
 			break;
 		}
 		case EMITTER_SHAPE_LINE:
 		{
-			_particles[i].x = RandomFloat(emitter._x, emitter._x2);
-			_particles[i].y = RandomFloat(emitter._y, emitter._y2);
+			_particles.x[i] = _RandomFloat(emitter._x, emitter._x2);
+			_particles.y[i] = _RandomFloat(emitter._y, emitter._y2);
 			break;
 		}
 		case EMITTER_SHAPE_CIRCLE:
 		{
-			float angle = RandomFloat(0.0f, UTILS_2PI);
-			_particles[i].x = emitter._radius * cosf(angle);
-			_particles[i].y = emitter._radius * sinf(angle);
+			float angle = _RandomFloat(0.0f, UTILS_2PI);
+			_particles.x[i] = emitter._radius * cosf(angle);
+			_particles.y[i] = emitter._radius * sinf(angle);
 			break;
 		}
 		case EMITTER_SHAPE_FILLED_CIRCLE:
@@ -821,18 +981,18 @@ void ParticleSystem::_RespawnParticle(int32 i, const EffectParameters &params)
 			do
 			{
 				float half_radius = emitter._radius * 0.5f;
-				_particles[i].x = RandomFloat(-half_radius, half_radius);
-				_particles[i].y = RandomFloat(-half_radius, half_radius);
-			} while(_particles[i].x * _particles[i].x +
-			        _particles[i].y * _particles[i].y > radius_squared);
+				_particles.x[i] = _RandomFloat(-half_radius, half_radius);
+				_particles.y[i] = _RandomFloat(-half_radius, half_radius);
+			} while(_particles.x[i] * _particles.x[i] +
+			        _particles.y[i] * _particles.y[i] > radius_squared);
 
 
 			break;
 		}
 		case EMITTER_SHAPE_FILLED_RECTANGLE:
 		{
-			_particles[i].x = RandomFloat(emitter._x, emitter._x2);
-			_particles[i].y = RandomFloat(emitter._y, emitter._y2);
+			_particles.x[i] = _RandomFloat(emitter._x, emitter._x2);
+			_particles.y[i] = _RandomFloat(emitter._y, emitter._y2);
 			break;
 		}
 		default:
@@ -840,46 +1000,46 @@ void ParticleSystem::_RespawnParticle(int32 i, const EffectParameters &params)
 	};
 
 
-	_particles[i].x += RandomFloat(-emitter._x_variation, emitter._x_variation);
-	_particles[i].y += RandomFloat(-emitter._y_variation, emitter._y_variation);
+	_particles.x[i] += _RandomFloat(-emitter._x_variation, emitter._x_variation);
+	_particles.y[i] += _RandomFloat(-emitter._y_variation, emitter._y_variation);
 
 	if(params.orientation != 0.0f)
-		RotatePoint(_particles[i].x, _particles[i].y, params.orientation);
+		RotatePoint(_particles.x[i], _particles.y[i], params.orientation);
 
-	_particles[i].color = _system_def->keyframes[0]->color;
+	_particles.color[i] = _system_def->keyframes[0]->color;
 
-	_particles[i].rotation_speed  = _system_def->keyframes[0]->rotation_speed;
-	_particles[i].time            = 0.0f;
-	_particles[i].size_x            = _system_def->keyframes[0]->size_x;
-	_particles[i].size_y            = _system_def->keyframes[0]->size_y;
+	_particles.rotation_speed[i]  = _system_def->keyframes[0]->rotation_speed;
+	_particles.time[i]            = 0.0f;
+	_particles.size_x[i]            = _system_def->keyframes[0]->size_x;
+	_particles.size_y[i]            = _system_def->keyframes[0]->size_y;
 
 	if(_system_def->random_initial_angle)
-		_particles[i].rotation_angle = RandomFloat(0.0f, UTILS_2PI);
+		_particles.rotation_angle[i] = _RandomFloat(0.0f, UTILS_2PI);
 	else
-		_particles[i].rotation_angle = 0.0f;
+		_particles.rotation_angle[i] = 0.0f;
 
-	_particles[i].current_keyframe = _system_def->keyframes[0];
+	_particles.keyframe_state[i].current_keyframe = _system_def->keyframes[0];
 
 	if(_system_def->keyframes.size() > 1)
-		_particles[i].next_keyframe = _system_def->keyframes[1];
+		_particles.keyframe_state[i].next_keyframe = _system_def->keyframes[1];
 	else
-		_particles[i].next_keyframe = NULL;
+		_particles.keyframe_state[i].next_keyframe = NULL;
 
 	float speed = _system_def->emitter._initial_speed;
-	speed += RandomFloat(-emitter._initial_speed_variation, emitter._initial_speed_variation);
+	speed += _RandomFloat(-emitter._initial_speed_variation, emitter._initial_speed_variation);
 
 
 	if(_system_def->emitter._spin == EMITTER_SPIN_CLOCKWISE)
 	{
-		_particles[i].rotation_direction = 1.0f;
+		_particles.rotation_direction[i] = 1.0f;
 	}
 	else if(_system_def->emitter._spin == EMITTER_SPIN_COUNTERCLOCKWISE)
 	{
-		_particles[i].rotation_direction = -1.0f;
+		_particles.rotation_direction[i] = -1.0f;
 	}
 	else
 	{
-		_particles[i].rotation_direction = static_cast<float>(2 * (rand()%2)) - 1.0f;
+		_particles.rotation_direction[i] = (_RandomFloat(0.0f, 1.0f) < 0.5f) ? -1.0f : 1.0f;
 	}
 
 	// figure out the orientation
@@ -888,92 +1048,94 @@ void ParticleSystem::_RespawnParticle(int32 i, const EffectParameters &params)
 
 	if(emitter._omnidirectional)
 	{
-		angle = RandomFloat(0.0f, UTILS_2PI);
+		angle = _RandomFloat(0.0f, UTILS_2PI);
 	}
 	else if(emitter._inner_cone == 0.0f && emitter._outer_cone == 0.0f)
 	{
 		angle = emitter._orientation + params.orientation;
 	}
 
-	_particles[i].velocity_x = speed * cosf(angle);
-	_particles[i].velocity_y = speed * sinf(angle);
+	_particles.velocity_x[i] = speed * cosf(angle);
+	_particles.velocity_y[i] = speed * sinf(angle);
 
 	// figure out property variations
 
-	_particles[i].current_size_variation_x  = RandomFloat(-_system_def->keyframes[0]->size_variation_x, _system_def->keyframes[0]->size_variation_x);
-	_particles[i].current_size_variation_y  = RandomFloat(-_system_def->keyframes[0]->size_variation_y, _system_def->keyframes[0]->size_variation_y);
+	_particles.keyframe_state[i].current_size_variation_x  = _RandomFloat(-_system_def->keyframes[0]->size_variation_x, _system_def->keyframes[0]->size_variation_x);
+	_particles.keyframe_state[i].current_size_variation_y  = _RandomFloat(-_system_def->keyframes[0]->size_variation_y, _system_def->keyframes[0]->size_variation_y);
 
 	for(int32 j = 0; j < 4; ++j)
-		_particles[i].current_color_variation[j] = RandomFloat(-_system_def->keyframes[0]->color_variation[j], _system_def->keyframes[0]->color_variation[j]);
+		_particles.keyframe_state[i].current_color_variation[j] = _RandomFloat(-_system_def->keyframes[0]->color_variation[j], _system_def->keyframes[0]->color_variation[j]);
 
-	_particles[i].current_rotation_speed_variation = RandomFloat(-_system_def->keyframes[0]->rotation_speed_variation, _system_def->keyframes[0]->rotation_speed_variation);
+	_particles.keyframe_state[i].current_rotation_speed_variation = _RandomFloat(-_system_def->keyframes[0]->rotation_speed_variation, _system_def->keyframes[0]->rotation_speed_variation);
 
 	if(_system_def->keyframes.size() > 1)
 	{
 		// figure out the next keyframe's variations
-		_particles[i].next_size_variation_x  = RandomFloat(-_system_def->keyframes[1]->size_variation_x, _system_def->keyframes[1]->size_variation_x);
-		_particles[i].next_size_variation_y  = RandomFloat(-_system_def->keyframes[1]->size_variation_y, _system_def->keyframes[1]->size_variation_y);
+		_particles.keyframe_state[i].next_size_variation_x  = _RandomFloat(-_system_def->keyframes[1]->size_variation_x, _system_def->keyframes[1]->size_variation_x);
+		_particles.keyframe_state[i].next_size_variation_y  = _RandomFloat(-_system_def->keyframes[1]->size_variation_y, _system_def->keyframes[1]->size_variation_y);
 
 		for(int32 j = 0; j < 4; ++j)
-			_particles[i].next_color_variation[j] = RandomFloat(-_system_def->keyframes[1]->color_variation[j], _system_def->keyframes[1]->color_variation[j]);
+			_particles.keyframe_state[i].next_color_variation[j] = _RandomFloat(-_system_def->keyframes[1]->color_variation[j], _system_def->keyframes[1]->color_variation[j]);
+
+		_particles.keyframe_state[i].next_rotation_speed_variation = _RandomFloat(-_system_def->keyframes[1]->rotation_speed_variation, _system_def->keyframes[1]->rotation_speed_variation);
 
-		_particles[i].next_rotation_speed_variation = RandomFloat(-_system_def->keyframes[1]->rotation_speed_variation, _system_def->keyframes[1]->rotation_speed_variation);
+		_BeginKeyframe(i);
 	}
 	else
 	{
 		// if there's only 1 keyframe, then apply the variations now
 		for(int32 j = 0; j < 4; ++j)
-			_particles[i].color[j] += RandomFloat(-_particles[i].current_color_variation[j], _particles[i].current_color_variation[j]);
+			_particles.color[i][j] += _RandomFloat(-_particles.keyframe_state[i].current_color_variation[j], _particles.keyframe_state[i].current_color_variation[j]);
 
-		_particles[i].size_x += RandomFloat(-_particles[i].current_size_variation_x, _particles[i].current_size_variation_x);
-		_particles[i].size_y += RandomFloat(-_particles[i].current_size_variation_y, _particles[i].current_size_variation_y);
+		_particles.size_x[i] += _RandomFloat(-_particles.keyframe_state[i].current_size_variation_x, _particles.keyframe_state[i].current_size_variation_x);
+		_particles.size_y[i] += _RandomFloat(-_particles.keyframe_state[i].current_size_variation_y, _particles.keyframe_state[i].current_size_variation_y);
 
-		_particles[i].rotation_speed += RandomFloat(-_particles[i].current_rotation_speed_variation, _particles[i].current_rotation_speed_variation);
+		_particles.rotation_speed[i] += _RandomFloat(-_particles.keyframe_state[i].current_rotation_speed_variation, _particles.keyframe_state[i].current_rotation_speed_variation);
 	}
 
-	_particles[i].tangential_acceleration = _system_def->tangential_acceleration;
+	_particles.tangential_acceleration[i] = _system_def->tangential_acceleration;
 	if(_system_def->tangential_acceleration_variation != 0.0f)
-		_particles[i].tangential_acceleration += RandomFloat(-_system_def->tangential_acceleration_variation, _system_def->tangential_acceleration_variation);
+		_particles.tangential_acceleration[i] += _RandomFloat(-_system_def->tangential_acceleration_variation, _system_def->tangential_acceleration_variation);
 
-	_particles[i].radial_acceleration = _system_def->radial_acceleration;
+	_particles.radial_acceleration[i] = _system_def->radial_acceleration;
 	if(_system_def->radial_acceleration_variation != 0.0f)
-		_particles[i].radial_acceleration += RandomFloat(-_system_def->radial_acceleration_variation, _system_def->radial_acceleration_variation);
+		_particles.radial_acceleration[i] += _RandomFloat(-_system_def->radial_acceleration_variation, _system_def->radial_acceleration_variation);
 
-	_particles[i].acceleration_x = _system_def->acceleration_x;
+	_particles.acceleration_x[i] = _system_def->acceleration_x;
 	if(_system_def->acceleration_variation_x != 0.0f)
-		_particles[i].acceleration_x += RandomFloat(-_system_def->acceleration_variation_x, _system_def->acceleration_variation_x);
+		_particles.acceleration_x[i] += _RandomFloat(-_system_def->acceleration_variation_x, _system_def->acceleration_variation_x);
 
-	_particles[i].acceleration_y = _system_def->acceleration_y;
+	_particles.acceleration_y[i] = _system_def->acceleration_y;
 	if(_system_def->acceleration_variation_y != 0.0f)
-		_particles[i].acceleration_y += RandomFloat(-_system_def->acceleration_variation_y, _system_def->acceleration_variation_y);
+		_particles.acceleration_y[i] += _RandomFloat(-_system_def->acceleration_variation_y, _system_def->acceleration_variation_y);
 
-	_particles[i].wind_velocity_x = _system_def->wind_velocity_x;
+	_particles.wind_velocity_x[i] = _system_def->wind_velocity_x;
 	if(_system_def->wind_velocity_variation_x != 0.0f)
-		_particles[i].wind_velocity_x += RandomFloat(-_system_def->wind_velocity_variation_x, _system_def->wind_velocity_variation_x);
+		_particles.wind_velocity_x[i] += _RandomFloat(-_system_def->wind_velocity_variation_x, _system_def->wind_velocity_variation_x);
 
-	_particles[i].wind_velocity_y = _system_def->wind_velocity_y;
+	_particles.wind_velocity_y[i] = _system_def->wind_velocity_y;
 	if(_system_def->wind_velocity_variation_y != 0.0f)
-		_particles[i].wind_velocity_y += RandomFloat(-_system_def->wind_velocity_variation_y, _system_def->wind_velocity_variation_y);
+		_particles.wind_velocity_y[i] += _RandomFloat(-_system_def->wind_velocity_variation_y, _system_def->wind_velocity_variation_y);
 
-	_particles[i].damping = _system_def->damping;
+	_particles.damping[i] = _system_def->damping;
 	if(_system_def->damping_variation != 0.0f)
-		_particles[i].damping += RandomFloat(-_system_def->damping_variation, _system_def->damping_variation);
+		_particles.damping[i] += _RandomFloat(-_system_def->damping_variation, _system_def->damping_variation);
 
 	if(_system_def->wave_motion_used)
 	{
-		_particles[i].wave_length_coefficient = _system_def->wave_length;
+		_particles.wave_length_coefficient[i] = _system_def->wave_length;
 		if(_system_def->wave_length_variation != 0.0f)
-			_particles[i].wave_length_coefficient += RandomFloat(-_system_def->wave_length_variation, _system_def->wave_length_variation);
+			_particles.wave_length_coefficient[i] += _RandomFloat(-_system_def->wave_length_variation, _system_def->wave_length_variation);
 
-		_particles[i].wave_length_coefficient = UTILS_2PI / _particles[i].wave_length_coefficient;
+		_particles.wave_length_coefficient[i] = UTILS_2PI / _particles.wave_length_coefficient[i];
 
-		_particles[i].wave_half_amplitude = _system_def->wave_amplitude;
+		_particles.wave_half_amplitude[i] = _system_def->wave_amplitude;
 		if(_system_def->wave_amplitude != 0.0f)
-			_particles[i].wave_half_amplitude += RandomFloat(-_system_def->wave_amplitude_variation, _system_def->wave_amplitude_variation);
-		_particles[i].wave_half_amplitude *= 0.5f;
+			_particles.wave_half_amplitude[i] += _RandomFloat(-_system_def->wave_amplitude_variation, _system_def->wave_amplitude_variation);
+		_particles.wave_half_amplitude[i] *= 0.5f;
 	}
 
-	_particles[i].lifetime = _system_def->particle_lifetime + RandomFloat(-_system_def->particle_lifetime_variation, _system_def->particle_lifetime_variation);
+	_particles.lifetime[i] = _system_def->particle_lifetime + _RandomFloat(-_system_def->particle_lifetime_variation, _system_def->particle_lifetime_variation);
 }
 
 
@@ -987,6 +1149,47 @@ float ParticleSystem::GetAge() const
 }
 
 
+//-----------------------------------------------------------------------------
+// SeedRandom: seeds the system's random number stream
+//-----------------------------------------------------------------------------
+
+void ParticleSystem::SeedRandom(uint32 seed)
+{
+	// Mix the bits of the seed, so that consecutive seeds do not start out with similar streams
+	seed ^= seed >> 16;
+	seed *= 0x7feb352d;
+	seed ^= seed >> 15;
+	seed *= 0x846ca68b;
+	seed ^= seed >> 16;
+
+	// The xorshift generator never leaves the zero state, so that state is not allowed
+	_random_state = (seed != 0) ? seed : 0x9e3779b9;
+}
+
+
+//-----------------------------------------------------------------------------
+// _RandomFloat: returns a random number from the system's own random stream
+//-----------------------------------------------------------------------------
+
+float ParticleSystem::_RandomFloat(float a, float b)
+{
+	_random_state ^= _random_state << 13;
+	_random_state ^= _random_state >> 17;
+	_random_state ^= _random_state << 5;
+
+	// This gives the same distribution as hoa_utils::RandomFloat(), which uses 10001 evenly spaced values
+	if(a > b)
+	{
+		float c = a;
+		a = b;
+		b = c;
+	}
+
+	float r = static_cast<float>(_random_state % 10001);
+	return a + (b - a) * r / 10000.0f;
+}
+
+
 
 }  // namespace private_video
 }  // namespace hoa_video
@@ -59,10 +59,36 @@ public:
 };
 
 
+/*!***************************************************************************
+ *  \brief a request to update a single particle system. The particle manager
+ *         gathers one of these for every system of every active effect, and
+ *         then hands them out to its worker threads. Systems never share any
+ *         data that is modified during an update, so they may be updated in
+ *         any order and on any thread.
+ *****************************************************************************/
+
+class ParticleSystemJob
+{
+public:
+
+	//! the system to update
+	ParticleSystem *system;
+
+	//! parameters of the effect that the system belongs to
+	EffectParameters params;
+
+	//! set to the return value of ParticleSystem::Update() once the job is done
+	bool success;
+};
+
+
 class ParticleSystemDef
 {
 public:
 
+	//! deletes the keyframes
+	~ParticleSystemDef();
+
 
 	//! Is this system supposed to be displayed
 	bool enabled;
@@ -75,6 +101,10 @@ public:
 	//! contain at least 1 keyframe (in that case, the properties are all held constant)
 	std::vector <ParticleKeyframe *> keyframes;
 
+	//! Lookup table for finding which keyframe a particle is on. This must be rebuilt with
+	//! keyframe_table.Build(keyframes) whenever the keyframes change
+	ParticleKeyframeTable keyframe_table;
+
 	//! How to blend the particles: VIDEO_NO_BLEND, VIDEO_BLEND, or VIDEO_BLEND_ADD
 	//! For most effects, we want VIDEO_BLEND_ADD
 	int32 blend_mode;
@@ -228,6 +258,11 @@ public:
 
 	//! Array of filenames for each frame of animation
 	std::vector <std::string> animation_frame_filenames;
+
+
+	//! The animation made from the frames above. It is loaded together with the definition,
+	//! and every system created from the definition shares its images
+	hoa_video::AnimatedImage animation;
 	
 }; // class ParticleSystemDef
 
@@ -307,15 +342,50 @@ public:
 	 */	
 	float GetAge() const;
 
+
+	/*!
+	 *  \brief seeds the random number stream that the system takes all of its random values from
+	 *
+	 *  \note Each system has its own stream, so that a system produces the same particles no matter
+	 *        which thread updates it or in what order the systems of an effect are updated.
+	 * \param seed the seed for the stream, where any value (including zero) may be used
+	 */
+	void SeedRandom(uint32 seed);
+
 private:
 
 
+	/*!
+	 *  \brief returns a random number between a and b, taken from the system's own random stream
+	 *         instead of the global one used by hoa_utils::RandomFloat()
+	 * \param a one bound of the range
+	 * \param b the other bound of the range
+	 * \return a random number between the two bounds, inclusive
+	 */
+	float _RandomFloat(float a, float b);
+
+
 	/*!
 	 *  \brief helper function to update properties of particles
 	 * \param t the current frame time
 	 * \param params the effect parameters to use for this update (orientation and attractor point)
 	 */	
 	void _UpdateParticles(float t, const EffectParameters &params);
+
+
+	/*!
+	 *  \brief helper function to advance particles to their next keyframes, and to
+	 *         interpolate their keyframed properties (size, color, and rotation speed)
+	 */
+	void _UpdateKeyframes();
+
+
+	/*!
+	 *  \brief helper function to store the values that a particle's keyframed properties
+	 *         have at its current keyframe, and how much they change by its next keyframe
+	 * \param i index of the particle, which must have a next keyframe
+	 */
+	void _BeginKeyframe(int32 i);
 	
 
 	/*!
@@ -380,9 +450,9 @@ private:
 	std::vector <Color>            _particle_colors;
 	std::vector <ParticleTexCoord> _particle_texcoords;
 	
-	//! This array holds everything except positions and colors. The reason we keep positions and
-	//! colors separate is so that they can be efficiently fed to OpenGL for rendering.
-	std::vector <Particle>     _particles;
+	//! The properties of all particles, with a separate array for each property. Only the first
+	//! _num_particles elements of each array are active particles.
+	ParticleArrays _particles;
 	
 	//! if stopped is true, no new particles should be emitted
 	bool _stopped;
@@ -395,6 +465,9 @@ private:
 	
 	//! last time the system was updated (based on the system's age)
 	float _last_update_time;
+
+	//! state of the system's random number stream, which is never zero
+	uint32 _random_state;
 	
 }; // class ParticleSystem
 
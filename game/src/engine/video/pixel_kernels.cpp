@@ -0,0 +1,391 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    pixel_kernels.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for pixel format conversion routines
+***
+*** SSE2 has no instruction to rearrange the bytes within a register, so the
+*** SSE2 versions of the conversions between RGB and RGBA instead shift whole
+*** pixels within 32-bit words or 64-bit lanes. x86 processors are always
+*** little endian, which those versions rely upon.
+*** ***************************************************************************/
+
+#include <cstring>
+
+#include "pixel_kernels.h"
+
+#if defined(PIXEL_KERNELS_SSE2)
+	#include <emmintrin.h>
+#elif defined(PIXEL_KERNELS_NEON)
+	#include <arm_neon.h>
+#endif
+
+namespace hoa_video {
+
+namespace private_video {
+
+// Dividing by 100 is done by multiplying by GRAY_DIVISOR_MULTIPLIER and shifting right by GRAY_DIVISOR_SHIFT, which
+// gives the exact quotient for every possible weighted sum (0 - 25500)
+const uint16 GRAY_DIVISOR_MULTIPLIER = 41944;
+const uint32 GRAY_DIVISOR_SHIFT = 22;
+
+// -----------------------------------------------------------------------------
+// Scalar conversions
+// -----------------------------------------------------------------------------
+
+namespace scalar_kernels {
+
+void ExpandGrayToRGBA(const uint8* src, uint8* dst, uint32 count) {
+	for (uint32 i = 0; i < count; i++, dst += 4) {
+		dst[0] = src[i];
+		dst[1] = src[i];
+		dst[2] = src[i];
+		dst[3] = 0xFF;
+	}
+}
+
+
+
+void ExpandRGBToRGBA(const uint8* src, uint8* dst, uint32 count) {
+	for (uint32 i = 0; i < count; i++, src += 3, dst += 4) {
+		dst[0] = src[0];
+		dst[1] = src[1];
+		dst[2] = src[2];
+		dst[3] = 0xFF;
+	}
+}
+
+
+
+void CopyRGBAClearTransparent(const uint8* src, uint8* dst, uint32 count) {
+	for (uint32 i = 0; i < count; i++, src += 4, dst += 4) {
+		if (src[3] == 0) {
+			dst[0] = 0;
+			dst[1] = 0;
+			dst[2] = 0;
+			dst[3] = 0;
+		}
+		else {
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+			dst[3] = src[3];
+		}
+	}
+}
+
+
+
+void PackRGBAToRGB(const uint8* src, uint8* dst, uint32 count) {
+	for (uint32 i = 0; i < count; i++, src += 4, dst += 3) {
+		dst[0] = src[0];
+		dst[1] = src[1];
+		dst[2] = src[2];
+	}
+}
+
+
+
+void ConvertToGrayscale(uint8* pixels, uint32 count, bool rgba) {
+	uint32 format_bytes = (rgba ? 4 : 3);
+	for (uint32 i = 0; i < count; i++, pixels += format_bytes) {
+		uint32 sum = 30 * pixels[0] + 59 * pixels[1] + 11 * pixels[2];
+		uint8 value = static_cast<uint8>((sum * GRAY_DIVISOR_MULTIPLIER) >> GRAY_DIVISOR_SHIFT);
+		pixels[0] = value;
+		pixels[1] = value;
+		pixels[2] = value;
+	}
+}
+
+
+
+void PremultiplyAlpha(uint8* pixels, uint32 count) {
+	for (uint32 i = 0; i < count; i++, pixels += 4) {
+		for (uint32 j = 0; j < 3; j++) {
+			uint32 value = pixels[j] * pixels[3] + 128;
+			pixels[j] = static_cast<uint8>((value + (value >> 8)) >> 8);
+		}
+	}
+}
+
+} // namespace scalar_kernels
+
+// -----------------------------------------------------------------------------
+// Vectorized conversions
+// -----------------------------------------------------------------------------
+
+const char* PixelKernelsName() {
+#if defined(PIXEL_KERNELS_SSE2)
+	return "SSE2";
+#elif defined(PIXEL_KERNELS_NEON)
+	return "NEON";
+#else
+	return "scalar";
+#endif
+}
+
+
+
+void ExpandGrayToRGBA(const uint8* src, uint8* dst, uint32 count) {
+	uint32 i = 0;
+
+#if defined(PIXEL_KERNELS_SSE2)
+	const __m128i opaque = _mm_set1_epi8(static_cast<char>(0xFF));
+	for (; i + 16 <= count; i += 16, dst += 64) {
+		__m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		// Pair each gray value with itself and with an opaque alpha, then interleave the pairs into G G G A pixels
+		__m128i gray_gray_lo = _mm_unpacklo_epi8(gray, gray);
+		__m128i gray_gray_hi = _mm_unpackhi_epi8(gray, gray);
+		__m128i gray_alpha_lo = _mm_unpacklo_epi8(gray, opaque);
+		__m128i gray_alpha_hi = _mm_unpackhi_epi8(gray, opaque);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(gray_gray_lo, gray_alpha_lo));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi16(gray_gray_lo, gray_alpha_lo));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), _mm_unpacklo_epi16(gray_gray_hi, gray_alpha_hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), _mm_unpackhi_epi16(gray_gray_hi, gray_alpha_hi));
+	}
+#elif defined(PIXEL_KERNELS_NEON)
+	for (; i + 16 <= count; i += 16, dst += 64) {
+		uint8x16x4_t rgba;
+		rgba.val[0] = vld1q_u8(src + i);
+		rgba.val[1] = rgba.val[0];
+		rgba.val[2] = rgba.val[0];
+		rgba.val[3] = vdupq_n_u8(0xFF);
+		vst4q_u8(dst, rgba);
+	}
+#endif
+
+	scalar_kernels::ExpandGrayToRGBA(src + i, dst, count - i);
+}
+
+
+
+void ExpandRGBToRGBA(const uint8* src, uint8* dst, uint32 count) {
+	uint32 i = 0;
+
+#if defined(PIXEL_KERNELS_SSE2)
+	for (; i + 4 <= count; i += 4, src += 12, dst += 16) {
+		uint32 in[3];
+		uint32 out[4];
+		memcpy(in, src, 12);
+		out[0] = in[0] | 0xFF000000;
+		out[1] = (in[0] >> 24) | (in[1] << 8) | 0xFF000000;
+		out[2] = (in[1] >> 16) | (in[2] << 16) | 0xFF000000;
+		out[3] = (in[2] >> 8) | 0xFF000000;
+		memcpy(dst, out, 16);
+	}
+#elif defined(PIXEL_KERNELS_NEON)
+	for (; i + 16 <= count; i += 16, src += 48, dst += 64) {
+		uint8x16x3_t rgb = vld3q_u8(src);
+		uint8x16x4_t rgba;
+		rgba.val[0] = rgb.val[0];
+		rgba.val[1] = rgb.val[1];
+		rgba.val[2] = rgb.val[2];
+		rgba.val[3] = vdupq_n_u8(0xFF);
+		vst4q_u8(dst, rgba);
+	}
+#endif
+
+	scalar_kernels::ExpandRGBToRGBA(src, dst, count - i);
+}
+
+
+
+void ExpandPaletteToRGBA(const uint8* src, const uint8* palette, uint8* dst, uint32 count) {
+	for (uint32 i = 0; i < count; i++, dst += 4) {
+		memcpy(dst, palette + 4 * src[i], 4);
+	}
+}
+
+
+
+void CopyRGBAClearTransparent(const uint8* src, uint8* dst, uint32 count) {
+	uint32 i = 0;
+
+#if defined(PIXEL_KERNELS_SSE2)
+	const __m128i alpha_mask = _mm_set1_epi32(0xFF000000);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 4 <= count; i += 4, src += 16, dst += 16) {
+		__m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		__m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(rgba, alpha_mask), zero);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_andnot_si128(transparent, rgba));
+	}
+#elif defined(PIXEL_KERNELS_NEON)
+	const uint32x4_t alpha_mask = vdupq_n_u32(0xFF000000);
+	for (; i + 4 <= count; i += 4, src += 16, dst += 16) {
+		uint32x4_t rgba = vreinterpretq_u32_u8(vld1q_u8(src));
+		uint32x4_t opaque = vtstq_u32(rgba, alpha_mask);
+		vst1q_u8(dst, vreinterpretq_u8_u32(vandq_u32(rgba, opaque)));
+	}
+#endif
+
+	scalar_kernels::CopyRGBAClearTransparent(src, dst, count - i);
+}
+
+
+
+void PackRGBAToRGB(const uint8* src, uint8* dst, uint32 count) {
+	uint32 i = 0;
+
+	// Each group of pixels is read entirely before it is written, and is written no further ahead than it was read,
+	// so these loops are safe to use when converting in place
+#if defined(PIXEL_KERNELS_SSE2)
+	// Each 64-bit lane holds two pixels, which are joined into six consecutive bytes. The two lanes are then stored
+	// with 8-byte writes that overlap, which write two bytes past the end of the group. The loop stops one pixel short
+	// of the end so that those bytes never fall outside of the destination.
+	const __m128i first_pixel_mask = _mm_set1_epi64x(0x0000000000FFFFFFLL);
+	const __m128i second_pixel_mask = _mm_set1_epi64x(0x0000FFFFFF000000LL);
+	for (; i + 5 <= count; i += 4, src += 16, dst += 12) {
+		__m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		__m128i rgb = _mm_or_si128(_mm_and_si128(rgba, first_pixel_mask), _mm_and_si128(_mm_srli_epi64(rgba, 8), second_pixel_mask));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst), rgb);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 6), _mm_unpackhi_epi64(rgb, rgb));
+	}
+#elif defined(PIXEL_KERNELS_NEON)
+	for (; i + 16 <= count; i += 16, src += 64, dst += 48) {
+		uint8x16x4_t rgba = vld4q_u8(src);
+		uint8x16x3_t rgb;
+		rgb.val[0] = rgba.val[0];
+		rgb.val[1] = rgba.val[1];
+		rgb.val[2] = rgba.val[2];
+		vst3q_u8(dst, rgb);
+	}
+#endif
+
+	scalar_kernels::PackRGBAToRGB(src, dst, count - i);
+}
+
+
+
+void ConvertToGrayscale(uint8* pixels, uint32 count, bool rgba) {
+	uint32 i = 0;
+
+#if defined(PIXEL_KERNELS_SSE2)
+	// Only RGBA data is vectorized, since RGB pixels do not line up with the 32-bit lanes of a register
+	if (rgba == true) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i weights = _mm_set_epi16(0, 11, 59, 30, 0, 11, 59, 30);
+		const __m128i multiplier = _mm_set1_epi16(static_cast<int16>(GRAY_DIVISOR_MULTIPLIER));
+		const __m128i alpha_mask = _mm_set1_epi32(0xFF000000);
+		for (; i + 4 <= count; i += 4, pixels += 16) {
+			__m128i rgba_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+
+			// Produces the weighted sums (30R + 59G) and 11B for each pixel, which are added together to give
+			// the full sum of each pixel in the first and third 32-bit lanes
+			__m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(rgba_pixels, zero), weights);
+			__m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(rgba_pixels, zero), weights);
+			lo = _mm_add_epi32(lo, _mm_srli_epi64(lo, 32));
+			hi = _mm_add_epi32(hi, _mm_srli_epi64(hi, 32));
+			lo = _mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0));
+			hi = _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0));
+			__m128i sums = _mm_unpacklo_epi64(lo, hi);
+
+			// The sums fit in 16 bits, where the division can be done with a high multiply
+			__m128i gray = _mm_packs_epi32(sums, sums);
+			gray = _mm_srli_epi16(_mm_mulhi_epu16(gray, multiplier), GRAY_DIVISOR_SHIFT - 16);
+			gray = _mm_unpacklo_epi16(gray, zero);
+
+			gray = _mm_or_si128(gray, _mm_or_si128(_mm_slli_epi32(gray, 8), _mm_slli_epi32(gray, 16)));
+			gray = _mm_or_si128(gray, _mm_and_si128(rgba_pixels, alpha_mask));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), gray);
+		}
+	}
+#elif defined(PIXEL_KERNELS_NEON)
+	const uint16x4_t multiplier = vdup_n_u16(GRAY_DIVISOR_MULTIPLIER);
+	for (; i + 16 <= count; i += 16, pixels += (rgba ? 64 : 48)) {
+		uint8x16x4_t channels;
+		if (rgba == true) {
+			channels = vld4q_u8(pixels);
+		}
+		else {
+			uint8x16x3_t rgb = vld3q_u8(pixels);
+			channels.val[0] = rgb.val[0];
+			channels.val[1] = rgb.val[1];
+			channels.val[2] = rgb.val[2];
+		}
+
+		uint16x8_t sum_lo = vmull_u8(vget_low_u8(channels.val[0]), vdup_n_u8(30));
+		sum_lo = vmlal_u8(sum_lo, vget_low_u8(channels.val[1]), vdup_n_u8(59));
+		sum_lo = vmlal_u8(sum_lo, vget_low_u8(channels.val[2]), vdup_n_u8(11));
+		uint16x8_t sum_hi = vmull_u8(vget_high_u8(channels.val[0]), vdup_n_u8(30));
+		sum_hi = vmlal_u8(sum_hi, vget_high_u8(channels.val[1]), vdup_n_u8(59));
+		sum_hi = vmlal_u8(sum_hi, vget_high_u8(channels.val[2]), vdup_n_u8(11));
+
+		uint16x8_t gray_lo = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(sum_lo), multiplier), 16),
+			vshrn_n_u32(vmull_u16(vget_high_u16(sum_lo), multiplier), 16));
+		uint16x8_t gray_hi = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(sum_hi), multiplier), 16),
+			vshrn_n_u32(vmull_u16(vget_high_u16(sum_hi), multiplier), 16));
+		uint8x16_t gray = vcombine_u8(vmovn_u16(vshrq_n_u16(gray_lo, GRAY_DIVISOR_SHIFT - 16)),
+			vmovn_u16(vshrq_n_u16(gray_hi, GRAY_DIVISOR_SHIFT - 16)));
+
+		channels.val[0] = gray;
+		channels.val[1] = gray;
+		channels.val[2] = gray;
+		if (rgba == true) {
+			vst4q_u8(pixels, channels);
+		}
+		else {
+			uint8x16x3_t rgb;
+			rgb.val[0] = gray;
+			rgb.val[1] = gray;
+			rgb.val[2] = gray;
+			vst3q_u8(pixels, rgb);
+		}
+	}
+#endif
+
+	scalar_kernels::ConvertToGrayscale(pixels, count - i, rgba);
+}
+
+
+
+void PremultiplyAlpha(uint8* pixels, uint32 count) {
+	uint32 i = 0;
+
+#if defined(PIXEL_KERNELS_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i color_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	const __m128i alpha_factor = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+	const __m128i rounding = _mm_set1_epi16(128);
+	for (; i + 4 <= count; i += 4, pixels += 16) {
+		__m128i rgba_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+		__m128i halves[2] = { _mm_unpacklo_epi8(rgba_pixels, zero), _mm_unpackhi_epi8(rgba_pixels, zero) };
+
+		for (uint32 j = 0; j < 2; j++) {
+			// The alpha of each pixel is copied to all four of its lanes, except that alpha itself is multiplied by 255
+			__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[j], _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			alpha = _mm_or_si128(_mm_and_si128(alpha, color_mask), alpha_factor);
+
+			__m128i value = _mm_add_epi16(_mm_mullo_epi16(halves[j], alpha), rounding);
+			halves[j] = _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), _mm_packus_epi16(halves[0], halves[1]));
+	}
+#elif defined(PIXEL_KERNELS_NEON)
+	const uint16x8_t rounding = vdupq_n_u16(128);
+	for (; i + 16 <= count; i += 16, pixels += 64) {
+		uint8x16x4_t rgba = vld4q_u8(pixels);
+		for (uint32 j = 0; j < 3; j++) {
+			uint16x8_t lo = vaddq_u16(vmull_u8(vget_low_u8(rgba.val[j]), vget_low_u8(rgba.val[3])), rounding);
+			uint16x8_t hi = vaddq_u16(vmull_u8(vget_high_u8(rgba.val[j]), vget_high_u8(rgba.val[3])), rounding);
+			rgba.val[j] = vcombine_u8(vshrn_n_u16(vaddq_u16(lo, vshrq_n_u16(lo, 8)), 8),
+				vshrn_n_u16(vaddq_u16(hi, vshrq_n_u16(hi, 8)), 8));
+		}
+		vst4q_u8(pixels, rgba);
+	}
+#endif
+
+	scalar_kernels::PremultiplyAlpha(pixels, count - i);
+}
+
+} // namespace private_video
+
+} // namespace hoa_video
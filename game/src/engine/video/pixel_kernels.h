@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    pixel_kernels.h
+*** \author  agent, agent@local
+*** \brief   Header file for pixel format conversion routines
+***
+*** These functions perform the per-pixel conversions that are done on image
+*** data when it is loaded or manipulated in system memory. When the code is
+*** compiled for a processor with SSE2 (all x86-64 processors) or NEON
+*** instructions, most of the conversions process several pixels at a time.
+*** Otherwise, and for any pixels left over at the end of a row, a scalar
+*** version of each conversion is used. Both versions produce exactly the
+*** same results.
+***
+*** All pixel data is 8 bits per component, in RGB or RGBA order. Pixel counts
+*** are given in pixels, not bytes. Source and destination buffers must not
+*** overlap unless noted otherwise.
+*** ***************************************************************************/
+
+#ifndef __PIXEL_KERNELS_HEADER__
+#define __PIXEL_KERNELS_HEADER__
+
+#include "defs.h"
+#include "utils.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define PIXEL_KERNELS_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define PIXEL_KERNELS_NEON
+#endif
+
+namespace hoa_video {
+
+namespace private_video {
+
+//! \brief Returns the name of the instruction set that the pixel kernels were compiled for ("SSE2", "NEON", or "scalar")
+const char* PixelKernelsName();
+
+//! \brief Expands single channel grayscale pixels to opaque RGBA pixels
+void ExpandGrayToRGBA(const uint8* src, uint8* dst, uint32 count);
+
+//! \brief Expands RGB pixels to opaque RGBA pixels
+void ExpandRGBToRGBA(const uint8* src, uint8* dst, uint32 count);
+
+/** \brief Expands palette indices to RGBA pixels
+*** \param palette A table of 256 RGBA colors, stored in the same byte order as the destination pixels
+***
+*** There is no vectorized version of this conversion, since neither SSE2 nor NEON can look up table entries in parallel.
+**/
+void ExpandPaletteToRGBA(const uint8* src, const uint8* palette, uint8* dst, uint32 count);
+
+/** \brief Copies RGBA pixels, setting the color of every fully transparent pixel to black
+***
+*** When texture smoothing is enabled, OpenGL averages neighboring pixels together, including the color of
+*** transparent pixels. Transparent pixels are made black so that no outline of their color appears around the
+*** edges of an image. The source and destination may be the same buffer.
+**/
+void CopyRGBAClearTransparent(const uint8* src, uint8* dst, uint32 count);
+
+/** \brief Removes the alpha channel from RGBA pixels
+*** The destination may be the same buffer as the source, in which case the conversion is done in place.
+**/
+void PackRGBAToRGB(const uint8* src, uint8* dst, uint32 count);
+
+/** \brief Converts pixels to grayscale in place, leaving any alpha channel unmodified
+*** \param pixels The pixel data to convert
+*** \param count The number of pixels
+*** \param rgba True if the pixels are RGBA, or false if they are RGB
+***
+*** The gray value of a pixel is (30R + 59G + 11B) / 100, rounded down.
+**/
+void ConvertToGrayscale(uint8* pixels, uint32 count, bool rgba);
+
+/** \brief Multiplies the color components of RGBA pixels by their alpha in place
+*** Each component is set to C * A / 255, rounded to the nearest integer.
+**/
+void PremultiplyAlpha(uint8* pixels, uint32 count);
+
+//! \brief The scalar versions of the conversions, which are used when no vector instructions are available
+namespace scalar_kernels {
+
+void ExpandGrayToRGBA(const uint8* src, uint8* dst, uint32 count);
+
+void ExpandRGBToRGBA(const uint8* src, uint8* dst, uint32 count);
+
+void CopyRGBAClearTransparent(const uint8* src, uint8* dst, uint32 count);
+
+void PackRGBAToRGB(const uint8* src, uint8* dst, uint32 count);
+
+void ConvertToGrayscale(uint8* pixels, uint32 count, bool rgba);
+
+void PremultiplyAlpha(uint8* pixels, uint32 count);
+
+} // namespace scalar_kernels
+
+} // namespace private_video
+
+} // namespace hoa_video
+
+#endif // __PIXEL_KERNELS_HEADER__
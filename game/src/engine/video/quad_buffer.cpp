@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    quad_buffer.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the QuadBuffer class
+*** ***************************************************************************/
+
+#include "quad_buffer.h"
+#include "video.h"
+
+using namespace std;
+
+using namespace hoa_utils;
+using namespace hoa_video::private_video;
+
+namespace hoa_video {
+
+QuadBuffer::QuadBuffer() :
+	_layout_generation(0)
+{}
+
+
+
+void QuadBuffer::Clear() {
+	_groups.clear();
+	_quads.clear();
+}
+
+
+
+bool QuadBuffer::AddImage(const StillImage& image, float x, float y) {
+	if (image._texture == NULL) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "image had no texture data and can not be added to the buffer" << endl;
+		return false;
+	}
+
+	Context& current_context = VideoManager->_current_context;
+	float h_dir = current_context.coordinate_system.GetHorizontalDirection();
+	float v_dir = current_context.coordinate_system.GetVerticalDirection();
+
+	// This mirrors the computations done in ImageDescriptor::_DrawOrientation(), except that the screen shaking offset
+	// is applied when the buffer is drawn
+	x += ((current_context.x_align + 1) * image._width) * 0.5f * -h_dir;
+	y += ((current_context.y_align + 1) * image._height) * 0.5f * -v_dir;
+
+	if (current_context.x_flip)
+		x += image._width * h_dir;
+	if (current_context.y_flip)
+		y += image._height * v_dir;
+
+	float x_scale = (h_dir < 0.0f) ? -image._width : image._width;
+	float y_scale = (v_dir < 0.0f) ? -image._height : image._height;
+
+	// The texture coordinates are kept relative to the texture, since the texture may later be moved
+	Quad quad;
+	quad.texture = image._texture;
+	quad.s0 = image._u1;
+	quad.s1 = image._u2;
+	quad.t0 = image._v1;
+	quad.t1 = image._v2;
+
+	if (current_context.x_flip) {
+		float temp = quad.s0;
+		quad.s0 = quad.s1;
+		quad.s1 = temp;
+	}
+	if (current_context.y_flip) {
+		float temp = quad.t0;
+		quad.t0 = quad.t1;
+		quad.t1 = temp;
+	}
+
+	float left = x + image._u1 * x_scale;
+	float right = x + image._u2 * x_scale;
+	float bottom = y + image._v1 * y_scale;
+	float top = y + image._v2 * y_scale;
+
+	quad.vertices[0] = left;
+	quad.vertices[1] = bottom;
+	quad.vertices[2] = right;
+	quad.vertices[3] = bottom;
+	quad.vertices[4] = right;
+	quad.vertices[5] = top;
+	quad.vertices[6] = left;
+	quad.vertices[7] = top;
+
+	if (_quads.empty() == true)
+		_layout_generation = TextureManager->_layout_generation;
+	_quads.push_back(quad);
+	_AddToGroup(quad);
+	return true;
+} // bool QuadBuffer::AddImage(const StillImage& image, float x, float y)
+
+
+
+void QuadBuffer::Draw(const Color& draw_color) const {
+	if (_groups.empty() == true)
+		return;
+
+	// Anything waiting in the video engine's quad batch must be drawn first to retain the correct draw order
+	VideoManager->_FlushBatch();
+
+	// The texture sheets and texture coordinates of the groups are no longer valid once any texture has been moved
+	if (_layout_generation != TextureManager->_layout_generation) {
+		_groups.clear();
+		for (uint32 i = 0; i < _quads.size(); i++)
+			_AddToGroup(_quads[i]);
+		_layout_generation = TextureManager->_layout_generation;
+	}
+
+	Context& current_context = VideoManager->_current_context;
+	uint8 blend = 0;
+	if (current_context.blend == 1)
+		blend = 1;
+	else if (current_context.blend != 0)
+		blend = 2;
+
+	float modulation = VideoManager->_screen_fader.GetFadeModulation();
+	Color color = draw_color * modulation;
+
+	VideoManager->_SetGLBlendMode(blend);
+	VideoManager->_SetGLTexturing(true);
+	VideoManager->_SetGLClientStates(true, true, false);
+	glColor4fv(color.GetColors());
+
+	glPushMatrix();
+	if (VideoManager->_shake_forces.empty() == false) {
+		CoordSys& coord_sys = current_context.coordinate_system;
+		float x_shake = VideoManager->_x_shake * (coord_sys.GetRight() - coord_sys.GetLeft()) / 1024.0f;
+		float y_shake = VideoManager->_y_shake * (coord_sys.GetTop() - coord_sys.GetBottom()) / 768.0f;
+		glTranslatef(x_shake * coord_sys.GetHorizontalDirection(), y_shake * coord_sys.GetVerticalDirection(), 0.0f);
+	}
+
+	for (uint32 i = 0; i < _groups.size(); i++) {
+		const QuadGroup& group = _groups[i];
+
+		TextureManager->_UseTexSheet(group.texture_sheet);
+		TextureManager->_BindTexture(group.texture_sheet->tex_id);
+		group.texture_sheet->Smooth(group.smooth);
+
+		glVertexPointer(2, GL_FLOAT, 0, &group.vertices[0]);
+		glTexCoordPointer(2, GL_FLOAT, 0, &group.tex_coords[0]);
+		glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(group.vertices.size() / 2));
+		VideoManager->_RecordDraw(GL_QUADS, &group.vertices[0], GL_FLOAT, static_cast<uint32>(group.vertices.size() / 2));
+	}
+
+	glPopMatrix();
+
+	if (VideoManager->CheckGLError() == true) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "an OpenGL error occurred: " << VideoManager->CreateGLErrorString() << endl;
+	}
+} // void QuadBuffer::Draw(const Color& draw_color) const
+
+
+
+void QuadBuffer::_AddToGroup(const Quad& quad) const {
+	BaseTexture* texture = quad.texture;
+
+	QuadGroup* group = NULL;
+	for (uint32 i = 0; i < _groups.size(); i++) {
+		if (_groups[i].texture_sheet == texture->texture_sheet && _groups[i].smooth == texture->smooth) {
+			group = &_groups[i];
+			break;
+		}
+	}
+	if (group == NULL) {
+		_groups.push_back(QuadGroup(texture->texture_sheet, texture->smooth));
+		group = &_groups.back();
+	}
+
+	// This mirrors the computations done in ImageDescriptor::_DrawTexture()
+	float s0 = texture->u1 + (quad.s0 * (texture->u2 - texture->u1));
+	float s1 = texture->u1 + (quad.s1 * (texture->u2 - texture->u1));
+	float t0 = texture->v1 + (quad.t0 * (texture->v2 - texture->v1));
+	float t1 = texture->v1 + (quad.t1 * (texture->v2 - texture->v1));
+
+	const GLfloat tex_coords[] = {
+		s0, t1,
+		s1, t1,
+		s1, t0,
+		s0, t0
+	};
+
+	group->vertices.insert(group->vertices.end(), quad.vertices, quad.vertices + 8);
+	group->tex_coords.insert(group->tex_coords.end(), tex_coords, tex_coords + 8);
+}
+
+} // namespace hoa_video
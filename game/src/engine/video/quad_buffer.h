@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    quad_buffer.h
+*** \author  agent, agent@local
+*** \brief   Header file for the QuadBuffer class
+***
+*** A quad buffer holds the pre-computed vertex and texture coordinates of a
+*** large number of static images so that they can all be drawn again every
+*** frame with very few OpenGL calls, and without any per-image CPU work.
+*** ***************************************************************************/
+
+#ifndef __QUAD_BUFFER_HEADER__
+#define __QUAD_BUFFER_HEADER__
+
+#include "defs.h"
+#include "utils.h"
+
+#include "color.h"
+#include "image.h"
+
+namespace hoa_video {
+
+/** ****************************************************************************
+*** \brief A retained list of textured quads that are drawn together
+***
+*** Images are added to the buffer once, at positions relative to the buffer's
+*** origin. When the buffer is drawn, the origin is placed at the current draw
+*** cursor and every quad is drawn with one glDrawArrays() call per texture
+*** sheet used by the buffer's images. This is intended for large groups of
+*** images that never move relative to one another, such as the tiles of a map.
+***
+*** \note The alignment and flip flags of the current draw context are applied
+*** to each image when it is added to the buffer, not when the buffer is drawn.
+*** The blending flag and screen shaking are applied when the buffer is drawn.
+***
+*** \note Only the texture coordinates of the images are retained. The vertex
+*** colors of the images are ignored; the entire buffer is drawn in one color.
+*** Images without a texture (pure color images) can not be added.
+***
+*** \note The buffer holds pointers to the image textures without referencing
+*** them. The images added to the buffer must remain loaded for as long as the
+*** buffer is in use. When the texture manager moves images to another position
+*** or texture sheet, the quads are grouped and their texture coordinates are
+*** computed again the next time that the buffer is drawn.
+*** ***************************************************************************/
+class QuadBuffer {
+public:
+	QuadBuffer();
+
+	~QuadBuffer()
+		{}
+
+	//! \brief Removes all quads from the buffer
+	void Clear();
+
+	/** \brief Adds the quad of a still image to the buffer
+	*** \param image The image to add
+	*** \param x The x coordinate to draw the image at, relative to the origin of the buffer
+	*** \param y The y coordinate to draw the image at, relative to the origin of the buffer
+	*** \return True if the image was added, false if it has no texture data
+	***
+	*** The coordinates are interpreted in the current coordinate system, just as if the draw cursor
+	*** had been moved to (x, y) before drawing the image.
+	**/
+	bool AddImage(const StillImage& image, float x, float y);
+
+	//! \brief Draws all quads in the buffer with the origin at the current draw cursor position
+	void Draw() const
+		{ Draw(Color::white); }
+
+	/** \brief Draws all quads in the buffer, modulated by a color
+	*** \param draw_color The color to modulate the quads by
+	**/
+	void Draw(const Color& draw_color) const;
+
+	//! \brief Returns true if no quads have been added to the buffer
+	bool IsEmpty() const
+		{ return _quads.empty(); }
+
+	//! \brief Returns the number of quads in the buffer
+	uint32 GetNumQuads() const
+		{ return _quads.size(); }
+
+private:
+	//! \brief The data of a single quad that is needed to place it in a group again after its texture has moved
+	class Quad {
+	public:
+		//! \brief The texture that the quad samples from
+		private_video::BaseTexture* texture;
+
+		//! \brief Four x,y vertex coordinate pairs
+		GLfloat vertices[8];
+
+		/** \brief The left, right, bottom, and top texture coordinates of the quad, relative to its texture
+		*** These range from 0.0f to 1.0f across the texture's area of its sheet, and already have the flip flags applied.
+		**/
+		float s0, s1, t0, t1;
+	};
+
+	//! \brief A set of quads that all sample from the same texture sheet with the same smoothing property
+	class QuadGroup {
+	public:
+		QuadGroup(private_video::TexSheet* sheet, bool smooth) :
+			texture_sheet(sheet), smooth(smooth) {}
+
+		//! \brief The texture sheet that all quads in this group sample from
+		private_video::TexSheet* texture_sheet;
+
+		//! \brief True if the texture sheet should be drawn smoothed
+		bool smooth;
+
+		//! \brief Four x,y vertex coordinate pairs for each quad
+		std::vector<GLfloat> vertices;
+
+		//! \brief Four s,t texture coordinate pairs for each quad
+		std::vector<GLfloat> tex_coords;
+	};
+
+	/** \brief The groups of quads held by the buffer
+	*** The number of groups is usually very small (one per texture sheet), so they are kept in a vector and searched linearly.
+	**/
+	mutable std::vector<QuadGroup> _groups;
+
+	//! \brief Every quad added to the buffer, which the groups are built from
+	std::vector<Quad> _quads;
+
+	//! \brief The texture manager's layout generation when the texture coordinates of the groups were computed
+	mutable uint32 _layout_generation;
+
+	/** \brief Adds a quad to the group of its texture's sheet, creating the group if needed
+	*** \param quad The quad to add, whose texture coordinates are computed from the current location of its texture
+	**/
+	void _AddToGroup(const Quad& quad) const;
+}; // class QuadBuffer
+
+} // namespace hoa_video
+
+#endif // __QUAD_BUFFER_HEADER__
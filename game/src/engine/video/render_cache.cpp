@@ -0,0 +1,335 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    render_cache.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the RenderCache class
+*** ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "render_cache.h"
+#include "video.h"
+
+#ifndef APIENTRY
+	#define APIENTRY
+#endif
+
+using namespace std;
+
+using namespace hoa_utils;
+using namespace hoa_video::private_video;
+
+namespace hoa_video {
+
+// Entry point of glBlendFuncSeparate(), which is given its own name so that it does not collide with the declarations
+// made by glext.h or GLEW on platforms that provide them
+typedef void (APIENTRY *BlendFuncSeparateFunction)(GLenum src_rgb, GLenum dst_rgb, GLenum src_alpha, GLenum dst_alpha);
+
+static BlendFuncSeparateFunction blend_func_separate = NULL;
+
+bool RenderCache::_supported = false;
+
+RenderCache::RenderCache() :
+	_dirty(true),
+	_recording(false),
+	_width(0.0f),
+	_height(0.0f),
+	_x_scale(0.0f),
+	_y_scale(0.0f)
+{}
+
+
+
+RenderCache::RenderCache(const RenderCache& copy) :
+	_dirty(true),
+	_recording(false),
+	_width(0.0f),
+	_height(0.0f),
+	_x_scale(0.0f),
+	_y_scale(0.0f)
+{}
+
+
+
+RenderCache& RenderCache::operator=(const RenderCache& copy) {
+	// The offscreen texture is kept, but must be recorded again with the new owner's contents
+	_dirty = true;
+	return *this;
+}
+
+
+
+RenderCache::~RenderCache() {
+	// Caches that still hold a texture are registered with the video engine, which destroys them before the OpenGL
+	// context goes away. Any cache that is still valid here therefore has a context to release its texture in.
+	if (_target.IsValid() == true)
+		Destroy();
+}
+
+
+
+bool RenderCache::InitializeExtension() {
+	_supported = false;
+
+	if (RenderTarget::IsSupported() == false)
+		return false;
+
+	// The function is part of OpenGL 1.4, and available as an extension to earlier versions
+	const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+	const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+	bool core_function = (version != NULL && (version[0] > '1' || (version[0] == '1' && version[2] >= '4')));
+	bool extension_function = (extensions != NULL && strstr(extensions, "GL_EXT_blend_func_separate") != NULL);
+
+	blend_func_separate = NULL;
+	if (core_function == true)
+		blend_func_separate = reinterpret_cast<BlendFuncSeparateFunction>(GetGLProcAddress("glBlendFuncSeparate"));
+	if (blend_func_separate == NULL && extension_function == true)
+		blend_func_separate = reinterpret_cast<BlendFuncSeparateFunction>(GetGLProcAddress("glBlendFuncSeparateEXT"));
+
+	if (blend_func_separate == NULL) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "separate alpha blending is not supported, render caches will be disabled" << endl;
+		return false;
+	}
+
+	_supported = true;
+	return true;
+} // bool RenderCache::InitializeExtension()
+
+
+
+bool RenderCache::BeginRecording(float width, float height) {
+	if (_recording == true) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "the cache was already being recorded" << endl;
+		return false;
+	}
+
+	if (VideoManager->_recording_cache != NULL) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "another render cache was already being recorded" << endl;
+		return false;
+	}
+
+	if (IsSupported() == false || width <= 0.0f || height <= 0.0f)
+		return false;
+
+	// Fading and shaking are applied while images are drawn, so they would be retained in the cached image
+	if (IsFloatEqual(VideoManager->_screen_fader.GetFadeModulation(), 1.0f) == false || VideoManager->_shake_forces.empty() == false)
+		return false;
+
+	// ----- (1): Create a framebuffer that covers the area with the same number of pixels that it has on the screen
+	float x_scale, y_scale;
+	_GetCurrentScale(x_scale, y_scale);
+	int32 pixel_width = static_cast<int32>(ceilf(width * x_scale));
+	int32 pixel_height = static_cast<int32>(ceilf(height * y_scale));
+	if (pixel_width <= 0 || pixel_height <= 0)
+		return false;
+
+	VideoManager->_FlushBatch();
+
+	if (_target.IsValid() == false || _target.GetWidth() != pixel_width || _target.GetHeight() != pixel_height) {
+		uint32 old_size = GetMemorySize();
+		uint32 new_size = RoundUpPow2(pixel_width) * RoundUpPow2(pixel_height) * 4;
+		if (VideoManager->_render_cache_memory - old_size + new_size > VIDEO_RENDER_CACHE_MEMORY_LIMIT)
+			return false;
+
+		Destroy();
+		if (_target.Create(pixel_width, pixel_height) == false) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create the framebuffer for a render cache" << endl;
+			VideoManager->_BindScreenTarget();
+			return false;
+		}
+
+		// The cached image is drawn at the size it was recorded at, so its pixels never need to be interpolated
+		TextureManager->_BindTexture(_target.GetTexture());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		VideoManager->_render_caches.insert(this);
+		VideoManager->_render_cache_memory += GetMemorySize();
+	}
+	else {
+		_target.Bind();
+	}
+
+	// ----- (2): Set up a context that draws into the framebuffer, with the origin at its bottom left corner
+	_width = pixel_width / x_scale;
+	_height = pixel_height / y_scale;
+	_x_scale = x_scale;
+	_y_scale = y_scale;
+
+	VideoManager->PushState();
+	VideoManager->DisableScissoring();
+	VideoManager->_current_context.viewport = ScreenRect(0, 0, pixel_width, pixel_height);
+	glViewport(0, 0, pixel_width, pixel_height);
+	VideoManager->SetCoordSys(CoordSys(0.0f, _width, 0.0f, _height));
+	VideoManager->SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_BOTTOM, VIDEO_X_NOFLIP, VIDEO_Y_NOFLIP, VIDEO_BLEND, 0);
+	VideoManager->Move(0.0f, 0.0f);
+
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	// The blending state must be applied again, since recording changes the blending function of each mode
+	VideoManager->_SetGLBlendMode(0);
+	VideoManager->_recording_cache = this;
+	_recording = true;
+	return true;
+} // bool RenderCache::BeginRecording(float width, float height)
+
+
+
+void RenderCache::EndRecording() {
+	if (_recording == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "the cache was not being recorded" << endl;
+		return;
+	}
+
+	VideoManager->_FlushBatch();
+	VideoManager->_SetGLBlendMode(0);
+	VideoManager->_recording_cache = NULL;
+	_recording = false;
+	_dirty = false;
+
+	VideoManager->_BindScreenTarget();
+
+	// Restores the viewport, coordinate system, and scissoring of the screen
+	VideoManager->PopState();
+}
+
+
+
+void RenderCache::Draw(const Color& draw_color) const {
+	if (_target.IsValid() == false || _recording == true)
+		return;
+
+	// Don't draw anything if the image is completely transparent (invisible)
+	if (IsFloatEqual(draw_color[3], 0.0f) == true)
+		return;
+
+	// Anything waiting in the video engine's quad batch must be drawn first to retain the correct draw order
+	VideoManager->_FlushBatch();
+
+	Context& current_context = VideoManager->_current_context;
+	CoordSys& coord_sys = current_context.coordinate_system;
+
+	// The same alignment, flipping, and shaking offsets that are applied to a StillImage of the same size
+	float x_offset = ((current_context.x_align + 1) * _width) * 0.5f * -coord_sys.GetHorizontalDirection();
+	float y_offset = ((current_context.y_align + 1) * _height) * 0.5f * -coord_sys.GetVerticalDirection();
+	if (VideoManager->_shake_forces.empty() == false) {
+		x_offset += VideoManager->_x_shake * (coord_sys.GetRight() - coord_sys.GetLeft()) / 1024.0f * coord_sys.GetHorizontalDirection();
+		y_offset += VideoManager->_y_shake * (coord_sys.GetTop() - coord_sys.GetBottom()) / 768.0f * coord_sys.GetVerticalDirection();
+	}
+
+	// Only the lower left portion of the target's power-of-two texture holds the image
+	GLfloat s0 = 0.0f;
+	GLfloat s1 = static_cast<GLfloat>(_target.GetWidth()) / static_cast<GLfloat>(_target.GetTextureWidth());
+	GLfloat t0 = 0.0f;
+	GLfloat t1 = static_cast<GLfloat>(_target.GetHeight()) / static_cast<GLfloat>(_target.GetTextureHeight());
+	if (current_context.x_flip)
+		swap(s0, s1);
+	if (current_context.y_flip)
+		swap(t0, t1);
+
+	const GLfloat vertices[] = {
+		0.0f, 0.0f,
+		1.0f, 0.0f,
+		1.0f, 1.0f,
+		0.0f, 1.0f
+	};
+	const GLfloat tex_coords[] = {
+		s0, t0,
+		s1, t0,
+		s1, t1,
+		s0, t1
+	};
+
+	// The texture holds premultiplied colors, so the modulating color must be premultiplied as well
+	float modulation = VideoManager->_screen_fader.GetFadeModulation() * draw_color[3];
+	glColor4f(draw_color[0] * modulation, draw_color[1] * modulation, draw_color[2] * modulation, draw_color[3]);
+
+	VideoManager->_SetGLBlendMode(3);
+	VideoManager->_SetGLTexturing(true);
+	VideoManager->_SetGLClientStates(true, true, false);
+	TextureManager->_BindTexture(_target.GetTexture());
+
+	glPushMatrix();
+	glTranslatef(x_offset, y_offset, 0.0f);
+	glScalef(_width * coord_sys.GetHorizontalDirection(), _height * coord_sys.GetVerticalDirection(), 1.0f);
+	glVertexPointer(2, GL_FLOAT, 0, vertices);
+	glTexCoordPointer(2, GL_FLOAT, 0, tex_coords);
+	glDrawArrays(GL_QUADS, 0, 4);
+	VideoManager->_RecordDraw(GL_QUADS, vertices, GL_FLOAT, 4);
+	glPopMatrix();
+
+	if (VideoManager->CheckGLError() == true) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "an OpenGL error occurred: " << VideoManager->CreateGLErrorString() << endl;
+	}
+} // void RenderCache::Draw(const Color& draw_color) const
+
+
+
+bool RenderCache::IsDirty() const {
+	if (_dirty == true || _target.IsValid() == false)
+		return true;
+
+	float x_scale, y_scale;
+	_GetCurrentScale(x_scale, y_scale);
+	return (IsFloatEqual(x_scale, _x_scale, 0.01f) == false || IsFloatEqual(y_scale, _y_scale, 0.01f) == false);
+}
+
+
+
+void RenderCache::Destroy() {
+	_dirty = true;
+	if (_target.IsValid() == false)
+		return;
+
+	if (VideoManager == NULL) {
+		_target.Destroy();
+		return;
+	}
+
+	// Destroying the framebuffer binds the window's framebuffer, which must not receive the quads waiting in the batch
+	VideoManager->_FlushBatch();
+	VideoManager->_render_cache_memory -= GetMemorySize();
+	VideoManager->_render_caches.erase(this);
+	_target.Destroy();
+
+	if (_recording == false)
+		VideoManager->_BindScreenTarget();
+}
+
+
+
+uint32 RenderCache::GetMemorySize() const {
+	if (_target.IsValid() == false)
+		return 0;
+	return static_cast<uint32>(_target.GetTextureWidth() * _target.GetTextureHeight() * 4);
+}
+
+
+
+void RenderCache::_SetRecordingBlendFunction(uint8 blend_mode) {
+	if (blend_mode == 1)
+		blend_func_separate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
+	else
+		blend_func_separate(GL_SRC_ALPHA, GL_ONE, GL_ONE, GL_ONE); // Additive blending
+}
+
+
+
+void RenderCache::_GetCurrentScale(float& x_scale, float& y_scale) {
+	Context& current_context = VideoManager->_current_context;
+	x_scale = current_context.viewport.width / fabs(current_context.coordinate_system.GetRight() - current_context.coordinate_system.GetLeft());
+	y_scale = current_context.viewport.height / fabs(current_context.coordinate_system.GetTop() - current_context.coordinate_system.GetBottom());
+}
+
+} // namespace hoa_video
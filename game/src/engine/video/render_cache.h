@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    render_cache.h
+*** \author  agent, agent@local
+*** \brief   Header file for the RenderCache class
+***
+*** A render cache retains the result of drawing a group of images in an
+*** offscreen texture, so that the group can be drawn again as a single quad
+*** for as long as its contents do not change. It is used by GUI elements,
+*** whose borders and backgrounds are made of many small images but rarely
+*** change from one frame to the next.
+*** ***************************************************************************/
+
+#ifndef __RENDER_CACHE_HEADER__
+#define __RENDER_CACHE_HEADER__
+
+#include "defs.h"
+#include "utils.h"
+
+#include "color.h"
+#include "render_target.h"
+
+namespace hoa_video {
+
+//! \brief The maximum amount of texture memory, in bytes, that all render caches together may use
+const uint32 VIDEO_RENDER_CACHE_MEMORY_LIMIT = 32 * 1024 * 1024;
+
+/** ****************************************************************************
+*** \brief Retains a drawing in an offscreen texture so that it can be drawn as one quad
+***
+*** A cache is filled by calling BeginRecording(), drawing as usual, and then
+*** calling EndRecording(). Everything drawn in between goes to the cache instead
+*** of the screen. While recording, the draw cursor starts at the origin of the
+*** cache, in a coordinate system that runs from (0, 0) at the bottom left to
+*** (width, height) at the top right. Afterwards Draw() places the cached image
+*** at the draw cursor, aligned by the draw flags in the same way as a StillImage
+*** of the same size.
+***
+*** The owner of a cache must call Invalidate() whenever the recorded contents
+*** would change, and record the cache again when IsDirty() returns true. The
+*** video engine invalidates every cache when the OpenGL context is replaced, and
+*** a cache also becomes dirty when it is drawn at a different scale than it was
+*** recorded at.
+***
+*** Recording can fail, for example when framebuffer objects are not supported
+*** or the caches have used up their share of texture memory. Owners must then
+*** draw their contents directly, as they would without a cache.
+***
+*** \note The cached texture holds colors with premultiplied alpha, so that
+*** translucent images recorded on top of one another blend exactly as they
+*** would on the screen. This requires the glBlendFuncSeparate() function of
+*** OpenGL 1.4 or the GL_EXT_blend_func_separate extension.
+***
+*** \note Copies of a cache are created empty and dirty, since the offscreen
+*** texture can only have one owner.
+*** ***************************************************************************/
+class RenderCache {
+	friend class VideoEngine;
+
+public:
+	RenderCache();
+
+	RenderCache(const RenderCache& copy);
+
+	RenderCache& operator=(const RenderCache& copy);
+
+	~RenderCache();
+
+	/** \brief Retrieves the entry points needed by render caches from the current OpenGL context
+	*** \return True if render caches are supported by the context
+	*** \note This must be called after RenderTarget::InitializeExtension(), every time a new OpenGL context is created.
+	**/
+	static bool InitializeExtension();
+
+	//! \brief Returns true if render caches can be recorded in the current OpenGL context
+	static bool IsSupported()
+		{ return _supported && private_video::RenderTarget::IsSupported(); }
+
+	/** \brief Directs all subsequent drawing into the cache, replacing its previous contents
+	*** \param width The width of the area to record, in units of the current coordinate system
+	*** \param height The height of the area to record, in units of the current coordinate system
+	*** \return True if recording began. If false, nothing was changed and the contents should be drawn directly.
+	***
+	*** Recording is refused while the screen is faded or shaking, since those effects would be retained in the
+	*** cache. Every successful call must be followed by a call to EndRecording().
+	**/
+	bool BeginRecording(float width, float height);
+
+	//! \brief Ends the recording and directs drawing back to the screen
+	void EndRecording();
+
+	//! \brief Draws the cached image at the current draw cursor position
+	void Draw() const
+		{ Draw(Color::white); }
+
+	/** \brief Draws the cached image, modulated by a color
+	*** \param draw_color The color to modulate the image by
+	*** Nothing is drawn if the cache has never been recorded.
+	**/
+	void Draw(const Color& draw_color) const;
+
+	//! \brief Marks the contents of the cache as out of date
+	void Invalidate()
+		{ _dirty = true; }
+
+	/** \brief Returns true if the cache must be recorded before it can be drawn in the current context
+	*** This is the case if the cache was invalidated, was never recorded, or was recorded at a scale different
+	*** from that of the current coordinate system and viewport.
+	**/
+	bool IsDirty() const;
+
+	/** \brief Releases the offscreen texture of the cache and marks it dirty
+	*** This must be called while the OpenGL context that recorded the cache is still active.
+	**/
+	void Destroy();
+
+	//! \brief Returns the amount of texture memory used by the cache, in bytes
+	uint32 GetMemorySize() const;
+
+private:
+	//! \brief True if the current OpenGL context supports separate blending functions for the alpha channel
+	static bool _supported;
+
+	//! \brief The offscreen framebuffer that holds the cached image
+	private_video::RenderTarget _target;
+
+	//! \brief Set when the contents of the cache are out of date
+	bool _dirty;
+
+	//! \brief True between calls to BeginRecording() and EndRecording()
+	bool _recording;
+
+	//! \brief The dimensions of the cached image when it is drawn, in units of the coordinate system it was recorded in
+	float _width, _height;
+
+	//! \brief The number of pixels per coordinate system unit at the time the cache was recorded
+	float _x_scale, _y_scale;
+
+	/** \brief Sets the OpenGL blending function used while a cache is being recorded
+	*** \param blend_mode 1 for normal blending, 2 for additive blending
+	***
+	*** The color channels are blended as usual, while the alpha channel accumulates coverage. This leaves the texture
+	*** with premultiplied colors, as needed by the blending that Draw() uses.
+	**/
+	static void _SetRecordingBlendFunction(uint8 blend_mode);
+
+	//! \brief Computes the number of pixels per coordinate system unit in the current context
+	static void _GetCurrentScale(float& x_scale, float& y_scale);
+}; // class RenderCache
+
+} // namespace hoa_video
+
+#endif // __RENDER_CACHE_HEADER__
@@ -0,0 +1,269 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    render_target.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the RenderTarget class
+*** ***************************************************************************/
+
+#include <cstring>
+
+#include "render_target.h"
+#include "video.h"
+
+// The extension's tokens are not defined by the OpenGL 1.1 headers available on some platforms
+#ifndef GL_FRAMEBUFFER_EXT
+	#define GL_FRAMEBUFFER_EXT 0x8D40
+#endif
+#ifndef GL_COLOR_ATTACHMENT0_EXT
+	#define GL_COLOR_ATTACHMENT0_EXT 0x8CE0
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE_EXT
+	#define GL_FRAMEBUFFER_COMPLETE_EXT 0x8CD5
+#endif
+
+#ifndef APIENTRY
+	#define APIENTRY
+#endif
+
+using namespace std;
+
+using namespace hoa_utils;
+
+namespace hoa_video {
+
+namespace private_video {
+
+// Entry points of the GL_EXT_framebuffer_object extension. These are given their own names so that they do not
+// collide with the declarations made by glext.h or GLEW on platforms that provide them.
+typedef void (APIENTRY *GenFramebuffersFunction)(GLsizei n, GLuint* framebuffers);
+typedef void (APIENTRY *DeleteFramebuffersFunction)(GLsizei n, const GLuint* framebuffers);
+typedef void (APIENTRY *BindFramebufferFunction)(GLenum target, GLuint framebuffer);
+typedef void (APIENTRY *FramebufferTexture2DFunction)(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+typedef GLenum (APIENTRY *CheckFramebufferStatusFunction)(GLenum target);
+
+static GenFramebuffersFunction gen_framebuffers = NULL;
+static DeleteFramebuffersFunction delete_framebuffers = NULL;
+static BindFramebufferFunction bind_framebuffer = NULL;
+static FramebufferTexture2DFunction framebuffer_texture_2d = NULL;
+static CheckFramebufferStatusFunction check_framebuffer_status = NULL;
+
+bool RenderTarget::_supported = false;
+
+RenderTarget::RenderTarget() :
+	_fbo_id(0),
+	_tex_id(INVALID_TEXTURE_ID),
+	_width(0),
+	_height(0),
+	_tex_width(0),
+	_tex_height(0)
+{}
+
+
+
+RenderTarget::~RenderTarget() {
+	// The OpenGL context is usually gone by the time the target is destroyed, so nothing is deleted here
+	if (_fbo_id != 0) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "render target was not destroyed before its destructor was invoked" << endl;
+	}
+}
+
+
+
+bool RenderTarget::InitializeExtension() {
+	_supported = false;
+
+	const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+	if (extensions == NULL || strstr(extensions, "GL_EXT_framebuffer_object") == NULL)
+		return false;
+
+	gen_framebuffers = reinterpret_cast<GenFramebuffersFunction>(GetGLProcAddress("glGenFramebuffersEXT"));
+	delete_framebuffers = reinterpret_cast<DeleteFramebuffersFunction>(GetGLProcAddress("glDeleteFramebuffersEXT"));
+	bind_framebuffer = reinterpret_cast<BindFramebufferFunction>(GetGLProcAddress("glBindFramebufferEXT"));
+	framebuffer_texture_2d = reinterpret_cast<FramebufferTexture2DFunction>(GetGLProcAddress("glFramebufferTexture2DEXT"));
+	check_framebuffer_status = reinterpret_cast<CheckFramebufferStatusFunction>(GetGLProcAddress("glCheckFramebufferStatusEXT"));
+
+	if (gen_framebuffers == NULL || delete_framebuffers == NULL || bind_framebuffer == NULL
+		|| framebuffer_texture_2d == NULL || check_framebuffer_status == NULL)
+	{
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "framebuffer object extension was reported but its functions could not be retrieved" << endl;
+		return false;
+	}
+
+	_supported = true;
+	return true;
+} // bool RenderTarget::InitializeExtension()
+
+
+
+bool RenderTarget::Create(int32 width, int32 height) {
+	Destroy();
+
+	if (_supported == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "framebuffer objects are not supported by the current OpenGL context" << endl;
+		return false;
+	}
+
+	if (width <= 0 || height <= 0) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid dimensions: " << width << "x" << height << endl;
+		return false;
+	}
+
+	_width = width;
+	_height = height;
+	_tex_width = RoundUpPow2(width);
+	_tex_height = RoundUpPow2(height);
+
+	GLuint tex_id = TextureManager->_CreateBlankGLTexture(_tex_width, _tex_height);
+	if (tex_id == INVALID_TEXTURE_ID) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create the color texture for the render target" << endl;
+		return false;
+	}
+
+	gen_framebuffers(1, &_fbo_id);
+	if (_AttachTexture(tex_id) == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "the render target framebuffer was incomplete" << endl;
+		TextureManager->_DeleteTexture(tex_id);
+		Destroy();
+		return false;
+	}
+
+	_tex_id = tex_id;
+	return true;
+} // bool RenderTarget::Create(int32 width, int32 height)
+
+
+
+void RenderTarget::Destroy() {
+	// Textures that are still taken are deleted by their owners, so this target must stop recognizing them
+	_taken_textures.clear();
+
+	if (_fbo_id == 0)
+		return;
+
+	BindDefault();
+	delete_framebuffers(1, &_fbo_id);
+	_fbo_id = 0;
+
+	if (_tex_id != INVALID_TEXTURE_ID) {
+		TextureManager->_DeleteTexture(_tex_id);
+		_tex_id = INVALID_TEXTURE_ID;
+	}
+	for (uint32 i = 0; i < _spare_textures.size(); i++) {
+		TextureManager->_DeleteTexture(_spare_textures[i]);
+	}
+	_spare_textures.clear();
+
+	_width = 0;
+	_height = 0;
+	_tex_width = 0;
+	_tex_height = 0;
+}
+
+
+
+void RenderTarget::Bind() const {
+	bind_framebuffer(GL_FRAMEBUFFER_EXT, _fbo_id);
+}
+
+
+
+void RenderTarget::BindDefault() {
+	if (_supported == true)
+		bind_framebuffer(GL_FRAMEBUFFER_EXT, 0);
+}
+
+
+
+GLuint RenderTarget::BeginTextureRead(GLuint tex_id) {
+	if (_supported == false)
+		return 0;
+
+	GLuint fbo_id = 0;
+	gen_framebuffers(1, &fbo_id);
+	if (fbo_id == 0)
+		return 0;
+
+	bind_framebuffer(GL_FRAMEBUFFER_EXT, fbo_id);
+	framebuffer_texture_2d(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, tex_id, 0);
+	if (check_framebuffer_status(GL_FRAMEBUFFER_EXT) != GL_FRAMEBUFFER_COMPLETE_EXT) {
+		EndTextureRead(fbo_id);
+		return 0;
+	}
+
+	return fbo_id;
+}
+
+
+
+void RenderTarget::EndTextureRead(GLuint fbo_id) {
+	bind_framebuffer(GL_FRAMEBUFFER_EXT, 0);
+	delete_framebuffers(1, &fbo_id);
+}
+
+
+
+GLuint RenderTarget::TakeTexture() {
+	if (_fbo_id == 0) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "the render target has not been created" << endl;
+		return INVALID_TEXTURE_ID;
+	}
+
+	GLuint replacement = INVALID_TEXTURE_ID;
+	if (_spare_textures.empty() == false) {
+		replacement = _spare_textures.back();
+		_spare_textures.pop_back();
+	}
+	else {
+		replacement = TextureManager->_CreateBlankGLTexture(_tex_width, _tex_height);
+		if (replacement == INVALID_TEXTURE_ID) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create a replacement color texture" << endl;
+			return INVALID_TEXTURE_ID;
+		}
+	}
+
+	if (_AttachTexture(replacement) == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "the render target framebuffer was incomplete with the replacement texture" << endl;
+		_spare_textures.push_back(replacement);
+		_AttachTexture(_tex_id);
+		return INVALID_TEXTURE_ID;
+	}
+
+	GLuint taken = _tex_id;
+	_tex_id = replacement;
+	_taken_textures.push_back(taken);
+	return taken;
+} // GLuint RenderTarget::TakeTexture()
+
+
+
+bool RenderTarget::ReclaimTexture(GLuint tex_id) {
+	for (vector<GLuint>::iterator i = _taken_textures.begin(); i != _taken_textures.end(); i++) {
+		if (*i == tex_id) {
+			_taken_textures.erase(i);
+			_spare_textures.push_back(tex_id);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+
+bool RenderTarget::_AttachTexture(GLuint tex_id) {
+	Bind();
+	framebuffer_texture_2d(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, tex_id, 0);
+	return (check_framebuffer_status(GL_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT);
+}
+
+} // namespace private_video
+
+} // namespace hoa_video
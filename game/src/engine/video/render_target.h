@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    render_target.h
+*** \author  agent, agent@local
+*** \brief   Header file for the RenderTarget class
+***
+*** A render target is an offscreen framebuffer object (FBO) that the video
+*** engine draws each frame into before the frame is presented on the screen.
+*** Because the frame lives in an ordinary texture, a copy of the screen can be
+*** made by handing that texture over to an image instead of copying pixels.
+*** ***************************************************************************/
+
+#ifndef __RENDER_TARGET_HEADER__
+#define __RENDER_TARGET_HEADER__
+
+#ifdef __APPLE__
+	#include <OpenGL/gl.h>
+#else
+	#include <GL/gl.h>
+#endif
+
+#include "defs.h"
+#include "utils.h"
+
+namespace hoa_video {
+
+namespace private_video {
+
+/** ****************************************************************************
+*** \brief An offscreen framebuffer with a single color texture attachment
+***
+*** The framebuffer is implemented with the GL_EXT_framebuffer_object extension.
+*** The entry points of the extension are retrieved at run-time, so the game
+*** still runs on drivers that do not support it. InitializeExtension() must be
+*** called every time a new OpenGL context is created, and no other method may be
+*** used if it returns false.
+***
+*** The color texture is created with power-of-two dimensions, which may be
+*** larger than the width and height requested for the target. Only the lower
+*** left width x height pixels of the texture are used.
+***
+*** \note The texture attached to the framebuffer can be swapped out by calling
+*** TakeTexture(). The taken texture is then owned by the caller, who should
+*** return it through ReclaimTexture() instead of deleting it, so that it may be
+*** attached again when the next texture is taken.
+*** ***************************************************************************/
+class RenderTarget {
+public:
+	RenderTarget();
+
+	~RenderTarget();
+
+	/** \brief Retrieves the framebuffer object entry points from the current OpenGL context
+	*** \return True if framebuffer objects are supported by the context
+	**/
+	static bool InitializeExtension();
+
+	//! \brief Returns true if the last call to InitializeExtension() succeeded
+	static bool IsSupported()
+		{ return _supported; }
+
+	/** \brief Creates the framebuffer object and its color texture
+	*** \param width The width of the target, in pixels
+	*** \param height The height of the target, in pixels
+	*** \return True if the framebuffer was created and is complete
+	***
+	*** Any previously created framebuffer is destroyed first. If the call fails, the target is left invalid.
+	**/
+	bool Create(int32 width, int32 height);
+
+	/** \brief Deletes the framebuffer object, its color texture, and any spare textures
+	*** This must be called while the OpenGL context that created the target is still active.
+	*** Textures that have been taken from the target and not yet reclaimed are left to their owners.
+	**/
+	void Destroy();
+
+	//! \brief Directs all subsequent drawing into the target
+	void Bind() const;
+
+	//! \brief Directs all subsequent drawing to the window's framebuffer
+	static void BindDefault();
+
+	/** \brief Detaches the color texture that holds the target's contents and attaches another one in its place
+	*** \return The OpenGL id of the detached texture, or INVALID_TEXTURE_ID if no replacement texture could be attached
+	***
+	*** The replacement texture is a previously reclaimed texture if one is available, so that no texture memory
+	*** needs to be allocated. The contents of the replacement texture are undefined until the target is next cleared.
+	**/
+	GLuint TakeTexture();
+
+	/** \brief Returns a texture previously retrieved through TakeTexture() to the target
+	*** \param tex_id The OpenGL id of the texture that is no longer needed
+	*** \return True if the texture was taken from this target and is now retained by it, false otherwise
+	***
+	*** When this method returns false, the caller remains responsible for deleting the texture.
+	**/
+	bool ReclaimTexture(GLuint tex_id);
+
+	/** \brief Attaches an existing texture to a temporary framebuffer, so that glCopyTexSubImage2D() reads from it
+	*** \param tex_id The OpenGL id of the texture to read from, which remains owned by the caller
+	*** \return The OpenGL id of the temporary framebuffer, or 0 if the texture could not be attached
+	***
+	*** The temporary framebuffer is left bound and must be deleted with EndTextureRead(), after which no framebuffer
+	*** is bound. This allows the contents of one texture to be copied into another without passing through system memory.
+	**/
+	static GLuint BeginTextureRead(GLuint tex_id);
+
+	/** \brief Deletes a temporary framebuffer created by BeginTextureRead()
+	*** \param fbo_id The OpenGL id of the framebuffer
+	**/
+	static void EndTextureRead(GLuint fbo_id);
+
+	//! \brief Returns true if the framebuffer has been created and may be drawn into
+	bool IsValid() const
+		{ return _fbo_id != 0; }
+
+	//! \name Class Member Access Functions
+	//@{
+	GLuint GetTexture() const
+		{ return _tex_id; }
+
+	int32 GetWidth() const
+		{ return _width; }
+
+	int32 GetHeight() const
+		{ return _height; }
+
+	int32 GetTextureWidth() const
+		{ return _tex_width; }
+
+	int32 GetTextureHeight() const
+		{ return _tex_height; }
+	//@}
+
+private:
+	//! \brief True if the current OpenGL context supports framebuffer objects
+	static bool _supported;
+
+	//! \brief The OpenGL id of the framebuffer object, or 0 if the target has not been created
+	GLuint _fbo_id;
+
+	//! \brief The OpenGL id of the texture currently attached to the framebuffer
+	GLuint _tex_id;
+
+	//! \brief The dimensions of the target, in pixels
+	int32 _width, _height;
+
+	//! \brief The power-of-two dimensions of the color textures used by the target, in pixels
+	int32 _tex_width, _tex_height;
+
+	//! \brief Textures of the target's dimensions that have been reclaimed and are free to attach
+	std::vector<GLuint> _spare_textures;
+
+	//! \brief Textures that have been taken from the target and not yet reclaimed
+	std::vector<GLuint> _taken_textures;
+
+	/** \brief Attaches a texture to the framebuffer as its color buffer
+	*** \param tex_id The OpenGL id of the texture to attach
+	*** \return True if the framebuffer is complete with the texture attached
+	**/
+	bool _AttachTexture(GLuint tex_id);
+}; // class RenderTarget
+
+} // namespace private_video
+
+} // namespace hoa_video
+
+#endif // __RENDER_TARGET_HEADER__
@@ -263,7 +263,7 @@ void TextElement::Draw(const Color& draw_color) const {
 		return;
 	}
 
-	glPushMatrix();
+	VideoManager->PushMatrix();
 	_DrawOrientation();
 
 	float modulation = VideoManager->_screen_fader.GetFadeModulation();
@@ -284,7 +284,7 @@ void TextElement::Draw(const Color& draw_color) const {
 		_DrawTexture(modulated_colors);
 	}
 
-	glPopMatrix();
+	VideoManager->PopMatrix();
 } // void TextElement::Draw(const Color& draw_color) const
 
 
@@ -401,12 +401,14 @@ void TextImage::Clear() {
 
 
 void TextImage::Draw() const {
-	glPushMatrix();
+	VideoManager->BeginRenderPass(VIDEO_RENDER_PASS_TEXT);
+	VideoManager->PushMatrix();
 	for (uint32 i = 0; i < _text_sections.size(); ++i) {
 		_text_sections[i]->Draw();
 		VideoManager->MoveRelative(0.0f, TextManager->GetFontProperties(_style.font)->line_skip * -VideoManager->_current_context.coordinate_system.GetVerticalDirection());
 	}
-	glPopMatrix();
+	VideoManager->PopMatrix();
+	VideoManager->EndRenderPass();
 }
 
 
@@ -417,12 +419,14 @@ void TextImage::Draw(const Color& draw_color) const {
 		return;
 	}
 
-	glPushMatrix();
+	VideoManager->BeginRenderPass(VIDEO_RENDER_PASS_TEXT);
+	VideoManager->PushMatrix();
 	for (uint32 i = 0; i < _text_sections.size(); ++i) {
 		_text_sections[i]->Draw(draw_color);
 		VideoManager->MoveRelative(0.0f, TextManager->GetFontProperties(_style.font)->line_skip * -VideoManager->_current_context.coordinate_system.GetVerticalDirection());
 	}
-	glPopMatrix();
+	VideoManager->PopMatrix();
+	VideoManager->EndRenderPass();
 }
 
 
@@ -522,8 +526,13 @@ TextSupervisor::~TextSupervisor() {
 
 		if (fp->glyph_cache != NULL) {
 			for (uint32 j = 0; j < fp->glyph_cache->size(); j++) {
-				if (fp->glyph_cache->at(j) != NULL)
-					delete fp->glyph_cache->at(j);
+				FontGlyph* glyph = fp->glyph_cache->at(j);
+				if (glyph != NULL) {
+					if (glyph->texture->texture_sheet != NULL)
+						glyph->texture->texture_sheet->RemoveTexture(glyph->texture);
+					delete glyph->texture;
+					delete glyph;
+				}
 			}
 			delete fp->glyph_cache;
 		}
@@ -583,6 +592,7 @@ bool TextSupervisor::LoadFont(const string& filename, const string& font_name, u
 
 	// Create the glyph cache for the font and add it to the font map
 	fp->glyph_cache = new vector<FontGlyph*>;
+	_InitializeMetricTables(fp);
 	_font_map[font_name] = fp;
 	return true;
 } // bool TextSupervisor::LoadFont(...)
@@ -623,6 +633,7 @@ void TextSupervisor::Draw(const ustring& text, const TextStyle& style) {
 	}
 
 	FontProperties* fp = _font_map[style.font];
+	VideoManager->BeginRenderPass(VIDEO_RENDER_PASS_TEXT);
 	VideoManager->PushState();
 
 	// Break the string into lines and render the shadow and text for each line
@@ -648,25 +659,26 @@ void TextSupervisor::Draw(const ustring& text, const TextStyle& style) {
 		}
 
 		// Save the draw cursor position before drawing this text
-		glPushMatrix();
+		VideoManager->PushMatrix();
 
 		// If text shadows are enabled, draw the shadow first
 		if (style.shadow_style != VIDEO_TEXT_SHADOW_NONE) {
-			glPushMatrix();
+			VideoManager->PushMatrix();
 			VideoManager->MoveRelative(VideoManager->_current_context.coordinate_system.GetHorizontalDirection() * style.shadow_offset_x, 0.0f);
 			VideoManager->MoveRelative(0.0f, VideoManager->_current_context.coordinate_system.GetVerticalDirection() * style.shadow_offset_y);
 			_DrawTextHelper(buffer, fp, _GetTextShadowColor(style));
-			glPopMatrix();
+			VideoManager->PopMatrix();
 		}
 
 		// Now draw the text itself, restore the position of the draw cursor, and move the draw cursor one line down
 		_DrawTextHelper(buffer, fp, style.color);
-		glPopMatrix();
+		VideoManager->PopMatrix();
 		VideoManager->MoveRelative(0, -fp->line_skip * VideoManager->_current_context.coordinate_system.GetVerticalDirection());
 
 	} while (last_line < text.length());
 
 	VideoManager->PopState();
+	VideoManager->EndRenderPass();
 } // void TextSupervisor::Draw(const ustring& text)
 
 
@@ -677,8 +689,13 @@ int32 TextSupervisor::CalculateTextWidth(const string& font_name, const hoa_util
 		return -1;
 	}
 
+	FontProperties* fp = _font_map[font_name];
 	int32 width;
-	if (TTF_SizeUNICODE(_font_map[font_name]->ttf_font, text.c_str(), &width, NULL) == -1) {
+	if (_CalculateCachedTextWidth(fp, text.c_str(), text.length(), width) == true) {
+		return width;
+	}
+
+	if (TTF_SizeUNICODE(fp->ttf_font, text.c_str(), &width, NULL) == -1) {
 		IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TTF_SizeUNICODE failed with TTF error: " << TTF_GetError() << endl;
 		return -1;
 	}
@@ -694,8 +711,19 @@ int32 TextSupervisor::CalculateTextWidth(const string& font_name, const string&
 		return -1;
 	}
 
+	// SDL_ttf measures standard strings by treating each byte as a Latin-1 character, which maps directly to the same unicode value
+	FontProperties* fp = _font_map[font_name];
+	_measure_buffer.resize(text.length());
+	for (uint32 i = 0; i < text.length(); i++) {
+		_measure_buffer[i] = static_cast<uint8>(text[i]);
+	}
+
 	int32 width;
-	if (TTF_SizeText(_font_map[font_name]->ttf_font, text.c_str(), &width, NULL) == -1) {
+	if (text.empty() == false && _CalculateCachedTextWidth(fp, &_measure_buffer[0], text.length(), width) == true) {
+		return width;
+	}
+
+	if (TTF_SizeText(fp->ttf_font, text.c_str(), &width, NULL) == -1) {
 		IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TTF_SizeText failed with TTF error: " << TTF_GetError() << endl;
 		return -1;
 	}
@@ -760,7 +788,6 @@ void TextSupervisor::_CacheGlyphs(const uint16* text, FontProperties* fp) {
 	SDL_Surface* initial = NULL;
 	SDL_Surface* intermediary = NULL;
 	int32 w, h;
-	GLuint texture;
 
 	// First find the maximum character and make sure that the glyph cache is large enough to hold it
 	uint16 max_character = 0;
@@ -794,8 +821,10 @@ void TextSupervisor::_CacheGlyphs(const uint16* text, FontProperties* fp) {
 			}
 		}
 
-		w = RoundUpPow2(initial->w + 1);
-		h = RoundUpPow2(initial->h + 1);
+		// The glyph is placed one pixel in from the top-left of its area in the glyph sheet, and a transparent column and row are
+		// added to the right and bottom of it. This retains a transparent border around each glyph in the sheet.
+		w = initial->w + 2;
+		h = initial->h + 2;
 
 		intermediary = SDL_CreateRGBSurface(0, w, h, 32, RMASK, GMASK, BMASK, AMASK);
 		if (intermediary == NULL) {
@@ -804,18 +833,14 @@ void TextSupervisor::_CacheGlyphs(const uint16* text, FontProperties* fp) {
 			return;
 		}
 
-
-		if (SDL_BlitSurface(initial, 0, intermediary, 0) < 0) {
+		SDL_Rect glyph_position = { 1, 1, 0, 0 };
+		if (SDL_BlitSurface(initial, 0, intermediary, &glyph_position) < 0) {
 			SDL_FreeSurface(initial);
 			SDL_FreeSurface(intermediary);
 			IF_PRINT_WARNING(VIDEO_DEBUG) << "call to SDL_BlitSurface() failed" << endl;
 			return;
 		}
 
-		glGenTextures(1, &texture);
-		TextureManager->_BindTexture(texture);
-
-
 		SDL_LockSurface(intermediary);
 
 		uint32 num_bytes = w * h * 4;
@@ -826,15 +851,22 @@ void TextSupervisor::_CacheGlyphs(const uint16* text, FontProperties* fp) {
 			(static_cast<uint8*>(intermediary->pixels))[j+2] = 0xff;
 		}
 
-		glTexImage2D(GL_TEXTURE_2D, 0, 4, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, intermediary->pixels );
+		ImageMemory glyph_data;
+		glyph_data.width = w;
+		glyph_data.height = h;
+		glyph_data.pixels = intermediary->pixels;
+		glyph_data.rgb_format = false;
+
+		BaseTexture* texture = new BaseTexture(w, h);
+		TexSheet* sheet = TextureManager->_InsertGlyphInTexSheet(texture, glyph_data);
+		glyph_data.pixels = NULL; // The pixels are owned by the SDL surface
 		SDL_UnlockSurface(intermediary);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-		if (VideoManager->CheckGLError()) {
+		if (sheet == NULL) {
+			delete texture;
 			SDL_FreeSurface(initial);
 			SDL_FreeSurface(intermediary);
-			IF_PRINT_WARNING(VIDEO_DEBUG) << "an OpenGL error was detected: " << VideoManager->CreateGLErrorString() << endl;
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextureController::_InsertGlyphInTexSheet() failed" << endl;
 			return;
 		}
 
@@ -842,6 +874,8 @@ void TextSupervisor::_CacheGlyphs(const uint16* text, FontProperties* fp) {
 		int miny, maxy;
 		int advance;
 		if (TTF_GlyphMetrics(font, character, &minx, &maxx, &miny, &maxy, &advance) != 0) {
+			sheet->RemoveTexture(texture);
+			delete texture;
 			SDL_FreeSurface(initial);
 			SDL_FreeSurface(intermediary);
 			IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TTF_GlyphMetrics() failed" << endl;
@@ -855,8 +889,10 @@ void TextSupervisor::_CacheGlyphs(const uint16* text, FontProperties* fp) {
 		glyph->top_y = fp->ascent - maxy;
 		glyph->width = initial->w + 1;
 		glyph->height = initial->h + 1;
-		glyph->max_x = static_cast<float>(initial->w + 1) / static_cast<float>(w);
-		glyph->max_y = static_cast<float>(initial->h + 1) / static_cast<float>(h);
+		glyph->tex_min_x = static_cast<float>(texture->x + 1) / static_cast<float>(sheet->width);
+		glyph->tex_min_y = static_cast<float>(texture->y + 1) / static_cast<float>(sheet->height);
+		glyph->tex_max_x = static_cast<float>(texture->x + 1 + glyph->width) / static_cast<float>(sheet->width);
+		glyph->tex_max_y = static_cast<float>(texture->y + 1 + glyph->height) / static_cast<float>(sheet->height);
 		glyph->advance = advance;
 
 		fp->glyph_cache->at(character) = glyph;
@@ -879,19 +915,19 @@ void TextSupervisor::_DrawTextHelper(const uint16* const text, FontProperties* f
 		return;
 	}
 
-	glBlendFunc(GL_ONE, GL_ONE);
-	glEnable(GL_BLEND);
+	// Glyphs are drawn directly, so any images waiting in the batch must be drawn first to preserve draw order
+	VideoManager->_FlushBatch();
 
 	CoordSys& cs = VideoManager->_current_context.coordinate_system;
 
 	_CacheGlyphs(text, fp);
 
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_TEXTURE_2D);
+	VideoManager->_SetGLBlendMode(1);
+	VideoManager->_SetGLTexturing(true);
 	glEnable(GL_ALPHA_TEST);
 	glAlphaFunc(GL_GREATER, 0.1f);
 
-	glPushMatrix();
+	VideoManager->PushMatrix();
 
 	int font_width, font_height;
 	if (TTF_SizeUNICODE(fp->ttf_font, text, &font_width, &font_height) != 0) {
@@ -907,18 +943,22 @@ void TextSupervisor::_DrawTextHelper(const uint16* const text, FontProperties* f
 	float modulation = VideoManager->_screen_fader.GetFadeModulation();
 	Color final_color = text_color * modulation;
 
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	GLint vertices[8];
-	GLfloat tex_coords[8];
-	glVertexPointer(2, GL_INT, 0, vertices);
-	glTexCoordPointer(2, GL_FLOAT, 0, tex_coords);
+	VideoManager->_SetGLClientStates(true, true, false);
+	glColor4fv((GLfloat*)&final_color);
 
-	// Iterate through each character in the string and render the character glyphs one at a time
+	// Collect the quads of every glyph in the line into a single vertex array. The glyphs of a line are nearly always found in
+	// the same glyph sheet, but if they are not the glyphs collected so far are drawn whenever the sheet changes.
+	TexSheet* current_sheet = NULL;
 	int xpos = 0;
 	for (const uint16* glyph = text; *glyph != 0; ++glyph) {
+		if (*glyph >= fp->glyph_cache->size() || (*fp->glyph_cache)[*glyph] == NULL)
+			continue;
+
 		FontGlyph* glyph_info = (*fp->glyph_cache)[*glyph];
+		if (glyph_info->texture->texture_sheet != current_sheet) {
+			_DrawLineGlyphs(current_sheet);
+			current_sheet = glyph_info->texture->texture_sheet;
+		}
 
 		int x_hi = glyph_info->width;
 		int y_hi = glyph_info->height;
@@ -931,48 +971,238 @@ void TextSupervisor::_DrawTextHelper(const uint16* const text, FontProperties* f
 		min_x = glyph_info->min_x * static_cast<int>(cs.GetHorizontalDirection()) + xpos;
 		min_y = glyph_info->min_y * static_cast<int>(cs.GetVerticalDirection());
 
-		float tx, ty;
-		tx = glyph_info->max_x;
-		ty = glyph_info->max_y;
-
-		TextureManager->_BindTexture(glyph_info->texture);
-		if (VideoManager->CheckGLError()) {
-			IF_PRINT_WARNING(VIDEO_DEBUG) << "OpenGL error detected: " << VideoManager->CreateGLErrorString() << endl;
-			return;
-		}
-
-		vertices[0] = min_x;
-		vertices[1] = min_y;
-		vertices[2] = min_x + x_hi;
-		vertices[3] = min_y;
-		vertices[4] = min_x + x_hi;
-		vertices[5] = min_y + y_hi;
-		vertices[6] = min_x;
-		vertices[7] = min_y + y_hi;
-		tex_coords[0] = 0.0f;
-		tex_coords[1] = ty;
-		tex_coords[2] = tx;
-		tex_coords[3] = ty;
-		tex_coords[4] = tx;
-		tex_coords[5] = 0.0f;
-		tex_coords[6] = 0.0f;
-		tex_coords[7] = 0.0f;
-
-		glColor4fv((GLfloat*)&final_color);
-		glDrawArrays(GL_QUADS, 0, 4);
+		const GLint vertices[] = {
+			min_x, min_y,
+			min_x + x_hi, min_y,
+			min_x + x_hi, min_y + y_hi,
+			min_x, min_y + y_hi
+		};
+		const GLfloat tex_coords[] = {
+			glyph_info->tex_min_x, glyph_info->tex_max_y,
+			glyph_info->tex_max_x, glyph_info->tex_max_y,
+			glyph_info->tex_max_x, glyph_info->tex_min_y,
+			glyph_info->tex_min_x, glyph_info->tex_min_y
+		};
+		_line_vertices.insert(_line_vertices.end(), vertices, vertices + 8);
+		_line_tex_coords.insert(_line_tex_coords.end(), tex_coords, tex_coords + 8);
 
 		xpos += glyph_info->advance;
 	} // for (const uint16* glyph = text; *glyph != 0; glyph++)
 
-	glDisableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-	glPopMatrix();
+	_DrawLineGlyphs(current_sheet);
+
+	VideoManager->PopMatrix();
 
 	glDisable(GL_ALPHA_TEST);
+
+	if (VideoManager->CheckGLError()) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "OpenGL error detected: " << VideoManager->CreateGLErrorString() << endl;
+	}
 } // void TextSupervisor::_DrawTextHelper(const uint16* const text, FontProperties* fp, Color color)
 
 
 
+void TextSupervisor::_DrawLineGlyphs(TexSheet* sheet) {
+	if (_line_vertices.empty() == true)
+		return;
+
+	TextureManager->_BindTexture(sheet->tex_id);
+	glVertexPointer(2, GL_INT, 0, &_line_vertices[0]);
+	glTexCoordPointer(2, GL_FLOAT, 0, &_line_tex_coords[0]);
+	glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(_line_vertices.size() / 2));
+	VideoManager->_RecordDraw(GL_QUADS, &_line_vertices[0], GL_INT, static_cast<uint32>(_line_vertices.size() / 2));
+
+	_line_vertices.clear();
+	_line_tex_coords.clear();
+}
+
+
+
+bool TextSupervisor::_GetGlyphMetrics(FontProperties* fp, uint16 character, GlyphMetrics& metrics) {
+	if (character >= fp->glyph_metrics.size()) {
+		fp->glyph_metrics.resize(character + 1);
+	}
+
+	GlyphMetrics& cached_metrics = fp->glyph_metrics[character];
+	if (cached_metrics.cached == false) {
+		int minx, maxx, miny, maxy, advance;
+		if (TTF_GlyphMetrics(fp->ttf_font, character, &minx, &maxx, &miny, &maxy, &advance) == 0) {
+			cached_metrics.min_x = minx;
+			cached_metrics.max_x = maxx;
+			cached_metrics.advance = advance;
+			cached_metrics.valid = true;
+		}
+		cached_metrics.cached = true;
+	}
+
+	metrics = cached_metrics;
+	return metrics.valid;
+}
+
+
+
+bool TextSupervisor::_GetKerning(FontProperties* fp, uint16 first, uint16 second, int32& kerning) {
+	uint32 key = (static_cast<uint32>(first) << 16) | second;
+	map<uint32, int32>::iterator pair_entry = fp->kerning.find(key);
+	if (pair_entry != fp->kerning.end()) {
+		kerning = pair_entry->second;
+		return (kerning != UNKNOWN_KERNING);
+	}
+
+	kerning = UNKNOWN_KERNING;
+	GlyphMetrics first_metrics, second_metrics;
+	uint16 pair[3] = { first, second, 0 };
+	int32 measured_width;
+
+	if (_GetGlyphMetrics(fp, first, first_metrics) == true && _GetGlyphMetrics(fp, second, second_metrics) == true
+		&& TTF_SizeUNICODE(fp->ttf_font, pair, &measured_width, NULL) == 0)
+	{
+		// Try every reasonable offset and keep the one that reproduces the measured width. If more than one offset does, or if
+		// the width can not be calculated for some offset, the offset of this pair is ambiguous and remains unknown.
+		int32 first_right = (first_metrics.advance > first_metrics.max_x) ? first_metrics.advance : first_metrics.max_x;
+		int32 second_right = (second_metrics.advance > second_metrics.max_x) ? second_metrics.advance : second_metrics.max_x;
+		uint32 num_matches = 0;
+		bool ambiguous = false;
+
+		for (int32 offset = -fp->height; offset <= fp->height && ambiguous == false; offset++) {
+			int32 second_x = first_metrics.advance + offset;
+
+			int32 min_x = 0;
+			if (first_metrics.min_x < min_x)
+				min_x = first_metrics.min_x;
+			if (second_x + second_metrics.min_x < min_x)
+				min_x = second_x + second_metrics.min_x;
+
+			int32 max_x = 0;
+			if (first_right > max_x)
+				max_x = first_right;
+			if (second_x + second_right > max_x)
+				max_x = second_x + second_right;
+
+			int32 width;
+			if (_ResolveTextWidth(fp, min_x, max_x, width) == false) {
+				ambiguous = true;
+			}
+			else if (width == measured_width) {
+				kerning = offset;
+				num_matches++;
+			}
+		}
+
+		if (ambiguous == true || num_matches != 1) {
+			kerning = UNKNOWN_KERNING;
+		}
+	}
+
+	fp->kerning[key] = kerning;
+	return (kerning != UNKNOWN_KERNING);
+} // bool TextSupervisor::_GetKerning(FontProperties* fp, uint16 first, uint16 second, int32& kerning)
+
+
+
+bool TextSupervisor::_ResolveTextWidth(FontProperties* fp, int32 min_x, int32 max_x, int32& width) {
+	// Both rules agree when the text does not extend to the left of its draw position, which is the case for most text
+	if (min_x == 0 || fp->width_rule == TEXT_WIDTH_RULE_RIGHT_EXTENT) {
+		width = max_x;
+		return true;
+	}
+	else if (fp->width_rule == TEXT_WIDTH_RULE_FULL_EXTENT) {
+		width = max_x - min_x;
+		return true;
+	}
+
+	return false;
+}
+
+
+
+bool TextSupervisor::_CalculateCachedTextWidth(FontProperties* fp, const uint16* text, uint32 length, int32& width) {
+	if (fp->use_metric_tables == false) {
+		return false;
+	}
+
+	// SDL_ttf treats byte order marks specially, so let it measure any string that contains one
+	static const uint16 BOM_NATIVE = 0xFEFF;
+	static const uint16 BOM_SWAPPED = 0xFFFE;
+
+	int32 x = 0;
+	int32 min_x = 0;
+	int32 max_x = 0;
+	GlyphMetrics metrics;
+
+	for (uint32 i = 0; i < length && text[i] != 0; i++) {
+		const uint16 character = text[i];
+		if (character == BOM_NATIVE || character == BOM_SWAPPED) {
+			return false;
+		}
+
+		if (_GetGlyphMetrics(fp, character, metrics) == false) {
+			return false;
+		}
+
+		if (i > 0) {
+			int32 kerning;
+			if (_GetKerning(fp, text[i - 1], character, kerning) == false) {
+				return false;
+			}
+			x += kerning;
+		}
+
+		if (x + metrics.min_x < min_x)
+			min_x = x + metrics.min_x;
+		int32 right = x + ((metrics.advance > metrics.max_x) ? metrics.advance : metrics.max_x);
+		if (right > max_x)
+			max_x = right;
+
+		x += metrics.advance;
+	}
+
+	return _ResolveTextWidth(fp, min_x, max_x, width);
+} // bool TextSupervisor::_CalculateCachedTextWidth(FontProperties* fp, const uint16* text, uint32 length, int32& width)
+
+
+
+void TextSupervisor::_InitializeMetricTables(FontProperties* fp) {
+	fp->width_rule = TEXT_WIDTH_RULE_UNKNOWN;
+	fp->use_metric_tables = true;
+
+	// Find a character that extends to the left of its draw position and see which width rule matches its measured width
+	static const uint16 overhang_candidates[] = { 'j', '_', '/', ',', 'f', 'y', 'g', 'p', 'J', '(', 0 };
+	for (const uint16* candidate = overhang_candidates; *candidate != 0 && fp->width_rule == TEXT_WIDTH_RULE_UNKNOWN; ++candidate) {
+		GlyphMetrics metrics;
+		if (_GetGlyphMetrics(fp, *candidate, metrics) == false || metrics.min_x >= 0)
+			continue;
+
+		uint16 single[2] = { *candidate, 0 };
+		int32 measured_width;
+		if (TTF_SizeUNICODE(fp->ttf_font, single, &measured_width, NULL) != 0)
+			continue;
+
+		int32 right = (metrics.advance > metrics.max_x) ? metrics.advance : metrics.max_x;
+		if (measured_width == right)
+			fp->width_rule = TEXT_WIDTH_RULE_RIGHT_EXTENT;
+		else if (measured_width == right - metrics.min_x)
+			fp->width_rule = TEXT_WIDTH_RULE_FULL_EXTENT;
+	}
+
+	// Verify that the tables reproduce the widths measured by SDL_ttf. If they do not, the tables are never used for this font.
+	static const char* verification_text = "The quick brown fox jumps over the lazy dog. AVAWAY Ta To LT fi ff (j) 0123456789";
+	ustring verification_string = MakeUnicodeString(verification_text);
+
+	int32 measured_width, calculated_width;
+	if (TTF_SizeUNICODE(fp->ttf_font, verification_string.c_str(), &measured_width, NULL) != 0) {
+		fp->use_metric_tables = false;
+	}
+	else if (_CalculateCachedTextWidth(fp, verification_string.c_str(), verification_string.length(), calculated_width) == true
+		&& calculated_width != measured_width)
+	{
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "glyph metric tables did not match SDL_ttf measurements and will not be used for this font" << endl;
+		fp->use_metric_tables = false;
+	}
+} // void TextSupervisor::_InitializeMetricTables(FontProperties* fp)
+
+
+
 bool TextSupervisor::_RenderText(hoa_utils::ustring& string, TextStyle& style, ImageMemory& buffer) {
 	FontProperties* fp = _font_map[style.font];
 	TTF_Font* font = fp->ttf_font;
@@ -53,11 +53,18 @@ enum TEXT_SHADOW_STYLE {
 
 /** ****************************************************************************
 *** \brief A structure to hold properties about a particular font glyph
+***
+*** The rendered glyphs of all fonts are stored together in glyph texture sheets
+*** (atlas pages) managed by the TextureController, so that an entire line of
+*** text can usually be drawn from a single texture.
 *** ***************************************************************************/
 class FontGlyph {
 public:
-	//! \brief The index of the GL texture for this glyph.
-	GLuint texture;
+	/** \brief The area of a glyph texture sheet which holds the rendered glyph
+	*** This area is one pixel larger than the glyph on every side, to prevent neighboring glyphs from bleeding
+	*** into one another when the sheet is sampled.
+	**/
+	private_video::BaseTexture* texture;
 
 	//! \brief The width and height of the glyph in pixels.
 	int32 width, height;
@@ -65,8 +72,11 @@ public:
 	//! \brief The mininum x and y pixel coordinates of the glyph in texture space (refer to TTF_GlyphMetrics).
 	int min_x, min_y;
 
-	//! \brief The maximum x and y pixel coordinates of the glyph in texture space (refer to TTF_GlyphMetrics).
-	float max_x, max_y;
+	//! \brief The texture coordinates of the top-left corner of the glyph in its texture sheet
+	float tex_min_x, tex_min_y;
+
+	//! \brief The texture coordinates of the bottom-right corner of the glyph in its texture sheet
+	float tex_max_x, tex_max_y;
 
 	//! \brief The amount of space between glyphs.
 	int32 advance;
@@ -76,6 +86,49 @@ public:
 }; // class FontGlyph
 
 
+/** ****************************************************************************
+*** \brief The horizontal metrics of a single glyph, used for measuring text
+***
+*** These values are retrieved from SDL_ttf once per character and are then
+*** used to calculate the width of strings without calling SDL_ttf again.
+*** ***************************************************************************/
+class GlyphMetrics {
+public:
+	GlyphMetrics() :
+		min_x(0), max_x(0), advance(0), cached(false), valid(false) {}
+
+	//! \brief The minimum and maximum x pixel coordinates of the glyph (refer to TTF_GlyphMetrics).
+	int16 min_x, max_x;
+
+	//! \brief The amount of space between the start of this glyph and the start of the next one.
+	int16 advance;
+
+	//! \brief Set to true once the metrics of the glyph have been retrieved from SDL_ttf
+	bool cached;
+
+	//! \brief Set to false if SDL_ttf could not provide the metrics of the glyph
+	bool valid;
+}; // class GlyphMetrics
+
+
+namespace private_video {
+
+//! \brief Indicates that the kerning between a pair of characters could not be determined
+const int32 UNKNOWN_KERNING = 0x7FFFFFFF;
+
+/** \brief Describes how SDL_ttf calculates the width of text that begins to the left of the draw position
+*** Older versions of SDL_ttf report only the right-most extent of the text, while newer versions report the entire
+*** extent. The rule followed by the SDL_ttf library in use is determined for each font when it is loaded.
+**/
+enum TEXT_WIDTH_RULE {
+	TEXT_WIDTH_RULE_UNKNOWN = 0,
+	TEXT_WIDTH_RULE_RIGHT_EXTENT = 1,
+	TEXT_WIDTH_RULE_FULL_EXTENT = 2
+};
+
+} // namespace private_video
+
+
 /** ****************************************************************************
 *** \brief A structure which holds properties about fonts
 *** ***************************************************************************/
@@ -95,6 +148,23 @@ public:
 
 	//! \brief A pointer to a cache which holds all of the glyphs used in this font.
 	std::vector<FontGlyph*>* glyph_cache;
+
+	/** \brief The horizontal metrics of each character measured in this font, indexed by character
+	*** Entries are added the first time that a character is measured by TextSupervisor::CalculateTextWidth().
+	**/
+	std::vector<GlyphMetrics> glyph_metrics;
+
+	/** \brief The kerning offset applied by SDL_ttf between each pair of characters measured so far
+	*** The key is the first character shifted into the upper 16 bits, combined with the second character. Pairs whose offset
+	*** could not be determined exactly have the value UNKNOWN_KERNING.
+	**/
+	std::map<uint32, int32> kerning;
+
+	//! \brief How SDL_ttf calculates the width of text in this font that extends to the left of its draw position
+	private_video::TEXT_WIDTH_RULE width_rule;
+
+	//! \brief If false, the metric tables failed to reproduce SDL_ttf's text widths and are never used for this font
+	bool use_metric_tables;
 }; // class FontProperties
 
 
@@ -491,6 +561,15 @@ private:
 	**/
 	std::map<std::string, FontProperties*> _font_map;
 
+	/** \brief The vertex and texture coordinates of the glyphs of the line of text currently being drawn
+	*** These are only retained as members to avoid allocating new arrays every time that a line of text is drawn.
+	**/
+	std::vector<GLint> _line_vertices;
+	std::vector<GLfloat> _line_tex_coords;
+
+	//! \brief Holds a standard string converted to unicode characters while it is being measured
+	std::vector<uint16> _measure_buffer;
+
 	// ---------- Private methods
 
 	/** \brief Retrieves the color for a shadow based on the current text color and a shadow style
@@ -515,6 +594,57 @@ private:
 	**/
 	void _DrawTextHelper(const uint16* const text, FontProperties* fp, Color text_color);
 
+	/** \brief Draws all glyphs collected in the line arrays with one OpenGL call and empties the arrays
+	*** \param sheet The glyph texture sheet that all of the collected glyphs are stored in
+	**/
+	void _DrawLineGlyphs(private_video::TexSheet* sheet);
+
+	/** \brief Retrieves the horizontal metrics of a character, caching them in the font's metric table if necessary
+	*** \param fp A pointer to the properties of the font
+	*** \param character The character to retrieve the metrics for
+	*** \param metrics A reference to place the metrics in
+	*** \return False if SDL_ttf was unable to provide metrics for the character
+	**/
+	bool _GetGlyphMetrics(FontProperties* fp, uint16 character, GlyphMetrics& metrics);
+
+	/** \brief Retrieves the kerning offset that SDL_ttf applies between two characters
+	*** \param fp A pointer to the properties of the font
+	*** \param first The first character of the pair
+	*** \param second The character that follows the first
+	*** \param kerning A reference to place the kerning offset in, in pixels
+	*** \return False if the kerning offset of the pair could not be determined exactly
+	***
+	*** SDL_ttf does not expose its kerning tables. The first time a pair is requested, its width is measured by SDL_ttf and the
+	*** offset is found as the single value which makes the width calculated from the glyph metrics match that measurement.
+	**/
+	bool _GetKerning(FontProperties* fp, uint16 first, uint16 second, int32& kerning);
+
+	/** \brief Converts the left-most and right-most extents of a piece of text into the width reported by SDL_ttf
+	*** \param fp A pointer to the properties of the font
+	*** \param min_x The left-most extent of the text, which is never greater than zero
+	*** \param max_x The right-most extent of the text
+	*** \param width A reference to place the width in
+	*** \return False if the width can not be determined because the font's width rule is unknown
+	**/
+	bool _ResolveTextWidth(FontProperties* fp, int32 min_x, int32 max_x, int32& width);
+
+	/** \brief Calculates the width of a string from the font's cached metric and kerning tables
+	*** \param fp A pointer to the properties of the font
+	*** \param text A pointer to the unicode string to measure
+	*** \param length The number of characters in the string
+	*** \param width A reference to place the calculated width in
+	*** \return False if the tables can not reproduce the width that SDL_ttf would report for this string
+	***
+	*** This follows the same steps that SDL_ttf takes when it measures a string, but every glyph and kerning offset is retrieved
+	*** from the tables instead of from the font file.
+	**/
+	bool _CalculateCachedTextWidth(FontProperties* fp, const uint16* text, uint32 length, int32& width);
+
+	/** \brief Determines the width rule of a newly loaded font and verifies that its metric tables measure text correctly
+	*** \param fp A pointer to the properties of the font
+	**/
+	void _InitializeMetricTables(FontProperties* fp);
+
 	/** \brief Renders a unicode string with a given TextStyle to a pixel array
 	*** \param string The unicdoe string to render
 	*** \param style The text style to render the string in
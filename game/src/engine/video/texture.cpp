@@ -35,8 +35,11 @@ TexSheet::TexSheet(int32 sheet_width, int32 sheet_height, GLuint sheet_id, TexSh
 	type(sheet_type),
 	is_static(sheet_static),
 	smoothed(false),
-	loaded(true)
+	loaded(true),
+	reload_failed(false),
+	last_used_frame(TextureManager->_current_frame)
 {
+	TextureManager->_AddSheetMemory(this);
 	Smooth();
 }
 
@@ -45,6 +48,8 @@ TexSheet::TexSheet(int32 sheet_width, int32 sheet_height, GLuint sheet_id, TexSh
 TexSheet::~TexSheet() {
 	// Unload OpenGL texture from memory
 	TextureManager->_DeleteTexture(tex_id);
+	if (loaded == true)
+		TextureManager->_RemoveSheetMemory(this);
 }
 
 
@@ -56,6 +61,7 @@ bool TexSheet::Unload() {
 	}
 
 	TextureManager->_DeleteTexture(tex_id);
+	TextureManager->_RemoveSheetMemory(this);
 	tex_id = INVALID_TEXTURE_ID;
 	loaded = false;
 	return true;
@@ -85,19 +91,25 @@ bool TexSheet::Reload() {
 	smoothed = false;
 	Smooth(was_smoothed);
 
-	// Reload all of the images that belong to this texture
+	// Reload all of the images that belong to this texture. The sheet remains unloaded if this fails, so the new
+	// texture must not be kept.
 	if (TextureManager->_ReloadImagesToSheet(this) == false) {
 		PRINT_ERROR << "call to TextureController::_ReloadImagesToSheet() failed" << endl;
+		TextureManager->_DeleteTexture(id);
+		tex_id = INVALID_TEXTURE_ID;
 		return false;
 	}
 
 	loaded = true;
+	TextureManager->_AddSheetMemory(this);
 	return true;
 }
 
 
 
 bool TexSheet::CopyRect(int32 x, int32 y, ImageMemory& data) {
+	// Batched quads may still refer to the area of the sheet that is about to be overwritten
+	VideoManager->_FlushBatch();
 	TextureManager->_BindTexture(tex_id);
 
 	glTexSubImage2D(
@@ -123,6 +135,7 @@ bool TexSheet::CopyRect(int32 x, int32 y, ImageMemory& data) {
 
 
 bool TexSheet::CopyScreenRect(int32 x, int32 y, const ScreenRect& screen_rect) {
+	VideoManager->_FlushBatch();
 	TextureManager->_BindTexture(tex_id);
 
 	glCopyTexSubImage2D(
@@ -146,6 +159,23 @@ bool TexSheet::CopyScreenRect(int32 x, int32 y, const ScreenRect& screen_rect) {
 
 
 
+void TexSheet::SetTextureLocation(BaseTexture* img, int32 x, int32 y) {
+	img->x = x;
+	img->y = y;
+
+	float sheet_width = static_cast<float>(width);
+	float sheet_height = static_cast<float>(height);
+
+	img->u1 = static_cast<float>(img->x + 0.5f) / sheet_width;
+	img->u2 = static_cast<float>(img->x + img->width - 0.5f) / sheet_width;
+	img->v1 = static_cast<float>(img->y + 0.5f) / sheet_height;
+	img->v2 = static_cast<float>(img->y + img->height - 0.5f) / sheet_height;
+
+	img->texture_sheet = this;
+}
+
+
+
 void TexSheet::Smooth(bool flag) {
 	// In case of global smoothing, do nothing here
 	if (VideoManager->IsSmoothTextures() == true)
@@ -181,17 +211,16 @@ void TexSheet::DEBUG_Draw() const {
 		0.0f, 0.0f, // Upper left
 	};
 
+	VideoManager->_FlushBatch();
+
 	// Enable texturing and bind the texture
-	glDisable(GL_BLEND);
-	glEnable(GL_TEXTURE_2D);
+	VideoManager->_SetGLBlendMode(0);
+	VideoManager->_SetGLTexturing(true);
 	TextureManager->_BindTexture(tex_id);
 
-	// Enable and setup the texture coordinate array
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	// Setup the texture coordinate and vertex arrays, then draw all of the vertices
+	VideoManager->_SetGLClientStates(true, true, false);
 	glTexCoordPointer(2, GL_FLOAT, 0, texture_coords);
-
-	// Use a vertex array to draw all of the vertices
-	glEnableClientState(GL_VERTEX_ARRAY);
 	glVertexPointer(2, GL_FLOAT, 0, vertex_coords);
 	glDrawArrays(GL_QUADS, 0, 4);
 
@@ -276,20 +305,8 @@ bool FixedTexSheet::InsertTexture(BaseTexture* img) {
 		node->image = NULL;
 	}
 
-	// Calculate the texture's pixel coordinates in the sheet given this node's block index
-	img->x = _texture_width * (node->block_index % _block_width);
-	img->y = _texture_height * (node->block_index / _block_width);
-
-	// Calculate the u,v coordinates
-	float sheet_width = static_cast<float>(width);
-	float sheet_height = static_cast<float>(height);
-
-	img->u1 = static_cast<float>(img->x + 0.5f) / sheet_width;
-	img->u2 = static_cast<float>(img->x + img->width - 0.5f) / sheet_width;
-	img->v1 = static_cast<float>(img->y + 0.5f) / sheet_height;
-	img->v2 = static_cast<float>(img->y + img->height - 0.5f) / sheet_height;
-
-	img->texture_sheet = this;
+	// Calculate the texture's pixel and u,v coordinates in the sheet given this node's block index
+	SetTextureLocation(img, _texture_width * (node->block_index % _block_width), _texture_height * (node->block_index / _block_width));
 	node->image = img;
 	return true;
 } // bool FixedTexSheet::InsertTexture(BaseTexture* img)
@@ -428,11 +445,13 @@ FixedTexNode* FixedTexSheet::_RemoveOpenNode() {
 // -----------------------------------------------------------------------------
 
 VariableTexSheet::VariableTexSheet(int32 sheet_width, int32 sheet_height, GLuint sheet_id, TexSheetType sheet_type, bool sheet_static) :
-	TexSheet(sheet_width, sheet_height, sheet_id, sheet_type, sheet_static)
+	TexSheet(sheet_width, sheet_height, sheet_id, sheet_type, sheet_static),
+	_occupied_area(0)
 {
-	_block_width = width / 16;
-	_block_height = height / 16;
-	_blocks = new VariableTexNode[_block_width * _block_height];
+	// Space is not managed in blocks by this class
+	_block_width = 0;
+	_block_height = 0;
+	_ResetFreeSpace();
 }
 
 
@@ -440,8 +459,6 @@ VariableTexSheet::VariableTexSheet(int32 sheet_width, int32 sheet_height, GLuint
 VariableTexSheet::~VariableTexSheet() {
 	if (GetNumberTextures() != 0)
 		IF_PRINT_WARNING(VIDEO_DEBUG) << "texture sheet being deleted when it has a non-zero allocated texture count: " << GetNumberTextures() << endl;
-
-	delete[] _blocks;
 }
 
 
@@ -469,117 +486,264 @@ bool VariableTexSheet::InsertTexture(BaseTexture* img) {
 
 	// Don't allow insertions into a texture sheet containing a texture larger than 512x512.
 	// Texture sheets with this property may only be used by one texture at a time
-	if (_block_width > 32 || _block_height > 32) { // 32 blocks == 512 pixels
-		if (_blocks[0].free_image == false)
+	if ((width > 512 || height > 512) && _textures.empty() == false)
+		return false;
+
+	if (img->width > width || img->height > height)
+		return false;
+
+	// Textures without any area do not occupy any space
+	int32 x = 0, y = 0;
+	if (img->width > 0 && img->height > 0) {
+		if (_PlaceInFreeRect(img->width, img->height, x, y) == false && _PlaceOnSkyline(img->width, img->height, x, y) == false)
 			return false;
 	}
 
-	// Attempt to find an open region in the texture sheet to fit this texture
-	int32 block_x = -1, block_y = -1;
-	int32 w = (img->width + 15) / 16;
-	int32 h = (img->height + 15) / 16;
-
-	// This is a brute force algorithm to try and find space to allocate the texture.
-	// If this becomes a bottleneck, we may wish to use a more intellegent algorithm here.
-	bool continue_search = true;
-	for (int32 y = 0; y < _block_height - h + 1 && continue_search; y++) {
-		for (int32 x = 0; x < _block_width - w + 1; x++) {
-			int32 furthest_blocker = -1;
-
-			bool continue_neighbor_search = true;
-			for (int32 dy = 0; dy < h && continue_neighbor_search; dy++) {
-				for (int32 dx = 0; dx < w; dx++) {
-					if (_blocks[(x + dx) + ((y + dy) * _block_width)].free_image == false) {
-						furthest_blocker = x + dx;
-						continue_neighbor_search = false;
-						break;
-					}
-				}
-			}
+	// Calculate the pixel and uv coordinates for the newly inserted texture
+	SetTextureLocation(img, x, y);
+	_textures.insert(img);
+	_occupied_area += img->width * img->height;
 
-			if (furthest_blocker == -1) {
-				block_x = x;
-				block_y = y;
-				continue_search = false;
-				break;
-			}
+	return true;
+} // bool VariableTexSheet::InsertTexture(BaseTexture* img)
+
+
+
+void VariableTexSheet::RemoveTexture(BaseTexture* img) {
+	if (img == NULL) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "NULL pointer was given as function argument" << endl;
+		return;
+	}
+
+	if (_textures.erase(img) == 0) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "texture pointer argument was not contained within this texture sheet" << endl;
+		return;
+	}
+
+	_occupied_area -= img->width * img->height;
+
+	if (_textures.empty() == true)
+		_ResetFreeSpace();
+	else if (img->width > 0 && img->height > 0)
+		_AddFreeRect(TexSheetRect(img->x, img->y, img->width, img->height));
+}
+
+
+
+void VariableTexSheet::RestoreTexture(BaseTexture* img) {
+	IF_PRINT_WARNING(VIDEO_DEBUG) << "freed textures of a variable size texture sheet can not be restored" << endl;
+}
+
+
+
+void VariableTexSheet::_ResetFreeSpace() {
+	_skyline.clear();
+	_skyline.push_back(SkylineSegment(0, 0, width));
+	_free_rects.clear();
+	_occupied_area = 0;
+}
+
+
+
+bool VariableTexSheet::_PlaceInFreeRect(int32 w, int32 h, int32& x, int32& y) {
+	// Find the free rectangle that leaves the least area unused
+	int32 best_index = -1;
+	int32 best_waste = 0;
+	for (uint32 i = 0; i < _free_rects.size(); i++) {
+		const TexSheetRect& rect = _free_rects[i];
+		if (rect.width < w || rect.height < h)
+			continue;
+
+		int32 waste = rect.width * rect.height - w * h;
+		if (best_index == -1 || waste < best_waste) {
+			best_index = i;
+			best_waste = waste;
 		}
 	}
 
-	// If either of these conditions is true, it means we were unable to allocate enough space to insert this texture
-	if (block_x == -1 || block_y == -1)
+	if (best_index == -1)
 		return false;
 
-	// Go through each block that is to be occupied by the new texture and set its properties
-	for (int32 y = block_y; y < block_y + h; y++) {
-		for (int32 x = block_x; x < block_x + w; x++) {
-			int32 index = x + (y * _block_width);
+	TexSheetRect rect = _free_rects[best_index];
+	_free_rects.erase(_free_rects.begin() + best_index);
+	x = rect.x;
+	y = rect.y;
+
+	// The remainder of the rectangle is split in two along the shorter leftover side, which keeps the larger of the
+	// two pieces as large as possible
+	int32 leftover_width = rect.width - w;
+	int32 leftover_height = rect.height - h;
+	if (leftover_width < leftover_height) {
+		_AddFreeRect(TexSheetRect(rect.x + w, rect.y, leftover_width, h));
+		_AddFreeRect(TexSheetRect(rect.x, rect.y + h, rect.width, leftover_height));
+	}
+	else {
+		_AddFreeRect(TexSheetRect(rect.x + w, rect.y, leftover_width, rect.height));
+		_AddFreeRect(TexSheetRect(rect.x, rect.y + h, w, leftover_height));
+	}
 
-			// If the texture pointer for the block is not NULL, this means it contains a freed texture.
-			// Now we must remove that texture entirely since we are overwriting at least one of its blocks.
-			if (_blocks[index].image) {
-				RemoveTexture(_blocks[index].image);
-			}
+	return true;
+} // bool VariableTexSheet::_PlaceInFreeRect(int32 w, int32 h, int32& x, int32& y)
+
+
+
+bool VariableTexSheet::_PlaceOnSkyline(int32 w, int32 h, int32& x, int32& y) {
+	// Find the segment where the bottom edge of the area is highest. Ties go to the narrowest segment, which leaves
+	// wider segments for wider textures.
+	int32 best_index = -1;
+	int32 best_bottom = 0;
+	int32 best_width = 0;
+	for (uint32 i = 0; i < _skyline.size(); i++) {
+		int32 top;
+		if (_FitOnSkyline(i, w, h, top) == false)
+			continue;
 
-			_blocks[index].free_image = false;
-			_blocks[index].image = img;
+		if (best_index == -1 || top + h < best_bottom || (top + h == best_bottom && _skyline[i].width < best_width)) {
+			best_index = i;
+			best_bottom = top + h;
+			best_width = _skyline[i].width;
 		}
 	}
 
-	// Calculate the pixel and uv coordinates for the newly inserted texture
-	img->x = block_x * 16;
-	img->y = block_y * 16;
+	if (best_index == -1)
+		return false;
 
-	float sheet_width = static_cast<float>(width);
-	float sheet_height = static_cast<float>(height);
+	x = _skyline[best_index].x;
+	y = best_bottom - h;
+
+	// Remove the part of the skyline that the area covers. Where the skyline was lower than the top of the area, the
+	// space between them can no longer be reached from the skyline and becomes a free rectangle.
+	int32 right = x + w;
+	uint32 i = best_index;
+	while (i < _skyline.size() && _skyline[i].x < right) {
+		int32 segment_right = _skyline[i].x + _skyline[i].width;
+		if (_skyline[i].y < y)
+			_AddFreeRect(TexSheetRect(_skyline[i].x, _skyline[i].y, min(segment_right, right) - _skyline[i].x, y - _skyline[i].y));
+
+		// A segment that extends past the area is shortened, and is the last one covered
+		if (segment_right > right) {
+			_skyline[i].width = segment_right - right;
+			_skyline[i].x = right;
+			break;
+		}
+		_skyline.erase(_skyline.begin() + i);
+	}
+	_skyline.insert(_skyline.begin() + best_index, SkylineSegment(x, y + h, w));
 
-	img->u1 = static_cast<float>(img->x + 0.5f) / sheet_width;
-	img->u2 = static_cast<float>(img->x + img->width - 0.5f) / sheet_width;
-	img->v1 = static_cast<float>(img->y + 0.5f) / sheet_height;
-	img->v2 = static_cast<float>(img->y + img->height - 0.5f) / sheet_height;
+	// Neighboring segments at the same height are joined
+	for (i = 0; i + 1 < _skyline.size();) {
+		if (_skyline[i].y == _skyline[i + 1].y) {
+			_skyline[i].width += _skyline[i + 1].width;
+			_skyline.erase(_skyline.begin() + i + 1);
+		}
+		else {
+			i++;
+		}
+	}
 
-	img->texture_sheet = this;
-	_textures.insert(img);
+	return true;
+} // bool VariableTexSheet::_PlaceOnSkyline(int32 w, int32 h, int32& x, int32& y)
+
+
+
+bool VariableTexSheet::_FitOnSkyline(uint32 index, int32 w, int32 h, int32& y) const {
+	if (_skyline[index].x + w > width)
+		return false;
+
+	// The area rests on the highest of the segments that it spans
+	y = 0;
+	int32 remaining_width = w;
+	for (uint32 i = index; remaining_width > 0 && i < _skyline.size(); i++) {
+		y = max(y, _skyline[i].y);
+		if (y + h > height)
+			return false;
+		remaining_width -= _skyline[i].width;
+	}
 
 	return true;
-} // bool VariableTexSheet::InsertTexture(BaseTexture* img)
+}
 
 
 
-void VariableTexSheet::RemoveTexture(BaseTexture* img) {
-	_SetBlockProperties(img, NULL, true);
-	_textures.erase(img);
+void VariableTexSheet::_AddFreeRect(TexSheetRect rect) {
+	if (rect.width <= 0 || rect.height <= 0)
+		return;
+
+	// Each merge may allow another, so the search begins again after every merge
+	uint32 i = 0;
+	while (i < _free_rects.size()) {
+		const TexSheetRect& other = _free_rects[i];
+		bool merged = false;
+		if (other.x == rect.x && other.width == rect.width) {
+			if (other.y + other.height == rect.y || rect.y + rect.height == other.y) {
+				rect.y = min(rect.y, other.y);
+				rect.height += other.height;
+				merged = true;
+			}
+		}
+		else if (other.y == rect.y && other.height == rect.height) {
+			if (other.x + other.width == rect.x || rect.x + rect.width == other.x) {
+				rect.x = min(rect.x, other.x);
+				rect.width += other.width;
+				merged = true;
+			}
+		}
+
+		if (merged == true) {
+			_free_rects.erase(_free_rects.begin() + i);
+			i = 0;
+		}
+		else {
+			i++;
+		}
+	}
+
+	_free_rects.push_back(rect);
+} // void VariableTexSheet::_AddFreeRect(TexSheetRect rect)
+
+// -----------------------------------------------------------------------------
+// AtlasTexSheet class
+// -----------------------------------------------------------------------------
+
+AtlasTexSheet::AtlasTexSheet(int32 sheet_width, int32 sheet_height, GLuint sheet_id, const std::string& atlas_filename) :
+	TexSheet(sheet_width, sheet_height, sheet_id, VIDEO_TEXSHEET_ATLAS, true),
+	filename(atlas_filename)
+{}
+
+
+
+bool AtlasTexSheet::AddTexture(BaseTexture* img, ImageMemory& data) {
+	IF_PRINT_WARNING(VIDEO_DEBUG) << "textures with their own pixel data can not be added to a texture atlas: " << filename << endl;
+	return false;
 }
 
 
 
-void VariableTexSheet::_SetBlockProperties(BaseTexture* tex, BaseTexture* new_tex, bool free) {
-	if (tex == NULL) {
+bool AtlasTexSheet::InsertTexture(BaseTexture* img) {
+	if (img == NULL) {
 		IF_PRINT_WARNING(VIDEO_DEBUG) << "NULL pointer was given as function argument" << endl;
-		return;
+		return false;
 	}
 
-	if (_textures.find(tex) == _textures.end()) {
-		IF_PRINT_WARNING(VIDEO_DEBUG) << "texture pointer argument was not contained within this texture sheet" << endl;
+	if (img->x < 0 || img->y < 0 || img->x + img->width > width || img->y + img->height > height) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "texture location was outside the bounds of the texture atlas: " << filename << endl;
+		return false;
 	}
 
-	// Calculate upper-left corner in blocks
-	int32 block_x = tex->x / 16;
-	int32 block_y = tex->y / 16;
+	// The location of the texture was set by the caller, so only the uv coordinates need to be calculated
+	SetTextureLocation(img, img->x, img->y);
+	_textures.insert(img);
 
-	// Calculate width and height in blocks
-	int32 w = (tex->width  + 15) / 16;
-	int32 h = (tex->height + 15) / 16;
+	return true;
+} // bool AtlasTexSheet::InsertTexture(BaseTexture* img)
 
-	for (int32 y = block_y; y < block_y + h; y++) {
-		for (int32 x = block_x; x < block_x + w; x++) {
-			int32 index = x + y * _block_width;
-			if (_blocks[index].image == tex) {
-				_blocks[index].free_image = free;
-				_blocks[index].image = new_tex;
-			}
-		}
-	}
+
+
+uint32 AtlasTexSheet::GetOccupiedArea() {
+	uint32 area = 0;
+	for (set<BaseTexture*>::iterator i = _textures.begin(); i != _textures.end(); i++)
+		area += (*i)->width * (*i)->height;
+	return area;
 }
 
 } // namespace private_video
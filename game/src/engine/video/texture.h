@@ -34,8 +34,8 @@
 *** This sheet allows textures of any size to be inserted, but has slower
 *** performance than the FixedTexSheet.
 ***
-*** - <b>VariableTexNode</b>: represents a texture node entry for the
-*** VariableTexSheet class.
+*** - <b>TexSheetRect</b> and <b>SkylineSegment</b>: represent the free space
+*** of the VariableTexSheet class.
 *** ***************************************************************************/
 
 #ifndef __TEXTURE_HEADER__
@@ -72,8 +72,12 @@ enum TexSheetType {
 	VIDEO_TEXSHEET_32x64 = 1,
 	VIDEO_TEXSHEET_64x64 = 2,
 	VIDEO_TEXSHEET_ANY = 3,
+	//! \brief Holds the rendered glyphs of fonts, which may be of any size
+	VIDEO_TEXSHEET_GLYPH = 4,
+	//! \brief Holds the contents of a texture atlas image, which were packed before the game was run
+	VIDEO_TEXSHEET_ATLAS = 5,
 
-	VIDEO_TEXSHEET_TOTAL = 4
+	VIDEO_TEXSHEET_TOTAL = 6
 };
 
 
@@ -149,6 +153,9 @@ public:
 	//! \brief Returns the number of textures that are contained on this texture sheet
 	virtual uint32 GetNumberTextures() = 0;
 
+	//! \brief Returns the number of pixels of the sheet that are held by the textures it contains
+	virtual uint32 GetOccupiedArea() = 0;
+
 	/** \brief Unloads all texture memory used by OpenGL for this sheet
 	*** \return Success/failure
 	**/
@@ -187,6 +194,16 @@ public:
 	**/
 	bool CopyScreenRect(int32 x, int32 y, const ScreenRect &screen_rect);
 
+	/** \brief Sets the location of a texture within the texture sheet and calculates its uv coordinates
+	*** \param img The texture to locate, which must already occupy the given area of the sheet
+	*** \param x The x coordinate of the texture in the sheet, in pixels
+	*** \param y The y coordinate of the texture in the sheet, in pixels
+	***
+	*** The uv coordinates are inset by half a texel on every side, so that filtering never samples the neighbouring
+	*** textures in the sheet.
+	**/
+	void SetTextureLocation(BaseTexture* img, int32 x, int32 y);
+
 	/** \brief Enables (GL_LINEAR) or disables (GL_NEAREST) smoothing for this texture sheet
 	*** \param flag True enables smoothing while false disables it. Default value is true.
 	**/
@@ -218,6 +235,18 @@ public:
 	//! \brief Flag indicating if texture sheet is loaded or not
 	bool loaded;
 
+	/** \brief Set when the sheet could not be reloaded after it was evicted
+	*** While set, the sheet is not reloaded every time that it is drawn. It is cleared when all textures are reloaded.
+	**/
+	bool reload_failed;
+
+	//! \brief The number of the last frame in which the sheet was drawn, used to decide which sheets to evict from texture memory
+	uint32 last_used_frame;
+
+	//! \brief Returns the number of bytes of texture memory that the sheet uses while it is loaded
+	uint32 GetMemorySize() const
+		{ return static_cast<uint32>(width) * static_cast<uint32>(height) * 4; }
+
 protected:
 	//! \brief The width and height of the sheet in number of texture blocks
 	int32 _block_width, _block_height;
@@ -299,6 +328,9 @@ public:
 	void RestoreTexture(BaseTexture* img);
 
 	uint32 GetNumberTextures();
+
+	uint32 GetOccupiedArea()
+		{ return GetNumberTextures() * _texture_width * _texture_height; }
 	//@}
 
 private:
@@ -336,29 +368,64 @@ private:
 
 
 /** ****************************************************************************
-*** \brief Keeps track of which images are used/freed in the variable texture mem manager
+*** \brief A rectangular area of a texture sheet, in pixels
 *** ***************************************************************************/
-class VariableTexNode {
+class TexSheetRect {
 public:
-	VariableTexNode() :
-		image(NULL), free_image(true) {}
+	TexSheetRect() :
+		x(0), y(0), width(0), height(0) {}
 
-	//! \brief A pointer to the image
-	BaseTexture* image;
+	TexSheetRect(int32 x_, int32 y_, int32 width_, int32 height_) :
+		x(x_), y(y_), width(width_), height(height_) {}
+
+	//! \brief The coordinates of the upper left corner of the area
+	int32 x, y;
 
-	//! \brief Set to true if the image is freed
-	bool free_image;
-}; // class VariableTexNode
+	//! \brief The dimensions of the area
+	int32 width, height;
+}; // class TexSheetRect
+
+
+/** ****************************************************************************
+*** \brief A horizontal segment of the skyline of a VariableTexSheet
+***
+*** The segment spans the columns from x to x + width of the sheet. All of the
+*** rows of these columns from y to the bottom of the sheet are free.
+*** ***************************************************************************/
+class SkylineSegment {
+public:
+	SkylineSegment(int32 x_, int32 y_, int32 width_) :
+		x(x_), y(y_), width(width_) {}
+
+	//! \brief The column where the segment begins
+	int32 x;
+
+	//! \brief The first free row below the segment
+	int32 y;
+
+	//! \brief The number of columns spanned by the segment
+	int32 width;
+}; // class SkylineSegment
 
 
 /** ****************************************************************************
 *** \brief Used to manage texture sheets of variable image sizes
 ***
-*** This class divides a texture sheet up into 16x16 pixel blocks, and keeps
-*** track of which images have allocated which blocks. This is done to reduce
-*** the time complexity for doing texture insertion and removal operations, but
-*** the downside is that it may leave some space in the texture sheet occupied
-*** but unused for images that are not divisible by 16 in width or height.
+*** Textures are placed with a skyline packer. The skyline is the boundary
+*** between the occupied top part of the sheet and the free bottom part, kept
+*** as a list of horizontal segments from left to right. A new texture is placed
+*** where its bottom edge is highest, which fills the sheet from the top down.
+***
+*** Areas that the skyline passes over when a texture is placed, and the areas
+*** of textures that are removed, are kept in a list of free rectangles. These
+*** are searched before the skyline, and are split guillotine style when a
+*** texture is placed in one of them. Free rectangles that share an entire edge
+*** are merged, and all free space is restored once the sheet is empty. Space
+*** that remains fragmented is recovered by the TextureController, which moves
+*** the textures of sheets that are mostly empty into other sheets.
+***
+*** \note Textures release their space as soon as they are freed, so freed
+*** textures can not be restored.
 *** ***************************************************************************/
 class VariableTexSheet : public TexSheet {
 public:
@@ -382,34 +449,125 @@ public:
 	void RemoveTexture(BaseTexture* img);
 
 	void FreeTexture(BaseTexture* img)
-		{ _SetBlockProperties(img, img, true); }
+		{ RemoveTexture(img); }
 
-	void RestoreTexture(BaseTexture* img)
-		{ _SetBlockProperties(img, img, false); }
+	void RestoreTexture(BaseTexture* img);
 
 	uint32 GetNumberTextures()
 		{ return _textures.size(); }
+
+	uint32 GetOccupiedArea()
+		{ return _occupied_area; }
 	//@}
 
-private:
-	/** \brief The list of 16x16 pixel blocks in the sheet.
-	*** The size of this structure is: (width / 16) * (height / 16)
-	**/
-	VariableTexNode* _blocks;
+	//! \brief Returns the textures that are contained on this texture sheet
+	const std::set<BaseTexture*>& GetTextures() const
+		{ return _textures; }
 
+private:
 	/** \brief A set containing each texture that has been inserted into this class
 	*** This container is used to be able to quickly determine if a texture is loaded by an object of this class
 	**/
 	std::set<BaseTexture*> _textures;
 
-	/** \brief Updates the properties of all of the blocks associated with a given texture
-	*** \param tex The texture to update
-	*** \param new_tex The texture pointer to set the block to
-	*** \param new_image The boolean value to set the free status flag to
+	//! \brief The segments of the skyline, sorted from left to right and together spanning the width of the sheet
+	std::vector<SkylineSegment> _skyline;
+
+	//! \brief The free areas of the sheet which lie above the skyline
+	std::vector<TexSheetRect> _free_rects;
+
+	//! \brief The sum of the areas of all textures in the sheet, in pixels
+	uint32 _occupied_area;
+
+	//! \brief Marks the entire sheet as free
+	void _ResetFreeSpace();
+
+	/** \brief Places an area in the free rectangle that fits it most closely
+	*** \param w The width of the area to place
+	*** \param h The height of the area to place
+	*** \param x Set to the column where the area was placed
+	*** \param y Set to the row where the area was placed
+	*** \return False if no free rectangle is large enough for the area
+	**/
+	bool _PlaceInFreeRect(int32 w, int32 h, int32& x, int32& y);
+
+	/** \brief Places an area on the skyline where its bottom edge is highest
+	*** \param w The width of the area to place
+	*** \param h The height of the area to place
+	*** \param x Set to the column where the area was placed
+	*** \param y Set to the row where the area was placed
+	*** \return False if the area does not fit anywhere on the skyline
+	**/
+	bool _PlaceOnSkyline(int32 w, int32 h, int32& x, int32& y);
+
+	/** \brief Determines the row that an area would be placed at if it were placed at the start of a skyline segment
+	*** \param index The index of the segment
+	*** \param w The width of the area
+	*** \param h The height of the area
+	*** \param y Set to the row that the area would be placed at
+	*** \return False if the area would extend past the right or bottom edge of the sheet
 	**/
-	void _SetBlockProperties(BaseTexture* tex, BaseTexture* new_tex, bool free);
+	bool _FitOnSkyline(uint32 index, int32 w, int32 h, int32& y) const;
+
+	/** \brief Adds a free rectangle, merging it with any free rectangles that share an entire edge with it
+	*** \param rect The area to add, which is ignored if it is empty
+	**/
+	void _AddFreeRect(TexSheetRect rect);
 }; // class VariableTexSheet : public TexSheet
 
+
+/** ****************************************************************************
+*** \brief A texture sheet holding the entire contents of a texture atlas image
+***
+*** Texture atlases are built by the atlas packer tool, which arranges many image
+*** files into a few large images and records the location of each image file in
+*** the atlas manifest. The contents of this sheet are loaded all at once from
+*** the atlas image file, so the textures that are inserted into this sheet must
+*** already have the location they occupy in the atlas set in their x and y
+*** members. Textures can not be added to this sheet with pixel data of their own.
+*** ***************************************************************************/
+class AtlasTexSheet : public TexSheet {
+public:
+	/** \brief Constructs a new texture sheet
+	*** \param sheet_width The width of the sheet
+	*** \param sheet_height The height of the sheet
+	*** \param sheet_id The OpenGL texture ID value for the sheet
+	*** \param atlas_filename The name of the atlas image file that the contents of the sheet are loaded from
+	**/
+	AtlasTexSheet(int32 sheet_width, int32 sheet_height, GLuint sheet_id, const std::string& atlas_filename);
+
+	~AtlasTexSheet()
+		{}
+
+	//! \name Methods inherited from TexSheet
+	//@{
+	bool AddTexture(BaseTexture* img, ImageMemory& data);
+
+	bool InsertTexture(BaseTexture* img);
+
+	void RemoveTexture(BaseTexture* img)
+		{ _textures.erase(img); }
+
+	void FreeTexture(BaseTexture* img)
+		{}
+
+	void RestoreTexture(BaseTexture* img)
+		{}
+
+	uint32 GetNumberTextures()
+		{ return _textures.size(); }
+
+	uint32 GetOccupiedArea();
+	//@}
+
+	//! \brief The name of the atlas image file that the contents of the sheet are loaded from
+	std::string filename;
+
+private:
+	//! \brief A set containing each texture that has been inserted into this class
+	std::set<BaseTexture*> _textures;
+}; // class AtlasTexSheet : public TexSheet
+
 }  // namespace private_video
 
 }  // namespace hoa_video
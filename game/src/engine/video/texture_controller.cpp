@@ -16,9 +16,11 @@
 #include "video.h"
 
 #include "texture_controller.h"
+#include "script.h"
 
 using namespace std;
 using namespace hoa_utils;
+using namespace hoa_script;
 using namespace hoa_video::private_video;
 
 template<> hoa_video::TextureController* Singleton<hoa_video::TextureController>::_singleton_reference = NULL;
@@ -32,19 +34,28 @@ TextureController* TextureManager = NULL;
 TextureController::TextureController() :
 	debug_current_sheet(-1),
 	_last_tex_id(INVALID_TEXTURE_ID),
-	_debug_num_tex_switches(0)
+	_current_frame(0),
+	_layout_generation(0),
+	_memory_usage(0),
+	_peak_memory_usage(0),
+	_shared_image_memory(0)
 {}
 
 
 
 TextureController::~TextureController() {
+	// The loader threads must be stopped before the textures that they are loading are deleted
+	_image_loader.Shutdown();
+
 	IF_PRINT_DEBUG(VIDEO_DEBUG) << "Deleting all remaining ImageTextures, a total of: " << _images.size() << endl;
 
 	// Invoking the ImageTexture destructor will erase the entry in the _images map that corresponds to that object
 	// Thus the map will decrement in size by one on every iteration through this loop
 	while (_images.empty() == false) {
 		ImageTexture* img = (*_images.begin()).second;
-		img->texture_sheet->RemoveTexture(img);
+		// Images whose asynchronous load never completed, and images sharing the space of another image, are not held by any texture sheet
+		if (img->texture_sheet != NULL && img->shared_texture == NULL)
+			img->texture_sheet->RemoveTexture(img);
 		delete img;
 	}
 
@@ -79,6 +90,8 @@ bool TextureController::SingletonInitialize() {
 		return false;
 	}
 
+	_image_loader.Initialize();
+
 	return true;
 }
 
@@ -95,11 +108,11 @@ bool TextureController::UnloadTextures() {
 		success = false;
 	}
 
-	// Unload all texture sheets
+	// Unload all texture sheets, except for those that were already evicted from texture memory
 	vector<TexSheet*>::iterator i = _tex_sheets.begin();
 	while (i != _tex_sheets.end()) {
 		if (*i != NULL) {
-			if ((*i)->Unload() == false) {
+			if ((*i)->loaded == true && (*i)->Unload() == false) {
 				IF_PRINT_WARNING(VIDEO_DEBUG) << "a TextureSheet::Unload() call failed" << endl;
 				success = false;
 			}
@@ -119,9 +132,13 @@ bool TextureController::UnloadTextures() {
 
 		if (fp->glyph_cache != NULL) {
 			for (uint32 k = 0; k < fp->glyph_cache->size(); ++k) {
-				if (fp->glyph_cache->at(k) != NULL) {
-					_DeleteTexture(fp->glyph_cache->at(k)->texture);
-					delete fp->glyph_cache->at(k);
+				FontGlyph* glyph = fp->glyph_cache->at(k);
+				if (glyph != NULL) {
+					// Release the glyph's space in its sheet. The glyph will be rendered again the next time it is drawn
+					if (glyph->texture->texture_sheet != NULL)
+						glyph->texture->texture_sheet->RemoveTexture(glyph->texture);
+					delete glyph->texture;
+					delete glyph;
 				}
 			}
 
@@ -142,6 +159,7 @@ bool TextureController::ReloadTextures() {
 
 	while (i != _tex_sheets.end()) {
 		if (*i != NULL) {
+			(*i)->reload_failed = false;
 			if ((*i)->Reload() == false) {
 				IF_PRINT_WARNING(VIDEO_DEBUG) << "a TextureSheet::Reload() call failed" << endl;
 				success = false;
@@ -157,11 +175,82 @@ bool TextureController::ReloadTextures() {
 
 	_DeleteTempTextures();
 
+	// Sheets that had been evicted were reloaded as well, so the budget may need to be enforced again
+	_EnforceMemoryBudget();
+
 	return success;
 }
 
 
 
+bool TextureController::LoadAtlasManifest(const std::string& filename) {
+	for (uint32 i = 0; i < _atlas_sheets.size(); i++) {
+		if (_atlas_sheets[i] != NULL) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "the atlas manifest can not be replaced while a texture atlas is loaded" << endl;
+			return false;
+		}
+	}
+
+	_atlas_filenames.clear();
+	_atlas_sheets.clear();
+	_atlas_entries.clear();
+
+	ReadScriptDescriptor manifest;
+	if (manifest.OpenFile(filename) == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to open the atlas manifest: " << filename << endl;
+		return false;
+	}
+
+	if (manifest.DoesTableExist("atlases") == false || manifest.DoesTableExist("images") == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "missing 'atlases' or 'images' table in the atlas manifest: " << filename << endl;
+		manifest.CloseFile();
+		return false;
+	}
+
+	manifest.OpenTable("atlases");
+	uint32 number_of_atlases = manifest.GetTableSize();
+	for (uint32 i = 1; i <= number_of_atlases; i++) {
+		_atlas_filenames.push_back(manifest.ReadString(i));
+	}
+	manifest.CloseTable();
+	_atlas_sheets.resize(_atlas_filenames.size(), NULL);
+
+	// Each image is described by a table of the form { filename, atlas number, x, y, width, height }
+	manifest.OpenTable("images");
+	uint32 number_of_images = manifest.GetTableSize();
+	for (uint32 i = 1; i <= number_of_images; i++) {
+		manifest.OpenTable(i);
+		string image_filename = manifest.ReadString(1);
+		uint32 atlas_number = manifest.ReadUInt(2);
+		AtlasEntry entry;
+		entry.x = manifest.ReadInt(3);
+		entry.y = manifest.ReadInt(4);
+		entry.width = manifest.ReadInt(5);
+		entry.height = manifest.ReadInt(6);
+		manifest.CloseTable();
+
+		// Atlases are numbered starting from one in the manifest
+		if (atlas_number == 0 || atlas_number > _atlas_filenames.size()) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid atlas number " << atlas_number << " for image: " << image_filename << endl;
+			continue;
+		}
+
+		entry.atlas = atlas_number - 1;
+		_atlas_entries[image_filename] = entry;
+	}
+	manifest.CloseTable();
+
+	if (manifest.IsErrorDetected() == true) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "errors were detected while reading the atlas manifest: " << filename << endl
+			<< manifest.GetErrorMessages() << endl;
+	}
+
+	manifest.CloseFile();
+	return true;
+} // bool TextureController::LoadAtlasManifest(const std::string& filename)
+
+
+
 void TextureController::DEBUG_NextTexSheet() {
 	debug_current_sheet++;
 
@@ -210,13 +299,15 @@ void TextureController::DEBUG_ShowTexSheet() {
 	VideoManager->SetDrawFlags(VIDEO_NO_BLEND, VIDEO_X_LEFT, VIDEO_Y_BOTTOM, 0);
 	VideoManager->SetCoordSys(0.0f, 1024.0f, 0.0f, 768.0f);
 
-	glPushMatrix();
+	VideoManager->PushMatrix();
 	VideoManager->Move(0.0f,0.0f);
-	glScalef(sheet->width / 2.0f, sheet->height / 2.0f, 1.0f);
+	VideoManager->Scale(sheet->width / 2.0f, sheet->height / 2.0f);
 
-	sheet->DEBUG_Draw();
+	// Sheets that were evicted have no texture to draw
+	if (sheet->loaded == true)
+		sheet->DEBUG_Draw();
 
-	glPopMatrix();
+	VideoManager->PopMatrix();
 
 	char buf[200];
 
@@ -239,6 +330,10 @@ void TextureController::DEBUG_ShowTexSheet() {
 		sprintf(buf, "  Type:    64x64");
 	else if (sheet->type == VIDEO_TEXSHEET_ANY)
 		sprintf(buf, "  Type:    Any size");
+	else if (sheet->type == VIDEO_TEXSHEET_GLYPH)
+		sprintf(buf, "  Type:    Font glyphs");
+	else if (sheet->type == VIDEO_TEXSHEET_ATLAS)
+		sprintf(buf, "  Type:    Texture atlas");
 	else
 		sprintf(buf, "  Type:    Unknown");
 
@@ -253,6 +348,18 @@ void TextureController::DEBUG_ShowTexSheet() {
 	VideoManager->MoveRelative(0, -20);
 	TextManager->Draw(buf);
 
+	sprintf(buf, "  Loaded:  %d", sheet->loaded);
+	VideoManager->MoveRelative(0, -20);
+	TextManager->Draw(buf);
+
+	sprintf(buf, "  Images:  %d", sheet->GetNumberTextures());
+	VideoManager->MoveRelative(0, -20);
+	TextManager->Draw(buf);
+
+	sprintf(buf, "  Occupied: %.1f%%", 100.0f * sheet->GetOccupiedArea() / (static_cast<float>(sheet->width) * sheet->height));
+	VideoManager->MoveRelative(0, -20);
+	TextManager->Draw(buf);
+
 	VideoManager->PopState();
 } // void TextureController::DEBUG_ShowTexSheet()
 
@@ -301,7 +408,7 @@ void TextureController::_BindTexture(GLuint tex_id) {
 
 	_last_tex_id = tex_id;
 	glBindTexture(GL_TEXTURE_2D, tex_id);
-	_debug_num_tex_switches++;
+	VideoManager->_draw_recorder.RecordTextureBind();
 
 	if (VideoManager->CheckGLError()) {
 		PRINT_WARNING << "an OpenGL error was detected: " << VideoManager->CreateGLErrorString() << endl;
@@ -311,6 +418,16 @@ void TextureController::_BindTexture(GLuint tex_id) {
 
 
 void TextureController::_DeleteTexture(GLuint tex_id) {
+	// The texture may still be referenced by quads waiting in the video engine's batch
+	VideoManager->_FlushBatch();
+
+	// Screen captures may hold a texture taken from the frame target, which keeps it for the next capture
+	if (VideoManager->_frame_target.ReclaimTexture(tex_id) == true) {
+		if (_last_tex_id == tex_id)
+			_last_tex_id = INVALID_TEXTURE_ID;
+		return;
+	}
+
 	glDeleteTextures(1, &tex_id);
 
 	if (_last_tex_id == tex_id)
@@ -358,6 +475,9 @@ TexSheet* TextureController::_CreateTexSheet(int32 width, int32 height, TexSheet
 		return NULL;
 	}
 
+	// Make room for the new sheet by evicting others if the texture memory budget has been exceeded
+	_EnforceMemoryBudget();
+
 	// Create a blank texture for the sheet to use
 	GLuint tex_id = _CreateBlankGLTexture(width, height);
 	if (tex_id == INVALID_TEXTURE_ID) {
@@ -381,6 +501,24 @@ TexSheet* TextureController::_CreateTexSheet(int32 width, int32 height, TexSheet
 
 
 
+TexSheet* TextureController::_CreateTexSheetFromTexture(GLuint tex_id, int32 width, int32 height) {
+	if (tex_id == INVALID_TEXTURE_ID) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid texture ID argument" << endl;
+		return NULL;
+	}
+
+	if (!IsPowerOfTwo(width) || !IsPowerOfTwo(height)) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "non power-of-two width and/or height argument" << endl;
+		return NULL;
+	}
+
+	TexSheet* sheet = new VariableTexSheet(width, height, tex_id, VIDEO_TEXSHEET_ANY, false);
+	_tex_sheets.push_back(sheet);
+	return sheet;
+}
+
+
+
 void TextureController::_RemoveSheet(TexSheet* sheet) {
 	if (sheet == NULL) {
 		IF_PRINT_WARNING(VIDEO_DEBUG) << "NULL argument passed to function" << endl;
@@ -396,6 +534,14 @@ void TextureController::_RemoveSheet(TexSheet* sheet) {
 
 	while(i != _tex_sheets.end()) {
 		if (*i == sheet) {
+			// The atlas may be loaded again later, when another one of its images is needed
+			if (sheet->type == VIDEO_TEXSHEET_ATLAS) {
+				for (uint32 j = 0; j < _atlas_sheets.size(); j++) {
+					if (_atlas_sheets[j] == sheet)
+						_atlas_sheets[j] = NULL;
+				}
+			}
+
 			delete sheet;
 			_tex_sheets.erase(i);
 			return;
@@ -450,7 +596,8 @@ TexSheet* TextureController::_InsertImageInTexSheet(BaseTexture *image, ImageMem
 			continue;
 		}
 
-		if (sheet->type == type && sheet->is_static == is_static) {
+		// Sheets that were evicted from texture memory are not reloaded only to find out whether the image fits in them
+		if (sheet->type == type && sheet->is_static == is_static && sheet->loaded == true) {
 			if (sheet->AddTexture(image, load_info) == true) {
 				return sheet;
 			}
@@ -476,14 +623,160 @@ TexSheet* TextureController::_InsertImageInTexSheet(BaseTexture *image, ImageMem
 
 
 
+TexSheet* TextureController::_InsertImageTexture(ImageTexture* img, ImageMemory& load_info, bool is_static, const ImageContentKey* content_key) {
+	if (img->tags.find("<T>") != string::npos)
+		return _InsertImageInTexSheet(img, load_info, is_static);
+
+	ImageContentKey key;
+	if (content_key != NULL)
+		key = *content_key;
+	else
+		key.Compute(load_info);
+
+	uint32 data_size = load_info.width * load_info.height * 4;
+	pair<multimap<ImageContentKey, ImageTexture*>::iterator, multimap<ImageContentKey, ImageTexture*>::iterator> matches = _image_contents.equal_range(key);
+	for (multimap<ImageContentKey, ImageTexture*>::iterator i = matches.first; i != matches.second; i++) {
+		ImageTexture* existing = i->second;
+		if (existing == img || existing->texture_sheet == NULL)
+			continue;
+
+		// A key match may be a hash collision, so the pixels are compared. Those of the existing image are read again
+		// from its image file rather than back from its texture sheet, which would stall until the GPU is idle.
+		ImageMemory existing_data;
+		if (_LoadImageTexturePixels(existing, existing_data) == false)
+			continue;
+
+		bool identical = (existing_data.width == load_info.width && existing_data.height == load_info.height &&
+			existing_data.rgb_format == load_info.rgb_format &&
+			memcmp(existing_data.pixels, load_info.pixels, load_info.width * load_info.height * (load_info.rgb_format ? 3 : 4)) == 0);
+		free(existing_data.pixels);
+		existing_data.pixels = NULL;
+		if (identical == false)
+			continue;
+
+		img->shared_texture = existing;
+		img->texture_sheet = existing->texture_sheet;
+		img->x = existing->x;
+		img->y = existing->y;
+		img->u1 = existing->u1;
+		img->v1 = existing->v1;
+		img->u2 = existing->u2;
+		img->v2 = existing->v2;
+		img->smooth = existing->smooth;
+		existing->AddReference();
+
+		_shared_image_memory += data_size;
+		IF_PRINT_DEBUG(VIDEO_DEBUG) << "image " << img->filename << img->tags << " shares the texture of identical image "
+			<< existing->filename << existing->tags << endl;
+		return img->texture_sheet;
+	}
+
+	TexSheet* sheet = _InsertImageInTexSheet(img, load_info, is_static);
+	if (sheet != NULL) {
+		img->content_key = key;
+		_image_contents.insert(make_pair(key, img));
+	}
+	return sheet;
+} // TexSheet* TextureController::_InsertImageTexture(ImageTexture* img, ImageMemory& load_info, bool is_static, const ImageContentKey* content_key)
+
+
+
+bool TextureController::_LoadImageTexturePixels(ImageTexture* img, ImageMemory& data) {
+	if (data.LoadImage(img->filename) == false)
+		return false;
+
+	size_t row_tag = img->tags.find("<X");
+	size_t column_tag = img->tags.find("<Y");
+	if (row_tag == string::npos || column_tag == string::npos)
+		return true;
+
+	// The element of a multi image is extracted in the same manner as ImageDescriptor::_LoadMultiImage()
+	int32 x = atoi(img->tags.substr(row_tag + 2).c_str());
+	int32 rows = atoi(img->tags.substr(img->tags.find('_', row_tag) + 1).c_str());
+	int32 y = atoi(img->tags.substr(column_tag + 2).c_str());
+	int32 cols = atoi(img->tags.substr(img->tags.find('_', column_tag) + 1).c_str());
+
+	ImageMemory element;
+	if (data.rgb_format == false && rows > 0 && cols > 0 && x < rows && y < cols) {
+		element.width = data.width / cols;
+		element.height = data.height / rows;
+		element.pixels = malloc(element.width * element.height * 4);
+	}
+
+	if (element.pixels == NULL) {
+		free(data.pixels);
+		data.pixels = NULL;
+		return false;
+	}
+
+	for (int32 row = 0; row < element.height; row++) {
+		memcpy((uint8*)element.pixels + 4 * element.width * row, (uint8*)data.pixels + (((x * data.height / rows) + row) *
+			data.width + y * data.width / cols) * 4, 4 * element.width);
+	}
+
+	free(data.pixels);
+	data.pixels = element.pixels;
+	data.width = element.width;
+	data.height = element.height;
+	element.pixels = NULL;
+	return true;
+} // bool TextureController::_LoadImageTexturePixels(ImageTexture* img, ImageMemory& data)
+
+
+
+TexSheet* TextureController::_InsertGlyphInTexSheet(BaseTexture* glyph, ImageMemory& glyph_data) {
+	for (uint32 i = 0; i < _tex_sheets.size(); i++) {
+		TexSheet* sheet = _tex_sheets[i];
+		if (sheet != NULL && sheet->type == VIDEO_TEXSHEET_GLYPH) {
+			if (sheet->AddTexture(glyph, glyph_data) == true) {
+				return sheet;
+			}
+		}
+	}
+
+	// All glyph sheets are full (or none exist yet), so create a new one. Glyphs are always drawn smoothed
+	TexSheet* sheet = _CreateTexSheet(512, 512, VIDEO_TEXSHEET_GLYPH, true);
+	if (sheet == NULL) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create a new glyph texture sheet" << endl;
+		return NULL;
+	}
+	sheet->Smooth(true);
+
+	if (sheet->AddTexture(glyph, glyph_data) == true) {
+		return sheet;
+	}
+	else {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "glyph could not be added to a new texture sheet, glyph size: " << glyph_data.width << "x" << glyph_data.height << endl;
+		return NULL;
+	}
+} // TexSheet* TextureController::_InsertGlyphInTexSheet(BaseTexture* glyph, ImageMemory& glyph_data)
+
+
+
 bool TextureController::_ReloadImagesToSheet(TexSheet* sheet) {
+	// The contents of a texture atlas are all reloaded at once from the atlas image file
+	if (sheet->type == VIDEO_TEXSHEET_ATLAS) {
+		AtlasTexSheet* atlas_sheet = dynamic_cast<AtlasTexSheet*>(sheet);
+		ImageMemory atlas_data;
+		if (atlas_sheet == NULL || atlas_data.LoadImage(atlas_sheet->filename) == false) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to load the image of a texture atlas" << endl;
+			return false;
+		}
+
+		bool success = atlas_sheet->CopyRect(0, 0, atlas_data);
+		free(atlas_data.pixels);
+		atlas_data.pixels = NULL;
+		return success;
+	}
+
 	// Delete images
 	std::map<string, pair<ImageMemory, ImageMemory> > multi_image_info;
 
 	bool success = true;
 	for (map<string, ImageTexture*>::iterator i = _images.begin(); i != _images.end(); i++) {
-		// Only operate on images which belong to the requested TexSheet
-		if (i->second->texture_sheet != sheet) {
+		// Only operate on images which belong to the requested TexSheet. Images that share the space of another image
+		// are restored along with that image.
+		if (i->second->texture_sheet != sheet || i->second->shared_texture != NULL) {
 			continue;
 		}
 
@@ -541,10 +834,6 @@ bool TextureController::_ReloadImagesToSheet(TexSheet* sheet) {
 					* load_info.width + y * load_info.width / cols) * 4, 4 * image.width);
 			}
 
-			// Convert to grayscale if needed
-			if (img->tags.find("<G>", 0) != img->filename.npos)
-				image.ConvertToGrayscale();
-
 			// Copy the image into the texture sheet
 			if (sheet->CopyRect(img->x, img->y, image) == false) {
 				IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TexSheet::CopyRect() failed" << endl;
@@ -567,10 +856,6 @@ bool TextureController::_ReloadImagesToSheet(TexSheet* sheet) {
 				success = false;
 			}
 
-			// Convert to grayscale if needed
-			if (img->tags.find("<G>", 0) != img->filename.npos)
-				load_info.ConvertToGrayscale();
-
 			if (sheet->CopyRect(img->x, img->y, load_info) == false) {
 				IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TexSheet::CopyRect() failed" << endl;
 				success = false;
@@ -605,6 +890,249 @@ bool TextureController::_ReloadImagesToSheet(TexSheet* sheet) {
 
 
 
+void TextureController::_UseTexSheet(TexSheet* sheet) {
+	// A sheet that failed to reload is not attempted again on every draw, as each attempt costs a texture allocation
+	if (sheet->loaded == false && sheet->reload_failed == false) {
+		IF_PRINT_DEBUG(VIDEO_DEBUG) << "reloading evicted texture sheet, size: " << sheet->width << "x" << sheet->height << endl;
+		if (sheet->Reload() == false) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to reload a texture sheet that was evicted from texture memory" << endl;
+			sheet->reload_failed = true;
+		}
+	}
+
+	sheet->last_used_frame = _current_frame;
+}
+
+
+
+void TextureController::_AddSheetMemory(const TexSheet* sheet) {
+	_memory_usage += sheet->GetMemorySize();
+	if (_memory_usage > _peak_memory_usage)
+		_peak_memory_usage = _memory_usage;
+}
+
+
+
+void TextureController::_RemoveSheetMemory(const TexSheet* sheet) {
+	_memory_usage -= sheet->GetMemorySize();
+}
+
+
+
+void TextureController::_EnforceMemoryBudget() {
+	// Budgets of 4096 megabytes or more can not be exceeded by a 32-bit byte count
+	uint32 budget_megabytes = VideoManager->GetTextureMemoryBudget();
+	if (budget_megabytes == 0 || budget_megabytes >= 4096)
+		return;
+
+	uint32 budget = budget_megabytes * 1024 * 1024;
+	if (_memory_usage <= budget)
+		return;
+
+	// Temporary textures, such as screen captures, are only written to disk when the OpenGL context is changed
+	set<TexSheet*> temporary_sheets;
+	for (map<string, ImageTexture*>::iterator i = _images.begin(); i != _images.end(); i++) {
+		if (i->second->texture_sheet != NULL && i->second->tags.find("<T>") != string::npos)
+			temporary_sheets.insert(i->second->texture_sheet);
+	}
+
+	while (_memory_usage > budget) {
+		TexSheet* oldest = NULL;
+		for (uint32 i = 0; i < _tex_sheets.size(); i++) {
+			TexSheet* sheet = _tex_sheets[i];
+			if (sheet == NULL || sheet->loaded == false || sheet->is_static == true)
+				continue;
+			if (sheet->last_used_frame + 1 >= _current_frame || temporary_sheets.find(sheet) != temporary_sheets.end())
+				continue;
+			if (oldest == NULL || sheet->last_used_frame < oldest->last_used_frame)
+				oldest = sheet;
+		}
+
+		// Every remaining sheet is either in use or can not be reloaded, so the budget is exceeded until some of them are removed
+		if (oldest == NULL)
+			return;
+
+		IF_PRINT_DEBUG(VIDEO_DEBUG) << "evicting texture sheet, size: " << oldest->width << "x" << oldest->height
+			<< ", last used in frame: " << oldest->last_used_frame << endl;
+		oldest->Unload();
+	}
+} // void TextureController::_EnforceMemoryBudget()
+
+
+
+void TextureController::_CompactTexSheets() {
+	if (_current_frame % VIDEO_TEXSHEET_COMPACTION_INTERVAL != 0)
+		return;
+
+	// Only sheets of the standard size are compacted, since larger sheets hold a single image
+	vector<VariableTexSheet*> candidates;
+	for (uint32 i = 0; i < _tex_sheets.size(); i++) {
+		TexSheet* sheet = _tex_sheets[i];
+		if (sheet == NULL || sheet->type != VIDEO_TEXSHEET_ANY || sheet->width != 512 || sheet->height != 512 || sheet->loaded == false)
+			continue;
+
+		VariableTexSheet* variable_sheet = dynamic_cast<VariableTexSheet*>(sheet);
+		if (variable_sheet != NULL)
+			candidates.push_back(variable_sheet);
+	}
+
+	VariableTexSheet* source = NULL;
+	for (uint32 i = 0; i < candidates.size(); i++) {
+		if (source == NULL || candidates[i]->GetOccupiedArea() < source->GetOccupiedArea())
+			source = candidates[i];
+	}
+	if (source == NULL || source->GetOccupiedArea() >= VIDEO_TEXSHEET_COMPACTION_OCCUPANCY * source->width * source->height)
+		return;
+
+	// The images are moved into the fullest sheets first, and the largest images are placed first so that they fit best
+	vector<VariableTexSheet*> destinations;
+	for (uint32 i = 0; i < candidates.size(); i++) {
+		if (candidates[i] != source && candidates[i]->is_static == source->is_static)
+			destinations.push_back(candidates[i]);
+	}
+	for (uint32 i = 1; i < destinations.size(); i++) {
+		for (uint32 j = i; j > 0 && destinations[j]->GetOccupiedArea() > destinations[j - 1]->GetOccupiedArea(); j--)
+			swap(destinations[j], destinations[j - 1]);
+	}
+
+	vector<BaseTexture*> textures(source->GetTextures().begin(), source->GetTextures().end());
+	for (uint32 i = 1; i < textures.size(); i++) {
+		for (uint32 j = i; j > 0 && textures[j]->width * textures[j]->height > textures[j - 1]->width * textures[j - 1]->height; j--)
+			swap(textures[j], textures[j - 1]);
+	}
+
+	// Find a new location for every image before any pixel data is copied. The old location of each image is kept, so
+	// that everything can be put back if any of the images does not fit.
+	vector<TexSheetRect> old_locations;
+	for (uint32 i = 0; i < textures.size(); i++) {
+		BaseTexture* texture = textures[i];
+		old_locations.push_back(TexSheetRect(texture->x, texture->y, texture->width, texture->height));
+
+		bool moved = false;
+		for (uint32 j = 0; j < destinations.size() && moved == false; j++)
+			moved = destinations[j]->InsertTexture(texture);
+
+		if (moved == false) {
+			_RestoreCompactedTextures(source, textures, old_locations, i);
+			return;
+		}
+	}
+
+	IF_PRINT_DEBUG(VIDEO_DEBUG) << "compacting texture sheet, images moved: " << textures.size() << endl;
+
+	// Batched quads may still refer to the images at their old locations
+	VideoManager->_FlushBatch();
+
+	// Copy the pixel data of each image from the source sheet to the new location of the image. With framebuffer objects,
+	// the source sheet is read by glCopyTexSubImage2D() and the pixels never leave texture memory.
+	bool copied = true;
+	GLuint read_fbo = RenderTarget::BeginTextureRead(source->tex_id);
+	if (read_fbo != 0) {
+		for (uint32 i = 0; i < textures.size(); i++) {
+			BaseTexture* texture = textures[i];
+			if (texture->width <= 0 || texture->height <= 0)
+				continue;
+
+			_BindTexture(texture->texture_sheet->tex_id);
+			glCopyTexSubImage2D(GL_TEXTURE_2D, 0, texture->x, texture->y, old_locations[i].x, old_locations[i].y,
+				texture->width, texture->height);
+		}
+
+		RenderTarget::EndTextureRead(read_fbo);
+		VideoManager->_BindScreenTarget();
+		if (VideoManager->CheckGLError() == true) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "an OpenGL error occured: " << VideoManager->CreateGLErrorString() << endl;
+			copied = false;
+		}
+	}
+	else {
+		// The whole source sheet is read back to system memory once and each image is uploaded to its new location
+		ImageMemory source_data;
+		if (textures.empty() == false) {
+			source_data.CopyFromTexture(source);
+			if (source_data.pixels == NULL) {
+				IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to read back the texture sheet being compacted" << endl;
+				copied = false;
+			}
+		}
+
+		for (uint32 i = 0; i < textures.size() && copied == true; i++) {
+			BaseTexture* texture = textures[i];
+			if (texture->width <= 0 || texture->height <= 0)
+				continue;
+
+			ImageMemory image_data;
+			image_data.width = texture->width;
+			image_data.height = texture->height;
+			image_data.pixels = malloc(image_data.width * image_data.height * 4);
+			if (image_data.pixels == NULL) {
+				PRINT_ERROR << "failed to malloc memory for a compacted image" << endl;
+				copied = false;
+				break;
+			}
+
+			for (int32 row = 0; row < image_data.height; row++) {
+				memcpy((uint8*)image_data.pixels + 4 * image_data.width * row, (uint8*)source_data.pixels +
+					((old_locations[i].y + row) * source_data.width + old_locations[i].x) * 4, 4 * image_data.width);
+			}
+
+			if (texture->texture_sheet->CopyRect(texture->x, texture->y, image_data) == false) {
+				IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TexSheet::CopyRect() failed" << endl;
+				copied = false;
+			}
+
+			free(image_data.pixels);
+			image_data.pixels = NULL;
+		}
+
+		if (source_data.pixels != NULL) {
+			free(source_data.pixels);
+			source_data.pixels = NULL;
+		}
+	}
+
+	// The images are left in the source sheet, which still holds their pixels, unless every one of them was copied
+	if (copied == false) {
+		_RestoreCompactedTextures(source, textures, old_locations, textures.size());
+		return;
+	}
+
+	// Images that share the space of a moved image follow it to its new location
+	for (map<string, ImageTexture*>::iterator i = _images.begin(); i != _images.end(); i++) {
+		ImageTexture* img = i->second;
+		if (img->shared_texture == NULL || img->texture_sheet != source)
+			continue;
+
+		img->texture_sheet = img->shared_texture->texture_sheet;
+		img->x = img->shared_texture->x;
+		img->y = img->shared_texture->y;
+		img->u1 = img->shared_texture->u1;
+		img->v1 = img->shared_texture->v1;
+		img->u2 = img->shared_texture->u2;
+		img->v2 = img->shared_texture->v2;
+	}
+
+	// The images now hold the locations of their new sheets, which is of no consequence since the source sheet is deleted
+	for (uint32 i = 0; i < textures.size(); i++)
+		source->RemoveTexture(textures[i]);
+	_RemoveSheet(source);
+	_layout_generation++;
+} // void TextureController::_CompactTexSheets()
+
+
+
+void TextureController::_RestoreCompactedTextures(TexSheet* source, const vector<BaseTexture*>& textures,
+	const vector<TexSheetRect>& old_locations, uint32 count) {
+	// The images were never removed from the source sheet, so only their locations need to be restored
+	for (uint32 i = 0; i < count; i++) {
+		BaseTexture* placed = textures[i];
+		placed->texture_sheet->RemoveTexture(placed);
+		source->SetTextureLocation(placed, old_locations[i].x, old_locations[i].y);
+	}
+}
+
+
+
 void TextureController::_RegisterImageTexture(ImageTexture* img) {
 	if (img == NULL) {
 		IF_PRINT_WARNING(VIDEO_DEBUG) << "NULL argument passed to function" << endl;
@@ -635,6 +1163,19 @@ void TextureController::_UnregisterImageTexture(ImageTexture* img) {
 		return;
 	}
 	_images.erase(img_iter);
+
+	if (img->shared_texture != NULL) {
+		_shared_image_memory -= img->width * img->height * 4;
+		return;
+	}
+
+	pair<multimap<ImageContentKey, ImageTexture*>::iterator, multimap<ImageContentKey, ImageTexture*>::iterator> matches = _image_contents.equal_range(img->content_key);
+	for (multimap<ImageContentKey, ImageTexture*>::iterator i = matches.first; i != matches.second; i++) {
+		if (i->second == img) {
+			_image_contents.erase(i);
+			break;
+		}
+	}
 }
 
 
@@ -670,4 +1211,104 @@ void TextureController::_UnregisterTextTexture(TextTexture* tex) {
 }
 
 
+
+bool TextureController::_GetAtlasImageInfo(const std::string& filename, uint32& rows, uint32& cols) const {
+	map<string, AtlasEntry>::const_iterator entry = _atlas_entries.find(filename);
+	if (entry == _atlas_entries.end())
+		return false;
+
+	rows = static_cast<uint32>(entry->second.height);
+	cols = static_cast<uint32>(entry->second.width);
+	return true;
+}
+
+
+
+ImageTexture* TextureController::_CreateAtlasImageTexture(const std::string& filename, const std::string& tags,
+	uint32 grid_rows, uint32 grid_cols, uint32 row, uint32 col)
+{
+	map<string, AtlasEntry>::const_iterator entry = _atlas_entries.find(filename);
+	if (entry == _atlas_entries.end()) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "image file was not packed into a texture atlas: " << filename << endl;
+		return NULL;
+	}
+
+	if (grid_rows == 0 || grid_cols == 0 || row >= grid_rows || col >= grid_cols) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid image element arguments for file: " << filename << endl;
+		return NULL;
+	}
+
+	const AtlasEntry& location = entry->second;
+	AtlasTexSheet* sheet = _atlas_sheets[location.atlas];
+	if (sheet == NULL) {
+		sheet = _LoadAtlasTexSheet(location.atlas);
+		if (sheet == NULL) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to load texture atlas: " << _atlas_filenames[location.atlas] << endl;
+			return NULL;
+		}
+	}
+
+	int32 element_width = location.width / static_cast<int32>(grid_cols);
+	int32 element_height = location.height / static_cast<int32>(grid_rows);
+
+	ImageTexture* img = new ImageTexture(filename, tags, element_width, element_height);
+	img->x = location.x + static_cast<int32>(col) * element_width;
+	img->y = location.y + static_cast<int32>(row) * element_height;
+
+	if (sheet->InsertTexture(img) == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to locate image in texture atlas: " << filename << endl;
+		delete img;
+		if (sheet->GetNumberTextures() == 0)
+			_RemoveSheet(sheet);
+		return NULL;
+	}
+
+	return img;
+} // ImageTexture* TextureController::_CreateAtlasImageTexture(...)
+
+
+
+AtlasTexSheet* TextureController::_LoadAtlasTexSheet(uint32 atlas) {
+	const string& atlas_filename = _atlas_filenames[atlas];
+
+	ImageMemory atlas_data;
+	if (atlas_data.LoadImage(atlas_filename) == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to load texture atlas image: " << atlas_filename << endl;
+		return NULL;
+	}
+
+	if (!IsPowerOfTwo(atlas_data.width) || !IsPowerOfTwo(atlas_data.height)) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "texture atlas image did not have power-of-two dimensions: " << atlas_filename << endl;
+		free(atlas_data.pixels);
+		atlas_data.pixels = NULL;
+		return NULL;
+	}
+
+	_EnforceMemoryBudget();
+
+	GLuint tex_id = _CreateBlankGLTexture(atlas_data.width, atlas_data.height);
+	if (tex_id == INVALID_TEXTURE_ID) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create a new blank OpenGL texture" << endl;
+		free(atlas_data.pixels);
+		atlas_data.pixels = NULL;
+		return NULL;
+	}
+
+	AtlasTexSheet* sheet = new AtlasTexSheet(atlas_data.width, atlas_data.height, tex_id, atlas_filename);
+	bool success = sheet->CopyRect(0, 0, atlas_data);
+	free(atlas_data.pixels);
+	atlas_data.pixels = NULL;
+
+	if (success == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TexSheet::CopyRect() failed for texture atlas: " << atlas_filename << endl;
+		delete sheet;
+		return NULL;
+	}
+
+	_tex_sheets.push_back(sheet);
+	_atlas_sheets[atlas] = sheet;
+	return sheet;
+} // AtlasTexSheet* TextureController::_LoadAtlasTexSheet(uint32 atlas)
+
+
 }  // namespace hoa_video
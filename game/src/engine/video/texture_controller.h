@@ -34,9 +34,37 @@
 
 #include "texture.h"
 #include "image_base.h"
+#include "image_loader.h"
+#include "render_target.h"
 
 namespace hoa_video {
 
+namespace private_video {
+
+//! \brief The location of an image file that was packed into one of the texture atlases
+class AtlasEntry {
+public:
+	AtlasEntry() :
+		atlas(0), x(0), y(0), width(0), height(0) {}
+
+	//! \brief The index of the atlas that holds the image, into the list of atlases in the atlas manifest
+	uint32 atlas;
+
+	//! \brief The position of the upper left corner of the image in the atlas, in pixels
+	int32 x, y;
+
+	//! \brief The dimensions of the image, in pixels
+	int32 width, height;
+}; // class AtlasEntry
+
+} // namespace private_video
+
+//! \brief The number of frames between attempts to compact the texture sheets that hold images of any size
+const uint32 VIDEO_TEXSHEET_COMPACTION_INTERVAL = 300;
+
+//! \brief Texture sheets that hold images of any size are emptied into other sheets when less than this fraction of them is occupied
+const float VIDEO_TEXSHEET_COMPACTION_OCCUPANCY = 0.25f;
+
 //! \brief The singleton pointer for the instance of the texture controller
 extern TextureController* TextureManager;
 
@@ -54,6 +82,11 @@ class TextureController : public hoa_utils::Singleton<TextureController> {
 	friend class private_video::FixedTexSheet;
 	friend class private_video::VariableTexSheet;
 	friend class private_video::ParticleSystem;
+	friend class private_video::RenderTarget;
+	friend class private_video::ImageLoader;
+	friend class QuadBuffer;
+	friend class RenderCache;
+	friend class private_video::LightBuffer;
 
 public:
 	TextureController();
@@ -77,6 +110,32 @@ public:
 	**/
 	bool ReloadTextures();
 
+	/** \brief Loads the manifest of the texture atlases that were built by the atlas packer
+	*** \param filename The name of the Lua manifest file written by the atlas packer
+	*** \return True if the manifest was read successfully
+	***
+	*** Once the manifest is loaded, every image file listed in it is taken from its texture atlas when it is
+	*** loaded, instead of being read from its own file. Each atlas is loaded in its entirety the first time
+	*** that one of its images is needed, and is removed once none of its images are referenced. The manifest
+	*** can not be replaced while any atlas is loaded.
+	**/
+	bool LoadAtlasManifest(const std::string& filename);
+
+	//! \brief Returns the number of bytes of texture memory used by all of the texture sheets that are currently loaded
+	uint32 GetMemoryUsage() const
+		{ return _memory_usage; }
+
+	//! \brief Returns the highest number of bytes of texture memory that have been used at any one time
+	uint32 GetPeakMemoryUsage() const
+		{ return _peak_memory_usage; }
+
+	/** \brief Returns the number of bytes of texture memory that are saved by images sharing the data of identical images
+	*** This is the size of the pixel data of every loaded image that did not need to be added to a texture sheet,
+	*** because an image with identical pixel data was already held by one.
+	**/
+	uint32 GetSharedImageMemory() const
+		{ return _shared_image_memory; }
+
 	//! \brief Cycles forward to show the next texture sheet
 	void DEBUG_NextTexSheet();
 
@@ -104,11 +163,41 @@ private:
 	//! \brief A STL map containing all of the images currently being managed by this class
 	std::map<std::string, private_video::ImageTexture*> _images;
 
+	//! \brief The image textures that hold their own space in a texture sheet, using the key of their pixel data as the map key
+	std::multimap<private_video::ImageContentKey, private_video::ImageTexture*> _image_contents;
+
 	//! \brief A STL set containing all of the text images currently being managed by this class
 	std::set<private_video::TextTexture*> _text_images;
 
-	//! \brief Keeps track of the number of texture switches per frame
-	uint32 _debug_num_tex_switches;
+	//! \brief The filenames of the texture atlas images listed in the atlas manifest
+	std::vector<std::string> _atlas_filenames;
+
+	//! \brief The texture sheet holding each atlas, or NULL for atlases that are not currently loaded
+	std::vector<private_video::AtlasTexSheet*> _atlas_sheets;
+
+	//! \brief The location of every image file listed in the atlas manifest, using the image filename as the map key
+	std::map<std::string, private_video::AtlasEntry> _atlas_entries;
+
+	//! \brief Decodes the image files of images that are loaded asynchronously
+	private_video::ImageLoader _image_loader;
+
+	//! \brief The number of frames that have been drawn, which is recorded by texture sheets when they are used
+	uint32 _current_frame;
+
+	/** \brief Incremented whenever images are moved to a different position or texture sheet
+	*** Objects that retain the texture coordinates of images, such as QuadBuffer, compare this against the value it had
+	*** when the coordinates were computed to know when they must be computed again.
+	**/
+	uint32 _layout_generation;
+
+	//! \brief The number of bytes of texture memory used by all loaded texture sheets
+	uint32 _memory_usage;
+
+	//! \brief The highest value that _memory_usage has reached
+	uint32 _peak_memory_usage;
+
+	//! \brief The number of bytes of pixel data that were not added to texture sheets because they were identical to loaded images
+	uint32 _shared_image_memory;
 
 	// ---------- Private methods
 
@@ -129,6 +218,7 @@ private:
 
 	/** \brief A wrapper to glDeleteTextures() that also adds checking to eliminate redundant texture binding
 	*** \param tex_id The integer handle to the OpenGL texture to delete
+	*** \note Textures taken from the video engine's frame target are given back to the target rather than deleted
 	 */
 	void _DeleteTexture(GLuint tex_id);
 
@@ -159,6 +249,16 @@ private:
 	**/
 	private_video::TexSheet* _CreateTexSheet(int32 width, int32 height, private_video::TexSheetType type, bool is_static);
 
+	/** \brief Creates a new variable image texture sheet that uses an existing OpenGL texture
+	*** \param tex_id The OpenGL ID of the texture, which the sheet takes ownership of
+	*** \param width The width of the texture, in pixels
+	*** \param height The height of the texture, in pixels
+	*** \return A pointer to the newly created TexSheet, or NULL if the arguments were invalid
+	***
+	*** This is used to wrap textures that were drawn into by OpenGL, such as the contents of a render target.
+	**/
+	private_video::TexSheet* _CreateTexSheetFromTexture(GLuint tex_id, int32 width, int32 height);
+
 	/** \brief Removes references to a texture sheet and deletes it from memory
 	*** \param sheet A pointer to the sheet we wish to remove
 	**/
@@ -176,6 +276,16 @@ private:
 	**/
 	private_video::TexSheet* _InsertImageInTexSheet(private_video::BaseTexture* image, private_video::ImageMemory& load_info, bool is_static);
 
+	/** \brief Inserts a rendered font glyph into a glyph texture sheet
+	*** \param glyph A pointer to the texture representing the glyph
+	*** \param glyph_data The pixel data of the rendered glyph
+	*** \return The glyph texture sheet that now contains the glyph, or NULL if the glyph could not be inserted
+	***
+	*** Glyphs are kept in their own sheets, apart from all other images, so that the glyphs of a line of text are very likely
+	*** to all be found in the same texture. A new glyph sheet is created when all of the existing ones are full.
+	**/
+	private_video::TexSheet* _InsertGlyphInTexSheet(private_video::BaseTexture* glyph, private_video::ImageMemory& glyph_data);
+
 	/** \brief Iterate through all currently loaded images and if they belong to the specified TexSheet, reload them into it
 	*** \param sheet A pointer to the TexSheet whose images we wish to reload
 	*** \return True only if every single image owned by the TexSheet was successfully reloaded back into it
@@ -183,6 +293,55 @@ private:
 	bool _ReloadImagesToSheet(private_video::TexSheet* sheet);
 	//@}
 
+	//! \name Texture Memory Budget Operations
+	//@{
+	/** \brief Records that a texture sheet is being drawn in the current frame
+	*** \param sheet The sheet that is about to be bound for drawing
+	***
+	*** A sheet that was evicted from texture memory is reloaded by this call, so this must be called before the
+	*** texture of a sheet is bound. Sheets that were used recently are never evicted.
+	**/
+	void _UseTexSheet(private_video::TexSheet* sheet);
+
+	//! \brief Adds the size of a texture sheet that was just loaded to the texture memory usage
+	void _AddSheetMemory(const private_video::TexSheet* sheet);
+
+	//! \brief Subtracts the size of a texture sheet that was just unloaded from the texture memory usage
+	void _RemoveSheetMemory(const private_video::TexSheet* sheet);
+
+	/** \brief Evicts the least recently used texture sheets until the texture memory usage is within the budget
+	***
+	*** Only sheets which are not static, and which hold no temporary textures, can be evicted, since the images of
+	*** all other sheets can not be read again from their image files. Sheets used in the current or previous frame
+	*** are not evicted either. The budget is set by VideoEngine::SetTextureMemoryBudget().
+	**/
+	void _EnforceMemoryBudget();
+
+	/** \brief Moves the images of the emptiest 512x512 sheet of images of any size into other sheets and deletes it
+	***
+	*** This is attempted every VIDEO_TEXSHEET_COMPACTION_INTERVAL frames, and only for sheets that are less than
+	*** VIDEO_TEXSHEET_COMPACTION_OCCUPANCY occupied. All of the images of the sheet must fit into other loaded sheets
+	*** of the same static status, or nothing is moved. The pixel data of the images is copied from the sheet to their new
+	*** locations, so that no image files need to be read. The copy is made on the GPU through a framebuffer object when
+	*** they are supported. Otherwise the sheet is read back to system memory once and each image is uploaded again. If
+	*** any of the pixel data could not be copied, every image is returned to the sheet and it is kept.
+	**/
+	void _CompactTexSheets();
+
+	/** \brief Returns images that were being moved by _CompactTexSheets() to their locations in the sheet being compacted
+	*** \param source The sheet being compacted, which still holds every image
+	*** \param textures The images being moved
+	*** \param old_locations The location of each image in the source sheet
+	*** \param count The number of images, from the start of the list, that were inserted into another sheet
+	**/
+	void _RestoreCompactedTextures(private_video::TexSheet* source, const std::vector<private_video::BaseTexture*>& textures,
+		const std::vector<private_video::TexSheetRect>& old_locations, uint32 count);
+
+	//! \brief Called once every frame after the screen is displayed, which is when texture sheets are evicted and compacted
+	void _EndFrame()
+		{ _EnforceMemoryBudget(); _CompactTexSheets(); _current_frame++; }
+	//@}
+
 	//! \name Image Texture Operations
 	//@{
 	/** \brief Adds an image texture to the map registery
@@ -207,6 +366,31 @@ private:
 	 **/
 	hoa_video::private_video::ImageTexture* _GetImageTexture(std::string nametag)
 		{ if (_IsImageTextureRegistered(nametag) == true) return _images[nametag]; else return NULL; }
+
+	/** \brief Loads the pixel data of an image texture from its image file
+	*** \param img The image texture, which may be an element of a multi image
+	*** \param data Set to the pixel data of the texture, which the caller must free
+	*** \return False if the image file could not be loaded, in which case no pixel data is held by data
+	**/
+	bool _LoadImageTexturePixels(private_video::ImageTexture* img, private_video::ImageMemory& data);
+
+	/** \brief Places the pixel data of an image texture in a texture sheet, or shares the space of an identical image
+	*** \param img A pointer to the ImageTexture to place
+	*** \param load_info The pixel data of the image
+	*** \param is_static Whether the image should be placed in a static texture sheet
+	*** \param content_key The key of the pixel data, or NULL to compute it here. The image loader computes it on its
+	*** worker threads so that the main thread does not need to.
+	*** \return A pointer to the texture sheet that holds the image data, or NULL on failure
+	***
+	*** If an image with the same content key and identical pixels is already held by a texture sheet, the texture is
+	*** given the position of that image and holds a reference to it, and no texture memory is used. The pixels of the
+	*** existing image are read again from its image file to be compared, since the key alone may collide. Otherwise the
+	*** image is inserted by _InsertImageInTexSheet() and may later be shared by other images. Both RGBA and RGB (JPG)
+	*** images are shared, but only with images of the same format. Temporary images are never shared, since their
+	*** contents may be replaced.
+	**/
+	private_video::TexSheet* _InsertImageTexture(private_video::ImageTexture* img, private_video::ImageMemory& load_info, bool is_static,
+		const private_video::ImageContentKey* content_key = NULL);
 	//@}
 
 	//! \name Text Texture Operations
@@ -228,6 +412,41 @@ private:
 	bool _IsTextTextureRegistered(private_video::TextTexture* tex) const
 		{ return (_text_images.find(tex) != _text_images.end()); }
 	//@}
+
+	//! \name Texture Atlas Operations
+	//@{
+	//! \brief Returns true if the image file was packed into one of the texture atlases
+	bool _IsImageInAtlas(const std::string& filename) const
+		{ return (_atlas_entries.find(filename) != _atlas_entries.end()); }
+
+	/** \brief Retrieves the dimensions of an image file that was packed into one of the texture atlases
+	*** \param filename The name of the image file
+	*** \param rows Set to the height of the image, in pixels
+	*** \param cols Set to the width of the image, in pixels
+	*** \return False if the image file was not packed into a texture atlas, in which case the arguments are not modified
+	**/
+	bool _GetAtlasImageInfo(const std::string& filename, uint32& rows, uint32& cols) const;
+
+	/** \brief Creates an image texture for an image file, or an element of a multi image file, that was packed into a texture atlas
+	*** \param filename The name of the image file
+	*** \param tags The tags to give to the new image texture
+	*** \param grid_rows The number of rows of elements that the image is divided into, which is 1 for an ordinary image
+	*** \param grid_cols The number of columns of elements that the image is divided into, which is 1 for an ordinary image
+	*** \param row The row of the element to create the texture for
+	*** \param col The column of the element to create the texture for
+	*** \return The new image texture located in the atlas's texture sheet, or NULL if the texture could not be created
+	***
+	*** The atlas is loaded into a texture sheet if it is not already. The returned texture has not yet been referenced.
+	**/
+	private_video::ImageTexture* _CreateAtlasImageTexture(const std::string& filename, const std::string& tags,
+		uint32 grid_rows, uint32 grid_cols, uint32 row, uint32 col);
+
+	/** \brief Loads the image of a texture atlas into a new texture sheet
+	*** \param atlas The index of the atlas to load
+	*** \return The new texture sheet, or NULL if the atlas image could not be loaded
+	**/
+	private_video::AtlasTexSheet* _LoadAtlasTexSheet(uint32 atlas);
+	//@}
 }; // class TextureController : public hoa_utils::Singleton<TextureController>
 
 } // namespace hoa_video
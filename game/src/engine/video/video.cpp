@@ -14,6 +14,7 @@
 *** ***************************************************************************/
 
 #include "video.h"
+#include "image_cache.h"
 #include "audio.h"
 #include "script.h"
 #include "system.h"
@@ -79,12 +80,35 @@ VideoEngine::VideoEngine() :
 	_y_cursor = 0;
 	_screen_width = 0;
 	_screen_height = 0;
+	_render_width = 0;
+	_render_height = 0;
+	_render_scale = 1.0f;
+	_render_scale_smooth = true;
+	_native_gui = true;
+	_scene_resolved = false;
 	_fullscreen = false;
+	_vsync_active = false;
 	_temp_width = 0;
 	_temp_height = 0;
+	_temp_render_scale = 1.0f;
 	_temp_fullscreen = false;
 	_smooth_textures = true;
 	_advanced_display = false;
+	_frame_profiler_display = false;
+	_image_upload_budget = DEFAULT_IMAGE_UPLOAD_BUDGET;
+	_texture_memory_budget = 0;
+	_preload_particle_effects = true;
+	_batch_sheet = NULL;
+	_recording_cache = NULL;
+	_render_cache_memory = 0;
+	_batch_smooth = false;
+	_batch_blend = 0;
+	_batch_grayscale = false;
+	_gl_blend_mode = 0;
+	_gl_texture_2d_enabled = false;
+	_gl_vertex_array_enabled = false;
+	_gl_texture_coord_array_enabled = false;
+	_gl_color_array_enabled = false;
 	_x_shake = 0;
 	_y_shake = 0;
 	_gamma_value = 1.0f;
@@ -114,6 +138,8 @@ VideoEngine::VideoEngine() :
 		 _fps_samples[sample] = 0;
 
 	_light_overlay_enabled = false;
+	_light_color = Color::white;
+	_lighting_overlay_active = false;
 	_ambient_overlay_enabled = false;
 	_ambient_x_speed = 0.0f;
 	_ambient_y_speed = 0.0f;
@@ -139,7 +165,14 @@ VideoEngine::~VideoEngine() {
 	_light_overlay_image.Clear();
 	_ambient_overlay_image.Clear();
 
+	_DestroyRenderCaches();
+	_frame_profiler.DestroyQueries();
+	_light_buffer.Destroy();
+	_frame_target.Destroy();
+	_grayscale_program.Destroy();
 	TextureManager->SingletonDestroy();
+
+	_headless_context.Destroy();
 }
 
 
@@ -209,6 +242,15 @@ bool VideoEngine::SingletonInitialize() {
 	if (_initialized)
 		return true;
 
+	// Without a display, SDL is still needed for its events and timers, so it is given a driver that opens no window
+	if (_target == VIDEO_TARGET_HEADLESS) {
+		if (HeadlessContext::IsAvailable() == false) {
+			PRINT_ERROR << "headless rendering was requested, but the game was built without OSMesa (configure with --enable-osmesa)" << endl;
+			return false;
+		}
+		SDL_putenv(const_cast<char*>("SDL_VIDEODRIVER=dummy"));
+	}
+
 	if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
 		PRINT_ERROR << "SDL video initialization failed" << endl;
 		return false;
@@ -237,6 +279,23 @@ bool VideoEngine::FinalizeInitialization() {
 		return false;
 	}
 
+	_particle_manager.Initialize();
+
+	// The frame target and grayscale program are not created by the first call to ApplySettings(), which occurs before
+	// the texture manager exists
+	_InitializeFrameTarget();
+	_InitializeGrayscaleProgram();
+
+	// Decoded image data is cached in the user's data directory so that image files only need to be decompressed once
+	if (ImageCache::SetDirectory(GetUserDataPath(true) + "cache/") == false)
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "the image cache could not be enabled, image files will be decoded every time they are loaded" << endl;
+
+	// Image files that were packed into texture atlases by the atlas packer are taken from the atlases when loaded
+	if (DoesFileExist("lua/data/config/atlas_manifest.lua") == true) {
+		if (TextureManager->LoadAtlasManifest("lua/data/config/atlas_manifest.lua") == false)
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to load the texture atlas manifest, image files will be loaded individually" << endl;
+	}
+
 	if (SetDefaultCursor("img/menus/cursor.png") == false) {
 		if (VIDEO_DEBUG)
 			cerr << "VIDEO WARNING: problem loading default menu cursor" << endl;
@@ -264,7 +323,8 @@ void VideoEngine::SetInitialResolution(int32 width, int32 height) {
 	const SDL_VideoInfo* video_info(0);
 	video_info = SDL_GetVideoInfo();
 
-	if (video_info) {
+	// There is no display to fit the resolution to when running headless, so the requested one is always used
+	if (video_info && _target != VIDEO_TARGET_HEADLESS) {
 		// Set the resolution to be the highest possible (lower than the user one)
 		if (video_info->current_w >= width && video_info->current_h >= height) {
 			SetResolution(width, height);
@@ -344,11 +404,15 @@ void VideoEngine::Clear() {
 
 
 void VideoEngine::Clear(const Color &c) {
+	_FlushBatch();
 	SetViewport(0.0f, 100.0f, 0.0f, 100.0f);
 	glClearColor(c[0], c[1], c[2], c[3]);
 	glClear(GL_COLOR_BUFFER_BIT);
 
-	TextureManager->_debug_num_tex_switches = 0;
+	_draw_recorder.BeginFrame(_render_width, _render_height, _advanced_display);
+	_frame_profiler.BeginFrame(_frame_profiler_display);
+	_light_buffer.Clear();
+	_lighting_overlay_active = false;
 
 	if (CheckGLError() == true) {
 		IF_PRINT_WARNING(VIDEO_DEBUG) << "an OpenGL error occured: " << CreateGLErrorString() << endl;
@@ -372,12 +436,18 @@ void VideoEngine::Display(uint32 frame_time) {
 	SetStandardCoordSys();
 	_UpdateShake(frame_time);
 
-	// This must be called before DrawFPS, because we only want to count
-	// texture switches related to the game's normal operation, not the
-	// ones used to draw the video engine debugging text
+	// The frame's statistics are completed here, so that the debugging text drawn below is not counted along with
+	// the game's normal operation
+	_FlushBatch();
+	_draw_recorder.EndFrame();
+	_frame_profiler.EndFrame();
+
 	if (_advanced_display)
 		_DEBUG_ShowAdvancedStats();
 
+	if (_frame_profiler_display == true)
+		_DEBUG_ShowFrameProfile();
+
 	if (TextureManager->debug_current_sheet >= 0)
 		TextureManager->DEBUG_ShowTexSheet();
 
@@ -385,8 +455,38 @@ void VideoEngine::Display(uint32 frame_time) {
 
 	PopState();
 
-	SDL_GL_SwapBuffers();
+	_FlushBatch();
+
+	// When the frame was drawn offscreen, it must be drawn to the window before the buffers are swapped, unless the
+	// game mode already did so with ResolveScene()
+	if (_frame_target.IsValid() == true && _scene_resolved == false)
+		_DrawFrameTarget();
+
+	// Errors are checked once per frame here regardless of the VIDEO_DEBUG setting, since a single call to glGetError()
+	// per frame is cheap. The per-draw checks made through CheckGLError() only occur when VIDEO_DEBUG is enabled.
+	_gl_error_code = glGetError();
+	if (_gl_error_code != GL_NO_ERROR) {
+		PRINT_WARNING << "an OpenGL error was detected during the last frame: " << CreateGLErrorString() << endl;
+	}
+
+	if (_target == VIDEO_TARGET_HEADLESS)
+		_headless_context.Finish();
+	else
+		SDL_GL_SwapBuffers();
 
+	// The next frame begins on the frame target again, at the render scale
+	if (_scene_resolved == true) {
+		_scene_resolved = false;
+		_SetRenderSurfaceSize(_frame_target.GetWidth(), _frame_target.GetHeight());
+	}
+	_BindScreenTarget();
+
+	// Images that finished decoding are placed in texture memory after the swap, so that the time taken delays the next frame
+	// rather than the presentation of this one
+	TextureManager->_image_loader.UploadImages(_image_upload_budget);
+
+	// Texture sheets are only evicted between frames, once everything that uses them has been drawn
+	TextureManager->_EndFrame();
 } // void VideoEngine::Display(uint32 frame_time)
 
 
@@ -405,15 +505,60 @@ const std::string VideoEngine::CreateGLErrorString() {
 //-----------------------------------------------------------------------------
 
 void VideoEngine::GetPixelSize(float& x, float& y) {
-	x = fabs(_current_context.coordinate_system.GetRight() - _current_context.coordinate_system.GetLeft()) / _screen_width;
-	y = fabs(_current_context.coordinate_system.GetTop() - _current_context.coordinate_system.GetBottom()) / _screen_height;
+	x = fabs(_current_context.coordinate_system.GetRight() - _current_context.coordinate_system.GetLeft()) / _render_width;
+	y = fabs(_current_context.coordinate_system.GetTop() - _current_context.coordinate_system.GetBottom()) / _render_height;
+}
+
+
+
+void VideoEngine::SetRenderScale(float scale) {
+	if (scale < VIDEO_MIN_RENDER_SCALE) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "render scale " << scale << " was below the minimum, using " << VIDEO_MIN_RENDER_SCALE << endl;
+		scale = VIDEO_MIN_RENDER_SCALE;
+	}
+	else if (scale > 1.0f) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "render scale " << scale << " was above 1.0, using 1.0 instead" << endl;
+		scale = 1.0f;
+	}
+
+	_temp_render_scale = scale;
+}
+
+
+
+void VideoEngine::ResolveScene() {
+	if (_native_gui == false || _scene_resolved == true)
+		return;
+
+	// There is nothing to gain when the scene was already drawn at the full resolution
+	if (_frame_target.IsValid() == false || (_render_width == _screen_width && _render_height == _screen_height))
+		return;
+
+	// A state popped after this call would restore a viewport sized for the frame target
+	if (_context_stack.empty() == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "can not resolve the scene while video states are saved on the stack" << endl;
+		return;
+	}
+
+	_FlushBatch();
+	_DrawFrameTarget();
+	_scene_resolved = true;
+	_SetRenderSurfaceSize(_screen_width, _screen_height);
 }
 
 
 
 bool VideoEngine::ApplySettings() {
+	_FlushBatch();
+
 	if (_target == VIDEO_TARGET_SDL_WINDOW) {
-		// Losing GL context, so unload images first
+		// Losing GL context, so destroy the render caches, timer queries, light buffer, frame target, and grayscale program
+		// and unload images first
+		_DestroyRenderCaches();
+		_frame_profiler.DestroyQueries();
+		_light_buffer.Destroy();
+		_frame_target.Destroy();
+		_grayscale_program.Destroy();
 		if (TextureManager && TextureManager->UnloadTextures() == false) {
 			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to delete OpenGL textures during a context change" << endl;
 		}
@@ -453,34 +598,44 @@ bool VideoEngine::ApplySettings() {
 				_temp_fullscreen = _fullscreen;
 				_temp_width = _screen_width;
 				_temp_height = _screen_height;
+				_temp_render_scale = _render_scale;
 
 				if (TextureManager && _screen_width > 0) { // Test to see if we already had a valid video mode
 					TextureManager->ReloadTextures();
+					_InitializeFrameTarget();
+					_InitializeGrayscaleProgram();
 				}
 				return false;
 			}
 		}
 
 		// Only now that SDL_SetVideoMode(...) has been called can we make OpenGL calls
-		glDisable(GL_BLEND);
-		glDisable(GL_TEXTURE_2D);
+		_ResetGLState();
+		FrameProfiler::InitializeExtension();
 		glDisable(GL_ALPHA_TEST);
 		glDisable(GL_STENCIL_TEST);
 		_current_context.scissoring_enabled = false;
 		glDisable(GL_SCISSOR_TEST);
-		glDisableClientState(GL_VERTEX_ARRAY);
-		glDisableClientState(GL_COLOR_ARRAY);
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 
 		// Turn off writing to the depth buffer
 		glDepthMask(GL_FALSE);
 
 		_screen_width = _temp_width;
 		_screen_height = _temp_height;
+		_render_scale = _temp_render_scale;
+		_render_width = _screen_width;
+		_render_height = _screen_height;
 		_fullscreen = _temp_fullscreen;
 
-		if (TextureManager)
+		// The frame pacer in the main loop needs to know whether the buffer swap already waits for the display
+		int swap_control = 0;
+		_vsync_active = (SDL_GL_GetAttribute(SDL_GL_SWAP_CONTROL, &swap_control) == 0 && swap_control > 0);
+
+		if (TextureManager) {
 			TextureManager->ReloadTextures();
+			_InitializeFrameTarget();
+			_InitializeGrayscaleProgram();
+		}
 
 		return true;
 	} // if (_target == VIDEO_TARGET_SDL_WINDOW)
@@ -489,11 +644,58 @@ bool VideoEngine::ApplySettings() {
 	else if (_target == VIDEO_TARGET_QT_WIDGET) {
 		_screen_width = _temp_width;
 		_screen_height = _temp_height;
+		_render_width = _temp_width;
+		_render_height = _temp_height;
 		_fullscreen = _temp_fullscreen;
+		_vsync_active = false;
 
 		return true;
 	}
 
+	// Used when no display is available. The context survives a change of resolution along with its textures, so only
+	// the frame target, which matches the size of the screen, needs to be created again.
+	else if (_target == VIDEO_TARGET_HEADLESS) {
+		bool first_context = (_headless_context.IsValid() == false);
+		_frame_target.Destroy();
+
+		if (_headless_context.Create(_temp_width, _temp_height) == false) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create a " << _temp_width << "x" << _temp_height << " headless context" << endl;
+
+			_temp_fullscreen = _fullscreen;
+			_temp_width = _screen_width;
+			_temp_height = _screen_height;
+			_temp_render_scale = _render_scale;
+
+			if (TextureManager && _screen_width > 0)
+				_InitializeFrameTarget();
+			return false;
+		}
+
+		if (first_context == true) {
+			_ResetGLState();
+			FrameProfiler::InitializeExtension();
+			glDisable(GL_ALPHA_TEST);
+			glDisable(GL_STENCIL_TEST);
+			glDepthMask(GL_FALSE);
+		}
+		_current_context.scissoring_enabled = false;
+		glDisable(GL_SCISSOR_TEST);
+
+		_screen_width = _temp_width;
+		_screen_height = _temp_height;
+		_render_scale = _temp_render_scale;
+		_render_width = _screen_width;
+		_render_height = _screen_height;
+		_fullscreen = false;
+		_temp_fullscreen = false;
+		_vsync_active = false;
+
+		if (TextureManager)
+			_InitializeFrameTarget();
+
+		return true;
+	} // else if (_target == VIDEO_TARGET_HEADLESS)
+
 	return false;
 } // bool VideoEngine::ApplySettings()
 
@@ -511,20 +713,21 @@ void VideoEngine::SetViewport(float left, float right, float bottom, float top)
 		return;
 	}
 
-	int32 l = static_cast<int32>(left * _screen_width * .01f);
-	int32 b = static_cast<int32>(bottom * _screen_height * .01f);
-	int32 r = static_cast<int32>(right * _screen_width * .01f);
-	int32 t = static_cast<int32>(top * _screen_height * .01f);
+	int32 l = static_cast<int32>(left * _render_width * .01f);
+	int32 b = static_cast<int32>(bottom * _render_height * .01f);
+	int32 r = static_cast<int32>(right * _render_width * .01f);
+	int32 t = static_cast<int32>(top * _render_height * .01f);
 
 	if (l < 0)
 		l = 0;
 	if (b < 0)
 		b = 0;
-	if (r > _screen_width)
-		r = _screen_width;
-	if (t > _screen_height)
-		t = _screen_height;
+	if (r > _render_width)
+		r = _render_width;
+	if (t > _render_height)
+		t = _render_height;
 
+	_FlushBatch();
 	_current_context.viewport = ScreenRect(l, b, r - l, t - b);
 	glViewport(l, b, r - l, t - b);
 }
@@ -532,6 +735,8 @@ void VideoEngine::SetViewport(float left, float right, float bottom, float top)
 
 
 void VideoEngine::SetCoordSys(const CoordSys& coordinate_system) {
+	// Batched quads are stored in modelview space, so they must be drawn before the projection changes
+	_FlushBatch();
 	_current_context.coordinate_system = coordinate_system;
 
 	glMatrixMode(GL_PROJECTION);
@@ -544,11 +749,14 @@ void VideoEngine::SetCoordSys(const CoordSys& coordinate_system) {
 	// This small translation is supposed to help with pixel-perfect 2D rendering in OpenGL.
 	// Reference: http://www.opengl.org/resources/faq/technical/transformations.htm#tran0030
 	glTranslatef(0.375, 0.375, 0);
+	_transform.LoadIdentity();
+	_transform.Translate(0.375f, 0.375f);
 }
 
 
 
 void VideoEngine::EnableScissoring() {
+	_FlushBatch();
 	_current_context.scissoring_enabled = true;
 	glEnable(GL_SCISSOR_TEST);
 }
@@ -556,6 +764,7 @@ void VideoEngine::EnableScissoring() {
 
 
 void VideoEngine::DisableScissoring() {
+	_FlushBatch();
 	_current_context.scissoring_enabled = false;
 	glDisable(GL_SCISSOR_TEST);
 }
@@ -563,6 +772,7 @@ void VideoEngine::DisableScissoring() {
 
 
 void VideoEngine::SetScissorRect(float left, float right, float bottom, float top) {
+	_FlushBatch();
 	_current_context.scissor_rectangle = CalculateScreenRect(left, right, bottom, top);
 
 	glScissor(static_cast<GLint>((_current_context.scissor_rectangle.left / static_cast<float>(VIDEO_STANDARD_RESOLUTION_WIDTH)) * _current_context.viewport.width),
@@ -575,6 +785,7 @@ void VideoEngine::SetScissorRect(float left, float right, float bottom, float to
 
 
 void VideoEngine::SetScissorRect(const ScreenRect& rect) {
+	_FlushBatch();
 	_current_context.scissor_rectangle = rect;
 
 	glScissor(static_cast<GLint>((_current_context.scissor_rectangle.left / static_cast<float>(VIDEO_STANDARD_RESOLUTION_WIDTH)) * _current_context.viewport.width),
@@ -622,6 +833,8 @@ ScreenRect VideoEngine::CalculateScreenRect(float left, float right, float botto
 void VideoEngine::Move(float x, float y) {
 	glLoadIdentity();
 	glTranslatef(x, y, 0);
+	_transform.LoadIdentity();
+	_transform.Translate(x, y);
 	_x_cursor = x;
 	_y_cursor = y;
 }
@@ -630,17 +843,32 @@ void VideoEngine::Move(float x, float y) {
 
 void VideoEngine::MoveRelative(float x, float y) {
 	glTranslatef(x, y, 0);
+	_transform.Translate(x, y);
 	_x_cursor += x;
 	_y_cursor += y;
 }
 
 
 
+void VideoEngine::PopMatrix() {
+	if (_transform_stack.empty()) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "no transformations were saved on the stack" << endl;
+		return;
+	}
+
+	glPopMatrix();
+	_transform = _transform_stack.top();
+	_transform_stack.pop();
+}
+
+
+
 
 void VideoEngine::PushState() {
 	// Push current modelview transformation
 	glMatrixMode(GL_MODELVIEW);
 	glPushMatrix();
+	_transform_stack.push(_transform);
 
 	_context_stack.push(_current_context);
 }
@@ -654,6 +882,8 @@ void VideoEngine::PopState() {
 		return;
 	}
 
+	// The restored context may use a different viewport or scissor rectangle than the batched quads
+	_FlushBatch();
 	_current_context = _context_stack.top();
 	_context_stack.pop();
     
@@ -666,6 +896,10 @@ void VideoEngine::PopState() {
 	// Restore the modelview transformation
 	glMatrixMode(GL_MODELVIEW);
 	glPopMatrix();
+	if (_transform_stack.empty() == false) {
+		_transform = _transform_stack.top();
+		_transform_stack.pop();
+	}
 	glViewport(_current_context.viewport.left, _current_context.viewport.top, _current_context.viewport.width, _current_context.viewport.height);
 
 	if (_current_context.scissoring_enabled) {
@@ -687,6 +921,7 @@ void VideoEngine::SetTransform(float matrix[16]) {
 	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
 	glLoadMatrixf(matrix);
+	_transform.LoadMatrix(matrix);
 }
 
 
@@ -848,6 +1083,7 @@ void VideoEngine::DrawLightning() {
 
 
 void VideoEngine::DrawOverlays() {
+	BeginRenderPass(VIDEO_RENDER_PASS_OVERLAYS);
 	PushState();
 	SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_BOTTOM, 0);
 
@@ -883,6 +1119,7 @@ void VideoEngine::DrawOverlays() {
 	}
 
 	PopState();
+	EndRenderPass();
 }
 
 
@@ -896,10 +1133,17 @@ StillImage VideoEngine::CaptureScreen() throw(Exception) {
 	// TEMP: temporary resolution until capture screen bug is fixed
 // 	return screen_image;
 
+	// Make sure that everything drawn so far is present in the frame buffer
+	_FlushBatch();
+
 	// Retrieve width/height of the viewport. viewport_dimensions[2] is the width, [3] is the height
 	GLint viewport_dimensions[4];
 	glGetIntegerv(GL_VIEWPORT, viewport_dimensions);
-	screen_image.SetDimensions((float)viewport_dimensions[2], (float)viewport_dimensions[3]);
+
+	// The capture is sized in screen pixels, so a frame drawn at a reduced render scale still covers the same area
+	float x_scale = static_cast<float>(_screen_width) / static_cast<float>(_render_width);
+	float y_scale = static_cast<float>(_screen_height) / static_cast<float>(_render_height);
+	screen_image.SetDimensions(viewport_dimensions[2] * x_scale, viewport_dimensions[3] * y_scale);
 
 	// Set up the screen rectangle to copy
 	ScreenRect screen_rect(0, viewport_dimensions[3], viewport_dimensions[2], viewport_dimensions[3]);
@@ -908,8 +1152,22 @@ StillImage VideoEngine::CaptureScreen() throw(Exception) {
 	ImageTexture* new_image = new ImageTexture("capture_screen" + NumberToString(capture_id), "<T>", viewport_dimensions[2], viewport_dimensions[3]);
 	new_image->AddReference();
 
-	// Create a texture sheet of an appropriate size that can retain the capture
-	TexSheet* temp_sheet = TextureManager->_CreateTexSheet(RoundUpPow2(viewport_dimensions[2]), RoundUpPow2(viewport_dimensions[3]), VIDEO_TEXSHEET_ANY, false);
+	// When frames are drawn offscreen, the texture holding the last frame drawn becomes the sheet for the capture and the
+	// frame target continues with a spare texture, so nothing needs to be allocated or copied. Otherwise create a texture
+	// sheet of an appropriate size that can retain the capture.
+	TexSheet* temp_sheet = NULL;
+	bool copy_screen = true;
+	if (_frame_target.IsValid() == true && _frame_target.GetWidth() >= viewport_dimensions[2] && _frame_target.GetHeight() >= viewport_dimensions[3]) {
+		GLuint frame_tex_id = _frame_target.TakeTexture();
+		if (frame_tex_id != INVALID_TEXTURE_ID) {
+			temp_sheet = TextureManager->_CreateTexSheetFromTexture(frame_tex_id, _frame_target.GetTextureWidth(), _frame_target.GetTextureHeight());
+			copy_screen = false;
+		}
+	}
+	if (temp_sheet == NULL) {
+		temp_sheet = TextureManager->_CreateTexSheet(RoundUpPow2(viewport_dimensions[2]), RoundUpPow2(viewport_dimensions[3]), VIDEO_TEXSHEET_ANY, false);
+		copy_screen = true;
+	}
 	VariableTexSheet* sheet = dynamic_cast<VariableTexSheet*>(temp_sheet);
 
 	// Ensure that texture sheet creation succeeded, insert the texture image into the sheet, and copy the screen into the sheet
@@ -926,7 +1184,7 @@ StillImage VideoEngine::CaptureScreen() throw(Exception) {
 		screen_image.Clear();
 		return screen_image;
 	}
-	if (sheet->CopyScreenRect(0, 0, screen_rect) == false) {
+	if (copy_screen == true && sheet->CopyScreenRect(0, 0, screen_rect) == false) {
 		TextureManager->_RemoveSheet(sheet);
 		delete new_image;
 		throw Exception("call to TexSheet::CopyScreenRect() failed", __FILE__, __LINE__, __FUNCTION__);
@@ -938,7 +1196,7 @@ StillImage VideoEngine::CaptureScreen() throw(Exception) {
 	screen_image._image_texture = new_image;
 	screen_image._texture = new_image;
 
-	// Vertically flip the texture image by swapping the v coordinates, since OpenGL returns the image upside down in the CopyScreenRect call
+	// Vertically flip the texture image by swapping the v coordinates, since OpenGL stores the rows of the screen bottom to top
 	float temp = new_image->v1;
 	new_image->v1 = new_image->v2;
 	new_image->v2 = temp;
@@ -953,6 +1211,18 @@ StillImage VideoEngine::CaptureScreen() throw(Exception) {
 
 
 
+bool VideoEngine::IsLoadingImages() const {
+	return TextureManager->_image_loader.IsLoading();
+}
+
+
+
+void VideoEngine::FinishLoadingImages() {
+	TextureManager->_image_loader.FinishAll();
+}
+
+
+
 void VideoEngine::SetGamma(float value) {
 	_gamma_value = value;
 
@@ -974,6 +1244,8 @@ void VideoEngine::SetGamma(float value) {
 void VideoEngine::MakeScreenshot(const std::string& filename) {
 	private_video::ImageMemory buffer;
 
+	_FlushBatch();
+
 	// Retrieve the width and height of the viewport.
 	GLint viewport_dimensions[4]; // viewport_dimensions[2] is the width, [3] is the height
 	glGetIntegerv(GL_VIEWPORT, viewport_dimensions);
@@ -1011,6 +1283,364 @@ void VideoEngine::MakeScreenshot(const std::string& filename) {
 	buffer.pixels = NULL;
 }
 
+//-----------------------------------------------------------------------------
+// VideoEngine class - Quad batching methods
+//-----------------------------------------------------------------------------
+
+void VideoEngine::_BatchQuad(TexSheet* sheet, bool smooth, uint8 blend, bool grayscale, const GLfloat* vertices,
+	const GLfloat* tex_coords, const Color* colors, bool unichrome)
+{
+	// Grayscale only affects the texture color, so it is ignored for untextured quads or when it can not be drawn
+	if (sheet == NULL || _grayscale_program.IsValid() == false)
+		grayscale = false;
+
+	// Any difference in the state that the quad requires means that the pending quads must be drawn first
+	if (_batch_vertices.empty() == false && (sheet != _batch_sheet || smooth != _batch_smooth || blend != _batch_blend
+		|| grayscale != _batch_grayscale))
+	{
+		_FlushBatch();
+	}
+
+	// An evicted texture sheet is reloaded here rather than when the batch is drawn, since reloading draws to the sheet
+	if (sheet != NULL)
+		TextureManager->_UseTexSheet(sheet);
+
+	_batch_sheet = sheet;
+	_batch_smooth = smooth;
+	_batch_blend = blend;
+	_batch_grayscale = grayscale;
+
+	// Transform the vertices on the CPU so that the quad no longer depends on the current modelview matrix.
+	// This preserves the semantics of Move(), MoveRelative(), and all other matrix operations. The copy of the
+	// matrix kept by those operations is used, since reading the matrix back from OpenGL would stall the pipeline.
+	const float* matrix = _transform.m;
+
+	for (uint32 i = 0; i < 4; i++) {
+		GLfloat x = vertices[i * 2];
+		GLfloat y = vertices[i * 2 + 1];
+		_batch_vertices.push_back(matrix[0] * x + matrix[2] * y + matrix[4]);
+		_batch_vertices.push_back(matrix[1] * x + matrix[3] * y + matrix[5]);
+
+		if (sheet != NULL) {
+			_batch_tex_coords.push_back(tex_coords[i * 2]);
+			_batch_tex_coords.push_back(tex_coords[i * 2 + 1]);
+		}
+		else {
+			_batch_tex_coords.push_back(0.0f);
+			_batch_tex_coords.push_back(0.0f);
+		}
+
+		const Color& color = (unichrome == true) ? colors[0] : colors[i];
+		_batch_colors.push_back(color[0]);
+		_batch_colors.push_back(color[1]);
+		_batch_colors.push_back(color[2]);
+		_batch_colors.push_back(color[3]);
+	}
+
+	if (_batch_vertices.size() >= MAX_BATCH_QUADS * 8) {
+		_FlushBatch();
+	}
+} // void VideoEngine::_BatchQuad(...)
+
+
+
+void VideoEngine::_FlushBatch() {
+	if (_batch_vertices.empty() == true)
+		return;
+
+	_SetGLBlendMode(_batch_blend);
+	_SetGLTexturing(_batch_sheet != NULL);
+	_SetGLClientStates(true, _batch_sheet != NULL, true);
+
+	if (_batch_sheet != NULL) {
+		TextureManager->_BindTexture(_batch_sheet->tex_id);
+		_batch_sheet->Smooth(_batch_smooth);
+		glTexCoordPointer(2, GL_FLOAT, 0, &_batch_tex_coords[0]);
+	}
+
+	glVertexPointer(2, GL_FLOAT, 0, &_batch_vertices[0]);
+	glColorPointer(4, GL_FLOAT, 0, &_batch_colors[0]);
+
+	// The batched vertices have already been transformed by the modelview matrix
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+	// The grayscale program is only enabled for the duration of the draw call, so no other drawing code needs to know about it
+	if (_batch_grayscale == true) {
+		_grayscale_program.Enable();
+		_draw_recorder.RecordStateChange();
+	}
+	glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(_batch_vertices.size() / 2));
+	_RecordDraw(GL_QUADS, &_batch_vertices[0], GL_FLOAT, static_cast<uint32>(_batch_vertices.size() / 2));
+	if (_batch_grayscale == true) {
+		FragmentProgram::Disable();
+		_draw_recorder.RecordStateChange();
+	}
+	glPopMatrix();
+
+	_batch_vertices.clear();
+	_batch_tex_coords.clear();
+	_batch_colors.clear();
+
+	if (CheckGLError() == true) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "an OpenGL error occurred: " << CreateGLErrorString() << endl;
+	}
+} // void VideoEngine::_FlushBatch()
+
+
+
+void VideoEngine::_SetGLBlendMode(uint8 blend_mode) {
+	if (blend_mode == _gl_blend_mode)
+		return;
+
+	if (blend_mode == 0) {
+		glDisable(GL_BLEND);
+	}
+	else {
+		if (_gl_blend_mode == 0)
+			glEnable(GL_BLEND);
+
+		// Render caches hold premultiplied colors, so the alpha channel is blended differently while one is recorded
+		if (_recording_cache != NULL && (blend_mode == 1 || blend_mode == 2))
+			RenderCache::_SetRecordingBlendFunction(blend_mode);
+		else if (blend_mode == 1)
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
+		else if (blend_mode == 2)
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending
+		else if (blend_mode == 3)
+			glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); // Premultiplied alpha blending
+		else
+			glBlendFunc(GL_DST_COLOR, GL_ZERO); // Multiplicative blending
+	}
+
+	_gl_blend_mode = blend_mode;
+	_draw_recorder.RecordStateChange();
+}
+
+
+
+void VideoEngine::_SetGLTexturing(bool enable) {
+	if (enable == _gl_texture_2d_enabled)
+		return;
+
+	if (enable)
+		glEnable(GL_TEXTURE_2D);
+	else
+		glDisable(GL_TEXTURE_2D);
+	_gl_texture_2d_enabled = enable;
+	_draw_recorder.RecordStateChange();
+}
+
+
+
+void VideoEngine::_SetGLClientStates(bool vertex_array, bool texture_coord_array, bool color_array) {
+	if (vertex_array != _gl_vertex_array_enabled) {
+		if (vertex_array)
+			glEnableClientState(GL_VERTEX_ARRAY);
+		else
+			glDisableClientState(GL_VERTEX_ARRAY);
+		_gl_vertex_array_enabled = vertex_array;
+		_draw_recorder.RecordStateChange();
+	}
+
+	if (texture_coord_array != _gl_texture_coord_array_enabled) {
+		if (texture_coord_array)
+			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		else
+			glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		_gl_texture_coord_array_enabled = texture_coord_array;
+		_draw_recorder.RecordStateChange();
+	}
+
+	if (color_array != _gl_color_array_enabled) {
+		if (color_array)
+			glEnableClientState(GL_COLOR_ARRAY);
+		else
+			glDisableClientState(GL_COLOR_ARRAY);
+		_gl_color_array_enabled = color_array;
+		_draw_recorder.RecordStateChange();
+	}
+}
+
+
+
+void VideoEngine::_ResetGLState() {
+	glDisable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glDisable(GL_TEXTURE_2D);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+
+	_gl_blend_mode = 0;
+	_gl_texture_2d_enabled = false;
+	_gl_vertex_array_enabled = false;
+	_gl_texture_coord_array_enabled = false;
+	_gl_color_array_enabled = false;
+}
+
+void VideoEngine::_InitializeFrameTarget() {
+	_frame_target.Destroy();
+	_scene_resolved = false;
+	_render_width = _screen_width;
+	_render_height = _screen_height;
+
+	if (_target == VIDEO_TARGET_QT_WIDGET)
+		return;
+
+	if (RenderTarget::InitializeExtension() == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "framebuffer objects are not supported, frames will be drawn directly to the window" << endl;
+		if (_render_scale < 1.0f) {
+			IF_PRINT_WARNING(VIDEO_DEBUG) << "the render scale can not be applied without framebuffer objects" << endl;
+		}
+		return;
+	}
+	RenderCache::InitializeExtension();
+
+	// The scene is drawn at the render scale, and stretched to the full size of the window in _DrawFrameTarget()
+	int32 target_width = max(1, static_cast<int32>(_screen_width * _render_scale + 0.5f));
+	int32 target_height = max(1, static_cast<int32>(_screen_height * _render_scale + 0.5f));
+
+	if (_frame_target.Create(target_width, target_height) == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create the frame target, frames will be drawn directly to the window" << endl;
+		return;
+	}
+	_render_width = target_width;
+	_render_height = target_height;
+
+	// Create() leaves the new target bound, so the next frame is drawn into it
+	glViewport(0, 0, _render_width, _render_height);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+}
+
+
+
+void VideoEngine::_DrawFrameTarget() {
+	RenderTarget::BindDefault();
+
+	// The target covers the entire window, regardless of the viewport and scissor rectangle used by the game
+	glPushAttrib(GL_VIEWPORT_BIT | GL_SCISSOR_BIT);
+	glViewport(0, 0, _screen_width, _screen_height);
+	glDisable(GL_SCISSOR_TEST);
+
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	glOrtho(0.0, 1.0, 0.0, 1.0, -1.0, 1.0);
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	// Only the lower left portion of the target's power-of-two texture holds the frame
+	GLfloat texture_width = static_cast<GLfloat>(_frame_target.GetTextureWidth());
+	GLfloat texture_height = static_cast<GLfloat>(_frame_target.GetTextureHeight());
+	GLfloat u1 = 0.0f;
+	GLfloat v1 = 0.0f;
+	GLfloat u2 = static_cast<GLfloat>(_frame_target.GetWidth()) / texture_width;
+	GLfloat v2 = static_cast<GLfloat>(_frame_target.GetHeight()) / texture_height;
+
+	// A target smaller than the window is magnified with the filter chosen for the render scale. Interpolated samples are
+	// kept half a texel inside the frame, so that the unused portion of the texture does not bleed into its edges.
+	bool interpolate = (_render_scale_smooth == true &&
+		(_frame_target.GetWidth() != _screen_width || _frame_target.GetHeight() != _screen_height));
+	if (interpolate == true) {
+		u1 += 0.5f / texture_width;
+		v1 += 0.5f / texture_height;
+		u2 -= 0.5f / texture_width;
+		v2 -= 0.5f / texture_height;
+	}
+
+	const GLfloat vertices[] = {
+		0.0f, 0.0f,
+		1.0f, 0.0f,
+		1.0f, 1.0f,
+		0.0f, 1.0f
+	};
+	const GLfloat tex_coords[] = {
+		u1, v1,
+		u2, v1,
+		u2, v2,
+		u1, v2
+	};
+
+	_SetGLBlendMode(0);
+	_SetGLTexturing(true);
+	_SetGLClientStates(true, true, false);
+	TextureManager->_BindTexture(_frame_target.GetTexture());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (interpolate == true) ? GL_LINEAR : GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (interpolate == true) ? GL_LINEAR : GL_NEAREST);
+	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+	glVertexPointer(2, GL_FLOAT, 0, vertices);
+	glTexCoordPointer(2, GL_FLOAT, 0, tex_coords);
+	glDrawArrays(GL_QUADS, 0, 4);
+
+	glPopMatrix();
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopAttrib();
+} // void VideoEngine::_DrawFrameTarget()
+
+
+
+void VideoEngine::_BindScreenTarget() {
+	if (_frame_target.IsValid() == true && _scene_resolved == false)
+		_frame_target.Bind();
+	else
+		RenderTarget::BindDefault();
+}
+
+
+
+void VideoEngine::_SetRenderSurfaceSize(int32 width, int32 height) {
+	if (width == _render_width && height == _render_height)
+		return;
+
+	// The viewport is a percentage of the surface (see SetViewport()), so it covers the same portion of the new surface
+	ScreenRect& viewport = _current_context.viewport;
+	viewport = ScreenRect(viewport.left * width / _render_width, viewport.top * height / _render_height,
+		viewport.width * width / _render_width, viewport.height * height / _render_height);
+	_render_width = width;
+	_render_height = height;
+	glViewport(viewport.left, viewport.top, viewport.width, viewport.height);
+
+	// The scissor rectangle is relative to the viewport, so it must be applied again for the new viewport
+	if (_current_context.scissoring_enabled == true)
+		SetScissorRect(_current_context.scissor_rectangle);
+}
+
+
+
+void VideoEngine::_DestroyRenderCaches() {
+	// Each cache removes itself from the set as it is destroyed
+	while (_render_caches.empty() == false) {
+		(*_render_caches.begin())->Destroy();
+	}
+	_render_cache_memory = 0;
+}
+
+
+
+void VideoEngine::_InitializeGrayscaleProgram() {
+	_grayscale_program.Destroy();
+
+	if (_target == VIDEO_TARGET_QT_WIDGET)
+		return;
+
+	if (FragmentProgram::InitializeExtension() == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "fragment programs are not supported, grayscale images will be drawn in color" << endl;
+		return;
+	}
+
+	if (_grayscale_program.Create(GRAYSCALE_FRAGMENT_PROGRAM) == false) {
+		IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create the grayscale fragment program, grayscale images will be drawn in color" << endl;
+		return;
+	}
+
+	FragmentProgram::Disable();
+}
+
 //-----------------------------------------------------------------------------
 // _CreateTempFilename
 //-----------------------------------------------------------------------------
@@ -1203,36 +1833,109 @@ void VideoEngine::_UpdateLightning(uint32 frame_time) {
 
 
 void VideoEngine::_DEBUG_ShowAdvancedStats() {
-	char text[50];
-	sprintf(text, "Switches: %d\nParticles: %d", TextureManager->_debug_num_tex_switches, _particle_manager.GetNumParticles());
-
-	Move(896.0f, 690.0f);
+	const FramePacer& pacer = SystemManager->GetFramePacer();
+	const FrameStatistics& frame = _draw_recorder.GetLastFrame();
+
+	char text[400];
+	sprintf(text, "Switches: %d\nDraw calls: %d\nState changes: %d\nVertices: %d\nOverdraw: %.2f\nParticles: %d\n"
+		"Tex memory: %.1f MB\nTex peak: %.1f MB\nTex shared: %.1f MB\nGUI cache: %.1f MB\nFrame: %.2f ms +/- %.2f\nFrame max: %.2f ms",
+		frame.texture_binds, frame.draw_calls, frame.state_changes, frame.vertices, frame.GetOverdraw(), _particle_manager.GetNumParticles(),
+		TextureManager->GetMemoryUsage() / 1048576.0f, TextureManager->GetPeakMemoryUsage() / 1048576.0f,
+		TextureManager->GetSharedImageMemory() / 1048576.0f, _render_cache_memory / 1048576.0f,
+		pacer.GetFrameTimeAverage(), pacer.GetFrameTimeDeviation(), pacer.GetFrameTimeMaximum());
+
+	Move(896.0f, 670.0f);
 	TextManager->Draw(text);
 }
 
 
 
+void VideoEngine::_DEBUG_ShowFrameProfile() {
+	// Each millisecond is drawn as this many pixels of the standard coordinate system, up to the maximum bar length
+	const float pixels_per_ms = 20.0f;
+	const float max_bar_length = 300.0f;
+	const Color cpu_color(1.0f, 0.8f, 0.2f, 0.8f);
+	const Color gpu_color(0.3f, 0.6f, 1.0f, 0.8f);
+	const bool gpu_supported = FrameProfiler::IsGPUTimingSupported();
+
+	char text[100];
+	SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_BOTTOM, VIDEO_BLEND, 0);
+	Move(20.0f, 740.0f);
+	TextManager->Draw(gpu_supported ? "Frame profile (ms): CPU / GPU" : "Frame profile (ms): CPU, GPU timing not supported",
+		TextStyle("text18", Color::white));
+
+	float y = 715.0f;
+	for (int32 i = 0; i < VIDEO_RENDER_PASS_TOTAL; i++) {
+		VIDEO_RENDER_PASS pass = static_cast<VIDEO_RENDER_PASS>(i);
+		float cpu_time = _frame_profiler.GetCPUTime(pass);
+		float gpu_time = _frame_profiler.GetGPUTime(pass);
+
+		if (gpu_supported == true)
+			sprintf(text, "%s: %.2f / %.2f", FrameProfiler::GetPassName(pass), cpu_time, gpu_time);
+		else
+			sprintf(text, "%s: %.2f", FrameProfiler::GetPassName(pass), cpu_time);
+		Move(20.0f, y);
+		TextManager->Draw(text, TextStyle("text18", Color::white));
+
+		Move(200.0f, y + 8.0f);
+		DrawRectangle(min(cpu_time * pixels_per_ms, max_bar_length) + 1.0f, 6.0f, cpu_color);
+		if (gpu_supported == true) {
+			Move(200.0f, y + 1.0f);
+			DrawRectangle(min(gpu_time * pixels_per_ms, max_bar_length) + 1.0f, 6.0f, gpu_color);
+		}
+
+		y -= 22.0f;
+	}
+
+	if (_frame_profiler.IsLogging() == true) {
+		Move(20.0f, y);
+		TextManager->Draw("Logging to file", TextStyle("text18", Color::white));
+	}
+} // void VideoEngine::_DEBUG_ShowFrameProfile()
+
+
+
+void VideoEngine::BeginRenderPass(VIDEO_RENDER_PASS pass) {
+	if (_frame_profiler.IsProfiling() == false)
+		return;
+
+	// Quads still waiting in the batch belong to the pass before this one
+	_FlushBatch();
+	_frame_profiler.BeginPass(pass);
+}
+
+
+
+void VideoEngine::EndRenderPass() {
+	if (_frame_profiler.IsProfiling() == false)
+		return;
+
+	_FlushBatch();
+	_frame_profiler.EndPass();
+}
+
+
+
 void VideoEngine::DrawLine(float x1, float y1, float x2, float y2, float width, const Color& color) {
 	GLfloat vert_coords[] =
 	{
 		x1, y1,
 		x2, y2
 	};
-	glEnable(GL_BLEND);
-	glDisable(GL_TEXTURE_2D);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
+
+	_FlushBatch();
+	_SetGLBlendMode(1);
+	_SetGLTexturing(false);
 	glPushAttrib(GL_LINE_WIDTH);
 
 	float pixel_width, pixel_height;
 	GetPixelSize(pixel_width, pixel_height);
 	glLineWidth(width * pixel_height);
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_COLOR_ARRAY);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	_SetGLClientStates(true, false, false);
 	glColor4fv((GLfloat*)color.GetColors());
 	glVertexPointer(2, GL_FLOAT, 0, vert_coords);
 	glDrawArrays(GL_LINES, 0, 2);
-	glDisableClientState(GL_VERTEX_ARRAY);
+	_RecordDraw(GL_LINES, vert_coords, GL_FLOAT, 2);
 	glPopAttrib();
 }
 
@@ -1262,12 +1965,13 @@ void VideoEngine::DrawGrid(float x, float y, float x_step, float y_step, const C
 		vertices.push_back(y);
 		num_vertices += 2;
 	}
+	_FlushBatch();
 	glColor4fv(&c[0]);
-	glDisable(GL_TEXTURE_2D);
-	glEnableClientState(GL_VERTEX_ARRAY);
+	_SetGLTexturing(false);
+	_SetGLClientStates(true, false, false);
 	glVertexPointer(2, GL_FLOAT, 0, &(vertices[0]));
 	glDrawArrays(GL_LINES, 0, num_vertices);
-	glDisableClientState(GL_VERTEX_ARRAY);
+	_RecordDraw(GL_LINES, &vertices[0], GL_FLOAT, static_cast<uint32>(num_vertices));
 
 	PopState();
 }
@@ -1294,22 +1998,25 @@ void VideoEngine::DrawRectangleOutline(float left, float right, float bottom, fl
 
 
 void VideoEngine::DrawHalo(const ImageDescriptor& image, float x, float y, const Color &color) {
-	PushMatrix();
-	Move(x, y);
-	int8 old_blend_mode = _current_context.blend;
-	_current_context.blend = VIDEO_BLEND_ADD;
-	image.Draw(color);
-	_current_context.blend = old_blend_mode;
-	PopMatrix();
+	// Outside of a lighting overlay, the halo is applied on its own while the image is known to be valid
+	if (_light_buffer.AddHalo(image, x, y, color) == true && _lighting_overlay_active == false)
+		_light_buffer.Apply(Color::white);
 }
 
 
 
-
 void VideoEngine::DrawLight(float radius, float x, float y, const Color &color) {
-	// This function has been left unimplemented as the old implementation was broken
-	// FBOs have been removed and the old implementation was no longer valid
-	// TODO: Re-implement this method
+	if (_light_buffer.AddLight(radius, x, y, color) == true && _lighting_overlay_active == false)
+		_light_buffer.Apply(Color::white);
+}
+
+
+
+void VideoEngine::ApplyLightingOverlay() {
+	BeginRenderPass(VIDEO_RENDER_PASS_OVERLAYS);
+	_light_buffer.Apply(_light_color);
+	EndRenderPass();
+	_lighting_overlay_active = false;
 }
 
 }  // namespace hoa_video
@@ -73,6 +73,14 @@ extern "C" {
 #include "text.h"
 #include "particle_manager.h"
 #include "particle_effect.h"
+#include "quad_buffer.h"
+#include "render_target.h"
+#include "render_cache.h"
+#include "fragment_program.h"
+#include "headless_context.h"
+#include "draw_recorder.h"
+#include "frame_profiler.h"
+#include "light_buffer.h"
 
 //! \brief All calls to the video engine are wrapped in this namespace.
 namespace hoa_video {
@@ -94,6 +102,12 @@ const uint32 MAX_FTIME_DIFF = 5;
 //! \brief The number of samples to take if we need to play catchup with the current FPS
 const uint32 FPS_CATCHUP = 20;
 
+//! \brief The maximum number of quads that may be held in the quad batch before it is forcibly flushed
+const uint32 MAX_BATCH_QUADS = 2048;
+
+//! \brief The default number of milliseconds spent each frame copying asynchronously loaded images into texture memory
+const uint32 DEFAULT_IMAGE_UPLOAD_BUDGET = 4;
+
 }
 
 //! \brief Draw flags to control x and y alignment, flipping, and texture blending.
@@ -147,7 +161,10 @@ enum VIDEO_TARGET {
 	//! Represents a QT widget
 	VIDEO_TARGET_QT_WIDGET  = 1,
 
-	VIDEO_TARGET_TOTAL = 2
+	//! Represents an offscreen buffer in main memory, used when no display is available
+	VIDEO_TARGET_HEADLESS = 2,
+
+	VIDEO_TARGET_TOTAL = 3
 };
 
 
@@ -177,6 +194,9 @@ const float VIDEO_STANDARD_RESOLUTION_WIDTH  = 1024.0f;
 const float VIDEO_STANDARD_RESOLUTION_HEIGHT = 768.0f;
 //@}
 
+//! \brief The smallest fraction of the screen resolution that the scene may be drawn at
+const float VIDEO_MIN_RENDER_SCALE = 0.25f;
+
 
 /** \brief Linearly interpolates a value which is (alpha * 100) percent between initial and final
 *** \param alpha Determines where inbetween initial (0.0f) and final (1.0f) the interpolation should be
@@ -224,6 +244,9 @@ class VideoEngine : public hoa_utils::Singleton<VideoEngine> {
 	friend class CompositeImage;
 	friend class private_video::TextElement;
 	friend class TextImage;
+	friend class QuadBuffer;
+	friend class RenderCache;
+	friend class private_video::LightBuffer;
 
 public:
 	~VideoEngine();
@@ -242,9 +265,11 @@ public:
 	// ---------- General methods
 
 	/** \brief Sets the target window environment where the video engine will be used
-	*** \param target The window target, which can be VIDEO_TARGET_SDL_WINDOW or VIDEO_TARGET_QT_WIDGET
+	*** \param target The window target, which can be VIDEO_TARGET_SDL_WINDOW, VIDEO_TARGET_QT_WIDGET, or VIDEO_TARGET_HEADLESS
 	*** \note The video engien's default target is a SDL window, so if that's what you desire then this
 	*** function does not need to be called.
+	*** \note The headless target renders without a window or display, and is only available when the game is built
+	*** with OSMesa. Everything else in the engine, including screen captures, works the same as with a window.
 	*** \note You must set the target before calling the SingletonInitialize() function. Any invocations
 	*** of the SetTarget function after SingletonInitialize has been called will result in no effect.
 	**/
@@ -306,6 +331,16 @@ public:
 	bool IsFullscreen() const
 		{ return _fullscreen; }
 
+	/** \brief Returns true if the buffer swap in Display() waits for the display to refresh
+	*** This is requested for every video mode, but drivers are free to ignore the request.
+	**/
+	bool IsVSyncActive() const
+		{ return _vsync_active; }
+
+	//! \brief Returns true if frames are drawn into main memory rather than to a window
+	bool IsHeadless() const
+		{ return _target == VIDEO_TARGET_HEADLESS; }
+
 	/** \brief sets the current resolution to the given width and height
 	*** \param width new screen width
 	*** \param height new screen height
@@ -335,6 +370,48 @@ public:
 	void SetSmoothTextures(bool smooth)
 		{ _smooth_textures = smooth; }
 
+	//! \brief Returns the fraction of the screen resolution that frames are drawn at (1.0f is the full resolution)
+	float GetRenderScale() const
+		{ return _render_scale; }
+
+	/** \brief Sets the fraction of the screen resolution that the scene is drawn at
+	*** \param scale The render scale, clamped to the range [VIDEO_MIN_RENDER_SCALE, 1.0f]
+	***
+	*** A scale below 1.0f draws each frame into a smaller offscreen target which is stretched over the window when the
+	*** frame is displayed, reducing the number of pixels that must be filled. This has no effect when framebuffer
+	*** objects are not supported.
+	***
+	*** \note  you must call ApplySettings() to actually apply the change
+	**/
+	void SetRenderScale(float scale);
+
+	//! \brief Returns true if a scaled frame is interpolated when it is stretched over the window
+	bool IsRenderScaleSmooth() const
+		{ return _render_scale_smooth; }
+
+	//! \brief Sets whether a scaled frame is stretched with bilinear (true) or nearest neighbor (false) filtering
+	void SetRenderScaleSmooth(bool smooth)
+		{ _render_scale_smooth = smooth; }
+
+	//! \brief Returns true if game modes may draw their GUI at the full screen resolution over a scaled scene
+	bool IsNativeGUI() const
+		{ return _native_gui; }
+
+	//! \brief Sets whether calls to ResolveScene() draw the remainder of the frame at the full screen resolution
+	void SetNativeGUI(bool native)
+		{ _native_gui = native; }
+
+	/** \brief Stretches the scene drawn so far over the window so that the rest of the frame is drawn at the full resolution
+	***
+	*** Game modes call this between drawing their scene and their GUI, so that text and menus remain sharp when the
+	*** scene is drawn at a reduced render scale. It does nothing unless the native GUI option is enabled and the frame
+	*** is currently drawn at a reduced scale. It must not be called while any state is pushed on the context stack.
+	***
+	*** \note Once the scene is resolved, screen captures and render caches taken during the rest of the frame are drawn
+	*** at the full resolution and no longer contain the scene.
+	**/
+	void ResolveScene();
+
 	//! \brief Returns a reference to the current coordinate system
 	const CoordSys& GetCoordSys() const
 		{ return _current_context.coordinate_system; }
@@ -458,11 +535,10 @@ public:
 	*** calls (Move/MoveRelative/Scale/Rotate)
 	**/
 	void PushMatrix()
-		{ glPushMatrix(); }
+		{ glPushMatrix(); _transform_stack.push(_transform); }
 
 	//! \brief Pops the modelview transformation from the stack
-	void PopMatrix()
-		{ glPopMatrix(); }
+	void PopMatrix();
 
 	/** \brief Saves relevant state of the video engine on to an internal stack
 	*** The contents saved include the modelview transformation and the current
@@ -486,7 +562,7 @@ public:
 	*** prior to using this function.
 	**/
 	void Rotate(float angle)
-		{ glRotatef(angle, 0, 0, 1); }
+		{ glRotatef(angle, 0, 0, 1); _transform.Rotate(angle); }
 
 	/** \brief Scales all subsequent image drawing calls in the horizontal and vertical direction
 	*** \param x The amount of horizontal scaling to perform (0.5 for half, 1.0 for normal, 2.0 for double, etc)
@@ -495,7 +571,7 @@ public:
 	*** prior to using this function.
 	**/
 	void Scale(float x, float y)
-		{ glScalef(x, y, 1.0f); }
+		{ glScalef(x, y, 1.0f); _transform.Scale(x, y); }
 
 	/** \brief Sets the OpenGL transform to the contents of 4x4 matrix
 	*** \param matrix A pointer to an array of 16 float values that form a 4x4 transformation matrix
@@ -513,9 +589,44 @@ public:
 	*** captures in memory at the same time. You should be careful not to have too many
 	*** screen captures existing at one time, because each image capture requires a relatively
 	*** large amount of texutre memory (roughly 3GB for a 1024x768 screen).
+	***
+	*** \note When framebuffer objects are supported, frames are drawn into an offscreen target and
+	*** the capture simply takes over the texture holding the last frame drawn. Otherwise the screen
+	*** is copied into a newly created texture sheet.
 	**/
 	StillImage CaptureScreen() throw(hoa_utils::Exception);
 
+	/** \brief Sets how long the video engine may spend each frame placing asynchronously loaded images into texture memory
+	*** \param milliseconds The time limit, which is checked after each image so it may be exceeded by the time needed for one image
+	***
+	*** Images loaded through StillImage::LoadAsync() and similar calls are decoded on worker threads. Their image data
+	*** is copied into texture memory at the end of each call to Display() until this time limit is reached.
+	**/
+	void SetImageUploadBudget(uint32 milliseconds)
+		{ _image_upload_budget = milliseconds; }
+
+	/** \brief Sets the amount of texture memory that the game's texture sheets should be kept within
+	*** \param megabytes The size of the budget in megabytes, or zero for no limit (the default)
+	***
+	*** When the budget is exceeded, the texture sheets that have gone the longest without being drawn are evicted
+	*** from texture memory. An evicted sheet is reloaded from the image files of its images the next time that it
+	*** is drawn. Static texture sheets are never evicted, so the budget may still be exceeded.
+	**/
+	void SetTextureMemoryBudget(uint32 megabytes)
+		{ _texture_memory_budget = megabytes; }
+
+	//! \brief Returns the texture memory budget in megabytes, or zero if there is no limit
+	uint32 GetTextureMemoryBudget() const
+		{ return _texture_memory_budget; }
+
+	//! \brief Returns true if any asynchronously loaded image is not yet ready to be drawn
+	bool IsLoadingImages() const;
+
+	/** \brief Blocks until every asynchronously loaded image is ready to be drawn
+	*** This is useful when a game mode has finished loading and wishes to be drawn in its entirety on its first frame.
+	**/
+	void FinishLoadingImages();
+
 	/** \brief Returns a pointer to the GUIManager singleton object
 	*** This method allows the user to perform text operations. For example, to load a
 	*** font, the user may utilize this method like so:
@@ -552,6 +663,16 @@ public:
 	void DisableLightOverlay()
 		{ _light_overlay_enabled = false; }
 
+	/** \brief Sets the color of the scene where no light falls on it
+	*** \param color The ambient light color, which the scene is multiplied by when ApplyLightingOverlay() is called
+	**/
+	void EnableSceneLighting(const Color& color)
+		{ _light_color = color; }
+
+	//! \brief Returns the ambient light color to white, so that only lights that are drawn change the scene
+	void DisableSceneLighting()
+		{ _light_color = Color::white; }
+
 	/** \brief returns the scene lighting color
 	 * \return the light color used in the scene
 	 */
@@ -581,11 +702,13 @@ public:
 	**/
 	void DisableOverlays();
 
-	/** \brief Draws a halo at a specified location
+	/** \brief Draws a halo additively at a specified location
 	*** \param image The halo image to draw
 	*** \param x The x coordinate of the halo on the screen
 	*** \param y The y coordinate of the halo on the screen
 	*** \param color The color to draw the halo (default: white)
+	*** While a lighting overlay has been begun, the halo is not drawn until ApplyLightingOverlay() is called, so the
+	*** image must remain valid until then. Otherwise it is drawn immediately.
 	***/
 	void DrawHalo(const ImageDescriptor &id, float x, float y, const Color &color = Color::white);
 
@@ -594,10 +717,23 @@ public:
 	*** \param x The x coordinate of light
 	*** \param y The y coordinate of light
 	*** \param color The color of the light to draw (default: white)
+	*** While a lighting overlay has been begun, the light is not drawn until ApplyLightingOverlay() is called.
+	*** Otherwise it is added onto the screen immediately. Lights outside of the screen are ignored.
 	**/
 	void DrawLight(float radius, float x, float y, const Color &color = Color::white);
 
-	/** \brief Applies lighting after all images have been drawn.
+	/** \brief Starts collecting the lights and halos that are drawn, so that ApplyLightingOverlay() applies them together
+	*** Call this before the scene is drawn. Lights and halos that are drawn without a lighting overlay are drawn immediately.
+	**/
+	void BeginLightingOverlay()
+		{ _light_buffer.Clear(); _lighting_overlay_active = true; }
+
+	/** \brief Applies lighting after all images have been drawn, and ends the lighting overlay
+	*** The scene is multiplied by the scene lighting color, brightened by every light drawn since the last call,
+	*** and then every halo is added on top of it. While the scene lighting color is not white, the lights are
+	*** accumulated in a buffer of reduced resolution and applied with a single quad. The scene lighting color is applied
+	*** even if BeginLightingOverlay() was not called.
+	***
 	*** \note All GUI and text rendering should be done AFTER this call is made, so that they are not affected by
 	*** the lighting.
 	**/
@@ -681,6 +817,24 @@ public:
 	**/
 	ParticleEffectID AddParticleEffect(const std::string &filename, float x, float y, bool reload = false);
 
+	/** \brief Loads the definitions of every particle effect file in a directory
+	*** \param directory The directory containing the effect files, such as "lua/graphics/particles"
+	*** \return The number of effect definitions that were loaded
+	***
+	*** Definitions are cached by filename, so adding one of these effects afterwards does not read any files.
+	**/
+	uint32 PreloadParticleEffects(const std::string &directory);
+
+	/** \brief Sets whether the particle effects in lua/graphics/particles are preloaded when the engine starts
+	*** \param preload True to preload the effects, which is the default
+	**/
+	void SetParticleEffectPreloading(bool preload)
+		{ _preload_particle_effects = preload; }
+
+	//! \brief Returns true if the particle effects should be preloaded when the engine starts
+	bool IsParticleEffectPreloading() const
+		{ return _preload_particle_effects; }
+
 	/** \brief draws all active particle effects
 	 * \return success/failure
 	 */
@@ -776,6 +930,59 @@ public:
 	void ToggleAdvancedDisplay()
 		{ _advanced_display = !_advanced_display; }
 
+	//! \brief Returns the number of OpenGL draw calls that were submitted during the last frame
+	int32 GetNumDrawCalls() const
+		{ return static_cast<int32>(_draw_recorder.GetLastFrame().draw_calls); }
+
+	/** \brief Returns the draw calls, texture binds, state changes, and overdraw of the last frame
+	*** The debugging overlays drawn over the frame are not included. Overdraw is only estimated while the advanced
+	*** display is shown or draw calls are being captured.
+	**/
+	const private_video::FrameStatistics& GetFrameStatistics() const
+		{ return _draw_recorder.GetLastFrame(); }
+
+	/** \brief Writes every draw call of the following frames to a text file
+	*** \param filename The name of the file to write
+	*** \param number_frames The number of frames to capture, beginning with the next one
+	*** \return False if the file could not be opened
+	**/
+	bool CaptureDrawCalls(const std::string& filename, uint32 number_frames)
+		{ return _draw_recorder.StartCapture(filename, number_frames); }
+
+	/** \brief Begins a render pass that is timed separately by the frame profiler
+	*** \param pass The pass to begin
+	*** Every call must be matched by a call to EndRenderPass(). Passes may be nested, in which case the inner pass is
+	*** not counted towards the outer one. These calls do nothing unless the frame profiler is active.
+	**/
+	void BeginRenderPass(VIDEO_RENDER_PASS pass);
+
+	//! \brief Ends the render pass that was most recently begun
+	void EndRenderPass();
+
+	//! \brief Shows or hides the frame profiler, which displays the CPU and GPU time spent on each render pass
+	void ToggleFrameProfiler()
+		{ _frame_profiler_display = !_frame_profiler_display; }
+
+	/** \brief Begins writing the render pass timings of every frame to a CSV file
+	*** \param filename The name of the file to write
+	*** \return False if the file could not be opened
+	*** Frames are profiled while the log is open even if the frame profiler is not shown.
+	**/
+	bool StartFrameProfileLog(const std::string& filename)
+		{ return _frame_profiler.StartLog(filename); }
+
+	//! \brief Closes the CSV file that render pass timings are being written to
+	void StopFrameProfileLog()
+		{ _frame_profiler.StopLog(); }
+
+	//! \brief Returns true if render pass timings are being written to a CSV file
+	bool IsFrameProfileLogging() const
+		{ return _frame_profiler.IsLogging(); }
+
+	//! \brief Returns the amount of texture memory used by render caches, in bytes
+	uint32 GetRenderCacheMemory() const
+		{ return _render_cache_memory; }
+
 	/** \brief sets the default cursor to the image in the given filename
 	* \param cursor_image_filename file containing the cursor image
 	*/
@@ -828,15 +1035,39 @@ private:
 	//! \brief Holds the most recently fetched OpenGL error code
 	GLenum _gl_error_code;
 
-	//! \brief The type of window target that the video manager will operate on (SDL window or QT widget)
+	//! \brief The type of window target that the video manager will operate on (SDL window, QT widget, or headless)
 	VIDEO_TARGET _target;
 
+	//! \brief The OpenGL context that frames are drawn with when the target is headless
+	private_video::HeadlessContext _headless_context;
+
 	//! \brief The width and height of the current screen, in pixels
 	int32  _screen_width, _screen_height;
 
+	/** \brief The width and height of the surface that is currently drawn to, in pixels
+	*** This is the size of the frame target, which is smaller than the screen when a render scale is used, or the size
+	*** of the screen once the scene has been resolved or when frames are drawn directly to the window.
+	**/
+	int32 _render_width, _render_height;
+
+	//! \brief The fraction of the screen resolution that the frame target is created at
+	float _render_scale;
+
+	//! \brief When true, a frame target smaller than the screen is stretched with bilinear filtering instead of nearest neighbor
+	bool _render_scale_smooth;
+
+	//! \brief When true, ResolveScene() draws the scaled scene to the window so that the GUI is drawn at the full resolution
+	bool _native_gui;
+
+	//! \brief Set to true by ResolveScene() once the frame target has been drawn to the window during the current frame
+	bool _scene_resolved;
+
     //! \brief True if the game is currently running fullscreen
 	bool _fullscreen;
 
+	//! \brief True if the driver honored the request to synchronize buffer swaps with the display refresh
+	bool _vsync_active;
+
 	//! \brief Enables or disables smoothing of textures
 	bool _smooth_textures;
 
@@ -855,8 +1086,85 @@ private:
 	//! advanced display flag. If true, info about the video engine is shown on screen
 	bool _advanced_display;
 
-	//! keep track of number of draw calls per frame
-	int32 _num_draw_calls;
+	//! \brief Counts the draw calls and state changes of each frame, and captures them to a file on request
+	private_video::DrawRecorder _draw_recorder;
+
+	//! \brief If true, the time spent on each render pass is shown on screen
+	bool _frame_profiler_display;
+
+	//! \brief Times the render passes of each frame while the frame profiler is shown or logging
+	private_video::FrameProfiler _frame_profiler;
+
+	//! \brief Holds the lights and halos drawn during a lighting overlay until they are applied to the scene
+	private_video::LightBuffer _light_buffer;
+
+	//! \brief True between calls to BeginLightingOverlay() and ApplyLightingOverlay(), while lights are being collected
+	bool _lighting_overlay_active;
+
+	//! \brief The number of milliseconds that may be spent each frame placing asynchronously loaded images into texture memory
+	uint32 _image_upload_budget;
+
+	//! \brief The number of megabytes of texture memory that texture sheets are kept within, or zero for no limit
+	uint32 _texture_memory_budget;
+
+	//! \brief True if the particle effect definitions are preloaded when the engine starts
+	bool _preload_particle_effects;
+
+	/** \brief Vertex data for the quads that are waiting in the batch to be drawn
+	*** All three containers hold four entries per quad. Vertices are stored already transformed by the modelview
+	*** matrix that was active when the quad was added, so they are drawn with an identity modelview matrix.
+	**/
+	//@{
+	std::vector<GLfloat> _batch_vertices;
+	std::vector<GLfloat> _batch_tex_coords;
+	std::vector<GLfloat> _batch_colors;
+	//@}
+
+	//! \brief The texture sheet shared by all batched quads, or NULL if the batched quads are untextured
+	private_video::TexSheet* _batch_sheet;
+
+	//! \brief The smoothing property to apply to the batch's texture sheet when the batch is flushed
+	bool _batch_smooth;
+
+	//! \brief The blending mode of all batched quads: 0 for no blending, 1 for normal blending, 2 for additive blending
+	uint8 _batch_blend;
+
+	//! \brief True if the batched quads are drawn in grayscale
+	bool _batch_grayscale;
+
+	/** \brief Shadow copies of the OpenGL state most frequently changed while drawing
+	*** These retain the state last submitted to OpenGL so that redundant state changes can be skipped. Any code
+	*** in the video engine that changes one of these states must do so through the corresponding _SetGL* method.
+	*** The texture binding is shadowed separately by TextureController, and texture filtering by each TexSheet.
+	**/
+	//@{
+	uint8 _gl_blend_mode;
+	bool _gl_texture_2d_enabled;
+	bool _gl_vertex_array_enabled;
+	bool _gl_texture_coord_array_enabled;
+	bool _gl_color_array_enabled;
+	//@}
+
+	/** \brief The offscreen target that each frame is drawn into, when framebuffer objects are supported
+	*** The target is bound for the entire frame, and its contents are drawn to the window in Display(). If the target
+	*** is not valid, frames are drawn directly to the window's back buffer. Its size is the screen size multiplied by
+	*** the render scale.
+	**/
+	private_video::RenderTarget _frame_target;
+
+	//! \brief All render caches that hold an offscreen texture, which must be destroyed when the OpenGL context is replaced
+	std::set<RenderCache*> _render_caches;
+
+	//! \brief The render cache that is currently being recorded, or NULL if drawing goes to the screen
+	RenderCache* _recording_cache;
+
+	//! \brief The amount of texture memory used by all render caches, in bytes
+	uint32 _render_cache_memory;
+
+	/** \brief Converts the texture color of grayscale images to gray as they are drawn
+	*** If the program is not valid, grayscale images are drawn in color.
+	**/
+	private_video::FragmentProgram _grayscale_program;
 
 	//! \brief Set to true when the lighting overlay is enabled
 	bool _light_overlay_enabled;
@@ -933,21 +1241,27 @@ private:
 	//! holds the desired screen height. Not actually applied until ApplySettings() is called
 	int32 _temp_height;
 
+	//! holds the desired render scale. Not actually applied until ApplySettings() is called
+	float _temp_render_scale;
+
 	//! image which is to be used as the cursor
 	StillImage _default_menu_cursor;
 
 	//! Image used for rendering rectangles
 	StillImage _rectangle_image;
 
-	//! current scene lighting color (essentially just modulates vertex colors of all the images)
+	//! current scene lighting color, which the scene is multiplied by where no light falls on it
 	Color _light_color;
 
-	//! STL map containing all loaded particle effect definitions
-	std::map<std::string, ParticleEffectDef*> _particle_effect_defs;
-
 	//! stack containing context, i.e. draw flags plus coord sys. Context is pushed and popped by any VideoEngine functions that clobber these settings
 	std::stack<private_video::Context> _context_stack;
 
+	//! \brief A copy of the current modelview transformation, which batched quads are transformed by
+	private_video::Transform2D _transform;
+
+	//! \brief Transformations saved by PushMatrix() and PushState(), mirroring the OpenGL modelview matrix stack
+	std::stack<private_video::Transform2D> _transform_stack;
+
 	//! check to see if the VideoManager has already been setup.
 	bool _initialized;
 
@@ -1017,10 +1331,95 @@ private:
 	//! \brief Called every frame whenever a lighting sequence is active
 	void _DrawLightning();
 
+	/** \brief Adds a single quad to the quad batch
+	*** \param sheet The texture sheet that the quad samples from, or NULL for an untextured quad
+	*** \param smooth The smoothing property of the texture being drawn
+	*** \param blend The blending mode: 0 for no blending, 1 for normal blending, 2 for additive blending
+	*** \param grayscale If true, the texture color is converted to grayscale when the quad is drawn
+	*** \param vertices An array of four x,y vertex coordinate pairs, relative to the current modelview matrix
+	*** \param tex_coords An array of four s,t texture coordinate pairs (ignored if sheet is NULL)
+	*** \param colors An array of four vertex colors, or of one color if unichrome is true
+	*** \param unichrome If true, the first color is used for all four vertices
+	***
+	*** If the texture sheet, smoothing, blending, or grayscale mode of the quad differ from those of the quads already
+	*** waiting in the batch, the batch is flushed before the new quad is added.
+	**/
+	void _BatchQuad(private_video::TexSheet* sheet, bool smooth, uint8 blend, bool grayscale, const GLfloat* vertices,
+		const GLfloat* tex_coords, const Color* colors, bool unichrome);
+
+	/** \brief Draws all quads waiting in the batch with a single OpenGL draw call and empties the batch
+	*** This must be called before any code issues OpenGL commands that either draw directly or change state that the
+	*** batched quads depend on (projection, viewport, scissoring, texture data). Calling it on an empty batch does nothing.
+	**/
+	void _FlushBatch();
+
+	/** \brief Sets the OpenGL blending state if it differs from the current state
+	*** \param blend_mode 0 to disable blending, 1 for normal blending, 2 for additive blending, 3 for blending
+	*** colors that have been premultiplied by their alpha, 4 for multiplying the screen by the color drawn
+	**/
+	void _SetGLBlendMode(uint8 blend_mode);
+
+	//! \brief Enables or disables GL_TEXTURE_2D if it differs from the current state
+	void _SetGLTexturing(bool enable);
+
+	//! \brief Enables or disables the vertex, texture coordinate, and color client arrays that differ from the current state
+	void _SetGLClientStates(bool vertex_array, bool texture_coord_array, bool color_array);
+
+	/** \brief Reports a draw call that was just made to the draw recorder
+	*** \param primitive The primitive type passed to glDrawArrays()
+	*** \param vertices The vertex array that was drawn, holding two coordinates per vertex
+	*** \param vertex_type The type of the coordinates, either GL_FLOAT or GL_INT
+	*** \param vertex_count The number of vertices that were drawn
+	*** This must be called before the matrices used for the draw are popped.
+	**/
+	void _RecordDraw(GLenum primitive, const void* vertices, GLenum vertex_type, uint32 vertex_count)
+		{ _draw_recorder.RecordDraw(primitive, _gl_texture_2d_enabled ? TextureManager->_last_tex_id : 0, _gl_blend_mode, vertices, vertex_type, vertex_count); }
+
+	/** \brief Submits the default value of all shadowed OpenGL state and updates the shadow copies to match
+	*** This is called whenever a new OpenGL context is created, since the shadow copies no longer reflect the state of the context.
+	**/
+	void _ResetGLState();
+
+	/** \brief Creates the offscreen frame target for the current OpenGL context, if the context supports it
+	*** If the target can not be created, frames will be drawn directly to the window and screen captures will copy the back buffer.
+	**/
+	void _InitializeFrameTarget();
+
+	/** \brief Draws the contents of the frame target over the entire window
+	*** After this call, the window's framebuffer is left bound. The frame target must be bound again before the next frame is drawn.
+	**/
+	void _DrawFrameTarget();
+
+	/** \brief Binds the framebuffer that the game draws to
+	*** This is the frame target, or the window's framebuffer when there is no frame target or once the scene has been resolved.
+	**/
+	void _BindScreenTarget();
+
+	/** \brief Changes the size of the surface that is drawn to, keeping the viewport at the same portion of the surface
+	*** \param width The width of the surface, in pixels
+	*** \param height The height of the surface, in pixels
+	**/
+	void _SetRenderSurfaceSize(int32 width, int32 height);
+
+	/** \brief Releases the offscreen textures of all render caches and marks them dirty
+	*** This must be called before the OpenGL context is destroyed. The caches are recorded again by their owners.
+	**/
+	void _DestroyRenderCaches();
+
+	/** \brief Compiles the grayscale fragment program for the current OpenGL context, if the context supports it
+	*** If the program can not be created, grayscale images will be drawn in color.
+	**/
+	void _InitializeGrayscaleProgram();
+
 	/** \brief Shows graphical statistics useful for performance tweaking
 	*** This includes, for instance, the number of texture switches made during a frame.
 	**/
 	void _DEBUG_ShowAdvancedStats();
+
+	/** \brief Shows the average CPU and GPU time spent on each render pass as a bar graph
+	*** Only CPU times are shown if the OpenGL context does not support timer queries.
+	**/
+	void _DEBUG_ShowFrameProfile();
 }; // class VideoEngine : public hoa_utils::Singleton<VideoEngine>
 
 }  // namespace hoa_video
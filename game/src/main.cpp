@@ -178,6 +178,24 @@ bool LoadSettings()
 	int32 resy = settings.ReadInt("screen_resy");
 	VideoManager->SetInitialResolution(resx, resy);
 	VideoManager->SetFullscreen(fullscreen);
+	// This is a hidden setting for systems with little video memory, given in megabytes. It is not available in the
+	// in-game options menu.
+	if (settings.DoesIntExist("texture_memory"))
+		VideoManager->SetTextureMemoryBudget(static_cast<uint32>(settings.ReadInt("texture_memory")));
+	// Another hidden setting, which turns off reading every particle effect file at startup when set to zero
+	if (settings.DoesIntExist("preload_particles"))
+		VideoManager->SetParticleEffectPreloading(settings.ReadInt("preload_particles") != 0);
+	// The frame rate that the main loop is limited to. A value of zero removes the limit.
+	if (settings.DoesIntExist("frame_rate"))
+		SystemManager->GetFramePacer().SetTargetFrameRate(static_cast<uint32>(settings.ReadInt("frame_rate")));
+	// The percentage of the screen resolution that the scene is drawn at, and how it is stretched to fill the screen.
+	// These are absent from settings files written by older versions of the game.
+	if (settings.DoesIntExist("render_scale"))
+		VideoManager->SetRenderScale(static_cast<float>(settings.ReadInt("render_scale")) / 100.0f);
+	if (settings.DoesBoolExist("smooth_scaling"))
+		VideoManager->SetRenderScaleSmooth(settings.ReadBool("smooth_scaling"));
+	if (settings.DoesBoolExist("native_gui"))
+		VideoManager->SetNativeGUI(settings.ReadBool("native_gui"));
 	settings.CloseTable();
 
 	if (settings.IsErrorDetected()) {
@@ -228,6 +246,10 @@ void InitializeEngine() throw (Exception) {
 	GUIManager = GUISystem::SingletonCreate();
 	GlobalManager = GameGlobal::SingletonCreate();
 
+	// The video target must be chosen before the video engine is initialized
+	if (hoa_main::start_headless == true)
+		VideoManager->SetTarget(VIDEO_TARGET_HEADLESS);
+
 	if (VideoManager->SingletonInitialize() == false) {
 		throw Exception("ERROR: unable to initialize VideoManager", __FILE__, __LINE__, __FUNCTION__);
 	}
@@ -277,6 +299,10 @@ void InitializeEngine() throw (Exception) {
 	if (VideoManager->FinalizeInitialization() == false)
 		throw Exception("ERROR: Unable to apply video settings", __FILE__, __LINE__, __FUNCTION__);
 
+	// Reading a particle effect file when the effect is first added stalls the frame, so they are all read now instead
+	if (VideoManager->IsParticleEffectPreloading() == true)
+		VideoManager->PreloadParticleEffects("lua/graphics/particles");
+
 	// TODO: Add this config file and function call; remove manual loading
 // 	LoadGUIThemes("lua/data/config/themes.lua");
 	if (GUIManager->LoadMenuSkin("black_sleet", "img/menus/black_sleet_skin.png", "img/menus/black_sleet_texture.png") == false) {
@@ -410,16 +436,19 @@ int main(int argc, char *argv[]) {
 			ModeManager->Draw();
 			VideoManager->Display(SystemManager->GetUpdateTime());
 
-			// 2) Process all new events
+			// 2) Hold the frame until the target frame rate allows the next one to begin
+			SystemManager->WaitForNextFrame(VideoManager->IsVSyncActive());
+
+			// 3) Process all new events
 			InputManager->EventHandler();
 
-			// 3) Update any streaming audio sources
+			// 4) Update any streaming audio sources
 			AudioManager->Update();
 
-			// 4) Update timers for correct time-based movement operation
+			// 5) Update timers for correct time-based movement operation
 			SystemManager->UpdateTimers();
 
-			// 5) Update the game status
+			// 6) Update the game status
 			ModeManager->Update();
 
 		} // while (SystemManager->NotDone())
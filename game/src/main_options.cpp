@@ -34,6 +34,7 @@ namespace hoa_main {
 
 bool start_in_test_mode = false;
 uint32 test_number = 0;
+bool start_headless = false;
 
 
 
@@ -42,6 +43,12 @@ bool ParseProgramOptions(int32 &return_code, int32 argc, char **argv) {
 	vector<string> options(argv, argv + argc);
 	return_code = 0;
 
+	// Automated runs on machines without a display may request headless rendering through the environment
+	const char* headless_variable = getenv("ALLACROST_HEADLESS");
+	if (headless_variable != NULL && headless_variable[0] != '\0' && strcmp(headless_variable, "0") != 0) {
+		start_headless = true;
+	}
+
 	for (uint32 i = 1; i < options.size(); i++) {
 		if (options[i] == "-c" || options[i] == "--check") {
 			if (CheckFiles() == true) {
@@ -68,6 +75,9 @@ bool ParseProgramOptions(int32 &return_code, int32 argc, char **argv) {
 		else if (options[i] == "--disable-audio") {
 			hoa_audio::AUDIO_ENABLE = false;
 		}
+		else if (options[i] == "--headless") {
+			start_headless = true;
+		}
 		else if (options[i] == "-h" || options[i] == "--help") {
 			PrintUsage();
 			return_code = 0;
@@ -169,6 +179,7 @@ void PrintUsage() {
 	cout << "                       map, mode_manager, pause, quit, scene, system" << endl;
 	cout << "                       test, utils, video" << endl;
 	cout << "  --disable-audio   :: disables loading and playing audio" << endl;
+	cout << "  --headless        :: renders offscreen without a window, for machines that have no display" << endl;
 	cout << "  --help/-h         :: prints this help menu" << endl;
 	cout << "  --info/-i         :: prints information about the user's system" << endl;
 	cout << "  --reset/-r        :: resets game configuration to use default settings" << endl;
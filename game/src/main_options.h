@@ -25,6 +25,11 @@ extern bool start_in_test_mode;
 //! \brief The specific test number to begin immediate execution of. If zero, this value is ignored
 extern uint32 test_number;
 
+/** \brief Set to true when it is requested that the game run without a window or display
+*** This is requested by the --headless option, or by setting the ALLACROST_HEADLESS environment variable to any value but "0".
+**/
+extern bool start_headless;
+
 /** \brief Parses command-line options and takes appropriate action on those options
 *** \param return_code A reference to the return code to exit the program with.
 *** \param argc The number of arguments given to the program
@@ -179,7 +179,8 @@ BattleMedia::~BattleMedia() {
 
 
 void BattleMedia::SetBackgroundImage(const string& filename) {
-	if (background_image.Load(filename) == false) {
+	// The backdrop is a large image that is decoded while the rest of the battle is being constructed
+	if (background_image.LoadAsync(filename) == false) {
 		IF_PRINT_WARNING(BATTLE_DEBUG) << "failed to load background image: " << filename << endl;
 	}
 }
@@ -520,6 +521,8 @@ void BattleMode::Draw() {
 
 	_DrawBackgroundGraphics();
 	_DrawSprites();
+	// When the battle is drawn at a reduced render scale, the GUI is drawn at the full resolution
+	VideoManager->ResolveScene();
 	_DrawGUI();
 
 	if (_battle_script.IsFileOpen() == true) {
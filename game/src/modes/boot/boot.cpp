@@ -558,7 +558,7 @@ void BootMode::_SetupOptionsMenu() {
 
 void BootMode::_SetupVideoOptionsMenu() {
 	_video_options_menu.SetPosition(512.0f, 300.0f);
-	_video_options_menu.SetDimensions(300.0f, 400.0f, 1, 4, 1, 4);
+	_video_options_menu.SetDimensions(300.0f, 400.0f, 1, 6, 1, 6);
 	_video_options_menu.SetTextStyle(TextStyle("title22"));
 	_video_options_menu.SetAlignment(VIDEO_X_CENTER, VIDEO_Y_CENTER);
 	_video_options_menu.SetOptionAlignment(VIDEO_X_CENTER, VIDEO_Y_CENTER);
@@ -571,9 +571,10 @@ void BootMode::_SetupVideoOptionsMenu() {
 	// Left & right will change window mode as well as confirm
 	_video_options_menu.AddOption(UTranslate("Window mode:"), &BootMode::_OnToggleFullscreen, NULL, NULL, &BootMode::_OnToggleFullscreen, &BootMode::_OnToggleFullscreen);
 	_video_options_menu.AddOption(UTranslate("Brightness:"), NULL, NULL, NULL, &BootMode::_OnBrightnessLeft, &BootMode::_OnBrightnessRight);
-	_video_options_menu.AddOption(UTranslate("Image quality:"));
-
-	_video_options_menu.EnableOption(3, false); // Disable image quality
+	// The render scale is lowered by confirm as well as left, wrapping around to the full resolution
+	_video_options_menu.AddOption(UTranslate("Render scale:"), &BootMode::_OnRenderScaleLeft, NULL, NULL, &BootMode::_OnRenderScaleLeft, &BootMode::_OnRenderScaleRight);
+	_video_options_menu.AddOption(UTranslate("Scaling filter:"), &BootMode::_OnToggleSmoothScaling, NULL, NULL, &BootMode::_OnToggleSmoothScaling, &BootMode::_OnToggleSmoothScaling);
+	_video_options_menu.AddOption(UTranslate("Interface resolution:"), &BootMode::_OnToggleNativeGUI, NULL, NULL, &BootMode::_OnToggleNativeGUI, &BootMode::_OnToggleNativeGUI);
 
 	_video_options_menu.SetSelection(0);
 }
@@ -856,6 +857,17 @@ void BootMode::_RefreshVideoOptions() {
 
 	// Update brightness
 	_video_options_menu.SetOptionText(2, UTranslate("Brightness: ") + MakeUnicodeString(NumberToString(VideoManager->GetGamma() * 50.0f + 0.5f) + " %"));
+
+	// Update the render scale and how the scaled scene is drawn to the screen
+	_video_options_menu.SetOptionText(3, UTranslate("Render scale: ") + MakeUnicodeString(NumberToString(static_cast<int32>(VideoManager->GetRenderScale() * 100.0f + 0.5f)) + " %"));
+	if (VideoManager->IsRenderScaleSmooth())
+		_video_options_menu.SetOptionText(4, UTranslate("Scaling filter: smooth"));
+	else
+		_video_options_menu.SetOptionText(4, UTranslate("Scaling filter: sharp"));
+	if (VideoManager->IsNativeGUI())
+		_video_options_menu.SetOptionText(5, UTranslate("Interface resolution: full"));
+	else
+		_video_options_menu.SetOptionText(5, UTranslate("Interface resolution: scaled"));
 }
 
 
@@ -1051,6 +1063,43 @@ void BootMode::_OnBrightnessRight() {
 
 
 
+void BootMode::_OnRenderScaleLeft() {
+	// Wrap around to the full resolution once the lowest render scale offered is reached
+	float scale = VideoManager->GetRenderScale() - RENDER_SCALE_STEP;
+	if (scale < MIN_RENDER_SCALE - 0.01f)
+		scale = 1.0f;
+
+	_ChangeRenderScale(scale);
+}
+
+
+
+void BootMode::_OnRenderScaleRight() {
+	float scale = VideoManager->GetRenderScale() + RENDER_SCALE_STEP;
+	if (scale > 1.0f)
+		scale = 1.0f;
+
+	_ChangeRenderScale(scale);
+}
+
+
+
+void BootMode::_OnToggleSmoothScaling() {
+	VideoManager->SetRenderScaleSmooth(!VideoManager->IsRenderScaleSmooth());
+	_RefreshVideoOptions();
+	_has_modified_settings = true;
+}
+
+
+
+void BootMode::_OnToggleNativeGUI() {
+	VideoManager->SetNativeGUI(!VideoManager->IsNativeGUI());
+	_RefreshVideoOptions();
+	_has_modified_settings = true;
+}
+
+
+
 void BootMode::_OnSoundLeft() {
 	AudioManager->SetSoundVolume(AudioManager->GetSoundVolume() - 0.1f);
 	_RefreshAudioOptions();
@@ -1483,6 +1532,19 @@ void BootMode::_ChangeResolution(int32 width, int32 height) {
 
 
 
+void BootMode::_ChangeRenderScale(float scale) {
+	// Applying the settings reloads every texture, so it is avoided when the scale would not change
+	if (fabs(scale - VideoManager->GetRenderScale()) < 0.01f)
+		return;
+
+	VideoManager->SetRenderScale(scale);
+	VideoManager->ApplySettings();
+	_RefreshVideoOptions();
+	_has_modified_settings = true;
+}
+
+
+
 bool BootMode::_LoadSettingsFile(const std::string& filename) {
 	ReadScriptDescriptor settings;
 
@@ -1592,6 +1654,15 @@ bool BootMode::_LoadSettingsFile(const std::string& filename) {
 	else if(VideoManager->IsFullscreen() == false && fullscreen)
 		_OnToggleFullscreen();
 
+	// The render scale settings are absent from profiles saved by older versions of the game
+	if (settings.DoesIntExist("render_scale"))
+		_ChangeRenderScale(static_cast<float>(settings.ReadInt("render_scale")) / 100.0f);
+	if (settings.DoesBoolExist("smooth_scaling"))
+		VideoManager->SetRenderScaleSmooth(settings.ReadBool("smooth_scaling"));
+	if (settings.DoesBoolExist("native_gui"))
+		VideoManager->SetNativeGUI(settings.ReadBool("native_gui"));
+	_RefreshVideoOptions();
+
 	settings.CloseTable();
 
 	if (settings.IsErrorDetected()) {
@@ -1671,9 +1742,23 @@ bool BootMode::_SaveSettingsFile(const std::string& filename) {
 
 	// video
 	settings_lua.OpenTable("settings");
+
+	// Settings files saved before these options existed do not hold their keys, which the Modify methods can not add
+	settings_lua.OpenTable("video_settings");
+	if (settings_lua.DoesIntExist("render_scale") == false)
+		settings_lua.AddNewInt("render_scale", 100);
+	if (settings_lua.DoesBoolExist("smooth_scaling") == false)
+		settings_lua.AddNewBool("smooth_scaling", true);
+	if (settings_lua.DoesBoolExist("native_gui") == false)
+		settings_lua.AddNewBool("native_gui", true);
+	settings_lua.CloseTable();
+
 	settings_lua.ModifyInt("video_settings.screen_resx", VideoManager->GetScreenWidth());
 	settings_lua.ModifyInt("video_settings.screen_resy", VideoManager->GetScreenHeight());
 	settings_lua.ModifyBool("video_settings.full_screen", VideoManager->IsFullscreen());
+	settings_lua.ModifyInt("video_settings.render_scale", static_cast<int32>(VideoManager->GetRenderScale() * 100.0f + 0.5f));
+	settings_lua.ModifyBool("video_settings.smooth_scaling", VideoManager->IsRenderScaleSmooth());
+	settings_lua.ModifyBool("video_settings.native_gui", VideoManager->IsNativeGUI());
 	//settings_lua.ModifyFloat("video_settings.brightness", VideoManager->GetGamma());
 
 	// audio
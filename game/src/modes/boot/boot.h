@@ -39,6 +39,12 @@ namespace private_boot {
 
 const std::string _LANGUAGE_FILE = "lua/data/config/languages.lua";
 
+//! \brief The amount that the render scale changes by in the video options menu, and the lowest scale offered there
+//@{
+const float RENDER_SCALE_STEP = 0.25f;
+const float MIN_RENDER_SCALE = 0.5f;
+//@}
+
 //! \brief Various states that boot mode may be in
 enum BOOT_STATE {
 	BOOT_INVALID = 0,
@@ -272,6 +278,10 @@ private:
 	void _OnResolution1280x1024();
 	void _OnBrightnessLeft();
 	void _OnBrightnessRight();
+	void _OnRenderScaleLeft();
+	void _OnRenderScaleRight();
+	void _OnToggleSmoothScaling();
+	void _OnToggleNativeGUI();
 	//@}
 
 	//! \brief Handler methods for the audio options menu
@@ -366,6 +376,11 @@ private:
 	**/
 	void _ChangeResolution(int32 width, int32 height);
 
+	/** \brief Changes the render scale, applies the new settings, and refreshes the video options
+	*** \param scale The fraction of the screen resolution that the scene should be drawn at
+	**/
+	void _ChangeRenderScale(float scale);
+
 	/** \brief Saves the settings to a file specified by the user
 	*** \param filename the name of the file for the settings to be loaded from if a blank string
 	*** is passed the default "settings.lua" will be used
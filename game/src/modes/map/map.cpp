@@ -256,13 +256,18 @@ void MapMode::Update() {
 void MapMode::Draw() {
 	_CalculateMapFrame();
 
+	// The lights and halos that the map script draws are collected and applied together once the map has been drawn
+	VideoManager->BeginLightingOverlay();
 	if (_draw_function)
 		ScriptCallFunction<void>(_draw_function);
 	else
 		_DrawMapLayers();
 
+	VideoManager->ApplyLightingOverlay();
 	VideoManager->DrawOverlays();
 
+	// When the map is drawn at a reduced render scale, the GUI and dialogue are drawn at the full resolution
+	VideoManager->ResolveScene();
 	_DrawGUI();
 
 	if (CurrentState() == STATE_DIALOGUE) {
@@ -277,6 +282,36 @@ void MapMode::Draw() {
 
 
 
+void MapMode::DrawLight(float radius, float x, float y, const Color& color) {
+	MapRectangle light_rect(x - radius, x + radius, y - radius, y + radius);
+	if (MapRectangle::CheckIntersection(light_rect, _map_frame.screen_edges) == false)
+		return;
+
+	// The script may have changed the coordinate system, so the map's own is set for the duration of the call
+	VideoManager->PushState();
+	VideoManager->SetCoordSys(0.0f, SCREEN_COLS, SCREEN_ROWS, 0.0f);
+	VideoManager->DrawLight(radius, x - _map_frame.screen_edges.left, y - _map_frame.screen_edges.top, color);
+	VideoManager->PopState();
+}
+
+
+
+void MapMode::DrawHalo(const ImageDescriptor& image, float x, float y, const Color& color) {
+	float half_width = image.GetWidth() * 0.5f;
+	MapRectangle halo_rect(x - half_width, x + half_width, y - image.GetHeight(), y);
+	if (MapRectangle::CheckIntersection(halo_rect, _map_frame.screen_edges) == false)
+		return;
+
+	// The script may have changed the coordinate system or draw flags, so the map's own are set for the duration of the call
+	VideoManager->PushState();
+	VideoManager->SetCoordSys(0.0f, SCREEN_COLS, SCREEN_ROWS, 0.0f);
+	VideoManager->SetDrawFlags(VIDEO_X_CENTER, VIDEO_Y_BOTTOM, 0);
+	VideoManager->DrawHalo(image, x - _map_frame.screen_edges.left, y - _map_frame.screen_edges.top, color);
+	VideoManager->PopState();
+}
+
+
+
 void MapMode::ResetState() {
 	_state_stack.clear();
 	_state_stack.push_back(STATE_INVALID);
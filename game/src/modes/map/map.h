@@ -155,6 +155,29 @@ public:
 
     void MoveVirtualFocus(uint16 x, uint16 y, uint32 duration);
 
+	/** \brief Adds a light to the current frame of the map
+	*** \param radius The radius of the light, in map grid units
+	*** \param x The x coordinate of the center of the light, in map grid coordinates
+	*** \param y The y coordinate of the center of the light, in map grid coordinates
+	*** \param color The color of the light at its center
+	***
+	*** Lights only last for the frame they are drawn in, so this is called from the map script's draw function.
+	*** The map's coordinate system is used regardless of the one that is active when this is called. Lights that do
+	*** not reach the visible area of the map are discarded.
+	**/
+	void DrawLight(float radius, float x, float y, const hoa_video::Color& color);
+
+	/** \brief Adds a halo to the current frame of the map
+	*** \param image The halo image, which must remain valid until the map has been drawn
+	*** \param x The x coordinate of the bottom center of the halo, in map grid coordinates
+	*** \param y The y coordinate of the bottom center of the halo, in map grid coordinates
+	*** \param color The color to modulate the halo by
+	*** The halo is drawn in the map's coordinate system and aligned by the map's default draw flags, as map objects
+	*** are, regardless of the ones that are active when this is called. Halos that do not reach the visible area of
+	*** the map are discarded.
+	**/
+	void DrawHalo(const hoa_video::ImageDescriptor& image, float x, float y, const hoa_video::Color& color);
+
 	//! \brief Returns true if the player may enter a battle upon colliding with an enemy sprite
     bool AttackAllowed()
 		{ return (CurrentState() != private_map::STATE_DIALOGUE && CurrentState() != private_map::STATE_TREASURE && !IsCameraOnVirtualFocus()); }
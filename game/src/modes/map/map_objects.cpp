@@ -310,9 +310,11 @@ void ObjectLayer::Update() {
 
 
 void ObjectLayer::Draw() const {
+	VideoManager->BeginRenderPass(VIDEO_RENDER_PASS_OBJECTS);
 	for (uint32 i = 0; i < _objects.size(); ++i) {
 		_objects[i]->Draw();
 	}
+	VideoManager->EndRenderPass();
 }
 
 
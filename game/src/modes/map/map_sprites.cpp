@@ -380,7 +380,7 @@ bool MapSprite::LoadStandardAnimations(std::string filename) {
 		for (uint8 i = 0; i < 32; i++)
 			frames[i].SetDimensions(img_half_width * 2, img_height);
 
-		if (ImageDescriptor::LoadMultiImageFromElementGrid(frames, filename, 4, 7) == false) {
+		if (ImageDescriptor::LoadMultiImageFromElementGrid(frames, filename, 4, 7, true) == false) {
 			return false;
 		}
 
@@ -426,7 +426,7 @@ bool MapSprite::LoadStandardAnimations(std::string filename) {
 	for (uint8 i = 0; i < 24; i++)
 		frames[i].SetDimensions(img_half_width * 2, img_height);
 
-	if (ImageDescriptor::LoadMultiImageFromElementGrid(frames, filename, 4, 6) == false) {
+	if (ImageDescriptor::LoadMultiImageFromElementGrid(frames, filename, 4, 6, true) == false) {
 		return false;
 	}
 
@@ -480,7 +480,7 @@ bool MapSprite::LoadRunningAnimations(std::string filename) {
 	for (uint8 i = 0; i < 24; i++)
 		frames[i].SetDimensions(img_half_width * 2, img_height);
 
-	if (ImageDescriptor::LoadMultiImageFromElementGrid(frames, filename, 4, 6) == false) {
+	if (ImageDescriptor::LoadMultiImageFromElementGrid(frames, filename, 4, 6, true) == false) {
 		return false;
 	}
 
@@ -529,7 +529,7 @@ bool MapSprite::LoadAttackAnimations(std::string filename) {
 	for (uint8 i = 0; i < 5; i++)
 		frames[i].SetDimensions(img_half_width * 4, img_height);
 
-	if (ImageDescriptor::LoadMultiImageFromElementGrid(frames, filename, 1, 5) == false) {
+	if (ImageDescriptor::LoadMultiImageFromElementGrid(frames, filename, 1, 5, true) == false) {
 		return false;
 	}
 
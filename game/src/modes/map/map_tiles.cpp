@@ -34,14 +34,18 @@ namespace hoa_map {
 namespace private_map {
 
 void TileLayer::Draw() const {
+	VideoManager->BeginRenderPass(VIDEO_RENDER_PASS_TILES);
 	MapMode::CurrentInstance()->GetTileSupervisor()->DrawTileLayer(_tile_layer_id);
+	VideoManager->EndRenderPass();
 }
 
 
 
 TileSupervisor::TileSupervisor() :
 	_row_count(0),
-	_column_count(0)
+	_column_count(0),
+	_chunk_row_count(0),
+	_chunk_column_count(0)
 {}
 
 
@@ -52,6 +56,7 @@ TileSupervisor::~TileSupervisor() {
 	for (uint32 i = 0; i < _tile_images.size(); i++)
 		delete(_tile_images[i]);
 
+	_tile_chunks.clear();
 	_tile_grid.clear();
 	_tile_images.clear();
 	_animated_tile_images.clear();
@@ -316,6 +321,13 @@ void TileSupervisor::Load(ReadScriptDescriptor& map_file, const MapMode* map_ins
 
 	// Remove all tileset images. Any tiles which were not added to _tile_images will no longer exist in memory
 	tileset_images.clear();
+
+	// ---------- (9) Allocate the tile chunks for every layer of each context. Chunks are not compiled until they are first drawn
+	_chunk_row_count = (_row_count + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH;
+	_chunk_column_count = (_column_count + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH;
+	for (map<MAP_CONTEXT, vector<vector<MapTile> > >::iterator i = _tile_grid.begin(); i != _tile_grid.end(); i++) {
+		_tile_chunks[i->first].assign(tile_layer_count, vector<TileChunk>(_chunk_row_count * _chunk_column_count));
+	}
 } // void TileSupervisor::Load(ReadScriptDescriptor& map_file, const MapMode* map_instance)
 
 
@@ -334,29 +346,99 @@ void TileSupervisor::DrawTileLayer(uint16 layer_index) {
 		return;
 	}
 
-	const MapFrame& frame = MapMode::CurrentInstance()->GetMapFrame();
-
 	MAP_CONTEXT current_context = MapMode::CurrentInstance()->GetCurrentContext();
-	MAP_CONTEXT inherited_context = GetInheritedContext(current_context);
+	map<MAP_CONTEXT, vector<vector<TileChunk> > >::iterator context_chunks = _tile_chunks.find(current_context);
+	if (context_chunks == _tile_chunks.end()) {
+		IF_PRINT_WARNING(MAP_DEBUG) << "no tile chunks were allocated for the current context: " << current_context << endl;
+		return;
+	}
+	vector<TileChunk>& layer_chunks = context_chunks->second[layer_index];
+
+	const MapFrame& frame = MapMode::CurrentInstance()->GetMapFrame();
+	uint16 row_start = static_cast<uint16>(frame.starting_row);
+	uint16 row_end = static_cast<uint16>(frame.starting_row + frame.num_draw_rows);
+	uint16 col_start = static_cast<uint16>(frame.starting_col);
+	uint16 col_end = static_cast<uint16>(frame.starting_col + frame.num_draw_cols);
+
+	// The draw cursor position of the tile in the first row and column of the map
+	float map_x_start = frame.tile_x_start - static_cast<float>(frame.starting_col * 2);
+	float map_y_start = frame.tile_y_start - static_cast<float>(frame.starting_row * 2);
+
+	// Determine which chunks overlap the visible area of the map
+	uint16 chunk_row_start = row_start / TILE_CHUNK_LENGTH;
+	uint16 chunk_row_end = (row_end + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH;
+	uint16 chunk_col_start = col_start / TILE_CHUNK_LENGTH;
+	uint16 chunk_col_end = (col_end + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH;
+	if (chunk_row_end > _chunk_row_count)
+		chunk_row_end = _chunk_row_count;
+	if (chunk_col_end > _chunk_column_count)
+		chunk_col_end = _chunk_column_count;
 
 	VideoManager->SetDrawFlags(VIDEO_BLEND, 0);
-	VideoManager->Move(frame.tile_x_start, frame.tile_y_start);
-	for (uint32 r = static_cast<uint32>(frame.starting_row); r < static_cast<uint32>(frame.starting_row + frame.num_draw_rows); ++r)	{
-		for (uint32 c = static_cast<uint32>(frame.starting_col); c < static_cast<uint32>(frame.starting_col + frame.num_draw_cols); ++c)	{
-			// Draw a tile image if it exists at this location
-			if (_tile_grid[current_context][r][c].tile_layers[layer_index] >= 0) {
-				_tile_images[_tile_grid[current_context][r][c].tile_layers[layer_index]]->Draw();
+	for (uint16 cr = chunk_row_start; cr < chunk_row_end; ++cr) {
+		for (uint16 cc = chunk_col_start; cc < chunk_col_end; ++cc) {
+			TileChunk& chunk = layer_chunks[cr * _chunk_column_count + cc];
+			if (chunk.compiled == false) {
+				_CompileTileChunk(chunk, current_context, layer_index, cr, cc);
 			}
-			else if (_tile_grid[current_context][r][c].tile_layers[layer_index] == INHERITED_TILE) {
-				if (_tile_grid[inherited_context][r][c].tile_layers[layer_index] >= 0) {
-					_tile_images[_tile_grid[inherited_context][r][c].tile_layers[layer_index]]->Draw();
-				}
+
+			VideoManager->Move(map_x_start + static_cast<float>(cc * TILE_CHUNK_LENGTH * 2), map_y_start + static_cast<float>(cr * TILE_CHUNK_LENGTH * 2));
+			chunk.still_tiles.Draw();
+
+			for (uint32 i = 0; i < chunk.animated_tiles.size(); i++) {
+				const TileChunk::AnimatedTile& tile = chunk.animated_tiles[i];
+				if (tile.row < row_start || tile.row >= row_end || tile.col < col_start || tile.col >= col_end)
+					continue;
+
+				VideoManager->Move(map_x_start + static_cast<float>(tile.col * 2), map_y_start + static_cast<float>(tile.row * 2));
+				tile.image->Draw();
 			}
-			VideoManager->MoveRelative(2.0f, 0.0f);
 		}
-		VideoManager->MoveRelative(-static_cast<float>(frame.num_draw_cols * 2), 2.0f);
 	}
-}
+} // void TileSupervisor::DrawTileLayer(uint16 layer_index)
+
+
+
+void TileSupervisor::_CompileTileChunk(TileChunk& chunk, MAP_CONTEXT context, uint16 layer_index, uint16 chunk_row, uint16 chunk_col) {
+	chunk.still_tiles.Clear();
+	chunk.animated_tiles.clear();
+
+	MAP_CONTEXT inherited_context = GetInheritedContext(context);
+	vector<vector<MapTile> >& context_grid = _tile_grid[context];
+
+	uint16 row_start = chunk_row * TILE_CHUNK_LENGTH;
+	uint16 row_end = row_start + TILE_CHUNK_LENGTH;
+	uint16 col_start = chunk_col * TILE_CHUNK_LENGTH;
+	uint16 col_end = col_start + TILE_CHUNK_LENGTH;
+	if (row_end > _row_count)
+		row_end = _row_count;
+	if (col_end > _column_count)
+		col_end = _column_count;
+
+	for (uint16 r = row_start; r < row_end; ++r) {
+		for (uint16 c = col_start; c < col_end; ++c) {
+			int16 image_index = context_grid[r][c].tile_layers[layer_index];
+			if (image_index == INHERITED_TILE) {
+				if (inherited_context == MAP_CONTEXT_NONE)
+					continue;
+				image_index = _tile_grid[inherited_context][r][c].tile_layers[layer_index];
+			}
+			if (image_index < 0)
+				continue;
+
+			// Still tiles are added to the buffer relative to the top-left tile of the chunk. Anything that can not be
+			// added to the buffer (animated tiles and tiles without texture data) is drawn individually every frame instead.
+			StillImage* still_image = dynamic_cast<StillImage*>(_tile_images[image_index]);
+			float x = static_cast<float>((c - col_start) * 2);
+			float y = static_cast<float>((r - row_start) * 2);
+			if (still_image == NULL || chunk.still_tiles.AddImage(*still_image, x, y) == false) {
+				chunk.animated_tiles.push_back(TileChunk::AnimatedTile(r, c, _tile_images[image_index]));
+			}
+		}
+	}
+
+	chunk.compiled = true;
+} // void TileSupervisor::_CompileTileChunk(TileChunk& chunk, MAP_CONTEXT context, uint16 layer_index, uint16 chunk_row, uint16 chunk_col)
 
 } // namespace private_map
 
@@ -23,6 +23,9 @@
 #include "defs.h"
 #include "utils.h"
 
+// Allacrost engines
+#include "video.h"
+
 // Local map mode headers
 #include "map_utils.h"
 
@@ -88,6 +91,49 @@ private:
 }; // class TileLayer : public MapLayer
 
 
+/** ****************************************************************************
+*** \brief A square section of a single tile layer that is drawn as a whole
+***
+*** Drawing every visible tile of a layer individually each frame is expensive,
+*** even though the still tiles of a map never change. Instead, each layer of
+*** each context is divided into chunks of TILE_CHUNK_LENGTH x TILE_CHUNK_LENGTH
+*** tiles. The first time a chunk needs to be drawn, the quads of all of its
+*** still tiles are compiled into a QuadBuffer that is then drawn with one
+*** OpenGL call per tileset texture. Animated tiles change their image every so
+*** often and are not compiled, but instead drawn individually after the
+*** buffer.
+*** ***************************************************************************/
+class TileChunk {
+public:
+	//! \brief Holds the location and image of an animated tile within the chunk
+	class AnimatedTile {
+	public:
+		AnimatedTile(uint16 r, uint16 c, hoa_video::ImageDescriptor* img) :
+			row(r), col(c), image(img) {}
+
+		//! \brief The row and column of the tile in the tile grid
+		uint16 row, col;
+
+		//! \brief A pointer to the tile's image, which is managed by the TileSupervisor
+		hoa_video::ImageDescriptor* image;
+	};
+
+	TileChunk() :
+		compiled(false) {}
+
+	//! \brief Set to true once the tiles of the chunk have been compiled into the members below
+	bool compiled;
+
+	/** \brief The pre-computed quads of all still tiles in the chunk
+	*** The origin of the buffer is the draw position of the top-left tile of the chunk.
+	**/
+	hoa_video::QuadBuffer still_tiles;
+
+	//! \brief All animated tiles in the chunk, along with any still tiles that could not be added to the quad buffer
+	std::vector<AnimatedTile> animated_tiles;
+}; // class TileChunk
+
+
 /** ****************************************************************************
 *** \brief A helper class to MapMode responsible for all tile data and operations
 ***
@@ -162,6 +208,9 @@ private:
 	**/
 	uint16 _column_count;
 
+	//! \brief The number of rows and columns of tile chunks needed to cover the map
+	uint16 _chunk_row_count, _chunk_column_count;
+
 	//! \brief Holds a TileLayer object for each tile layer loaded from the map
 	std::vector<TileLayer> _tile_layers;
 
@@ -183,6 +232,24 @@ private:
 	*** _tile_images vector, which contains both still and animated images.
 	**/
 	std::vector<hoa_video::AnimatedImage*> _animated_tile_images;
+
+	/** \brief The tile chunks of every layer for each map context
+	*** The vector of chunks for a layer is indexed by (chunk_row * _chunk_column_count + chunk_col). The chunks are
+	*** allocated when the map is loaded, but each chunk is only compiled when it is first drawn.
+	**/
+	std::map<MAP_CONTEXT, std::vector<std::vector<TileChunk> > > _tile_chunks;
+
+	/** \brief Compiles the tiles of a single chunk into its quad buffer and animated tile list
+	*** \param chunk The chunk to compile
+	*** \param context The map context that the chunk belongs to
+	*** \param layer_index The index of the tile layer that the chunk belongs to
+	*** \param chunk_row The row of the chunk in the chunk grid
+	*** \param chunk_col The column of the chunk in the chunk grid
+	***
+	*** Inherited tiles are resolved to the image of the inherited context when the chunk is compiled. The chunk is
+	*** built using the current draw flags of the video engine, so this must only be called from within DrawTileLayer().
+	**/
+	void _CompileTileChunk(TileChunk& chunk, MAP_CONTEXT context, uint16 layer_index, uint16 chunk_row, uint16 chunk_col);
 }; // class TileSupervisor
 
 } // namespace private_map
@@ -60,6 +60,9 @@ const int32 UNREFERENCED_TILE = -1;
 //! \brief Indicates that the tile drawn at this location should be the corresponding tile from the inhertiting context
 const int32 INHERITED_TILE = -2;
 
+//! \brief The number of rows and columns of tiles contained within each tile chunk
+const uint16 TILE_CHUNK_LENGTH = 16;
+
 
 /** \name Map State Enum
 *** \brief Represents the current state of operation during map mode.
@@ -95,6 +95,8 @@ void BindModeCode() {
 			.def("PopState", &MapMode::PopState)
 			.def("GetMapEventGroup", &MapMode::GetMapEventGroup)
 			.def("DrawMapLayers", &MapMode::_DrawMapLayers)
+			.def("DrawLight", &MapMode::DrawLight)
+			.def("DrawHalo", &MapMode::DrawHalo)
 
 			// Namespace constants
 			.enum_("constants") [
@@ -0,0 +1,438 @@
+////////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    atlas_packer.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the texture atlas packer tool
+***
+*** Usage: allacrost-atlas-packer ATLAS_DIR MANIFEST_FILE IMAGE_DIR...
+***
+*** Every PNG image file found directly inside each IMAGE_DIR is packed into one
+*** or more atlas images, which are written to ATLAS_DIR. Images from different
+*** directories never share an atlas, since the images of one directory are
+*** usually needed at the same time. The location of every packed image is
+*** written to MANIFEST_FILE, which is read by the game at startup through
+*** TextureController::LoadAtlasManifest().
+***
+*** The tool must be run from the game's data directory, so that the paths
+*** written to the manifest are the same paths that the game loads images with.
+*** ***************************************************************************/
+
+#include <dirent.h>
+#include <png.h>
+
+#include <algorithm>
+
+#include "utils.h"
+
+using namespace std;
+
+namespace hoa_atlas_packer {
+
+//! \brief The maximum width and height of an atlas image, in pixels
+const int32 ATLAS_SIZE = 1024;
+
+/** \brief Images larger than this in either dimension are not packed
+*** Such images would take up a large portion of an atlas, and are rarely loaded together with the smaller images of their directory.
+**/
+const int32 MAX_PACKED_SIZE = 256;
+
+/** \brief The number of pixels surrounding each packed image
+*** The edge pixels of each image are repeated into this border, so that texture smoothing never samples a neighboring image.
+**/
+const int32 IMAGE_BORDER = 1;
+
+//! \brief An image file that is packed into an atlas
+class PackedImage {
+public:
+	//! \brief The name of the image file
+	string filename;
+
+	//! \brief The dimensions of the image, in pixels
+	int32 width, height;
+
+	//! \brief The RGBA pixel data of the image
+	vector<uint8> pixels;
+
+	//! \brief The index of the atlas that the image was packed into
+	uint32 atlas;
+
+	//! \brief The position of the upper left corner of the image in its atlas, in pixels
+	int32 x, y;
+};
+
+//! \brief Sorts images from tallest to shortest, which lets the rows of an atlas be filled with little wasted space
+bool CompareImageHeights(const PackedImage* a, const PackedImage* b) {
+	if (a->height != b->height)
+		return a->height > b->height;
+	if (a->width != b->width)
+		return a->width > b->width;
+	return a->filename < b->filename;
+}
+
+
+
+/** \brief Loads the pixel data of a PNG image file, converted to RGBA format
+*** \param image The image to load, with its filename member set
+*** \return True if the image was loaded successfully
+**/
+bool LoadPngImage(PackedImage& image) {
+	FILE* fp = fopen(image.filename.c_str(), "rb");
+	if (fp == NULL)
+		return false;
+
+	uint8 test_buffer[8];
+	if (fread(test_buffer, 1, 8, fp) != 8 || png_sig_cmp(test_buffer, 0, 8)) {
+		fclose(fp);
+		return false;
+	}
+
+	png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	if (png_ptr == NULL) {
+		fclose(fp);
+		return false;
+	}
+
+	png_infop info_ptr = png_create_info_struct(png_ptr);
+	if (info_ptr == NULL) {
+		png_destroy_read_struct(&png_ptr, NULL, NULL);
+		fclose(fp);
+		return false;
+	}
+
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+		fclose(fp);
+		return false;
+	}
+
+	png_init_io(png_ptr, fp);
+	png_set_sig_bytes(png_ptr, 8);
+	png_read_png(png_ptr, info_ptr, PNG_TRANSFORM_STRIP_16 | PNG_TRANSFORM_PACKING | PNG_TRANSFORM_EXPAND, NULL);
+
+	uint8** row_pointers = png_get_rows(png_ptr, info_ptr);
+	uint32 channels = png_get_channels(png_ptr, info_ptr);
+	image.width = png_get_image_width(png_ptr, info_ptr);
+	image.height = png_get_image_height(png_ptr, info_ptr);
+	image.pixels.resize(image.width * image.height * 4);
+
+	// Gray images have one channel (two with alpha), and color images have three (four with alpha)
+	for (int32 y = 0; y < image.height; y++) {
+		for (int32 x = 0; x < image.width; x++) {
+			uint8* src = row_pointers[y] + x * channels;
+			uint8* dst = &image.pixels[(y * image.width + x) * 4];
+
+			if (channels <= 2) {
+				dst[0] = src[0];
+				dst[1] = src[0];
+				dst[2] = src[0];
+				dst[3] = (channels == 2) ? src[1] : 0xFF;
+			}
+			else {
+				dst[0] = src[0];
+				dst[1] = src[1];
+				dst[2] = src[2];
+				dst[3] = (channels == 4) ? src[3] : 0xFF;
+			}
+		}
+	}
+
+	png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+	fclose(fp);
+	return true;
+} // bool LoadPngImage(PackedImage& image)
+
+
+
+/** \brief Saves RGBA pixel data to a PNG image file
+*** \param filename The name of the file to write
+*** \param width The width of the image, in pixels
+*** \param height The height of the image, in pixels
+*** \param pixels The RGBA pixel data of the image
+*** \return True if the image was saved successfully
+**/
+bool SavePngImage(const string& filename, int32 width, int32 height, vector<uint8>& pixels) {
+	FILE* fp = fopen(filename.c_str(), "wb");
+	if (fp == NULL)
+		return false;
+
+	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	if (png_ptr == NULL) {
+		fclose(fp);
+		return false;
+	}
+
+	png_infop info_ptr = png_create_info_struct(png_ptr);
+	if (info_ptr == NULL) {
+		png_destroy_write_struct(&png_ptr, NULL);
+		fclose(fp);
+		return false;
+	}
+
+	vector<png_bytep> row_pointers(height);
+	for (int32 i = 0; i < height; i++) {
+		row_pointers[i] = &pixels[i * width * 4];
+	}
+
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_write_struct(&png_ptr, &info_ptr);
+		fclose(fp);
+		return false;
+	}
+
+	png_init_io(png_ptr, fp);
+	png_set_IHDR(png_ptr, info_ptr, width, height, 8, PNG_COLOR_TYPE_RGB_ALPHA,
+		PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_set_rows(png_ptr, info_ptr, &row_pointers[0]);
+	png_write_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
+
+	png_destroy_write_struct(&png_ptr, &info_ptr);
+	fclose(fp);
+	return true;
+} // bool SavePngImage(...)
+
+
+
+//! \brief Returns the smallest power of two that is greater than or equal to the argument
+int32 RoundUpPow2(int32 value) {
+	int32 result = 1;
+	while (result < value)
+		result <<= 1;
+	return result;
+}
+
+
+
+/** \brief Converts the path of an image directory into a name to use for the atlases made from its images
+*** For example, "img/icons/items" becomes "icons_items".
+**/
+string CreateAtlasName(string directory) {
+	if (directory.compare(0, 4, "img/") == 0)
+		directory.erase(0, 4);
+
+	for (uint32 i = 0; i < directory.size(); i++) {
+		if (directory[i] == '/' || directory[i] == '\\')
+			directory[i] = '_';
+	}
+	return directory;
+}
+
+
+
+/** \brief Packs the images of one directory into as many atlases as they require and writes those atlases
+*** \param images The images to pack, which have their atlas, x, and y members set by this function
+*** \param atlas_dir The directory to write the atlas images to
+*** \param atlas_name The name to give the atlas images, which is followed by the number of each atlas
+*** \param atlas_filenames The filenames of the atlases written are added to this list
+*** \return True if all atlases were written successfully
+***
+*** The images are placed in rows, from the tallest image to the shortest. The height of each atlas is
+*** reduced to the smallest power of two that holds all of its rows, and its width is reduced likewise
+*** if it only holds a single row.
+**/
+bool PackImages(vector<PackedImage*>& images, const string& atlas_dir, const string& atlas_name, vector<string>& atlas_filenames) {
+	sort(images.begin(), images.end(), CompareImageHeights);
+
+	uint32 first_image = 0;
+	uint32 atlas_number = 0;
+	while (first_image < images.size()) {
+		int32 row_x = 0;
+		int32 row_y = 0;
+		int32 row_height = 0;
+		int32 used_width = 0;
+
+		// Place images in the atlas until one no longer fits
+		uint32 end_image = first_image;
+		for (; end_image < images.size(); end_image++) {
+			PackedImage* image = images[end_image];
+			int32 padded_width = image->width + 2 * IMAGE_BORDER;
+			int32 padded_height = image->height + 2 * IMAGE_BORDER;
+
+			if (row_x + padded_width > ATLAS_SIZE) {
+				row_y += row_height;
+				row_x = 0;
+				row_height = 0;
+			}
+			if (row_y + padded_height > ATLAS_SIZE)
+				break;
+
+			image->atlas = atlas_filenames.size();
+			image->x = row_x + IMAGE_BORDER;
+			image->y = row_y + IMAGE_BORDER;
+
+			row_x += padded_width;
+			if (row_x > used_width)
+				used_width = row_x;
+			if (padded_height > row_height)
+				row_height = padded_height;
+		}
+
+		int32 atlas_width = RoundUpPow2(used_width);
+		int32 atlas_height = RoundUpPow2(row_y + row_height);
+		vector<uint8> atlas_pixels(atlas_width * atlas_height * 4, 0);
+
+		// Copy each image into the atlas, repeating its edge pixels into the surrounding border
+		for (uint32 i = first_image; i < end_image; i++) {
+			PackedImage* image = images[i];
+			for (int32 y = -IMAGE_BORDER; y < image->height + IMAGE_BORDER; y++) {
+				int32 src_y = (y < 0) ? 0 : ((y >= image->height) ? image->height - 1 : y);
+				for (int32 x = -IMAGE_BORDER; x < image->width + IMAGE_BORDER; x++) {
+					int32 src_x = (x < 0) ? 0 : ((x >= image->width) ? image->width - 1 : x);
+					const uint8* src = &image->pixels[(src_y * image->width + src_x) * 4];
+					uint8* dst = &atlas_pixels[((image->y + y) * atlas_width + image->x + x) * 4];
+					memcpy(dst, src, 4);
+				}
+			}
+		}
+
+		string atlas_filename = atlas_dir + "/" + atlas_name + "_" + hoa_utils::NumberToString(atlas_number) + ".png";
+		if (SavePngImage(atlas_filename, atlas_width, atlas_height, atlas_pixels) == false) {
+			cerr << "failed to write atlas image: " << atlas_filename << endl;
+			return false;
+		}
+
+		cout << atlas_filename << ": " << (end_image - first_image) << " images, " << atlas_width << "x" << atlas_height << endl;
+		atlas_filenames.push_back(atlas_filename);
+		first_image = end_image;
+		atlas_number++;
+	}
+
+	return true;
+} // bool PackImages(...)
+
+
+
+/** \brief Loads every PNG image file in a directory that is small enough to be packed
+*** \param directory The directory to search, which is not searched recursively
+*** \param images The loaded images are added to this list
+**/
+void LoadDirectoryImages(const string& directory, vector<PackedImage*>& images) {
+	DIR* dir = opendir(directory.c_str());
+	if (dir == NULL) {
+		cerr << "failed to open image directory: " << directory << endl;
+		return;
+	}
+
+	vector<string> filenames;
+	for (struct dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir)) {
+		string name = entry->d_name;
+		if (name.size() > 4 && name.compare(name.size() - 4, 4, ".png") == 0)
+			filenames.push_back(directory + "/" + name);
+	}
+	closedir(dir);
+
+	// Directory entries are returned in no particular order, so they are sorted for the output to be reproducible
+	sort(filenames.begin(), filenames.end());
+
+	for (uint32 i = 0; i < filenames.size(); i++) {
+		PackedImage* image = new PackedImage();
+		image->filename = filenames[i];
+
+		if (LoadPngImage(*image) == false) {
+			cerr << "failed to load image, it will not be packed: " << image->filename << endl;
+			delete image;
+		}
+		else if (image->width > MAX_PACKED_SIZE || image->height > MAX_PACKED_SIZE) {
+			delete image;
+		}
+		else {
+			images.push_back(image);
+		}
+	}
+} // void LoadDirectoryImages(const string& directory, vector<PackedImage*>& images)
+
+
+
+/** \brief Writes the atlas manifest file
+*** \param filename The name of the manifest file to write
+*** \param atlas_filenames The filenames of all atlases that were written
+*** \param images All images that were packed into the atlases
+*** \return True if the manifest was written successfully
+**/
+bool WriteManifest(const string& filename, const vector<string>& atlas_filenames, const vector<PackedImage*>& images) {
+	ofstream manifest(filename.c_str());
+	if (manifest.fail())
+		return false;
+
+	manifest << "------------------------------------------------------------------------------[[" << endl
+		<< "-- Filename: " << filename.substr(filename.rfind('/') + 1) << endl
+		<< "--" << endl
+		<< "-- This file is generated by allacrost-atlas-packer and should not be edited by hand." << endl
+		<< "-- It records where each packed image file is located within the texture atlases." << endl
+		<< "------------------------------------------------------------------------------]]" << endl
+		<< endl;
+
+	manifest << "atlases = {" << endl;
+	for (uint32 i = 0; i < atlas_filenames.size(); i++) {
+		manifest << "\t\"" << atlas_filenames[i] << "\"," << endl;
+	}
+	manifest << "}" << endl << endl;
+
+	// Atlases are numbered from one, like the elements of a Lua table
+	manifest << "-- Each image is described by { filename, atlas number, x, y, width, height }" << endl;
+	manifest << "images = {" << endl;
+	for (uint32 i = 0; i < images.size(); i++) {
+		const PackedImage* image = images[i];
+		manifest << "\t{ \"" << image->filename << "\", " << (image->atlas + 1) << ", " << image->x << ", " << image->y << ", "
+			<< image->width << ", " << image->height << " }," << endl;
+	}
+	manifest << "}" << endl;
+
+	return (manifest.fail() == false);
+} // bool WriteManifest(...)
+
+} // namespace hoa_atlas_packer
+
+using namespace hoa_atlas_packer;
+
+int main(int argc, char** argv) {
+	if (argc < 4) {
+		cerr << "usage: " << argv[0] << " ATLAS_DIR MANIFEST_FILE IMAGE_DIR..." << endl;
+		return 1;
+	}
+
+	string atlas_dir = argv[1];
+	string manifest_filename = argv[2];
+
+	bool success = true;
+	vector<string> atlas_filenames;
+	vector<PackedImage*> all_images;
+
+	for (int32 i = 3; i < argc; i++) {
+		string directory = argv[i];
+		while (directory.size() > 1 && directory[directory.size() - 1] == '/')
+			directory.erase(directory.size() - 1);
+
+		vector<PackedImage*> images;
+		LoadDirectoryImages(directory, images);
+		if (images.empty() == true)
+			continue;
+
+		if (PackImages(images, atlas_dir, CreateAtlasName(directory), atlas_filenames) == false)
+			success = false;
+
+		// The pixel data is no longer needed once the atlases have been written
+		for (uint32 j = 0; j < images.size(); j++) {
+			vector<uint8>().swap(images[j]->pixels);
+		}
+		all_images.insert(all_images.end(), images.begin(), images.end());
+	}
+
+	if (success == true && WriteManifest(manifest_filename, atlas_filenames, all_images) == false) {
+		cerr << "failed to write atlas manifest: " << manifest_filename << endl;
+		success = false;
+	}
+
+	for (uint32 i = 0; i < all_images.size(); i++) {
+		delete all_images[i];
+	}
+
+	return (success == true) ? 0 : 1;
+} // int main(int argc, char** argv)
@@ -0,0 +1,441 @@
+////////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    particle_benchmark.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the particle keyframe benchmark tool
+***
+*** Usage: allacrost-particle-benchmark [-i ITERATIONS] EFFECT_FILE...
+***
+*** Reads the keyframes of every system in the given particle effect files and
+*** computes the keyframed properties (size, color, and rotation speed) of a
+*** set of particles over their lifetimes in two ways. The first is the linear
+*** keyframe search followed by an interpolation of each property that the
+*** particle systems used to do every frame. The second is the keyframe table
+*** of ParticleKeyframeTable together with the start values and rates of change
+*** that ParticleSystem now computes whenever a particle reaches a keyframe.
+*** The time taken by both is printed, and the tool exits with an error if
+*** their results ever differ by more than a small tolerance.
+*** ***************************************************************************/
+
+extern "C" {
+	#include <lua.h>
+	#include <lauxlib.h>
+	#include <lualib.h>
+}
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+
+#include "utils.h"
+#include "particle_keyframe.h"
+
+using namespace std;
+using namespace hoa_utils;
+using namespace hoa_video;
+using namespace hoa_video::private_video;
+
+namespace hoa_particle_benchmark {
+
+//! \brief The number of particles that are simulated for each system
+const uint32 NUM_PARTICLES = 4096;
+
+//! \brief The number of time steps that each particle lives for
+const uint32 STEPS_PER_LIFETIME = 120;
+
+//! \brief The number of keyframed properties: size x, size y, rotation speed, and the four color components
+const uint32 NUM_PROPERTIES = 7;
+
+//! \brief The largest difference allowed between the two results, relative to the size of the values
+const float TOLERANCE = 0.0001f;
+
+//! \brief Returns the number of seconds that have passed since an earlier time
+double SecondsSince(const chrono::steady_clock::time_point& start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+
+//! \brief Returns the keyframed properties of a keyframe, in the order used by this tool
+void GetProperties(const ParticleKeyframe* keyframe, float* properties) {
+	properties[0] = keyframe->size_x;
+	properties[1] = keyframe->size_y;
+	properties[2] = keyframe->rotation_speed;
+	for (uint32 c = 0; c < 4; c++) {
+		properties[3 + c] = keyframe->color[c];
+	}
+}
+
+
+
+//! \brief Returns the variations of the keyframed properties of a keyframe, in the order used by this tool
+void GetVariations(const ParticleKeyframe* keyframe, float* variations) {
+	variations[0] = keyframe->size_variation_x;
+	variations[1] = keyframe->size_variation_y;
+	variations[2] = keyframe->rotation_speed_variation;
+	for (uint32 c = 0; c < 4; c++) {
+		variations[3 + c] = keyframe->color_variation[c];
+	}
+}
+
+
+
+//! \brief Reads a number from a field of the table on top of the Lua stack, where a missing field reads as zero like it does in the game
+float ReadNumber(lua_State* lua, const char* field) {
+	lua_getfield(lua, -1, field);
+	float value = static_cast<float>(lua_tonumber(lua, -1));
+	lua_pop(lua, 1);
+	return value;
+}
+
+
+
+//! \brief Reads a color from a field of the table on top of the Lua stack
+Color ReadColor(lua_State* lua, const char* field) {
+	Color color(0.0f, 0.0f, 0.0f, 0.0f);
+	lua_getfield(lua, -1, field);
+	if (lua_istable(lua, -1)) {
+		for (int32 c = 0; c < 4; c++) {
+			lua_rawgeti(lua, -1, c + 1);
+			color[c] = static_cast<float>(lua_tonumber(lua, -1));
+			lua_pop(lua, 1);
+		}
+	}
+	lua_pop(lua, 1);
+	return color;
+}
+
+
+
+/** \brief Reads the keyframes of every system in a particle effect file
+*** \param filename The name of the effect file
+*** \param systems Each system's keyframes are added to this list
+*** \return False if the file could not be run
+**/
+bool ReadEffect(const string& filename, vector<vector<ParticleKeyframe> >& systems) {
+	lua_State* lua = luaL_newstate();
+	if (luaL_dofile(lua, filename.c_str()) != 0) {
+		cerr << "failed to run " << filename << ": " << lua_tostring(lua, -1) << endl;
+		lua_close(lua);
+		return false;
+	}
+
+	// The systems table is indexed starting from zero, unlike most Lua tables
+	lua_getglobal(lua, "systems");
+	for (int32 i = 0; lua_istable(lua, -1); i++) {
+		lua_rawgeti(lua, -1, i);
+		if (lua_istable(lua, -1) == false) {
+			lua_pop(lua, 1);
+			break;
+		}
+
+		vector<ParticleKeyframe> keyframes;
+		lua_getfield(lua, -1, "keyframes");
+		for (int32 k = 1; lua_istable(lua, -1); k++) {
+			lua_rawgeti(lua, -1, k);
+			if (lua_istable(lua, -1) == false) {
+				lua_pop(lua, 1);
+				break;
+			}
+
+			ParticleKeyframe keyframe;
+			keyframe.size_x = ReadNumber(lua, "size_x");
+			keyframe.size_y = ReadNumber(lua, "size_y");
+			keyframe.color = ReadColor(lua, "color");
+			keyframe.rotation_speed = ReadNumber(lua, "rotation_speed");
+			keyframe.size_variation_x = ReadNumber(lua, "size_variation_x");
+			keyframe.size_variation_y = ReadNumber(lua, "size_variation_y");
+			keyframe.color_variation = ReadColor(lua, "color_variation");
+			keyframe.rotation_speed_variation = ReadNumber(lua, "rotation_speed_variation");
+			keyframe.time = ReadNumber(lua, "time");
+			keyframes.push_back(keyframe);
+			lua_pop(lua, 1);
+		}
+		lua_pop(lua, 2);
+
+		systems.push_back(keyframes);
+	}
+
+	lua_close(lua);
+	return true;
+}
+
+
+
+/** ****************************************************************************
+*** \brief The particles of one system, with the keyframed state needed by both methods
+***
+*** Each particle is given one random variation of each property for every
+*** keyframe when it is created, so that both methods see the same variations.
+*** ***************************************************************************/
+class BenchmarkParticles {
+public:
+	BenchmarkParticles(const vector<ParticleKeyframe*>& keyframes) :
+		keyframes(keyframes),
+		time(NUM_PARTICLES),
+		lifetime(NUM_PARTICLES),
+		variations(NUM_PARTICLES * keyframes.size() * NUM_PROPERTIES),
+		current(NUM_PARTICLES, 0),
+		reference_result(NUM_PARTICLES * NUM_PROPERTIES),
+		table_result(NUM_PARTICLES * NUM_PROPERTIES),
+		start(NUM_PARTICLES * NUM_PROPERTIES),
+		delta(NUM_PARTICLES * NUM_PROPERTIES),
+		keyframe_start_time(NUM_PARTICLES),
+		keyframe_inverse_duration(NUM_PARTICLES)
+	{
+		table.Build(keyframes);
+
+		for (uint32 i = 0; i < NUM_PARTICLES; i++) {
+			lifetime[i] = 0.5f + static_cast<float>(rand() % 1000) / 1000.0f;
+			// Spread the particles out over their lifetimes, so that they do not all reach keyframes at the same time
+			time[i] = lifetime[i] * static_cast<float>(rand() % STEPS_PER_LIFETIME) / STEPS_PER_LIFETIME;
+
+			for (uint32 k = 0; k < keyframes.size(); k++) {
+				float range[NUM_PROPERTIES];
+				GetVariations(keyframes[k], range);
+				for (uint32 p = 0; p < NUM_PROPERTIES; p++) {
+					float r = static_cast<float>(rand() % 10001) / 10000.0f;
+					variations[(i * keyframes.size() + k) * NUM_PROPERTIES + p] = range[p] * (2.0f * r - 1.0f);
+				}
+			}
+		}
+	}
+
+	//! \brief The keyframes of the system
+	const vector<ParticleKeyframe*>& keyframes;
+
+	//! \brief The keyframe table built from the keyframes
+	ParticleKeyframeTable table;
+
+	//! \brief The age and lifetime of each particle
+	vector<float> time, lifetime;
+
+	//! \brief The variation of each property, for each keyframe of each particle
+	vector<float> variations;
+
+	//! \brief The keyframe that each particle is on, as last found by the table method
+	vector<uint32> current;
+
+	//! \brief The keyframed properties computed by each method
+	vector<float> reference_result, table_result;
+
+	//! \brief The property values at each particle's current keyframe, and their change until the next keyframe
+	vector<float> start, delta;
+
+	//! \brief The time of each particle's current keyframe, and one over the time until the next
+	vector<float> keyframe_start_time, keyframe_inverse_duration;
+
+	//! \brief Returns the values of the properties at a keyframe of a particle, including the variations
+	void GetValues(uint32 i, uint32 k, float* values) const {
+		GetProperties(keyframes[k], values);
+		const float* variation = &variations[(i * keyframes.size() + k) * NUM_PROPERTIES];
+		for (uint32 p = 0; p < NUM_PROPERTIES; p++) {
+			values[p] += variation[p];
+		}
+	}
+
+	//! \brief Advances every particle by one time step, restarting particles that reach the end of their lifetime
+	void Advance() {
+		for (uint32 i = 0; i < NUM_PARTICLES; i++) {
+			time[i] += lifetime[i] / STEPS_PER_LIFETIME;
+			if (time[i] >= lifetime[i]) {
+				time[i] -= lifetime[i];
+				current[i] = 0;
+				BeginKeyframe(i);
+			}
+		}
+	}
+
+	//! \brief Computes the properties with a linear search for the keyframe and an interpolation of every property
+	void UpdateReference() {
+		uint32 num_keyframes = keyframes.size();
+		for (uint32 i = 0; i < NUM_PARTICLES; i++) {
+			float scaled_time = time[i] / lifetime[i];
+
+			uint32 k;
+			for (k = 0; k < num_keyframes; k++) {
+				if (keyframes[k]->time > scaled_time)
+					break;
+			}
+
+			float* result = &reference_result[i * NUM_PROPERTIES];
+			if (k == num_keyframes) {
+				GetProperties(keyframes[k - 1], result);
+				continue;
+			}
+			if (k == 0)
+				k = 1;
+
+			float current_values[NUM_PROPERTIES];
+			float next_values[NUM_PROPERTIES];
+			GetValues(i, k - 1, current_values);
+			GetValues(i, k, next_values);
+
+			float a = (scaled_time - keyframes[k - 1]->time) / (keyframes[k]->time - keyframes[k - 1]->time);
+			for (uint32 p = 0; p < NUM_PROPERTIES; p++) {
+				result[p] = a * next_values[p] + (1.0f - a) * current_values[p];
+			}
+		}
+	}
+
+	//! \brief Computes the properties with the keyframe table, which is only consulted when a particle reaches a new keyframe
+	void UpdateTable() {
+		uint32 num_keyframes = keyframes.size();
+		for (uint32 i = 0; i < NUM_PARTICLES; i++) {
+			float scaled_time = time[i] / lifetime[i];
+			float* result = &table_result[i * NUM_PROPERTIES];
+
+			if (current[i] + 1 < num_keyframes && scaled_time >= keyframes[current[i] + 1]->time) {
+				current[i] = table.FindKeyframe(scaled_time);
+				BeginKeyframe(i);
+			}
+
+			if (current[i] + 1 < num_keyframes) {
+				float a = (scaled_time - keyframe_start_time[i]) * keyframe_inverse_duration[i];
+				for (uint32 p = 0; p < NUM_PROPERTIES; p++) {
+					result[p] = start[i * NUM_PROPERTIES + p] + a * delta[i * NUM_PROPERTIES + p];
+				}
+			}
+		}
+	}
+
+	/** \brief Computes the start values and rates of change of a particle's properties at its current keyframe
+	*** A particle on the last keyframe is given the values of that keyframe instead, which never change.
+	**/
+	void BeginKeyframe(uint32 i) {
+		uint32 k = current[i];
+		if (k + 1 >= keyframes.size()) {
+			GetProperties(keyframes[k], &table_result[i * NUM_PROPERTIES]);
+			return;
+		}
+
+		float current_values[NUM_PROPERTIES];
+		float next_values[NUM_PROPERTIES];
+		GetValues(i, k, current_values);
+		GetValues(i, k + 1, next_values);
+
+		keyframe_start_time[i] = keyframes[k]->time;
+		keyframe_inverse_duration[i] = 1.0f / (keyframes[k + 1]->time - keyframes[k]->time);
+		for (uint32 p = 0; p < NUM_PROPERTIES; p++) {
+			start[i * NUM_PROPERTIES + p] = current_values[p];
+			delta[i * NUM_PROPERTIES + p] = next_values[p] - current_values[p];
+		}
+	}
+
+	//! \brief Returns the largest difference between the results of the two methods, relative to the size of the values
+	float MaxDifference() const {
+		float max_difference = 0.0f;
+		for (uint32 i = 0; i < reference_result.size(); i++) {
+			float scale = max(1.0f, fabsf(reference_result[i]));
+			max_difference = max(max_difference, fabsf(reference_result[i] - table_result[i]) / scale);
+		}
+		return max_difference;
+	}
+}; // class BenchmarkParticles
+
+
+
+/** \brief Benchmarks both methods on the keyframes of one system
+*** \return False if the results of the two methods differ by more than the tolerance
+**/
+bool BenchmarkSystem(const string& name, const vector<ParticleKeyframe>& keyframe_data, uint32 iterations) {
+	vector<ParticleKeyframe*> keyframes;
+	for (uint32 k = 0; k < keyframe_data.size(); k++) {
+		keyframes.push_back(const_cast<ParticleKeyframe*>(&keyframe_data[k]));
+	}
+
+	// Systems with a single keyframe never interpolate, so there is nothing to measure
+	if (keyframes.size() < 2) {
+		cout << setw(36) << left << name << right << setw(4) << keyframes.size() << "   (single keyframe, skipped)" << endl;
+		return true;
+	}
+
+	BenchmarkParticles particles(keyframes);
+	for (uint32 i = 0; i < NUM_PARTICLES; i++) {
+		particles.current[i] = particles.table.FindKeyframe(particles.time[i] / particles.lifetime[i]);
+		particles.BeginKeyframe(i);
+	}
+
+	double reference_seconds = 0.0;
+	double table_seconds = 0.0;
+	float max_difference = 0.0f;
+	for (uint32 n = 0; n < iterations * STEPS_PER_LIFETIME; n++) {
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		particles.UpdateReference();
+		reference_seconds += SecondsSince(start);
+
+		start = chrono::steady_clock::now();
+		particles.UpdateTable();
+		table_seconds += SecondsSince(start);
+
+		max_difference = max(max_difference, particles.MaxDifference());
+		particles.Advance();
+	}
+
+	double updates = static_cast<double>(NUM_PARTICLES) * iterations * STEPS_PER_LIFETIME;
+	cout << setw(36) << left << name << right << setw(4) << keyframes.size() << fixed << setprecision(2)
+		<< setw(11) << (reference_seconds * 1000000000.0 / updates) << " ns"
+		<< setw(11) << (table_seconds * 1000000000.0 / updates) << " ns"
+		<< setw(8) << (reference_seconds / table_seconds) << "x"
+		<< setw(12) << scientific << setprecision(1) << max_difference << endl;
+
+	if (max_difference > TOLERANCE) {
+		cerr << "the keyframed properties of " << name << " differ by more than the tolerance" << endl;
+		return false;
+	}
+	return true;
+}
+
+} // namespace hoa_particle_benchmark
+
+using namespace hoa_particle_benchmark;
+
+int main(int argc, char** argv) {
+	uint32 iterations = 5;
+	int32 first_file = 1;
+	if (argc > 2 && strcmp(argv[1], "-i") == 0) {
+		iterations = atoi(argv[2]);
+		first_file = 3;
+	}
+	if (iterations == 0 || first_file >= argc) {
+		cerr << "usage: " << argv[0] << " [-i ITERATIONS] EFFECT_FILE..." << endl;
+		return 1;
+	}
+
+	cout << "Particle keyframes: " << NUM_PARTICLES << " particles per system, " << iterations << " lifetimes, "
+		<< PARTICLE_KEYFRAME_TABLE_SIZE << " table entries" << endl;
+	cout << setw(36) << left << "system" << right << setw(4) << "keys" << setw(14) << "search" << setw(14) << "table"
+		<< setw(9) << "speedup" << setw(12) << "max diff" << endl;
+
+	srand(1);
+	bool success = true;
+	for (int32 i = first_file; i < argc; i++) {
+		vector<vector<ParticleKeyframe> > systems;
+		if (ReadEffect(argv[i], systems) == false) {
+			success = false;
+			continue;
+		}
+
+		// Only the file name is printed, without its directories
+		string filename = argv[i];
+		size_t slash = filename.find_last_of("/\\");
+		if (slash != string::npos)
+			filename = filename.substr(slash + 1);
+
+		for (uint32 s = 0; s < systems.size(); s++) {
+			success &= BenchmarkSystem(filename + " #" + NumberToString(s), systems[s], iterations);
+		}
+	}
+
+	return (success ? 0 : 1);
+} // int main(int argc, char** argv)
@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+//              Copyright (C) 2026 by The Allacrost Project
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    pixel_benchmark.cpp
+*** \author  agent, agent@local
+*** \brief   Source file for the pixel conversion benchmark tool
+***
+*** Usage: allacrost-pixel-benchmark [ITERATIONS]
+***
+*** Runs each of the pixel conversions in pixel_kernels.h on a 1024x1024 image,
+*** once with the scalar version and once with the vectorized version, and
+*** prints the throughput of both. The output of the two versions is compared
+*** as well, and the tool exits with an error if they ever differ.
+*** ***************************************************************************/
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+
+#include "utils.h"
+#include "pixel_kernels.h"
+
+using namespace std;
+using namespace hoa_video::private_video;
+
+namespace hoa_pixel_benchmark {
+
+//! \brief The width and height of the benchmark image, in pixels
+const uint32 IMAGE_SIZE = 1024;
+
+//! \brief The number of pixels in the benchmark image
+const uint32 PIXEL_COUNT = IMAGE_SIZE * IMAGE_SIZE;
+
+//! \brief The buffers that the conversions read from and write to
+class BenchmarkBuffers {
+public:
+	BenchmarkBuffers() :
+		source(PIXEL_COUNT * 4), scalar_result(PIXEL_COUNT * 4), vector_result(PIXEL_COUNT * 4) {}
+
+	//! \brief Random RGBA pixel data, where roughly one in four pixels is fully transparent
+	vector<uint8> source;
+
+	//! \brief The output of the scalar and vectorized versions of a conversion
+	vector<uint8> scalar_result, vector_result;
+}; // class BenchmarkBuffers
+
+//! \brief A conversion that reads from a source buffer and writes to a destination buffer
+typedef void (*CopyKernel)(const uint8* src, uint8* dst, uint32 count);
+
+//! \brief A conversion that modifies a buffer in place
+typedef void (*InPlaceKernel)(uint8* pixels, uint32 count);
+
+//! \brief Returns the number of seconds that have passed since an earlier time
+double SecondsSince(const chrono::steady_clock::time_point& start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+
+//! \brief Prints the throughput of both versions of a conversion, and returns false if their results differ
+bool Report(const string& name, double scalar_seconds, double vector_seconds, uint32 iterations, BenchmarkBuffers& buffers) {
+	double pixels = static_cast<double>(PIXEL_COUNT) * iterations / 1000000.0;
+	cout << setw(28) << left << name << right << fixed << setprecision(1)
+		<< setw(10) << (pixels / scalar_seconds) << " Mpx/s"
+		<< setw(10) << (pixels / vector_seconds) << " Mpx/s"
+		<< setw(8) << setprecision(2) << (scalar_seconds / vector_seconds) << "x" << endl;
+
+	if (buffers.scalar_result != buffers.vector_result) {
+		cerr << "the scalar and vectorized results of " << name << " differ" << endl;
+		return false;
+	}
+	return true;
+}
+
+
+
+//! \brief Benchmarks a conversion between two buffers
+bool BenchmarkCopy(const string& name, CopyKernel scalar, CopyKernel vectorized, uint32 iterations, BenchmarkBuffers& buffers) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (uint32 i = 0; i < iterations; i++) {
+		scalar(&buffers.source[0], &buffers.scalar_result[0], PIXEL_COUNT);
+	}
+	double scalar_seconds = SecondsSince(start);
+
+	start = chrono::steady_clock::now();
+	for (uint32 i = 0; i < iterations; i++) {
+		vectorized(&buffers.source[0], &buffers.vector_result[0], PIXEL_COUNT);
+	}
+	double vector_seconds = SecondsSince(start);
+
+	return Report(name, scalar_seconds, vector_seconds, iterations, buffers);
+}
+
+
+
+//! \brief Benchmarks a conversion that modifies a buffer, which is reset to the source data before each iteration
+bool BenchmarkInPlace(const string& name, InPlaceKernel scalar, InPlaceKernel vectorized, uint32 iterations, BenchmarkBuffers& buffers) {
+	double scalar_seconds = 0.0;
+	double vector_seconds = 0.0;
+
+	for (uint32 i = 0; i < iterations; i++) {
+		buffers.scalar_result = buffers.source;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		scalar(&buffers.scalar_result[0], PIXEL_COUNT);
+		scalar_seconds += SecondsSince(start);
+
+		buffers.vector_result = buffers.source;
+		start = chrono::steady_clock::now();
+		vectorized(&buffers.vector_result[0], PIXEL_COUNT);
+		vector_seconds += SecondsSince(start);
+	}
+
+	return Report(name, scalar_seconds, vector_seconds, iterations, buffers);
+}
+
+// The grayscale conversion takes an extra argument, so these wrappers give it the signature of the other in-place conversions
+void ScalarGrayscaleRGBA(uint8* pixels, uint32 count) { scalar_kernels::ConvertToGrayscale(pixels, count, true); }
+void VectorGrayscaleRGBA(uint8* pixels, uint32 count) { ConvertToGrayscale(pixels, count, true); }
+void ScalarGrayscaleRGB(uint8* pixels, uint32 count) { scalar_kernels::ConvertToGrayscale(pixels, count, false); }
+void VectorGrayscaleRGB(uint8* pixels, uint32 count) { ConvertToGrayscale(pixels, count, false); }
+
+// Packing is benchmarked in place, since that is how ImageMemory::RGBAToRGB() uses it
+void ScalarPackInPlace(uint8* pixels, uint32 count) { scalar_kernels::PackRGBAToRGB(pixels, pixels, count); }
+void VectorPackInPlace(uint8* pixels, uint32 count) { PackRGBAToRGB(pixels, pixels, count); }
+
+} // namespace hoa_pixel_benchmark
+
+using namespace hoa_pixel_benchmark;
+
+int main(int argc, char** argv) {
+	uint32 iterations = 50;
+	if (argc > 1)
+		iterations = atoi(argv[1]);
+	if (iterations == 0) {
+		cerr << "usage: " << argv[0] << " [ITERATIONS]" << endl;
+		return 1;
+	}
+
+	BenchmarkBuffers buffers;
+	srand(1);
+	for (uint32 i = 0; i < PIXEL_COUNT * 4; i++) {
+		buffers.source[i] = static_cast<uint8>(rand());
+	}
+	for (uint32 i = 3; i < PIXEL_COUNT * 4; i += 16) {
+		buffers.source[i] = 0;
+	}
+
+	cout << "Pixel kernels: " << PixelKernelsName() << ", " << IMAGE_SIZE << "x" << IMAGE_SIZE << " image, " << iterations << " iterations" << endl;
+	cout << setw(28) << left << "conversion" << right << setw(16) << "scalar" << setw(16) << "vectorized" << setw(9) << "speedup" << endl;
+
+	// The RGB and grayscale sources are taken from the start of the RGBA source buffer
+	bool success = true;
+	success &= BenchmarkCopy("gray -> RGBA", scalar_kernels::ExpandGrayToRGBA, ExpandGrayToRGBA, iterations, buffers);
+	success &= BenchmarkCopy("RGB -> RGBA", scalar_kernels::ExpandRGBToRGBA, ExpandRGBToRGBA, iterations, buffers);
+	success &= BenchmarkCopy("RGBA clear transparent", scalar_kernels::CopyRGBAClearTransparent, CopyRGBAClearTransparent, iterations, buffers);
+	success &= BenchmarkCopy("RGBA -> RGB", scalar_kernels::PackRGBAToRGB, PackRGBAToRGB, iterations, buffers);
+	success &= BenchmarkInPlace("RGBA -> RGB (in place)", ScalarPackInPlace, VectorPackInPlace, iterations, buffers);
+	success &= BenchmarkInPlace("grayscale RGBA", ScalarGrayscaleRGBA, VectorGrayscaleRGBA, iterations, buffers);
+	success &= BenchmarkInPlace("grayscale RGB", ScalarGrayscaleRGB, VectorGrayscaleRGB, iterations, buffers);
+	success &= BenchmarkInPlace("premultiply alpha", scalar_kernels::PremultiplyAlpha, PremultiplyAlpha, iterations, buffers);
+
+	return (success ? 0 : 1);
+} // int main(int argc, char** argv)